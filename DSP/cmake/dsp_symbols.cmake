@@ -0,0 +1,40 @@
+# Generate 'DSP/dsp_symbols.h': every function name 'dsp_...' of the library is mapped to 'dspd_...' or 'dspm_...',
+# so the double and mixed precision builds can be linked into one program next to the float build.
+#
+#   cmake -D SOURCE_DIR=<DSP directory> -D OUTPUT=<header> -P dsp_symbols.cmake
+
+file(GLOB_RECURSE files "${SOURCE_DIR}/include/*.h" "${SOURCE_DIR}/src/*.c")
+list(SORT files)
+
+# Names followed by '(': declarations, definitions and calls (static functions are renamed too, that does no harm)
+set(names "")
+foreach(file ${files})
+    file(STRINGS "${file}" lines REGEX "dsp_[A-Za-z0-9_]+[ ]*\\(")
+    foreach(line ${lines})
+        string(REGEX MATCHALL "dsp_[A-Za-z0-9_]+[ ]*\\(" matches "${line}")
+        foreach(match ${matches})
+            string(REGEX REPLACE "[ ]*\\($" "" name "${match}")
+            list(APPEND names ${name})
+        endforeach()
+    endforeach()
+endforeach()
+list(REMOVE_DUPLICATES names)
+list(SORT names)
+
+set(content "// Generated by DSP/cmake/dsp_symbols.cmake, do not edit\n")
+string(APPEND content "#ifndef SJ_DSP_SYMBOLS_H\n#define SJ_DSP_SYMBOLS_H\n\n")
+string(APPEND content "#if defined(DSP_PRECISION_DOUBLE)\n#define DSP_SYMBOL(name) dspd_ ## name\n")
+string(APPEND content "#elif defined(DSP_PRECISION_MIXED)\n#define DSP_SYMBOL(name) dspm_ ## name\n#endif\n\n")
+foreach(name ${names})
+    string(REGEX REPLACE "^dsp_" "" suffix "${name}")
+    string(APPEND content "#define ${name} DSP_SYMBOL(${suffix})\n")
+endforeach()
+string(APPEND content "\n#endif // SJ_DSP_SYMBOLS_H\n")
+
+# Only touch the header if the names changed
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if (NOT "${content}" STREQUAL "${previous}")
+    file(WRITE "${OUTPUT}" "${content}")
+endif()
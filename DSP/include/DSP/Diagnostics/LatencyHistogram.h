@@ -0,0 +1,133 @@
+#ifndef SJ_LATENCY_HISTOGRAM_H
+#define SJ_LATENCY_HISTOGRAM_H
+
+#include <stdio.h> // FILE
+#include <stdint.h> // uint64_t
+#include <time.h> // clock_gettime
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Histogram of the update latency of one block instance, cheap enough to stay enabled in production:
+//
+//     dsp_latency_t* const pid_latency = dsp_latency_create(pid, "pid");
+//     ...
+//     DSP_LATENCY_MEASURE(pid_latency, y = dsp_pid_update(pid, u));
+//     ...
+//     dsp_latency_report(&pid_latency, 1, stdout);
+//
+// Durations are taken in ticks of the time stamp counter on x86 (CLOCK_MONOTONIC nanoseconds elsewhere)
+// and sorted into log-linear buckets like an HDR histogram: exact below DSP_LATENCY_SUB_BUCKETS ticks,
+// above that every power of 2 is split into DSP_LATENCY_SUB_BUCKETS buckets (at most 1/32 relative error).
+// Recording is lock-free: any number of threads may record and read the same histogram concurrently.
+
+
+// Buckets per power of 2
+#define DSP_LATENCY_SUB_BITS 5
+#define DSP_LATENCY_SUB_BUCKETS (1 << DSP_LATENCY_SUB_BITS)
+
+// Durations of 2^DSP_LATENCY_MAX_BITS ticks and more (minutes) share the last bucket
+#define DSP_LATENCY_MAX_BITS 40
+#define DSP_LATENCY_BUCKETS (DSP_LATENCY_SUB_BUCKETS * (DSP_LATENCY_MAX_BITS - DSP_LATENCY_SUB_BITS + 1))
+
+// Maximum length of the name of a histogram (including the terminating '\0')
+#define DSP_LATENCY_NAME_SIZE 32
+
+// Summary in nanoseconds
+typedef struct LatencyStats {
+
+    uint64_t count;
+
+    double min_ns;
+    double mean_ns;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+
+    // Spread of the slow calls: p99.9 - p50
+    double jitter_ns;
+
+    // Calls longer than the deadline (see 'dsp_latency_set_deadline()')
+    uint64_t overruns;
+
+} dsp_latency_stats_t;
+
+// Latency histogram, see 'dsp_latency_create()'
+typedef struct LatencyHistogram dsp_latency_t;
+
+
+// Current time in ticks (time stamp counter on x86, nanoseconds elsewhere)
+static inline uint64_t dsp_latency_ticks(void) {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+#endif
+}
+
+// Record the duration of a call
+#define DSP_LATENCY_MEASURE(histogram, ...) do { \
+    const uint64_t dsp_latency_start_ = dsp_latency_ticks(); \
+    __VA_ARGS__; \
+    dsp_latency_record((histogram), dsp_latency_ticks() - dsp_latency_start_); \
+} while (0)
+
+
+/**
+ * @brief Create an empty histogram for a block instance
+ *
+ * @param block Measured block (e.g. the 'dsp_pid_t*'), only used to identify the histogram
+ *
+ * @param name Name in the report (copied, at most DSP_LATENCY_NAME_SIZE - 1 characters)
+ *
+ * @return Pointer to the new histogram (NULL if memory allocation failed)
+ */
+DSP_FUNCTION dsp_latency_t* dsp_latency_create(const void* const block, const char* const name);
+
+// Destroy (no thread may record into it anymore)
+DSP_FUNCTION bool dsp_latency_destroy(dsp_latency_t* const histogram);
+
+// Block the histogram was created for
+DSP_FUNCTION const void* dsp_latency_block(const dsp_latency_t* const histogram);
+
+// Count calls longer than 'deadline_ns' (0: no deadline)
+DSP_FUNCTION bool dsp_latency_set_deadline(dsp_latency_t* const histogram, const double deadline_ns);
+
+// Add one duration in ticks (use 'DSP_LATENCY_MEASURE()'), ignores NULL
+DSP_FUNCTION void dsp_latency_record(dsp_latency_t* const histogram, const uint64_t ticks);
+
+/**
+ * @brief Summarize the histogram
+ *
+ * @details Percentiles are the upper edge of the bucket holding the rank, limited to the maximum.
+ *          Durations recorded while the summary is taken may be counted partially.
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_latency_get_stats(const dsp_latency_t* const histogram, dsp_latency_stats_t* const stats);
+
+// Upper edge of the bucket holding the fraction 'q' (0 ... 1) of the calls in nanoseconds (0 if empty)
+DSP_FUNCTION double dsp_latency_percentile(const dsp_latency_t* const histogram, const double q);
+
+// Clear all counts (durations recorded at the same time may be lost)
+DSP_FUNCTION bool dsp_latency_reset(dsp_latency_t* const histogram);
+
+// Print one line of 'dsp_latency_stats_t' per histogram
+DSP_FUNCTION bool dsp_latency_report(const dsp_latency_t* const* const histograms, const size_t count, FILE* const stream);
+
+// Convert ticks of 'dsp_latency_ticks()' to nanoseconds (the time stamp counter is calibrated on first use)
+DSP_FUNCTION double dsp_latency_ticks_to_ns(const uint64_t ticks);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_LATENCY_HISTOGRAM_H
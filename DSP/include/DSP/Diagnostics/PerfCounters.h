@@ -0,0 +1,123 @@
+#ifndef SJ_PERF_COUNTERS_H
+#define SJ_PERF_COUNTERS_H
+
+#include <stdio.h> // FILE
+#include <stdint.h> // uint64_t
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Hardware performance counters around single block updates (Linux perf_event_open).
+// With the CMake option 'DSP_PERF_COUNTERS' every 'DSP_PERF_MEASURE()' reads
+// cycles, instructions, cache misses and branch misses before and after the call
+// and adds the difference to the counters of the block instance:
+//
+//     dsp_perf_t* const perf = dsp_perf_create(16);
+//     dsp_perf_instance_t* const pid_perf = dsp_perf_instance(perf, pid, "pid");
+//     ...
+//     DSP_PERF_MEASURE(perf, pid_perf, y = dsp_pid_update(pid, u));
+//     ...
+//     dsp_perf_report(perf, stdout);
+//
+// Without the option 'DSP_PERF_MEASURE()' is only the call and 'dsp_perf_create()' returns NULL.
+
+
+// Maximum length of the name of an instance (including the terminating '\0')
+#define DSP_PERF_NAME_SIZE 32
+
+// Counted events
+typedef enum PerfEvent {
+    PerfCycles = 0,
+    PerfInstructions,
+    PerfCacheMisses,
+    PerfBranchMisses,
+    DSP_PERF_EVENTS
+} dsp_perf_event_t;
+
+// Counters of one instance, summed over all measured calls
+typedef struct PerfStats {
+
+    uint64_t calls;
+
+    // Wall time (clock_gettime)
+    uint64_t nanoseconds;
+
+    // Events of the calling thread in user space, without the cost of the measurement itself
+    uint64_t counts[DSP_PERF_EVENTS];
+
+} dsp_perf_stats_t;
+
+// Counters of the calling thread, see 'dsp_perf_create()'
+typedef struct PerfSession dsp_perf_t;
+
+// Counters of one block instance
+typedef struct PerfInstance dsp_perf_instance_t;
+
+
+#ifdef DSP_PERF_COUNTERS
+#define DSP_PERF_MEASURE(perf, instance, ...) do { dsp_perf_start(perf); __VA_ARGS__; dsp_perf_stop(perf, instance); } while (0)
+#else
+#define DSP_PERF_MEASURE(perf, instance, ...) do { (void) (perf); (void) (instance); __VA_ARGS__; } while (0)
+#endif
+
+
+/**
+ * @brief Open the counters of the calling thread
+ *
+ * @details The events are opened as one group, so they are always read together.
+ *          Events the CPU or the kernel don't provide (e.g. in a virtual machine or with
+ *          '/proc/sys/kernel/perf_event_paranoid' > 2) are left out, calls and wall time are always measured.
+ *          The cost of an empty measurement is subtracted from every call.
+ *
+ * @note A session counts the thread that created it and must only be used by that thread.
+ *
+ * @param capacity Maximum number of instances
+ *
+ * @return Pointer to the new session (NULL without the CMake option 'DSP_PERF_COUNTERS' or if memory allocation failed)
+ */
+DSP_FUNCTION dsp_perf_t* dsp_perf_create(const size_t capacity);
+
+// Close the counters and destroy the session
+DSP_FUNCTION bool dsp_perf_destroy(dsp_perf_t* const perf);
+
+// Check if an event is counted
+DSP_FUNCTION bool dsp_perf_event_available(const dsp_perf_t* const perf, const dsp_perf_event_t event);
+
+/**
+ * @brief Get the counters of a block instance
+ *
+ * @param perf Session
+ *
+ * @param block Instrumented block (e.g. the 'dsp_pid_t*'), every block has one instance
+ *
+ * @param name Name in the report (copied, at most DSP_PERF_NAME_SIZE - 1 characters)
+ *
+ * @return Pointer to the instance, owned by the session (NULL if parameters are invalid or the session is full)
+ */
+DSP_FUNCTION dsp_perf_instance_t* dsp_perf_instance(dsp_perf_t* const perf, const void* const block, const char* const name);
+
+// Read the counters at the start of a measurement (use 'DSP_PERF_MEASURE()')
+DSP_FUNCTION void dsp_perf_start(dsp_perf_t* const perf);
+
+// Read the counters at the end of a measurement and add the difference to 'instance'
+DSP_FUNCTION void dsp_perf_stop(dsp_perf_t* const perf, dsp_perf_instance_t* const instance);
+
+// Counters of one instance
+DSP_FUNCTION bool dsp_perf_get_stats(const dsp_perf_instance_t* const instance, dsp_perf_stats_t* const stats);
+
+// Clear the counters of all instances
+DSP_FUNCTION bool dsp_perf_reset(dsp_perf_t* const perf);
+
+// Print calls, time and events per call and the instructions per cycle of every instance
+DSP_FUNCTION bool dsp_perf_report(const dsp_perf_t* const perf, FILE* const stream);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_PERF_COUNTERS_H
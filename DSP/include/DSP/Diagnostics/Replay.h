@@ -0,0 +1,102 @@
+#ifndef SJ_REPLAY_H
+#define SJ_REPLAY_H
+
+#include <stdio.h> // FILE
+#include <stdint.h> // uint64_t, uint32_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/BlockDiagram.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Replay of recorded signals through a block diagram, as fast as possible:
+//
+//     dsp_replay_file_t* const recording = dsp_replay_open("sensors.dsps");
+//     ... // diagram with an input of the width of the recording
+//     FILE* const file = fopen("outputs.dsps", "wb");
+//     dsp_replay_stats_t stats;
+//     dsp_replay_run(diagram, input, output, recording, file, 0, &stats);
+//     printf("%.3g samples/s\n", stats.samples_per_second);
+//
+// The recording is memory mapped (read into memory where mmap is not available) and
+// processed in batches of up to 'max_samples' samples of the diagram.
+// The outputs are written in the same format and with the same value type as the recording,
+// so the outputs of two builds can be compared byte by byte or within a tolerance.
+
+
+// Header of a recording, followed by 'samples' samples of 'width' values (native byte order)
+typedef struct ReplayFileHeader {
+    char magic[8]; // "DSPSIGNL"
+    uint32_t version; // 1
+    uint32_t value_size; // 4: float, 8: double
+    uint64_t samples;
+    uint64_t width; // Values per sample
+    double sample_time; // Seconds between two samples (0: unknown)
+} dsp_replay_file_header_t;
+
+#define DSP_REPLAY_MAGIC "DSPSIGNL"
+#define DSP_REPLAY_VERSION 1
+
+// Recording opened by 'dsp_replay_open()' (read only)
+typedef struct ReplayFile dsp_replay_file_t;
+
+typedef struct ReplayStats {
+    uint64_t samples;
+    uint64_t batches;
+    double seconds; // Wall time of the replay, including reading the recording and writing the outputs
+    double process_seconds; // Time spent in 'dsp_diagram_process()'
+    double samples_per_second; // samples / seconds
+} dsp_replay_stats_t;
+
+
+// Open a recording (NULL if it cannot be read or is not a recording of this version)
+DSP_FUNCTION dsp_replay_file_t* dsp_replay_open(const char* const path);
+
+// Unmap and close
+DSP_FUNCTION bool dsp_replay_close(dsp_replay_file_t* const file);
+
+// Header of an open recording
+DSP_FUNCTION const dsp_replay_file_header_t* dsp_replay_header(const dsp_replay_file_t* const file);
+
+// Copy 'n' samples starting at sample 'first' into 'values' (n * width values), returns the number of copied samples
+DSP_FUNCTION size_t dsp_replay_read(const dsp_replay_file_t* const file, const uint64_t first, const size_t n, real_t* const values);
+
+/**
+ * @brief Write the header of a recording
+ *
+ * @param value_size 4 (float) or 8 (double)
+ *
+ * @param samples Number of samples that follow, written with 'dsp_replay_write()'
+ */
+DSP_FUNCTION bool dsp_replay_write_header(FILE* const stream, const size_t width, const uint64_t samples, const size_t value_size, const double sample_time);
+
+// Append 'n' values (whole samples) as 'value_size' bytes each
+DSP_FUNCTION bool dsp_replay_write(FILE* const stream, const real_t* const values, const size_t n, const size_t value_size);
+
+/**
+ * @brief Feed a recording through a compiled diagram and write the outputs
+ *
+ * @param input Diagram input with the width of the recording
+ *
+ * @param output Diagram output written to 'stream'
+ *
+ * @param stream Binary file for the outputs (NULL: outputs are discarded, e.g. to measure the throughput)
+ *
+ * @param batch Samples per 'dsp_diagram_process()' (0 or more than 'max_samples' of the diagram: 'max_samples')
+ *
+ * @param stats Throughput of the replay (optional)
+ *
+ * @return 'true' if successfull and 'false' if the widths do not match, the diagram is not compiled or writing failed
+ */
+DSP_FUNCTION bool dsp_replay_run(dsp_diagram_t* const diagram, const size_t input, const size_t output,
+    const dsp_replay_file_t* const file, FILE* const stream, const size_t batch, dsp_replay_stats_t* const stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_REPLAY_H
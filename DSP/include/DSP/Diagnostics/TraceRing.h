@@ -0,0 +1,130 @@
+#ifndef SJ_TRACE_RING_H
+#define SJ_TRACE_RING_H
+
+#include <stdio.h> // FILE
+#include <stdint.h> // uint64_t, uint16_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/pidController.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Binary trace of block inputs, states and outputs, cheap enough to stay on in production:
+// every thread owns a fixed-size ring of records and overwrites the oldest one on each write.
+//
+//     dsp_trace_t* const trace = dsp_trace_create(65536);
+//     ...
+//     dsp_trace_stamp(trace); // once per tick of the loop
+//     y = dsp_pid_update(pid, u);
+//     dsp_trace_pid(trace, 1, pid);
+//     ...
+//     dsp_trace_dump(trace, file); // e.g. from a fault handler or another thread
+//
+// Only the owning thread writes, any thread may read a snapshot or dump at the same time.
+// Records the writer overwrites while they are copied are left out (sequence lock per record).
+// Dumps are decoded with 'dsp_trace_decode' (examples).
+
+
+// Values per record
+#define DSP_TRACE_VALUES 6
+
+// Kind of a record
+typedef enum TraceKind {
+    TraceValues = 0, // Values of 'dsp_trace_write()'
+    TracePid = 1     // input, pidsum, output, Xi, Xd, Xr (states after the update)
+} dsp_trace_kind_t;
+
+// One record (48 bytes, the values are stored as float in every precision build)
+typedef struct TraceRecord {
+
+    // Number of the record in its ring + 1 (0: being written)
+    uint64_t sequence;
+
+    // Last 'dsp_trace_stamp()' of the ring in ticks of 'dsp_latency_ticks()'
+    uint64_t timestamp;
+
+    // Block id chosen by the caller
+    uint16_t source;
+
+    // dsp_trace_kind_t or a value defined by the caller
+    uint16_t kind;
+
+    // Number of valid values
+    uint32_t count;
+
+    float values[DSP_TRACE_VALUES];
+
+} dsp_trace_record_t;
+
+// Header of a dump, followed by 'records' records (native byte order)
+typedef struct TraceFileHeader {
+    char magic[8]; // "DSPTRACE"
+    uint32_t version; // 1
+    uint32_t record_size; // sizeof(dsp_trace_record_t)
+    uint64_t records;
+    double ns_per_tick; // Conversion of the timestamps
+} dsp_trace_file_header_t;
+
+#define DSP_TRACE_MAGIC "DSPTRACE"
+#define DSP_TRACE_VERSION 1
+
+// Ring of one thread, see 'dsp_trace_create()'
+typedef struct TraceRing dsp_trace_t;
+
+
+/**
+ * @brief Create an empty ring
+ *
+ * @param capacity Number of records (rounded up to a power of 2, 48 bytes each)
+ *
+ * @return Pointer to the new ring (NULL if 'capacity' is 0 or memory allocation failed)
+ */
+DSP_FUNCTION dsp_trace_t* dsp_trace_create(const size_t capacity);
+
+// Destroy (no thread may use it anymore, unselect it first)
+DSP_FUNCTION bool dsp_trace_destroy(dsp_trace_t* const trace);
+
+// Number of records the ring holds
+DSP_FUNCTION size_t dsp_trace_capacity(const dsp_trace_t* const trace);
+
+// Number of records written since the creation
+DSP_FUNCTION uint64_t dsp_trace_written(const dsp_trace_t* const trace);
+
+// Ring of the calling thread, used by the write functions when their 'trace' is NULL (NULL: no tracing)
+DSP_FUNCTION bool dsp_trace_select(dsp_trace_t* const trace);
+DSP_FUNCTION dsp_trace_t* dsp_trace_selected();
+
+// Take the timestamp of the following records (once per tick instead of once per record)
+DSP_FUNCTION void dsp_trace_stamp(dsp_trace_t* const trace);
+
+// Write up to DSP_TRACE_VALUES values (the owning thread only)
+DSP_FUNCTION void dsp_trace_write(dsp_trace_t* const trace, const uint16_t source, const uint16_t kind, const real_t* const values, const size_t count);
+
+// Write input, pidsum, output, Xi, Xd and Xr of a controller (call after the update)
+DSP_FUNCTION void dsp_trace_pid(dsp_trace_t* const trace, const uint16_t source, const dsp_pid_t* const pid);
+
+/**
+ * @brief Copy the records in the ring, oldest first
+ *
+ * @param trace Ring (may be written by its thread at the same time)
+ *
+ * @param records Array for the copies
+ *
+ * @param capacity Size of 'records', the newest records are kept if it is smaller than the ring
+ *
+ * @return Number of copied records
+ */
+DSP_FUNCTION size_t dsp_trace_snapshot(const dsp_trace_t* const trace, dsp_trace_record_t* const records, const size_t capacity);
+
+// Write a header and the records of a snapshot to a binary file
+DSP_FUNCTION bool dsp_trace_dump(const dsp_trace_t* const trace, FILE* const stream);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_TRACE_RING_H
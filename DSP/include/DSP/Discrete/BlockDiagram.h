@@ -0,0 +1,135 @@
+#ifndef SJ_BLOCK_DIAGRAM_H
+#define SJ_BLOCK_DIAGRAM_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/pidController.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/Discontinuous.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Block of user code: reads one sample of its input port from 'in' and writes one sample of its output port to 'out'
+typedef void (*dsp_diagram_function_t)(void* const context, const real_t* const in, real_t* const out);
+
+// Signal-flow graph of blocks, see 'dsp_diagram_create()'
+typedef struct BlockDiagram dsp_diagram_t;
+
+
+/**
+ * @brief Create an empty block diagram
+ *
+ * @details Blocks have numbered input and output ports, the type of a port is its width
+ *          (number of values per sample). Every input port is connected to exactly one output port of the same width.
+ *          'dsp_diagram_compile()' turns the diagram into a flat list of instructions in execution order,
+ *          with the buffers of all connections resolved to pointers.
+ *
+ *              // u = pid(r - y), y = plant(saturation(u))
+ *              dsp_diagram_add_input(diagram, 1, &r);
+ *              dsp_diagram_add_sum(diagram, 2, gains, &error); // gains = {1, -1}
+ *              dsp_diagram_add_pid(diagram, pid, &controller);
+ *              dsp_diagram_add_saturation(diagram, saturation, &actuator);
+ *              dsp_diagram_add_zss(diagram, plant, &system);
+ *              dsp_diagram_add_output(diagram, 1, &y);
+ *              dsp_diagram_connect(diagram, r, 0, error, 0);
+ *              dsp_diagram_connect(diagram, system, 0, error, 1);
+ *              ...
+ *              dsp_diagram_compile(diagram);
+ *              dsp_diagram_input(diagram, r)[0] = reference;
+ *              dsp_diagram_step(diagram);
+ *              const real_t output = dsp_diagram_output(diagram, y)[0];
+ *
+ * @param max_blocks Maximum number of blocks
+ *
+ * @param max_samples Maximum number of samples of 'dsp_diagram_process()'
+ *
+ * @return Pointer to the new diagram (NULL if memory allocation failed)
+ */
+DSP_FUNCTION dsp_diagram_t* dsp_diagram_create(const size_t max_blocks, const size_t max_samples);
+
+// Destroy the diagram (not the blocks)
+DSP_FUNCTION bool dsp_diagram_destroy(dsp_diagram_t* const diagram);
+
+
+// ----- Blocks -----
+// The number of the new block is stored in 'id' (optional), blocks are numbered in the order they are added.
+// The diagram only keeps the pointers of the blocks.
+
+// Input of the diagram: output port 0 ('width' values)
+DSP_FUNCTION bool dsp_diagram_add_input(dsp_diagram_t* const diagram, const size_t width, size_t* const id);
+
+// Output of the diagram: input port 0 ('width' values)
+DSP_FUNCTION bool dsp_diagram_add_output(dsp_diagram_t* const diagram, const size_t width, size_t* const id);
+
+// Scalar blocks: input port 0 and output port 0 (1 value).
+// A transfer function without feedthrough (b[0] = 0) breaks algebraic loops.
+DSP_FUNCTION bool dsp_diagram_add_pid(dsp_diagram_t* const diagram, dsp_pid_t* const pid, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_ztf(dsp_diagram_t* const diagram, dsp_ztf_t* const ztf, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_saturation(dsp_diagram_t* const diagram, dsp_saturation_t* const saturation, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_dead_zone(dsp_diagram_t* const diagram, dsp_dead_zone_t* const dead_zone, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_rate_limiter(dsp_diagram_t* const diagram, dsp_rate_limiter_t* const rate_limiter, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_quantizer(dsp_diagram_t* const diagram, dsp_quantization_t* const quantizer, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_schmitt_trigger(dsp_diagram_t* const diagram, dsp_schmitt_trigger_t* const trigger, size_t* const id);
+DSP_FUNCTION bool dsp_diagram_add_schmitt_quantizer(dsp_diagram_t* const diagram, dsp_schmitt_quantization_t* const quantizer, size_t* const id);
+
+// State space model: input port 0 ('nu' values), output port 0 ('ny' values).
+// Without feedthrough (D = 0) the model breaks algebraic loops.
+DSP_FUNCTION bool dsp_diagram_add_zss(dsp_diagram_t* const diagram, dsp_zss_t* const zss, size_t* const id);
+
+// Weighted sum of 'n' scalar input ports (gains: 'n' elements, NULL: all 1), output port 0 (1 value)
+DSP_FUNCTION bool dsp_diagram_add_sum(dsp_diagram_t* const diagram, const size_t n, const real_t* const gains, size_t* const id);
+
+// 'n' scalar input ports into one output port of 'n' values
+DSP_FUNCTION bool dsp_diagram_add_mux(dsp_diagram_t* const diagram, const size_t n, size_t* const id);
+
+// One input port of 'n' values into 'n' scalar output ports (no instruction, the outputs point into the input)
+DSP_FUNCTION bool dsp_diagram_add_demux(dsp_diagram_t* const diagram, const size_t n, size_t* const id);
+
+// Block of user code with input port 0 ('in_width' values) and output port 0 ('out_width' values)
+DSP_FUNCTION bool dsp_diagram_add_function(dsp_diagram_t* const diagram, dsp_diagram_function_t function, void* const context,
+    const size_t in_width, const size_t out_width, size_t* const id);
+
+
+// ----- Wiring and execution -----
+
+// Connect an output port to an input port of the same width (an input port can only be connected once)
+DSP_FUNCTION bool dsp_diagram_connect(dsp_diagram_t* const diagram, const size_t from, const size_t from_port, const size_t to, const size_t to_port);
+
+/**
+ * @brief Sort the blocks into a list of instructions and resolve the buffers of all connections
+ *
+ * @details Without feedback every instruction processes a whole block of samples before the next one runs.
+ *          Feedback through a state space model or transfer function without feedthrough is split
+ *          into its output and its state update, then all instructions run sample by sample.
+ *
+ * @return 'true' if successfull and 'false' if an input port is unconnected,
+ *         the diagram has an algebraic loop or memory allocation failed
+ */
+DSP_FUNCTION bool dsp_diagram_compile(dsp_diagram_t* const diagram);
+
+// Buffers of the inputs and outputs: 'max_samples' samples of 'width' values (NULL if not compiled).
+// Valid until the next compilation.
+DSP_FUNCTION real_t* dsp_diagram_input(dsp_diagram_t* const diagram, const size_t id);
+DSP_FUNCTION const real_t* dsp_diagram_output(const dsp_diagram_t* const diagram, const size_t id);
+
+// Values per sample of a diagram input or output (0 for other blocks) and the 'max_samples' of the creation
+DSP_FUNCTION size_t dsp_diagram_width(const dsp_diagram_t* const diagram, const size_t id);
+DSP_FUNCTION size_t dsp_diagram_max_samples(const dsp_diagram_t* const diagram);
+
+// Process one sample (the first sample of the input and output buffers)
+DSP_FUNCTION bool dsp_diagram_step(dsp_diagram_t* const diagram);
+
+// Process the first 'n' samples of the input and output buffers
+DSP_FUNCTION bool dsp_diagram_process(dsp_diagram_t* const diagram, const size_t n);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_BLOCK_DIAGRAM_H
@@ -0,0 +1,131 @@
+#ifndef SJ_DISCONTINUOUS_BANK_H
+#define SJ_DISCONTINUOUS_BANK_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h" // real_t
+#include "DSP/Discrete/Discontinuous.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Multichannel versions of the Discontinuous blocks.
+// Every bank stores one array per parameter and state (one element per channel) in a single allocation
+// and processes all channels in one call with compare-select instead of branches.
+// Channels are configured from the single-channel structs and give the same outputs bit for bit.
+// 'in' and 'out' of the update functions have 'channels' elements and may be the same array.
+
+
+typedef struct SaturationBank {
+    size_t channels;
+    real_t* UpperLimit;
+    real_t* LowerLimit;
+    real_t* output;
+    void* block;
+} dsp_saturation_bank_t;
+
+DSP_FUNCTION dsp_saturation_bank_t* dsp_saturation_bank_create(const size_t channels, const real_t upper_limit, const real_t lower_limit);
+DSP_FUNCTION bool dsp_saturation_bank_set_channel(dsp_saturation_bank_t* const bank, const size_t channel, const dsp_saturation_t* const saturation);
+DSP_FUNCTION bool dsp_saturation_bank_update(dsp_saturation_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_saturation_bank_destroy(dsp_saturation_bank_t* const bank);
+
+
+
+
+typedef struct DeadZoneBank {
+    size_t channels;
+    real_t* UpperLimit;
+    real_t* LowerLimit;
+    real_t* output;
+    void* block;
+} dsp_dead_zone_bank_t;
+
+DSP_FUNCTION dsp_dead_zone_bank_t* dsp_dead_zone_bank_create(const size_t channels, const real_t upper_limit, const real_t lower_limit);
+DSP_FUNCTION bool dsp_dead_zone_bank_set_channel(dsp_dead_zone_bank_t* const bank, const size_t channel, const dsp_dead_zone_t* const dead_zone);
+DSP_FUNCTION bool dsp_dead_zone_bank_update(dsp_dead_zone_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_dead_zone_bank_destroy(dsp_dead_zone_bank_t* const bank);
+
+
+
+
+typedef struct RateLimiterBank {
+    size_t channels;
+    real_t* UpperLimit; // upper_rate * Ts
+    real_t* LowerLimit; // lower_rate * Ts
+    real_t* output;
+    void* block;
+} dsp_rate_limiter_bank_t;
+
+DSP_FUNCTION dsp_rate_limiter_bank_t* dsp_rate_limiter_bank_create(const size_t channels, const real_t upper_rate, const real_t lower_rate, const real_t Ts, const real_t initial_output);
+DSP_FUNCTION bool dsp_rate_limiter_bank_set_channel(dsp_rate_limiter_bank_t* const bank, const size_t channel, const dsp_rate_limiter_t* const rate_limiter);
+DSP_FUNCTION bool dsp_rate_limiter_bank_reset(dsp_rate_limiter_bank_t* const bank);
+DSP_FUNCTION bool dsp_rate_limiter_bank_update(dsp_rate_limiter_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_rate_limiter_bank_destroy(dsp_rate_limiter_bank_t* const bank);
+
+
+
+
+// y = c + q * round((u - c) / q), one rounding method for all channels
+typedef struct QuantizationBank {
+    size_t channels;
+    rounding_method_t method;
+    real_t* offset;
+    real_t* interval;
+    real_t* output;
+    void* block;
+} dsp_quantization_bank_t;
+
+DSP_FUNCTION dsp_quantization_bank_t* dsp_quantizer_bank_create(const size_t channels, const real_t offset, const real_t interval, const rounding_method_t method);
+DSP_FUNCTION bool dsp_quantizer_bank_set_channel(dsp_quantization_bank_t* const bank, const size_t channel, const real_t offset, const real_t interval);
+DSP_FUNCTION bool dsp_quantizer_bank_update(dsp_quantization_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_quantizer_bank_destroy(dsp_quantization_bank_t* const bank);
+
+
+
+
+typedef struct SchmittTriggerBank {
+    size_t channels;
+    real_t* low_level_input;
+    real_t* high_level_input;
+    real_t* low_level_output;
+    real_t* high_level_output;
+
+    // Masks: all bits set if inverted / if the (not inverted) output is high
+    uint32_t* inverted;
+    uint32_t* high;
+
+    real_t* output;
+    void* block;
+} dsp_schmitt_trigger_bank_t;
+
+DSP_FUNCTION dsp_schmitt_trigger_bank_t* dsp_schmitt_trigger_bank_create(const size_t channels, const dsp_schmitt_trigger_t* const trigger);
+DSP_FUNCTION bool dsp_schmitt_trigger_bank_set_channel(dsp_schmitt_trigger_bank_t* const bank, const size_t channel, const dsp_schmitt_trigger_t* const trigger);
+DSP_FUNCTION bool dsp_schmitt_trigger_bank_update(dsp_schmitt_trigger_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_schmitt_trigger_bank_destroy(dsp_schmitt_trigger_bank_t* const bank);
+
+
+
+
+typedef struct SchmittQuantizationBank {
+    size_t channels;
+    real_t* offset;
+    real_t* interval;
+    real_t* high_level_hysteresis;
+    real_t* low_level_hysteresis;
+    real_t* output;
+    void* block;
+} dsp_schmitt_quantization_bank_t;
+
+DSP_FUNCTION dsp_schmitt_quantization_bank_t* dsp_schmitt_quantizer_bank_create(const size_t channels, const dsp_schmitt_quantization_t* const quantizer);
+DSP_FUNCTION bool dsp_schmitt_quantizer_bank_set_channel(dsp_schmitt_quantization_bank_t* const bank, const size_t channel, const dsp_schmitt_quantization_t* const quantizer);
+DSP_FUNCTION bool dsp_schmitt_quantizer_bank_update(dsp_schmitt_quantization_bank_t* const bank, const real_t* const in, real_t* const out);
+DSP_FUNCTION bool dsp_schmitt_quantizer_bank_destroy(dsp_schmitt_quantization_bank_t* const bank);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_DISCONTINUOUS_BANK_H
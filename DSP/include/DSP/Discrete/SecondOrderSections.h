@@ -0,0 +1,99 @@
+#ifndef SJ_SOS_H
+#define SJ_SOS_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h" // real_t
+#include "DSP/Math/Polynomial.h" // dsp_poly_t
+#include "DSP/Discrete/zTransferFunction.h" // dsp_ztf_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Cascade of biquads: G(z) = G_1(z) * G_2(z) * ... * G_n(z)
+// with G_k(z) = (b0 + b1 * z^-1 + b2 * z^-2) / (1 + a1 * z^-1 + a2 * z^-2)
+// Every section runs in Direct Form II Transposed with two state values,
+// so the rounding errors stay local to the section instead of the whole polynomial.
+typedef struct SecondOrderSections {
+
+    size_t sections;
+
+    // Normalized coefficients of every section: b0, b1, b2, a1, a2 (a0 = 1)
+    real_t* coefficients;
+
+    // State of every section: s1, s2 (double in mixed precision builds)
+    accum_t* state;
+
+    // Internal: struct and arrays packed into one allocation
+    void* block;
+
+} dsp_sos_t;
+
+
+// Create 'sections' sections with G_k(z) = 1 and cleared state
+DSP_FUNCTION dsp_sos_t* dsp_sos_create(const size_t sections);
+
+/**
+ * @brief Create a cascade from the coefficients of its sections
+ *
+ * @param sections Number of sections
+ *
+ * @param sos Array with 6 coefficients per section: b0, b1, b2, a0, a1, a2 (the layout of MATLAB and SciPy)
+ *            If 'sos' is a NULL pointer: G_k(z) = 1
+ *
+ * @return Pointer to the new cascade (NULL if a0 is 0 or memory allocation failed)
+ */
+DSP_FUNCTION dsp_sos_t* dsp_sos_create_from_arrays(const size_t sections, const real_t* const sos);
+
+/**
+ * @brief Factor a transfer function into second order sections
+ *
+ * @details The roots of numerator and denominator are computed in double precision.
+ *          Starting with the poles closest to the unit circle, every pair of poles
+ *          (complex conjugated or the two largest real ones) is matched with the nearest remaining zeros.
+ *          The sections are stored in reverse order, so the section with the poles closest to the unit circle comes last,
+ *          and the overall gain is part of the first section.
+ *
+ * @note The factorization can only recover what survived the rounding of 'num' and 'den' to real_t:
+ *       the poles of a narrow high order filter may already be outside of the unit circle.
+ *       Such filters should be designed as sections and created with 'dsp_sos_create_from_arrays()'.
+ *
+ * @param order Order of the transfer function ('(order+1)/2' sections, at least 1)
+ *
+ * @param num Array with the coefficients of the numerator b0, b1, ..., bn ('order+1' in size, NULL: 1)
+ *
+ * @param den Array with the coefficients of the denominator a0, a1, ..., an ('order+1' in size, NULL: 1)
+ *
+ * @return Pointer to the new cascade (NULL if a0 is 0, the roots could not be paired or memory allocation failed)
+ */
+DSP_FUNCTION dsp_sos_t* dsp_sos_create_from_tf(const size_t order, const real_t* const num, const real_t* const den);
+
+// Factor the coefficients of a zTransferFunction (history is not copied)
+DSP_FUNCTION dsp_sos_t* dsp_sos_create_from_ztf(const dsp_ztf_t* const ztf);
+
+// Factor num(z^-1) / den(z^-1), the polynomials may have different orders
+DSP_FUNCTION dsp_sos_t* dsp_sos_create_from_poly(const dsp_poly_t* const num, const dsp_poly_t* const den);
+
+// Destroy
+DSP_FUNCTION bool dsp_sos_destroy(dsp_sos_t* const sos);
+
+// Set the coefficients of one section (3 elements each, NULL: 1)
+DSP_FUNCTION bool dsp_sos_set_section(dsp_sos_t* const sos, const size_t section, const real_t* const num, const real_t* const den);
+
+// Clear the state of all sections
+DSP_FUNCTION bool dsp_sos_reset(dsp_sos_t* const sos);
+
+// Process one sample
+DSP_FUNCTION real_t dsp_sos_update(dsp_sos_t* const sos, const real_t u);
+
+// Process 'n' samples ('in' and 'out' may be the same array)
+DSP_FUNCTION bool dsp_sos_process_block(dsp_sos_t* const sos, const real_t* const in, real_t* const out, const size_t n);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_SOS_H
@@ -21,6 +21,7 @@ DSP_FUNCTION real_t dsp_dot_product(
 // w = conv(u,v) returns the convolution of vectors u and v. 
 // If u and v are vectors of polynomial coefficients, 
 // convolving them is equivalent to multiplying the two polynomials.
+// Switches to FFT convolution if both u and v have at least DSP_FFT_CONV_MIN_SIZE elements.
 DSP_FUNCTION size_t dsp_conv(
     const real_t* const u, const size_t u_size,
     const real_t* const v, const size_t v_size,
@@ -0,0 +1,136 @@
+#ifndef SJ_STATE_SPACE_HPP
+#define SJ_STATE_SPACE_HPP
+
+#include <array>
+#include <cstddef>
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/zStateSpace.h"
+
+namespace dsp {
+
+
+/**
+ * @brief zStateSpace with the dimensions fixed at compile time (header-only)
+ *
+ * @details x[k+1] = A * x[k] + B * u[k]
+ *          y[k] = C * x[k] + D * u[k]
+ *          The matrices are row-major std::arrays like the elements of a 'dsp_matrix_t',
+ *          every loop runs over the template dimensions, so small models are unrolled completely.
+ *
+ *              dsp::StateSpace<2, 1, 1> model({a11, a12, a21, a22}, {b1, b2}, {c1, c2}, {d});
+ *              model.update(&u, &y);
+ *
+ *          'assign()' and 'copy_to()' convert from and to a 'dsp_zss_t' of the same dimensions.
+ */
+template <std::size_t NX, std::size_t NU, std::size_t NY>
+class StateSpace {
+public:
+
+    static constexpr std::size_t nx = NX;
+    static constexpr std::size_t nu = NU;
+    static constexpr std::size_t ny = NY;
+
+    std::array<real_t, NX * NX> A; // System matrix
+    std::array<real_t, NX * NU> B; // Input matrix
+    std::array<real_t, NY * NX> C; // Output matrix
+    std::array<real_t, NY * NU> D; // Feedthrough matrix
+    std::array<real_t, NX> x; // State vector
+
+    // All matrices and the state zero
+    StateSpace() : A(), B(), C(), D(), x() {}
+
+    StateSpace(const std::array<real_t, NX * NX>& a, const std::array<real_t, NX * NU>& b,
+        const std::array<real_t, NY * NX>& c, const std::array<real_t, NY * NU>& d) : A(a), B(b), C(c), D(d), x() {}
+
+    // Copy matrices and state of a zStateSpace with the same dimensions
+    bool assign(const dsp_zss_t* const zss) {
+        if (!same_dimensions(zss)) { return false; }
+        copy(zss->A->elements, A.data(), A.size());
+        copy(zss->B->elements, B.data(), B.size());
+        copy(zss->C->elements, C.data(), C.size());
+        copy(zss->D->elements, D.data(), D.size());
+        copy(zss->x->elements, x.data(), x.size());
+        return true;
+    }
+
+    // Copy matrices and state into a zStateSpace with the same dimensions
+    bool copy_to(dsp_zss_t* const zss) const {
+        if (!same_dimensions(zss)) { return false; }
+        copy(A.data(), zss->A->elements, A.size());
+        copy(B.data(), zss->B->elements, B.size());
+        copy(C.data(), zss->C->elements, C.size());
+        copy(D.data(), zss->D->elements, D.size());
+        return dsp_zss_set_state(zss, x.data());
+    }
+
+    // New zStateSpace with the same matrices and state (release with 'dsp_zss_destroy()')
+    dsp_zss_t* create_zss() const {
+        return dsp_zss_create_from_arrays(NX, NU, NY, A.data(), B.data(), C.data(), D.data(), x.data());
+    }
+
+    // Set the state ('NX' elements, NULL: 0)
+    void set_state(const real_t* const x0) {
+        for (std::size_t i = 0; i < NX; ++i) { x[i] = (x0 == NULL ? 0 : x0[i]); }
+    }
+
+    // Clear the state
+    void reset() { x.fill(0); }
+
+    // Any non-zero element in D
+    bool has_feedthrough() const {
+        for (std::size_t k = 0; k < NY * NU; ++k) {
+            if (D[k] != 0) { return true; }
+        }
+        return false;
+    }
+
+    // y[k] = C * x[k] + D * u[k]
+    void get_output(const real_t* const u, real_t* const y) const {
+        for (std::size_t i = 0; i < NY; ++i) {
+            real_t sum = 0;
+            for (std::size_t j = 0; j < NX; ++j) { sum += C[i * NX + j] * x[j]; }
+            for (std::size_t j = 0; j < NU; ++j) { sum += D[i * NU + j] * u[j]; }
+            y[i] = sum;
+        }
+    }
+
+    // x[k+1] = A * x[k] + B * u[k]
+    void update_state(const real_t* const u) {
+        std::array<real_t, NX> xn;
+        for (std::size_t i = 0; i < NX; ++i) {
+            real_t sum = 0;
+            for (std::size_t j = 0; j < NX; ++j) { sum += A[i * NX + j] * x[j]; }
+            for (std::size_t j = 0; j < NU; ++j) { sum += B[i * NU + j] * u[j]; }
+            xn[i] = sum;
+        }
+        x = xn;
+    }
+
+    // Get output and update state
+    void update(const real_t* const u, real_t* const y) {
+        get_output(u, y);
+        update_state(u);
+    }
+
+    std::array<real_t, NY> update(const std::array<real_t, NU>& u) {
+        std::array<real_t, NY> y;
+        update(u.data(), y.data());
+        return y;
+    }
+
+private:
+
+    bool same_dimensions(const dsp_zss_t* const zss) const {
+        return zss != NULL && zss->A != NULL && zss->B != NULL && zss->C != NULL && zss->D != NULL && zss->x != NULL &&
+            zss->A->rows == NX && zss->B->columns == NU && zss->C->rows == NY;
+    }
+
+    static void copy(const real_t* const from, real_t* const to, const std::size_t n) {
+        for (std::size_t k = 0; k < n; ++k) { to[k] = from[k]; }
+    }
+};
+
+
+} // namespace dsp
+
+#endif // SJ_STATE_SPACE_HPP
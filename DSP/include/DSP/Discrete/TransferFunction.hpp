@@ -0,0 +1,139 @@
+#ifndef SJ_TRANSFER_FUNCTION_HPP
+#define SJ_TRANSFER_FUNCTION_HPP
+
+#include <array>
+#include <cstddef>
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/zTransferFunction.h"
+
+namespace dsp {
+
+
+/**
+ * @brief zTransferFunction with the order fixed at compile time (header-only)
+ *
+ * @details G(z) = (b0 + b1 * z^-1 + ... + bN * z^-N) / (a0 + a1 * z^-1 + ... + aN * z^-N)
+ *          Coefficients and history live in std::arrays and every loop runs over 'N',
+ *          so the compiler unrolls the difference equation of small filters completely.
+ *          The coefficients are stored divided by a0, the history newest first.
+ *
+ *              dsp::TransferFunction<2> biquad({b0, b1, b2}, {1, a1, a2});
+ *              const real_t y = biquad.update(u);
+ *
+ *          'assign()' and 'copy_to()' convert from and to a 'dsp_ztf_t' of the same order.
+ */
+template <std::size_t N>
+class TransferFunction {
+public:
+
+    static constexpr std::size_t order = N;
+    using Coefficients = std::array<real_t, N + 1>;
+    using History = std::array<real_t, N>;
+
+    // G(z) = 1
+    TransferFunction() : b_(), a_(), u_(), y_() {
+        b_[0] = 1;
+        a_[0] = 1;
+    }
+
+    // G(z) = num(z^-1) / den(z^-1) with cleared history
+    TransferFunction(const Coefficients& num, const Coefficients& den) : TransferFunction() {
+        set_coefficients(num.data(), den.data());
+    }
+
+    // Copy coefficients and history of a zTransferFunction ('order' must be N)
+    bool assign(const dsp_ztf_t* const ztf) {
+        if (ztf == NULL || ztf->order != N) { return false; }
+        set_coefficients(ztf->b, ztf->a);
+        for (std::size_t i = 0; i < N; ++i) {
+            u_[i] = ztf->u[ztf->index + i];
+            y_[i] = static_cast<real_t>(ztf->y[ztf->index + i]);
+        }
+        output_ = static_cast<real_t>(ztf->y[ztf->index]);
+        return true;
+    }
+
+    // Copy coefficients and history into a zTransferFunction ('order' must be N)
+    bool copy_to(dsp_ztf_t* const ztf) const {
+        if (ztf == NULL || ztf->order != N) { return false; }
+        return dsp_ztf_set_coefficients(ztf, b_.data(), a_.data()) && dsp_ztf_set_initial_condition(ztf, u_.data(), y_.data());
+    }
+
+    // New zTransferFunction with the same coefficients and history (release with 'dsp_ztf_destroy()')
+    dsp_ztf_t* create_ztf() const {
+        return dsp_ztf_create_from_arrays(N, b_.data(), a_.data(), u_.data(), y_.data());
+    }
+
+    // Set the 'N+1' coefficients of numerator and denominator (NULL: 1)
+    void set_coefficients(const real_t* const num, const real_t* const den) {
+        const real_t a0 = (den == NULL ? 1 : den[0]);
+        for (std::size_t i = 0; i <= N; ++i) {
+            b_[i] = (num == NULL ? (i == 0 ? 1 : 0) : num[i]) / a0;
+            a_[i] = (den == NULL ? (i == 0 ? 1 : 0) : den[i]) / a0;
+        }
+    }
+
+    // Set the 'N' previous inputs and outputs (newest first, NULL: 0)
+    void set_initial_condition(const real_t* const initial_u, const real_t* const initial_y) {
+        for (std::size_t i = 0; i < N; ++i) {
+            u_[i] = (initial_u == NULL ? 0 : initial_u[i]);
+            y_[i] = (initial_y == NULL ? 0 : initial_y[i]);
+        }
+        output_ = newest_output();
+    }
+
+    // Clear the history
+    void reset() {
+        u_.fill(0);
+        y_.fill(0);
+        output_ = 0;
+    }
+
+    // Process one sample
+    real_t update(const real_t u) {
+        real_t y = b_[0] * u;
+        for (std::size_t i = 0; i < N; ++i) { y += b_[i + 1] * u_[i] - a_[i + 1] * y_[i]; }
+
+        // Shift the history, unrolled into register moves
+        for (std::size_t i = N; i-- > 1;) {
+            u_[i] = u_[i - 1];
+            y_[i] = y_[i - 1];
+        }
+        if (N != 0) {
+            u_[0] = u;
+            y_[0] = y;
+        }
+        output_ = y;
+        return y;
+    }
+
+    // Process 'n' samples
+    void process_block(const real_t* const in, real_t* const out, const std::size_t n) {
+        for (std::size_t k = 0; k < n; ++k) { out[k] = update(in[k]); }
+    }
+
+    // Last output, also after 'assign()', 'set_initial_condition()' and 'reset()'
+    real_t output() const { return output_; }
+
+    // Normalized coefficients (a0 = 1) and history (newest first)
+    const Coefficients& num() const { return b_; }
+    const Coefficients& den() const { return a_; }
+    const History& history_u() const { return u_; }
+    const History& history_y() const { return y_; }
+
+private:
+
+    // Without history (N = 0) there is no previous output
+    real_t newest_output() const { return (N == 0 ? 0 : y_[0]); }
+
+    Coefficients b_;
+    Coefficients a_;
+    History u_;
+    History y_;
+    real_t output_ = 0;
+};
+
+
+} // namespace dsp
+
+#endif // SJ_TRANSFER_FUNCTION_HPP
@@ -0,0 +1,131 @@
+#ifndef SJ_PID_BANK_H
+#define SJ_PID_BANK_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/pidController.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Many independent pidControllers stored as structure-of-arrays.
+ *        All controllers of the bank are updated in one vectorized pass,
+ *        the per-controller options are masks instead of branches.
+ *
+ * @note Every lane reproduces 'dsp_pid_update()' of the same controller bit for bit
+ *       (as long as the compiler doesn't contract multiplications and additions into FMAs).
+ */
+typedef struct pidBank {
+
+    // Number of controllers
+    size_t size;
+
+    // ----- Parameter (one element per controller) -----
+
+    real_t* Ts;
+    real_t* Kp;
+    real_t* Ki;
+    real_t* Kd;
+    real_t* N;
+    real_t* upper_limit;
+    real_t* lower_limit;
+    real_t* rising_slew_rate;
+    real_t* falling_slew_rate;
+    real_t* Kb;
+    real_t* Kt;
+
+    // Options as masks: all bits set if enabled, zero if disabled
+    uint32_t* limit_output;
+    uint32_t* limit_rate;
+    uint32_t* anti_windup_enabled;
+    uint32_t* tracking_enabled;
+
+    // ----- Internal -----
+
+    real_t* Xi; // Integrator States
+    real_t* Ad; // 1 - N * Ts
+    real_t* Bd; // Kd * N * Ts
+    real_t* Xd; // Derivative Filter States
+    real_t* rising_step_size; // R+ * Ts
+    real_t* falling_step_size; // R- * Ts
+    real_t* Xr; // Rate Limiter States
+
+    // PID States
+    real_t* input;
+    real_t* pidsum;
+    real_t* output;
+
+    // Internal: all arrays packed into one allocation
+    void* block;
+
+} dsp_pid_bank_t;
+
+
+
+// Create a bank of 'size' controllers with all parameters and states set to zero
+DSP_FUNCTION dsp_pid_bank_t* dsp_pid_bank_create(const size_t size);
+
+// Destroy
+DSP_FUNCTION bool dsp_pid_bank_destroy(dsp_pid_bank_t* const bank);
+
+// Copy parameters and states of a configured pidController into controller 'index' of the bank
+DSP_FUNCTION bool dsp_pid_bank_set_controller(dsp_pid_bank_t* const bank, const size_t index, const dsp_pid_t* const pid);
+
+// Copy parameters and states of controller 'index' of the bank into a pidController
+DSP_FUNCTION bool dsp_pid_bank_get_controller(const dsp_pid_bank_t* const bank, const size_t index, dsp_pid_t* const pid);
+
+// Reset the states of all controllers
+DSP_FUNCTION bool dsp_pid_bank_reset(dsp_pid_bank_t* const bank);
+
+/**
+ * @brief Calculate the new outputs of all controllers, see 'dsp_pid_get_output()'.
+ *
+ * @param bank Pointer to a pidBank struct
+ *
+ * @param u Array with the new inputs ('size' elements)
+ *
+ * @param y Array for the new outputs ('size' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_pid_bank_get_output(dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y);
+
+/**
+ * @brief Update the internal states of all controllers, see 'dsp_pid_update_state()'.
+ *
+ * @param bank Pointer to a pidBank struct
+ *
+ * @param y Array with the modified outputs used for tracking ('size' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_pid_bank_update_state(dsp_pid_bank_t* const bank, const real_t* const y);
+
+/**
+ * @brief Calculate the new outputs and update the internal states of all controllers in one pass,
+ *        see 'dsp_pid_update()'.
+ *
+ * @param bank Pointer to a pidBank struct
+ *
+ * @param u Array with the new inputs ('size' elements)
+ *
+ * @param y Array for the new outputs ('size' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_pid_bank_update(dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y);
+
+// Update only the controllers [first, first + count) ('u' and 'y' are indexed like in 'dsp_pid_bank_update()'),
+// independent ranges may run in parallel
+DSP_FUNCTION bool dsp_pid_bank_update_range(dsp_pid_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_PID_BANK_H
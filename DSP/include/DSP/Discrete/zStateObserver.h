@@ -21,13 +21,19 @@ typedef struct zStateObserver {
     dsp_matrix_t* D; // Feedthrough matrix
     dsp_matrix_t* L; // Observer gain matrix
 
-    dsp_vector_t* xh; // Estimated state vector
+    dsp_vector_t* xh; // Estimated state vector (the rounded state of 'xa' in the mixed precision build, set it with 'dsp_zso_set_state()')
 
     // Internal
     dsp_vector_t* xn; // Estimated state vector 
     dsp_vector_t* yh; // Estimated output
     dsp_vector_t* e; // Estimation error
 
+#ifdef DSP_PRECISION_MIXED
+    // Internal: estimated state and next state in double, updated in place of 'xh' and 'xn'
+    accum_t* xa;
+    accum_t* xan;
+#endif
+
 } dsp_zso_t;
 
 // Create state observer but don't initilize its internal arrrays
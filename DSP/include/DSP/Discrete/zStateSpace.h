@@ -21,11 +21,20 @@ typedef struct zStateSpace {
     dsp_matrix_t* C; // Output matrix
     dsp_matrix_t* D; // Feedthrough matrix
 
-    dsp_vector_t* x; // State vector
+    dsp_vector_t* x; // State vector (the rounded state of 'xa' in the mixed precision build, set it with 'dsp_zss_set_state()')
 
     // Internal
     dsp_vector_t* xn; // State vector
 
+#ifdef DSP_PRECISION_MIXED
+    // Internal: state and next state in double, updated in place of 'x' and 'xn'
+    accum_t* xa;
+    accum_t* xan;
+#endif
+
+    // Internal: all matrices and vectors packed into one allocation (NULL if they were allocated separately)
+    void* block;
+
 } dsp_zss_t;
 
 // Create state space but don't initilize its internal arrrays
@@ -184,6 +193,8 @@ DSP_FUNCTION bool dsp_zss_move_assign(dsp_zss_t* const dest, dsp_zss_t* const sr
 DSP_FUNCTION bool dsp_zss_swap(dsp_zss_t* const a, dsp_zss_t* const b);
 
 // Destroy
+// The internal arrays are packed into one cache-line aligned allocation:
+// state vectors first, then A, B, C and D, so an update streams through one contiguous block.
 DSP_FUNCTION bool dsp_zss_allocate_internal_arrays(dsp_zss_t* const zss, const size_t nx, const size_t nu, const size_t ny);
 DSP_FUNCTION bool dsp_zss_release_internal_arrays(dsp_zss_t* const zss);
 DSP_FUNCTION bool dsp_zss_destroy(dsp_zss_t* const zss);
@@ -0,0 +1,88 @@
+#ifndef SJ_Z_STATE_SPACE_BANK_H
+#define SJ_Z_STATE_SPACE_BANK_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/zStateSpace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Many state space models with the same dimensions but their own A, B, C, D and x ("lanes"),
+// advanced together. Every element of the matrices and states is stored for all lanes side by side,
+// so each term of x[k+1] = A * x[k] + B * u[k], y[k] = C * x[k] + D * u[k]
+// is one vectorized multiply-add across the lanes.
+typedef struct zStateSpaceBank {
+
+    size_t nx;
+    size_t nu;
+    size_t ny;
+    size_t lanes;
+
+    // Distance between two elements of one lane (lanes rounded up to a cache line)
+    size_t stride;
+
+    // Element (i,j) of the matrix of lane l: A[(i * nx + j) * stride + l], B, C, D likewise
+    real_t* A;
+    real_t* B;
+    real_t* C;
+    real_t* D;
+
+    // Element i of the state of lane l: x[i * stride + l]
+    real_t* x;
+
+    // Internal
+    real_t* xn;
+    void* block;
+
+} dsp_zss_bank_t;
+
+
+// Create a bank of 'lanes' models with all matrices and states set to zero
+DSP_FUNCTION dsp_zss_bank_t* dsp_zss_bank_create(const size_t nx, const size_t nu, const size_t ny, const size_t lanes);
+
+// Destroy
+DSP_FUNCTION bool dsp_zss_bank_destroy(dsp_zss_bank_t* const bank);
+
+// Copy matrices and state of a state space model with the same dimensions into one lane
+DSP_FUNCTION bool dsp_zss_bank_set_lane(dsp_zss_bank_t* const bank, const size_t lane, const dsp_zss_t* const zss);
+
+// Set / get the state of one lane ('nx' elements, NULL: zero)
+DSP_FUNCTION bool dsp_zss_bank_set_state(dsp_zss_bank_t* const bank, const size_t lane, const real_t* const x0);
+DSP_FUNCTION bool dsp_zss_bank_get_state(const dsp_zss_bank_t* const bank, const size_t lane, real_t* const x);
+
+/**
+ * @brief Get the outputs and update the states of all lanes
+ *
+ * @param bank Bank of state space models
+ *
+ * @param u Inputs, element j of lane l at 'u[j * lanes + l]' ('nu * lanes' elements)
+ *
+ * @param y Outputs, element i of lane l at 'y[i * lanes + l]' ('ny * lanes' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_zss_bank_update(dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y);
+
+// Update only the lanes [first, first + count), independent ranges may run in parallel
+DSP_FUNCTION bool dsp_zss_bank_update_range(dsp_zss_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y);
+
+/**
+ * @brief Update all lanes, split into contiguous ranges on 'threads' threads
+ *
+ * @note The threads are started and joined in every call, so this only pays off for large banks.
+ *       Without thread support in the build (CMake option 'DSP_THREADS') all lanes are updated by the caller.
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_zss_bank_update_parallel(dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y, const size_t threads);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_Z_STATE_SPACE_BANK_H
@@ -2,6 +2,7 @@
 #define SJ_ZTF_H
 
 #include "DSP/dsp_types.h" // real_t
+#include "DSP/Discrete/Signal.h" // dsp_signal_t
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,8 +16,14 @@ typedef struct zTransferFunction {
     size_t order;
     real_t* a;
     real_t* b;
+
+    // History of inputs and outputs as mirrored ring buffers of size '2 * (order+1)'.
+    // Every value is stored at 'i' and 'i + order+1', so the window
+    // u[index], u[index+1], ..., u[index+order] (newest to oldest) is always contiguous.
+    // The outputs are kept unrounded in accum_t (double in the mixed precision build).
     real_t* u;
-    real_t* y;
+    accum_t* y;
+    size_t index;
 
 } dsp_ztf_t;
 
@@ -236,6 +243,62 @@ DSP_FUNCTION bool dsp_ztf_reset(dsp_ztf_t* const ztf);
  */
 DSP_FUNCTION real_t dsp_ztf_update(dsp_ztf_t* const ztf, const real_t new_u);
 
+/**
+ * @brief Check if the numerator has a non-zero leading coefficient b[0]
+ *
+ * @param ztf A Z-Transfer-Function system
+ *
+ * @return Returns 'true' if the new input acts on the new output, 'false' for strictly proper systems
+ */
+DSP_FUNCTION bool dsp_ztf_has_feedthrough(const dsp_ztf_t* const ztf);
+
+/**
+ * @brief Calculate the output of the next update from the history alone
+ *
+ * @details Only meaningful without feedthrough: the result equals the return value of the
+ *          next 'dsp_ztf_update()', whatever its input. The state of the system is not advanced.
+ *
+ * @param ztf A Z-Transfer-Function system
+ *
+ * @return Returns the next system output
+ */
+DSP_FUNCTION real_t dsp_ztf_next_output(dsp_ztf_t* const ztf);
+
+/**
+ * @brief Calculate the outputs of the system for a whole frame of inputs
+ * 
+ * @details Produces exactly the same outputs and final state as calling 
+ *          'dsp_ztf_update()' once for every sample of the frame.
+ *          Once the first 'order' samples are processed, the history is read 
+ *          directly from the frame instead of being kept in the internal arrays
+ *          (below DSP_SIMD_MIN_SIZE coefficients, higher orders use the vector kernels per sample).
+ * 
+ * @param ztf A Z-Transfer-Function system
+ * 
+ * @param in Array with 'n' new system inputs
+ * 
+ * @param out Array for the 'n' new system outputs
+ *            May be the same array as 'in', but musst not overlap it otherwise
+ * 
+ * @param n Number of samples in the frame
+ * 
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_ztf_process_block(dsp_ztf_t* const ztf, const real_t* const in, real_t* const out, const size_t n);
+
+/**
+ * @brief Calculate the outputs of the system for a whole signal
+ * 
+ * @param ztf A Z-Transfer-Function system
+ * 
+ * @param in Signal with the new system inputs
+ * 
+ * @param out Signal for the new system outputs (resized to the size of 'in')
+ * 
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_ztf_process_signal(dsp_ztf_t* const ztf, const dsp_signal_t* const in, dsp_signal_t* const out);
+
 /**
  * @brief Get the latest output of the system
  * 
@@ -0,0 +1,114 @@
+#ifndef SJ_ZTF_BANK_H
+#define SJ_ZTF_BANK_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h" // real_t
+#include "DSP/Discrete/zTransferFunction.h" // dsp_ztf_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Many zTransferFunctions of the same order, one per channel, updated together.
+// Every row of the histories (and of per-channel coefficients) holds one value of every channel,
+// so each term of the difference equation is one vectorized multiply-add across all channels.
+typedef struct zTransferFunctionBank {
+
+    size_t order;
+    size_t channels;
+
+    // Distance between two rows (channels rounded up to a cache line)
+    size_t stride;
+
+    // One set of coefficients for all channels (otherwise one per channel)
+    bool shared;
+
+    // Normalized coefficients b[i] / a[0] and -a[i] / a[0] ('order+1' values or rows, a[0] is unused)
+    real_t* b;
+    real_t* a;
+
+    // Histories of inputs and outputs, 'order+1' rows.
+    // Row '(index + j) % (order+1)' holds the values of all channels 'j' samples ago.
+    real_t* u;
+    real_t* y;
+    size_t index;
+
+    // Internal: struct and arrays packed into one allocation
+    void* block;
+
+} dsp_ztf_bank_t;
+
+
+/**
+ * @brief Create a bank of 'channels' transfer functions of the same order
+ *
+ * @note The coefficients are set to G(z) = 1 and the histories are cleared.
+ *
+ * @param order Order of every transfer function
+ *
+ * @param channels Number of channels
+ *
+ * @param shared 'true': all channels share one set of coefficients,
+ *        'false': every channel has its own
+ *
+ * @return Pointer to the new bank (NULL if memory allocation failed)
+ */
+DSP_FUNCTION dsp_ztf_bank_t* dsp_ztf_bank_create(const size_t order, const size_t channels, const bool shared);
+
+// Bank of first order lowpass filters with shared coefficients (see 'dsp_ztf_create_lowpass_filter()')
+DSP_FUNCTION dsp_ztf_bank_t* dsp_ztf_bank_create_lowpass_filter(const size_t channels, const real_t K, const real_t T, const real_t Ts);
+
+// Destroy
+DSP_FUNCTION bool dsp_ztf_bank_destroy(dsp_ztf_bank_t* const bank);
+
+// Set the coefficients of all channels ('order+1' elements each, NULL: 1)
+DSP_FUNCTION bool dsp_ztf_bank_set_coefficients(dsp_ztf_bank_t* const bank, const real_t* const num, const real_t* const den);
+
+// Set the coefficients of one channel (only if the coefficients are not shared)
+DSP_FUNCTION bool dsp_ztf_bank_set_channel_coefficients(dsp_ztf_bank_t* const bank, const size_t channel, const real_t* const num, const real_t* const den);
+
+// Set the 'order' previous inputs and outputs (newest first, NULL: 0) of one channel
+DSP_FUNCTION bool dsp_ztf_bank_set_channel_initial_condition(dsp_ztf_bank_t* const bank, const size_t channel, const real_t* const initial_u, const real_t* const initial_y);
+
+/**
+ * @brief Copy a zTransferFunction of the same order into one channel
+ *
+ * @note The history is always copied, the coefficients only if they are not shared.
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or the orders differ
+ */
+DSP_FUNCTION bool dsp_ztf_bank_set_channel(dsp_ztf_bank_t* const bank, const size_t channel, const dsp_ztf_t* const ztf);
+
+// Clear the histories of all channels
+DSP_FUNCTION bool dsp_ztf_bank_reset(dsp_ztf_bank_t* const bank);
+
+/**
+ * @brief Process one sample of every channel
+ *
+ * @param bank Bank of transfer functions
+ *
+ * @param u Array with the new inputs ('channels' elements)
+ *
+ * @param y Array for the new outputs ('channels' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_ztf_bank_update(dsp_ztf_bank_t* const bank, const real_t* const u, real_t* const y);
+
+// Split update for parallel execution: advance all histories once with 'dsp_ztf_bank_next_sample()',
+// then process the channels [first, first + count) ('u' and 'y' are indexed like in 'dsp_ztf_bank_update()').
+// Independent ranges of the same sample may run in parallel.
+DSP_FUNCTION bool dsp_ztf_bank_next_sample(dsp_ztf_bank_t* const bank);
+DSP_FUNCTION bool dsp_ztf_bank_update_range(dsp_ztf_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y);
+
+// Process 'n' samples of every channel, 'in' and 'out' hold 'n' rows of 'channels' values
+DSP_FUNCTION bool dsp_ztf_bank_process_block(dsp_ztf_bank_t* const bank, const real_t* const in, real_t* const out, const size_t n);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_ZTF_BANK_H
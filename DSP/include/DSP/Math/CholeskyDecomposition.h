@@ -0,0 +1,67 @@
+#ifndef SJ_CHOLESKY_DECOMPOSITION_H
+#define SJ_CHOLESKY_DECOMPOSITION_H
+
+#include "DSP/dsp_types.h"
+#include "DSP/Math/Matrix.h"
+#include "DSP/Memory/Workspace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Cholesky decomposition of a symmetric positive definite matrix: A = L * L^T
+// About half the work of an LU decomposition and no pivoting needed.
+// All memory is taken from a caller-provided workspace, nothing is allocated on the heap.
+typedef struct MatrixCholesky {
+
+    size_t size;
+
+    // L in the lower triangle of a row-major 'size x size' array (upper triangle unused)
+    real_t* elements;
+
+    // A is not (numerically) positive definite
+    bool indefinite;
+
+} dsp_matrix_chol_t;
+
+
+// Bytes of workspace taken by 'dsp_matrix_chol_init()' for 'size x size' matrices
+DSP_FUNCTION size_t dsp_matrix_chol_workspace_size(const size_t size);
+
+/**
+ * @brief Prepare a decomposition for 'size x size' matrices
+ *
+ * @param chol Decomposition
+ *
+ * @param ws Workspace with at least 'dsp_matrix_chol_workspace_size(size)' free bytes,
+ *        the block is used by 'chol' until it is released
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'ws' is exhausted
+ */
+DSP_FUNCTION bool dsp_matrix_chol_init(dsp_matrix_chol_t* const chol, const size_t size, dsp_workspace_t* const ws);
+
+/**
+ * @brief Factor a symmetric positive definite matrix
+ *
+ * @param chol Decomposition of the same size as 'mat'
+ *
+ * @param mat Symmetric matrix, only the lower triangle is read (not modified)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'mat' is not positive definite
+ */
+DSP_FUNCTION bool dsp_matrix_chol_factor(dsp_matrix_chol_t* const chol, const dsp_matrix_t* const mat);
+
+// Solve A * x = b with the factored matrix A (x may be the same array as b)
+DSP_FUNCTION bool dsp_matrix_chol_solve(const dsp_matrix_chol_t* const chol, real_t* const x, const real_t* const b);
+
+// Determinant of the factored matrix (0 if not positive definite)
+DSP_FUNCTION real_t dsp_matrix_chol_det(const dsp_matrix_chol_t* const chol);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_CHOLESKY_DECOMPOSITION_H
@@ -0,0 +1,97 @@
+#ifndef SJ_FFT_H
+#define SJ_FFT_H
+
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Shortest sequence for which 'dsp_conv()' switches from the direct sum to FFT convolution
+#ifndef DSP_FFT_CONV_MIN_SIZE
+#define DSP_FFT_CONV_MIN_SIZE 128
+#endif
+
+
+// Radix-2 FFT of a real sequence of 'size' samples (power of 2, at least 4)
+// Spectra are stored as 'size/2 + 1' interleaved complex bins: re[0], im[0], re[1], im[1], ...
+typedef struct FftPlan {
+    size_t size;
+    real_t* twiddles; // exp(-2*pi*i * k / size) for k = 0, 1, ..., size/2 - 1 (interleaved)
+    size_t* bitrev;   // Bit reversal permutation of the internal 'size/2' point complex FFT
+} dsp_fft_plan_t;
+
+
+// Smallest power of 2 that is not smaller than 'n'
+DSP_FUNCTION size_t dsp_fft_size(const size_t n);
+
+// Create a plan for real sequences of 'size' samples (power of 2, at least 4)
+DSP_FUNCTION dsp_fft_plan_t* dsp_fft_plan_create(const size_t size);
+
+// Destroy a plan created with 'dsp_fft_plan_create()'
+DSP_FUNCTION bool dsp_fft_plan_destroy(dsp_fft_plan_t* const plan);
+
+/**
+ * @brief Get the shared plan for real sequences of 'size' samples
+ *
+ * @details Plans are created on first use and kept in a cache (one per power of 2).
+ *          Safe to call from several threads.
+ *          The plans are owned by the library and must not be destroyed by the caller.
+ *
+ * @param size Number of samples (power of 2, at least 4)
+ *
+ * @return Pointer to the plan or NULL if 'size' is invalid or memory allocation failed
+ */
+DSP_FUNCTION const dsp_fft_plan_t* dsp_fft_plan_cached(const size_t size);
+
+// Release all cached plans (not thread-safe, no cached plan may be in use)
+DSP_FUNCTION void dsp_fft_release_cached_plans();
+
+/**
+ * @brief Forward FFT of a real sequence
+ *
+ * @param plan Plan of size N
+ *
+ * @param x Array with N samples
+ *
+ * @param X Array for N+2 values (N/2 + 1 complex bins), may be the same array as 'x'
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_fft_real_forward(const dsp_fft_plan_t* const plan, const real_t* const x, real_t* const X);
+
+/**
+ * @brief Inverse FFT of the spectrum of a real sequence (scaled by 1/N)
+ *
+ * @param plan Plan of size N
+ *
+ * @param X Array with N+2 values (N/2 + 1 complex bins)
+ *
+ * @param x Array for N samples, may be the same array as 'X'
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_fft_real_inverse(const dsp_fft_plan_t* const plan, const real_t* const X, real_t* const x);
+
+/**
+ * @brief Convolution by FFT (overlap-add)
+ *
+ * @details Same result as 'dsp_conv()' within float tolerance,
+ *          in O((u_size + v_size) * log(v_size)) instead of O(u_size * v_size).
+ *
+ * @return Size of the convolution (u_size + v_size - 1) or 0 if parameters are invalid or memory allocation failed
+ */
+DSP_FUNCTION size_t dsp_fft_conv(
+    const real_t* const u, const size_t u_size,
+    const real_t* const v, const size_t v_size,
+    real_t* const w, const size_t w_size
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_FFT_H
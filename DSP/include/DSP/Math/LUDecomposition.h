@@ -0,0 +1,104 @@
+#ifndef SJ_LU_DECOMPOSITION_H
+#define SJ_LU_DECOMPOSITION_H
+
+#include "DSP/dsp_types.h"
+#include "DSP/Math/Matrix.h"
+#include "DSP/Math/Vector.h"
+#include "DSP/Memory/Workspace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// LU decomposition with partial pivoting: P * A = L * U
+// Factor once in O(n^3), then solve every right-hand side in O(n^2).
+typedef struct MatrixLU {
+
+    size_t size;
+
+    // L (unit lower triangle, diagonal not stored) and U (upper triangle) in one row-major array
+    real_t* elements;
+
+    // Row k was swapped with row pivots[k] during step k of the elimination
+    size_t* pivots;
+
+    // +1 or -1 for an even or odd number of row swaps
+    real_t sign;
+
+    // A zero pivot was found, the matrix can't be inverted
+    bool singular;
+
+} dsp_matrix_lu_t;
+
+
+// Create a decomposition for 'size x size' matrices but don't factor anything yet
+DSP_FUNCTION dsp_matrix_lu_t* dsp_matrix_lu_create(const size_t size);
+
+// Create the decomposition of a square matrix (NULL if 'mat' is not square or memory allocation failed)
+DSP_FUNCTION dsp_matrix_lu_t* dsp_matrix_lu_create_from_matrix(const dsp_matrix_t* const mat);
+
+// Destroy
+DSP_FUNCTION bool dsp_matrix_lu_destroy(dsp_matrix_lu_t* const lu);
+
+// Bytes of workspace taken by 'dsp_matrix_lu_init()' for 'size x size' matrices
+DSP_FUNCTION size_t dsp_matrix_lu_workspace_size(const size_t size);
+
+/**
+ * @brief Prepare a decomposition for 'size x size' matrices in a workspace (no heap allocation)
+ *
+ * @param lu Decomposition, must not be destroyed with 'dsp_matrix_lu_destroy()'
+ *
+ * @param ws Workspace with at least 'dsp_matrix_lu_workspace_size(size)' free bytes,
+ *        the blocks are used by 'lu' until they are released
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'ws' is exhausted
+ */
+DSP_FUNCTION bool dsp_matrix_lu_init(dsp_matrix_lu_t* const lu, const size_t size, dsp_workspace_t* const ws);
+
+/**
+ * @brief Factor a square matrix
+ *
+ * @param lu Decomposition of the same size as 'mat'
+ *
+ * @param mat Square matrix (not modified)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'mat' is singular
+ */
+DSP_FUNCTION bool dsp_matrix_lu_factor(dsp_matrix_lu_t* const lu, const dsp_matrix_t* const mat);
+
+// Check if the factored matrix is singular
+DSP_FUNCTION bool dsp_matrix_lu_is_singular(const dsp_matrix_lu_t* const lu);
+
+// Determinant of the factored matrix (0 if singular)
+DSP_FUNCTION real_t dsp_matrix_lu_det(const dsp_matrix_lu_t* const lu);
+
+/**
+ * @brief Solve A * x = b with the factored matrix A
+ *
+ * @param lu Decomposition of A
+ *
+ * @param x Array for the solution ('size' elements), may be the same array as 'b'
+ *
+ * @param b Array with the right-hand side ('size' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or A is singular
+ */
+DSP_FUNCTION bool dsp_matrix_lu_solve(const dsp_matrix_lu_t* const lu, real_t* const x, const real_t* const b);
+
+// Solve A * x = b (x may be the same vector as b)
+DSP_FUNCTION bool dsp_matrix_lu_solve_vector(const dsp_matrix_lu_t* const lu, dsp_vector_t* const x, const dsp_vector_t* const b);
+
+// Solve A * X = B for all columns of B at once (X may be the same matrix as B)
+DSP_FUNCTION bool dsp_matrix_lu_solve_matrix(const dsp_matrix_lu_t* const lu, dsp_matrix_t* const X, const dsp_matrix_t* const B);
+
+// Inverse of the factored matrix
+DSP_FUNCTION bool dsp_matrix_lu_inv(const dsp_matrix_lu_t* const lu, dsp_matrix_t* const result);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_LU_DECOMPOSITION_H
@@ -2,6 +2,7 @@
 #define SJ_MATRIX_H
 
 #include "DSP/dsp_types.h"
+#include "DSP/Memory/Workspace.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,6 +76,11 @@ DSP_FUNCTION bool dsp_matrix_subtract(dsp_matrix_t* result, const dsp_matrix_t*
 DSP_FUNCTION bool dsp_matrix_subtract_and_assign(dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2);
 DSP_FUNCTION bool dsp_matrix_multiply(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2);
 
+// Fused products (no temporary transposes)
+DSP_FUNCTION bool dsp_matrix_multiply_and_add(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2); // result += mat1 * mat2
+DSP_FUNCTION bool dsp_matrix_transpose_multiply(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2); // result = mat1^T * mat2
+DSP_FUNCTION bool dsp_matrix_multiply_transpose(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2); // result = mat1 * mat2^T
+
 // Arithmetic
 DSP_FUNCTION bool dsp_matrix_multiply_by_scalar(dsp_matrix_t* result, const dsp_matrix_t* const mat, const real_t scalar);
 DSP_FUNCTION bool dsp_matrix_multiply_by_scalar_and_assign(dsp_matrix_t* mat, const real_t scalar);
@@ -91,6 +97,19 @@ DSP_FUNCTION bool dsp_matrix_transpose(dsp_matrix_t* const result, const dsp_mat
 DSP_FUNCTION bool dsp_matrix_inv(dsp_matrix_t* const result, const dsp_matrix_t* const mat);
 DSP_FUNCTION bool dsp_matrix_pinv(dsp_matrix_t* const result, const dsp_matrix_t* const mat);
 
+// Workspace variants: no heap allocation, everything is taken from 'ws' and released before returning
+// (except the results of the '..._in_workspace()' functions, which must not be destroyed)
+DSP_FUNCTION size_t dsp_matrix_workspace_size(const size_t rows, const size_t columns);
+DSP_FUNCTION dsp_matrix_t* dsp_matrix_create_in_workspace(const size_t rows, const size_t columns, dsp_workspace_t* const ws);
+DSP_FUNCTION size_t dsp_matrix_det_workspace_size(const size_t size);
+DSP_FUNCTION real_t dsp_matrix_det_with_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws);
+DSP_FUNCTION size_t dsp_matrix_inv_workspace_size(const size_t size);
+DSP_FUNCTION bool dsp_matrix_inv_with_workspace(dsp_matrix_t* const result, const dsp_matrix_t* const mat, dsp_workspace_t* const ws);
+DSP_FUNCTION dsp_matrix_t* dsp_matrix_create_inv_in_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws);
+DSP_FUNCTION size_t dsp_matrix_pinv_workspace_size(const size_t rows, const size_t columns);
+DSP_FUNCTION bool dsp_matrix_pinv_with_workspace(dsp_matrix_t* const result, const dsp_matrix_t* const mat, dsp_workspace_t* const ws);
+DSP_FUNCTION dsp_matrix_t* dsp_matrix_create_pinv_in_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws);
+
 // Concat
 DSP_FUNCTION bool dsp_matrix_horzcat(dsp_matrix_t* const result, const dsp_matrix_t* const L, const dsp_matrix_t* const R);
 DSP_FUNCTION bool dsp_matrix_vertcat(dsp_matrix_t* const result, const dsp_matrix_t* const T, const dsp_matrix_t* const B);
@@ -2,6 +2,7 @@
 #define SJ_POLYNOMIAL_H
 
 #include "DSP/dsp_types.h"
+#include "DSP/Memory/Workspace.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -66,6 +67,20 @@ DSP_FUNCTION bool dsp_polynomial_divide(dsp_poly_t* const q, dsp_poly_t* const r
 DSP_FUNCTION bool dsp_polynomial_fit(dsp_poly_t* const p, const real_t* const x, const real_t* const y, const size_t size);
 DSP_FUNCTION bool dsp_polyfit(real_t* const p, const size_t order, const real_t* const x, const real_t* const y, const size_t size);
 
+// Bytes of workspace for fitting 'size' points with a polynomial of order 'order'
+DSP_FUNCTION size_t dsp_polyfit_workspace_size(const size_t order, const size_t size);
+
+/**
+ * @brief Least squares fit by Householder QR without heap allocation
+ *
+ * @param p Array for the 'order + 1' coefficients (p[k] belongs to x^k)
+ *
+ * @param ws Workspace with at least 'dsp_polyfit_workspace_size(order, size)' free bytes
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or the points don't determine the polynomial
+ */
+DSP_FUNCTION bool dsp_polyfit_with_workspace(real_t* const p, const size_t order, const real_t* const x, const real_t* const y, const size_t size, dsp_workspace_t* const ws);
+
 // Evaluate
 DSP_FUNCTION real_t dsp_polynomial_val(const dsp_poly_t* const p, const real_t x);
 DSP_FUNCTION real_t dsp_polyval(const real_t* const p, const size_t order, const real_t x);
@@ -0,0 +1,92 @@
+#ifndef SJ_QR_DECOMPOSITION_H
+#define SJ_QR_DECOMPOSITION_H
+
+#include "DSP/dsp_types.h"
+#include "DSP/Math/Matrix.h"
+#include "DSP/Memory/Workspace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Householder QR decomposition for least squares problems
+// Overdetermined A (rows >= columns) is factored as A = Q * R,
+// underdetermined A (rows < columns) as A^T = Q * R (minimum norm solutions).
+// All memory is taken from a caller-provided workspace, nothing is allocated on the heap.
+typedef struct MatrixQR {
+
+    size_t rows;
+    size_t columns;
+
+    // Householder vectors below and R on/above the diagonal of the factored matrix,
+    // stored column by column: 'min(rows, columns)' rows of 'max(rows, columns)' elements
+    real_t* elements;
+
+    // Scaling factors of the Householder reflections (min(rows, columns) elements)
+    real_t* tau;
+
+    // Scratch array for solving (max(rows, columns) elements)
+    real_t* temp;
+
+    // R has a (numerically) zero diagonal element, A doesn't have full rank
+    bool rank_deficient;
+
+} dsp_matrix_qr_t;
+
+
+// Bytes of workspace taken by 'dsp_matrix_qr_init()' for 'rows x columns' matrices
+DSP_FUNCTION size_t dsp_matrix_qr_workspace_size(const size_t rows, const size_t columns);
+
+/**
+ * @brief Prepare a decomposition for 'rows x columns' matrices
+ *
+ * @param qr Decomposition
+ *
+ * @param ws Workspace with at least 'dsp_matrix_qr_workspace_size(rows, columns)' free bytes,
+ *        the blocks are used by 'qr' until they are released
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'ws' is exhausted
+ */
+DSP_FUNCTION bool dsp_matrix_qr_init(dsp_matrix_qr_t* const qr, const size_t rows, const size_t columns, dsp_workspace_t* const ws);
+
+/**
+ * @brief Factor a matrix
+ *
+ * @param qr Decomposition of the same size as 'mat'
+ *
+ * @param mat Matrix (not modified)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or 'mat' doesn't have full rank
+ */
+DSP_FUNCTION bool dsp_matrix_qr_factor(dsp_matrix_qr_t* const qr, const dsp_matrix_t* const mat);
+
+// Check if the factored matrix doesn't have full rank
+DSP_FUNCTION bool dsp_matrix_qr_is_rank_deficient(const dsp_matrix_qr_t* const qr);
+
+/**
+ * @brief Solve A * x = b in the least squares sense with the factored matrix A
+ *
+ * @details Overdetermined: x minimizes |A * x - b|
+ *          Underdetermined: x is the solution of A * x = b with the smallest |x|
+ *
+ * @param qr Decomposition of A
+ *
+ * @param x Array for the solution ('columns' elements)
+ *
+ * @param b Array with the right-hand side ('rows' elements)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid or A doesn't have full rank
+ */
+DSP_FUNCTION bool dsp_matrix_qr_solve(dsp_matrix_qr_t* const qr, real_t* const x, const real_t* const b);
+
+// Pseudo inverse of the factored matrix ('columns x rows')
+DSP_FUNCTION bool dsp_matrix_qr_pinv(dsp_matrix_qr_t* const qr, dsp_matrix_t* const result);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_QR_DECOMPOSITION_H
@@ -0,0 +1,76 @@
+#ifndef SJ_SIMD_H
+#define SJ_SIMD_H
+
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Vectorized kernels behind dot products, convolutions and filters.
+// The instruction set is chosen at runtime from the features of the CPU,
+// unless the library was configured with a fixed one (CMake option 'DSP_SIMD').
+
+
+/**
+ * @brief Check if the kernels of an instruction set are compiled in and supported by this CPU
+ *
+ * @param isa Instruction set
+ *
+ * @return 'true' if the kernels of 'isa' can be used
+ */
+DSP_FUNCTION bool dsp_simd_is_supported(const dsp_simd_isa_t isa);
+
+/**
+ * @brief Select the kernels used by all following calls
+ *
+ * @note Calls running on other threads at the same time may still use the previous kernels,
+ *       select the kernels once at startup. 'SimdScalar' is always available as reference.
+ *
+ * @param isa Instruction set
+ *
+ * @return 'true' if successfull and 'false' if 'isa' is not supported or excluded by the build
+ */
+DSP_FUNCTION bool dsp_simd_select(const dsp_simd_isa_t isa);
+
+// Instruction set of the kernels in use
+DSP_FUNCTION dsp_simd_isa_t dsp_simd_selected();
+
+// Name of an instruction set ("Scalar", "SSE", "AVX2", "AVX512", "NEON")
+DSP_FUNCTION const char* dsp_simd_isa_name(const dsp_simd_isa_t isa);
+
+
+// Shorter dot products use the scalar kernel, the dispatch and the vector setup cost more than they save
+#define DSP_SIMD_MIN_SIZE 16
+
+// Returns the scalar dot product of u and v
+DSP_FUNCTION real_t dsp_simd_dot_product(const real_t* const u, const real_t* const v, const size_t size);
+
+// y = y + a * x
+DSP_FUNCTION void dsp_simd_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size);
+
+// y = y + a .* x (element-wise)
+DSP_FUNCTION void dsp_simd_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size);
+
+/**
+ * @brief Cache-blocked matrix product C = C + A * B
+ *
+ * @details The element (i,p) of A is 'a[i * a_row_stride + p * a_column_stride]',
+ *          so A can be read row-major (a_row_stride = k, a_column_stride = 1) 
+ *          or transposed (a_row_stride = 1, a_column_stride = m) without copying.
+ *          B (k x n) and C (m x n) are row-major with the row strides 'ldb' and 'ldc'.
+ */
+DSP_FUNCTION void dsp_simd_gemm(const size_t m, const size_t n, const size_t k,
+    const real_t* const a, const size_t a_row_stride, const size_t a_column_stride,
+    const real_t* const b, const size_t ldb,
+    real_t* const c, const size_t ldc
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_SIMD_H
@@ -146,6 +146,15 @@ DSP_FUNCTION bool dsp_matrix_subract_of_column_vector(dsp_matrix_t* const mat, c
 DSP_FUNCTION bool dsp_vector_solve_lse(dsp_vector_t* const x, const dsp_matrix_t* const A, const dsp_vector_t* const b);
 DSP_FUNCTION bool dsp_solve(real_t* const x, const size_t x_size, const real_t* const A, const real_t* const b, const size_t b_size);
 
+// Workspace variants: no heap allocation, everything is taken from 'ws' and released before returning
+// (except the results of the '..._in_workspace()' functions, which must not be destroyed)
+DSP_FUNCTION size_t dsp_vector_workspace_size(const size_t size);
+DSP_FUNCTION dsp_vector_t* dsp_vector_create_in_workspace(const size_t size, dsp_workspace_t* const ws);
+DSP_FUNCTION size_t dsp_vector_solve_lse_workspace_size(const size_t rows, const size_t columns);
+DSP_FUNCTION bool dsp_vector_solve_lse_with_workspace(dsp_vector_t* const x, const dsp_matrix_t* const A, const dsp_vector_t* const b, dsp_workspace_t* const ws);
+DSP_FUNCTION bool dsp_solve_with_workspace(real_t* const x, const size_t x_size, const real_t* const A, const real_t* const b, const size_t b_size, dsp_workspace_t* const ws);
+DSP_FUNCTION dsp_vector_t* dsp_vector_create_solution_in_workspace(const dsp_matrix_t* const A, const dsp_vector_t* const b, dsp_workspace_t* const ws);
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,119 @@
+#ifndef SJ_ALLOCATOR_H
+#define SJ_ALLOCATOR_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Alignment of every block handed out by the library allocators (bytes)
+#define DSP_ALLOCATOR_ALIGNMENT 16
+
+
+// Memory backend of 'dsp_malloc()', 'dsp_realloc()' and 'dsp_free()'.
+// Every block remembers the allocator it came from,
+// so objects can be destroyed after another allocator has been selected.
+typedef struct Allocator {
+
+    // Returns a block of 'size' bytes aligned to DSP_ALLOCATOR_ALIGNMENT or NULL
+    void* (*alloc)(void* const context, const size_t size);
+
+    // Resize a block (optional, NULL: alloc, copy and free)
+    void* (*realloc)(void* const context, void* const ptr, const size_t size);
+
+    // Give a block back (optional, NULL: the memory is released all at once by the owner)
+    void (*free)(void* const context, void* const ptr);
+
+    // Passed to the callbacks
+    void* context;
+
+} dsp_allocator_t;
+
+
+// malloc(), realloc() and free() of the C library
+DSP_FUNCTION const dsp_allocator_t* dsp_allocator_default();
+
+/**
+ * @brief Select the allocator for all following allocations of the calling thread
+ *
+ * @details Typical use: build a whole controller graph into an arena at startup
+ *
+ *              const dsp_allocator_t* const previous = dsp_allocator_select(dsp_arena_allocator(arena));
+ *              ... dsp_zss_create(...), dsp_pid_create(...), ...
+ *              dsp_allocator_select(previous);
+ *
+ * @param allocator Allocator, must outlive every block allocated with it (NULL selects the default allocator)
+ *
+ * @return The previously selected allocator
+ */
+DSP_FUNCTION const dsp_allocator_t* dsp_allocator_select(const dsp_allocator_t* const allocator);
+
+// Allocator selected for the calling thread
+DSP_FUNCTION const dsp_allocator_t* dsp_allocator_selected();
+
+
+
+// Bump arena: allocation is a pointer increment, blocks are never given back individually.
+// Objects in an arena are destroyed as usual (their memory stays in use until the arena is reset or destroyed).
+// Not thread-safe.
+typedef struct Arena {
+    dsp_allocator_t allocator;
+    unsigned char* memory;
+    size_t size; // Usable bytes
+    size_t used; // Bytes in use
+} dsp_arena_t;
+
+// Create an arena of 'size' bytes (one heap allocation)
+DSP_FUNCTION dsp_arena_t* dsp_arena_create(const size_t size);
+
+// Use caller-owned memory (e.g. a static array) as arena
+DSP_FUNCTION bool dsp_arena_init(dsp_arena_t* const arena, void* const memory, const size_t size);
+
+// Destroy an arena created with 'dsp_arena_create()' (all objects in it must no longer be used)
+DSP_FUNCTION bool dsp_arena_destroy(dsp_arena_t* const arena);
+
+// Give back all blocks (all objects in the arena must no longer be used)
+DSP_FUNCTION bool dsp_arena_reset(dsp_arena_t* const arena);
+
+// Allocator backed by the arena
+DSP_FUNCTION const dsp_allocator_t* dsp_arena_allocator(dsp_arena_t* const arena);
+
+
+
+// Fixed-size pool: blocks of one size on a free list, allocation and release in O(1).
+// Requests larger than the block size fail. Not thread-safe.
+// 'block_size' is the largest 'dsp_malloc()' request served, the bookkeeping of every block is added internally.
+typedef struct Pool {
+    dsp_allocator_t allocator;
+    unsigned char* memory;
+    size_t block_size; // Bytes per block, including the bookkeeping (multiple of DSP_ALLOCATOR_ALIGNMENT)
+    size_t blocks;     // Number of blocks
+    size_t available;  // Number of free blocks
+    void* free_list;
+} dsp_pool_t;
+
+// Bytes of memory needed for a pool of 'blocks' blocks that can hold 'block_size' bytes each
+DSP_FUNCTION size_t dsp_pool_memory_size(const size_t block_size, const size_t blocks);
+
+// Create a pool (one heap allocation)
+DSP_FUNCTION dsp_pool_t* dsp_pool_create(const size_t block_size, const size_t blocks);
+
+// Use caller-owned memory of at least 'dsp_pool_memory_size(block_size, blocks)' bytes as pool
+DSP_FUNCTION bool dsp_pool_init(dsp_pool_t* const pool, void* const memory, const size_t block_size, const size_t blocks);
+
+// Destroy a pool created with 'dsp_pool_create()' (all objects in it must no longer be used)
+DSP_FUNCTION bool dsp_pool_destroy(dsp_pool_t* const pool);
+
+// Allocator backed by the pool
+DSP_FUNCTION const dsp_allocator_t* dsp_pool_allocator(dsp_pool_t* const pool);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_ALLOCATOR_H
@@ -0,0 +1,40 @@
+#ifndef SJ_MEMORY_H
+#define SJ_MEMORY_H
+
+#include <stddef.h> // size_t, NULL
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Every allocation of the library goes through these functions.
+// They use the allocator selected with 'dsp_allocator_select()' (see Allocator.h), the C heap by default.
+// With the CMake option 'DSP_COUNT_ALLOCATIONS' the heap allocations of the calling thread are counted,
+// so tests can assert that a call doesn't touch the heap.
+
+
+// Same as malloc(), from the selected allocator
+DSP_FUNCTION void* dsp_malloc(const size_t size);
+
+// Same as realloc(), from the allocator 'ptr' came from
+DSP_FUNCTION void* dsp_realloc(void* const ptr, const size_t size);
+
+// Same as free(), to the allocator 'ptr' came from
+DSP_FUNCTION void dsp_free(void* const ptr);
+
+
+// Check if the library was built with allocation counting
+DSP_FUNCTION bool dsp_memory_counting_enabled();
+
+// Number of heap allocations (malloc/realloc of the default allocator) on the calling thread (0 without counting)
+DSP_FUNCTION size_t dsp_memory_allocation_count();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_MEMORY_H
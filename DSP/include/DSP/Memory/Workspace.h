@@ -0,0 +1,70 @@
+#ifndef SJ_WORKSPACE_H
+#define SJ_WORKSPACE_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Alignment of every block taken from a workspace (bytes)
+#define DSP_WORKSPACE_ALIGNMENT 64
+
+
+// Scratch memory for the '..._with_workspace()' functions.
+// Blocks are taken from the front and given back in LIFO order (mark/release),
+// so a workspace sized once with the '..._workspace_size()' queries
+// can be reused for every call without touching the heap.
+typedef struct Workspace {
+    unsigned char* memory; // Aligned to DSP_WORKSPACE_ALIGNMENT
+    size_t size;           // Usable bytes
+    size_t used;           // Bytes in use
+    size_t peak;           // Largest 'used' so far
+} dsp_workspace_t;
+
+
+// Bytes taken from a workspace for a block of 'size' bytes (rounded up to the alignment)
+DSP_FUNCTION size_t dsp_workspace_block_size(const size_t size);
+
+// Create a workspace of 'size' usable bytes (one heap allocation)
+DSP_FUNCTION dsp_workspace_t* dsp_workspace_create(const size_t size);
+
+// Destroy a workspace created with 'dsp_workspace_create()'
+DSP_FUNCTION bool dsp_workspace_destroy(dsp_workspace_t* const ws);
+
+/**
+ * @brief Use caller-owned memory as workspace (e.g. a static array)
+ *
+ * @note Up to DSP_WORKSPACE_ALIGNMENT - 1 bytes at the start are skipped if 'memory' is not aligned.
+ *
+ * @param ws Workspace
+ *
+ * @param memory Array of 'size' bytes, owned by the caller
+ *
+ * @param size Size of 'memory' in bytes
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_workspace_init(dsp_workspace_t* const ws, void* const memory, const size_t size);
+
+// Take an aligned block of 'size' bytes (NULL if the workspace is exhausted)
+DSP_FUNCTION void* dsp_workspace_take(dsp_workspace_t* const ws, const size_t size);
+
+// Current position, pass it to 'dsp_workspace_release()' to give back everything taken after it
+DSP_FUNCTION size_t dsp_workspace_mark(const dsp_workspace_t* const ws);
+
+// Give back all blocks taken after 'mark'
+DSP_FUNCTION bool dsp_workspace_release(dsp_workspace_t* const ws, const size_t mark);
+
+// Give back all blocks
+DSP_FUNCTION bool dsp_workspace_reset(dsp_workspace_t* const ws);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_WORKSPACE_H
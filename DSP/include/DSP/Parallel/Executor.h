@@ -0,0 +1,115 @@
+#ifndef SJ_EXECUTOR_H
+#define SJ_EXECUTOR_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+#include "DSP/Discrete/pidBank.h"
+#include "DSP/Discrete/zTransferFunctionBank.h"
+#include "DSP/Discrete/zStateSpaceBank.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Jobs with fewer items run on the calling thread by default
+#define DSP_EXECUTOR_INLINE_ITEMS 1024
+
+
+// Work on the items [first, first + count) of a job
+typedef void (*dsp_executor_task_t)(void* const context, const size_t first, const size_t count);
+
+// Timing of one worker (nanoseconds, worker 0 is the calling thread)
+typedef struct ExecutorStats {
+
+    // Jobs the worker took part in
+    uint64_t ticks;
+
+    // Items processed by the worker
+    uint64_t items;
+
+    // Time spent on its ranges: last job, sum and maximum of all jobs
+    uint64_t last_ns;
+    uint64_t total_ns;
+    uint64_t max_ns;
+
+} dsp_executor_stats_t;
+
+// Persistent pool of worker threads, see 'dsp_executor_create()'
+typedef struct Executor dsp_executor_t;
+
+
+/**
+ * @brief Create a pool of worker threads for ticks of large banks
+ *
+ * @details Every job is split into one contiguous range per worker, the calling thread works on the first range.
+ *          'dsp_executor_run()' returns after all ranges are done (one barrier per tick).
+ *          Between jobs the workers spin for a short time and then sleep.
+ *
+ * @note Without thread support in the build (CMake option 'DSP_THREADS') the executor has one worker, the caller.
+ *
+ * @param workers Number of workers including the calling thread (0: number of online CPUs)
+ *
+ * @param cpus CPU of every background worker ('workers - 1' elements, NULL: no pinning).
+ *        The calling thread keeps its affinity.
+ *
+ * @return Pointer to the new executor (NULL if memory allocation or creating the threads failed)
+ */
+DSP_FUNCTION dsp_executor_t* dsp_executor_create(const size_t workers, const int* const cpus);
+
+// Stop the workers and destroy the executor
+DSP_FUNCTION bool dsp_executor_destroy(dsp_executor_t* const executor);
+
+// Number of workers including the calling thread
+DSP_FUNCTION size_t dsp_executor_workers(const dsp_executor_t* const executor);
+
+// Run jobs with fewer than 'items' items on the calling thread only (default: DSP_EXECUTOR_INLINE_ITEMS)
+DSP_FUNCTION bool dsp_executor_set_inline_threshold(dsp_executor_t* const executor, const size_t items);
+
+/**
+ * @brief Run a task on the items [0, n) split across all workers and wait until every range is done
+ *
+ * @param executor Executor (only one thread may run jobs on it at a time)
+ *
+ * @param n Number of items
+ *
+ * @param granularity Ranges start at multiples of 'granularity' items (0: 1),
+ *        e.g. a cache line of values so no two workers write the same line
+ *
+ * @param task Called once per non-empty range
+ *
+ * @param context Passed to the task
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_executor_run(dsp_executor_t* const executor, const size_t n, const size_t granularity, dsp_executor_task_t task, void* const context);
+
+/**
+ * @brief Run a task once on every worker (also below the inline threshold) and wait until all are done
+ *
+ * @note Worker k calls 'task(context, k, 1)', e.g. to run a scheduler loop on every worker.
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid
+ */
+DSP_FUNCTION bool dsp_executor_broadcast(dsp_executor_t* const executor, dsp_executor_task_t task, void* const context);
+
+// Timing of one worker
+DSP_FUNCTION bool dsp_executor_get_stats(const dsp_executor_t* const executor, const size_t worker, dsp_executor_stats_t* const stats);
+
+// Clear the timing of all workers
+DSP_FUNCTION bool dsp_executor_reset_stats(dsp_executor_t* const executor);
+
+
+
+// One tick of a bank, partitioned across the workers (same results as the serial update)
+DSP_FUNCTION bool dsp_executor_pid_bank_update(dsp_executor_t* const executor, dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y);
+DSP_FUNCTION bool dsp_executor_ztf_bank_update(dsp_executor_t* const executor, dsp_ztf_bank_t* const bank, const real_t* const u, real_t* const y);
+DSP_FUNCTION bool dsp_executor_zss_bank_update(dsp_executor_t* const executor, dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_EXECUTOR_H
@@ -0,0 +1,120 @@
+#ifndef SJ_TASK_GRAPH_H
+#define SJ_TASK_GRAPH_H
+
+#include <stddef.h> // size_t
+#include "DSP/dsp_types.h"
+#include "DSP/Parallel/Executor.h"
+#include "DSP/Discrete/pidController.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zStateObserver.h"
+#include "DSP/Discrete/Discontinuous.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Block of user code: reads its input signals from 'in' and writes its output signals to 'out'
+typedef void (*dsp_task_function_t)(void* const context, const real_t* const in, real_t* const out);
+
+// Timing of one block (nanoseconds)
+typedef struct TaskStats {
+
+    // Ticks the block ran in
+    uint64_t ticks;
+
+    // Execution time: last tick, sum and maximum of all ticks
+    uint64_t last_ns;
+    uint64_t total_ns;
+    uint64_t max_ns;
+
+    // Worker that ran the block in the last tick
+    size_t worker;
+
+} dsp_task_stats_t;
+
+// Per-tick dependency graph of blocks, see 'dsp_task_graph_create()'
+typedef struct TaskGraph dsp_task_graph_t;
+
+
+/**
+ * @brief Create a graph of blocks connected by signals, updated once per tick
+ *
+ * @details Every block reads some signals and writes others. A block runs after the blocks writing its inputs,
+ *          signals nobody writes are inputs of the graph (set them before each tick).
+ *          Blocks are numbered in the order they are added, starting at 0.
+ *          The signals of a tick may not form a cycle, even through blocks with a state:
+ *          close feedback outside the graph by copying an output into an input between the ticks.
+ *
+ *              dsp_task_graph_t* const graph = dsp_task_graph_create(3, 2);
+ *              dsp_task_graph_add_pid(graph, pid, 0, 1);
+ *              dsp_task_graph_add_saturation(graph, saturation, 1, 2);
+ *              dsp_task_graph_compile(graph, executor);
+ *              ...
+ *              dsp_task_graph_set_signal(graph, 0, error);
+ *              dsp_task_graph_tick(graph);
+ *              const real_t u = dsp_task_graph_get_signal(graph, 2);
+ *
+ * @param signals Number of signals
+ *
+ * @param max_blocks Maximum number of blocks
+ *
+ * @return Pointer to the new graph (NULL if memory allocation failed)
+ */
+DSP_FUNCTION dsp_task_graph_t* dsp_task_graph_create(const size_t signals, const size_t max_blocks);
+
+// Destroy the graph (not the blocks)
+DSP_FUNCTION bool dsp_task_graph_destroy(dsp_task_graph_t* const graph);
+
+// Add blocks (the graph only keeps the pointer, a signal may only be written by one block)
+DSP_FUNCTION bool dsp_task_graph_add_pid(dsp_task_graph_t* const graph, dsp_pid_t* const pid, const size_t input, const size_t output);
+DSP_FUNCTION bool dsp_task_graph_add_ztf(dsp_task_graph_t* const graph, dsp_ztf_t* const ztf, const size_t input, const size_t output);
+DSP_FUNCTION bool dsp_task_graph_add_saturation(dsp_task_graph_t* const graph, dsp_saturation_t* const saturation, const size_t input, const size_t output);
+
+// Observer: inputs 'u' ('nu' signals) and measurements 'y' ('ny' signals), output estimated state 'xh' ('nx' signals)
+DSP_FUNCTION bool dsp_task_graph_add_zso(dsp_task_graph_t* const graph, dsp_zso_t* const zso, const size_t* const u, const size_t* const y, const size_t* const xh);
+
+// Block of user code with 'n_in' input and 'n_out' output signals
+DSP_FUNCTION bool dsp_task_graph_add_function(dsp_task_graph_t* const graph, dsp_task_function_t function, void* const context,
+    const size_t n_in, const size_t* const inputs, const size_t n_out, const size_t* const outputs);
+
+/**
+ * @brief Resolve the dependencies after all blocks are added
+ *
+ * @param graph Graph
+ *
+ * @param executor Workers of the ticks (NULL: the blocks run one after the other on the calling thread)
+ *
+ * @return 'true' if successfull and 'false' if parameters are invalid,
+ *         memory allocation failed or the blocks depend on each other in a cycle
+ */
+DSP_FUNCTION bool dsp_task_graph_compile(dsp_task_graph_t* const graph, dsp_executor_t* const executor);
+
+/**
+ * @brief Run every block once
+ *
+ * @details Ready blocks are pushed to the deque of the worker that finished their last dependency.
+ *          Idle workers steal the oldest ready block of another worker,
+ *          so a few expensive blocks don't hold back the cheap ones behind them.
+ *
+ * @return 'true' if successfull and 'false' if the graph isn't compiled
+ */
+DSP_FUNCTION bool dsp_task_graph_tick(dsp_task_graph_t* const graph);
+
+// Value of a signal
+DSP_FUNCTION bool dsp_task_graph_set_signal(dsp_task_graph_t* const graph, const size_t signal, const real_t value);
+DSP_FUNCTION real_t dsp_task_graph_get_signal(const dsp_task_graph_t* const graph, const size_t signal);
+
+// Timing of one block
+DSP_FUNCTION bool dsp_task_graph_get_stats(const dsp_task_graph_t* const graph, const size_t block, dsp_task_stats_t* const stats);
+
+// Clear the timing of all blocks
+DSP_FUNCTION bool dsp_task_graph_reset_stats(dsp_task_graph_t* const graph);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // SJ_TASK_GRAPH_H
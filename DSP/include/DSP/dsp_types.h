@@ -4,6 +4,7 @@
 #include <stdint.h> // size_t
 #include <stdbool.h> // bool
 
+#if defined(_WIN32) || defined(__CYGWIN__)
 #ifdef BUILD_SHARDED_DSP_LIB
 // #pragma message("Building shared libDSP")
 #define DSP_FUNCTION __declspec(dllexport)
@@ -12,6 +13,7 @@
 // #pragma message("Using shared libDSP")
 #define DSP_FUNCTION __declspec(dllimport)
 #endif
+#endif
 
 #ifndef DSP_FUNCTION
 #define DSP_FUNCTION
@@ -20,9 +22,65 @@
 
 // ----- Types -----
 
+// Precision of the build (CMake targets DSPc, DSPd and DSPm):
+// default                  real_t and accum_t are float
+// DSP_PRECISION_DOUBLE     real_t and accum_t are double
+// DSP_PRECISION_MIXED      real_t is float, accum_t is double. Double is used for the sums of 'dsp_simd_dot_product()'
+//                          (QR and Cholesky steps, triangular solves) and for the states of the linear systems:
+//                          ztf output history and difference equation, zss and zso state with their matrix-vector
+//                          products, second order sections. Signals, coefficients and the float copies 'x' and 'xh'
+//                          are float, as are the matrix product (GEMM), the LU elimination, pid, integrator,
+//                          derivative and the banks.
+#if defined(DSP_PRECISION_DOUBLE)
+
+// 64-bit floating point number
+typedef double real_t;
+typedef double accum_t;
+
+#elif defined(DSP_PRECISION_MIXED)
+
+// 32-bit signals with 64-bit accumulation
+typedef float real_t;
+typedef double accum_t;
+
+#else
 
 // 32-bit floating point number
 typedef float real_t;
+typedef float accum_t;
+
+#endif
+
+// The functions of the double and mixed precision builds are exported as 'dspd_...' and 'dspm_...'
+// (the generated header maps every 'dsp_...' name), so all builds can be linked into one program
+#if defined(DSP_PRECISION_DOUBLE) || defined(DSP_PRECISION_MIXED)
+#include "DSP/dsp_symbols.h"
+#endif
+
+// Functions of <math.h> for real_t
+#ifdef DSP_PRECISION_DOUBLE
+#define REAL_SQRT sqrt
+#define REAL_FABS fabs
+#define REAL_EXP exp
+#define REAL_POW pow
+#define REAL_ROUND round
+#define REAL_FLOOR floor
+#define REAL_CEIL ceil
+#define REAL_ACOS acos
+#define REAL_COPYSIGN copysign
+#define REAL_EPSILON DBL_EPSILON
+#else
+#define REAL_SQRT sqrtf
+#define REAL_FABS fabsf
+#define REAL_EXP expf
+#define REAL_POW powf
+#define REAL_ROUND roundf
+#define REAL_FLOOR floorf
+#define REAL_CEIL ceilf
+#define REAL_ACOS acosf
+#define REAL_COPYSIGN copysignf
+#define REAL_EPSILON FLT_EPSILON
+#endif
 
 
 // ----- Enums -----
@@ -55,5 +113,14 @@ typedef enum RoundingMethod {
     RoundUp
 } rounding_method_t;
 
+// Instruction set of the vectorized kernels
+typedef enum SimdIsa {
+    SimdScalar = 0, // Plain C (reference)
+    SimdSSE,        // x86 SSE
+    SimdAVX2,       // x86 AVX2 + FMA
+    SimdAVX512,     // x86 AVX-512F
+    SimdNEON        // ARM NEON
+} dsp_simd_isa_t;
+
 
 #endif // SJ_DSP_TYPES_H
\ No newline at end of file
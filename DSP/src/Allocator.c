@@ -0,0 +1,134 @@
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Allocator.h"
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+
+#define ARENA_SIZE sizeof(dsp_arena_t)
+#define POOL_SIZE sizeof(dsp_pool_t)
+#define ALIGN_UP(value) (((value) + (DSP_ALLOCATOR_ALIGNMENT - 1)) & ~((size_t) DSP_ALLOCATOR_ALIGNMENT - 1))
+
+// Room for the block header of 'dsp_malloc()' in every pool block
+#define POOL_BLOCK_SIZE(block_size) (ALIGN_UP(block_size) + DSP_ALLOCATOR_ALIGNMENT)
+
+
+
+// Arena
+static void* arena_alloc(void* const context, const size_t size) {
+    dsp_arena_t* const arena = (dsp_arena_t*) context;
+
+    const size_t block_size = ALIGN_UP(size);
+    if (block_size > arena->size - arena->used) { return NULL; }
+
+    void* const block = &(arena->memory[arena->used]);
+    arena->used += block_size;
+    return block;
+}
+
+dsp_arena_t* dsp_arena_create(const size_t size) {
+
+    // Header and memory in one allocation (from the heap, not from the selected allocator)
+    const dsp_allocator_t* const previous = dsp_allocator_select(dsp_allocator_default());
+    unsigned char* const block = (unsigned char*) dsp_malloc(ALIGN_UP(ARENA_SIZE) + size);
+    dsp_allocator_select(previous);
+    if (block == NULL) { return NULL; }
+
+    dsp_arena_t* const arena = (dsp_arena_t*) block;
+    dsp_arena_init(arena, &block[ALIGN_UP(ARENA_SIZE)], size);
+    return arena;
+}
+bool dsp_arena_init(dsp_arena_t* const arena, void* const memory, const size_t size) {
+    if (arena == NULL || memory == NULL) { return false; }
+
+    const size_t skip = ALIGN_UP((uintptr_t) memory) - (uintptr_t) memory;
+    if (skip > size) { return false; }
+
+    arena->allocator.alloc = arena_alloc;
+    arena->allocator.realloc = NULL;
+    arena->allocator.free = NULL;
+    arena->allocator.context = arena;
+    arena->memory = (unsigned char*) memory + skip;
+    arena->size = size - skip;
+    arena->used = 0;
+    return true;
+}
+bool dsp_arena_destroy(dsp_arena_t* const arena) {
+    if (arena == NULL) { return false; }
+    dsp_free(arena);
+    return true;
+}
+bool dsp_arena_reset(dsp_arena_t* const arena) {
+    if (arena == NULL) { return false; }
+    arena->used = 0;
+    return true;
+}
+const dsp_allocator_t* dsp_arena_allocator(dsp_arena_t* const arena) {
+    if (arena == NULL) { return NULL; }
+    return &(arena->allocator);
+}
+
+
+
+// Pool
+static void* pool_alloc(void* const context, const size_t size) {
+    dsp_pool_t* const pool = (dsp_pool_t*) context;
+    if (size > pool->block_size || pool->free_list == NULL) { return NULL; }
+
+    // Pop the first free block
+    void* const block = pool->free_list;
+    pool->free_list = *((void**) block);
+    --(pool->available);
+    return block;
+}
+static void pool_free(void* const context, void* const ptr) {
+    dsp_pool_t* const pool = (dsp_pool_t*) context;
+
+    // Push the block onto the free list
+    *((void**) ptr) = pool->free_list;
+    pool->free_list = ptr;
+    ++(pool->available);
+}
+
+size_t dsp_pool_memory_size(const size_t block_size, const size_t blocks) {
+    return POOL_BLOCK_SIZE(block_size) * blocks + DSP_ALLOCATOR_ALIGNMENT;
+}
+dsp_pool_t* dsp_pool_create(const size_t block_size, const size_t blocks) {
+
+    // Header and memory in one allocation (from the heap, not from the selected allocator)
+    const dsp_allocator_t* const previous = dsp_allocator_select(dsp_allocator_default());
+    unsigned char* const block = (unsigned char*) dsp_malloc(ALIGN_UP(POOL_SIZE) + dsp_pool_memory_size(block_size, blocks));
+    dsp_allocator_select(previous);
+    if (block == NULL) { return NULL; }
+
+    dsp_pool_t* const pool = (dsp_pool_t*) block;
+    dsp_pool_init(pool, &block[ALIGN_UP(POOL_SIZE)], block_size, blocks);
+    return pool;
+}
+bool dsp_pool_init(dsp_pool_t* const pool, void* const memory, const size_t block_size, const size_t blocks) {
+    if (pool == NULL || memory == NULL) { return false; }
+    if (block_size == 0 || blocks == 0) { return false; }
+
+    pool->allocator.alloc = pool_alloc;
+    pool->allocator.realloc = NULL;
+    pool->allocator.free = pool_free;
+    pool->allocator.context = pool;
+    pool->memory = (unsigned char*) ALIGN_UP((uintptr_t) memory);
+    pool->block_size = POOL_BLOCK_SIZE(block_size);
+    pool->blocks = blocks;
+    pool->available = blocks;
+
+    // Chain all blocks in address order
+    pool->free_list = NULL;
+    for (size_t k = blocks; k > 0; --k) {
+        pool_free(pool, &(pool->memory[(k - 1) * pool->block_size]));
+    }
+    pool->available = blocks;
+    return true;
+}
+bool dsp_pool_destroy(dsp_pool_t* const pool) {
+    if (pool == NULL) { return false; }
+    dsp_free(pool);
+    return true;
+}
+const dsp_allocator_t* dsp_pool_allocator(dsp_pool_t* const pool) {
+    if (pool == NULL) { return NULL; }
+    return &(pool->allocator);
+}
@@ -0,0 +1,678 @@
+#include <string.h> // memset, memcpy
+#include <stdint.h> // SIZE_MAX
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Discrete/BlockDiagram.h"
+
+#define REAL_SIZE sizeof(real_t)
+
+// Unconnected input port, block without instruction
+#define NONE SIZE_MAX
+
+
+typedef enum DiagramKind {
+    DiagramInput,
+    DiagramOutput,
+    DiagramPid,
+    DiagramZtf,
+    DiagramZss,
+    DiagramSaturation,
+    DiagramDeadZone,
+    DiagramRateLimiter,
+    DiagramQuantizer,
+    DiagramSchmittTrigger,
+    DiagramSchmittQuantizer,
+    DiagramSum,
+    DiagramMux,
+    DiagramDemux,
+    DiagramFunction,
+} diagram_kind_t;
+
+// Output port a connection comes from
+typedef struct DiagramSource {
+    size_t block;
+    size_t port;
+} diagram_source_t;
+
+// Values of a port: element e of sample j at 'data[j * stride + e]'
+typedef struct DiagramBuffer {
+    real_t* data;
+    size_t stride;
+} diagram_buffer_t;
+
+typedef struct DiagramBlock {
+    diagram_kind_t kind;
+    void* block;
+    dsp_diagram_function_t function;
+    void* context;
+
+    // Ports
+    size_t n_in;
+    size_t n_out;
+    size_t* in_width;
+    size_t* out_width;
+    diagram_source_t* sources;
+    real_t* gains;
+
+    // Set by 'dsp_diagram_compile()': buffers of the output ports (of the diagram output: its copy of the input),
+    // nodes computing the outputs and updating the state (the same node unless split)
+    diagram_buffer_t* outputs;
+    size_t output_node;
+    size_t update_node;
+
+    // Ports, sources, gains and buffers in one allocation
+    void* memory;
+} diagram_block_t;
+
+
+// Process the samples [first, first + n)
+struct DiagramInstruction;
+typedef void (*diagram_kernel_t)(const struct DiagramInstruction* const instruction, const size_t first, const size_t n);
+
+typedef struct DiagramInstruction {
+    diagram_kernel_t run;
+    void* block;
+
+    // Input port 0 and output port 0
+    const real_t* in;
+    size_t in_stride;
+    real_t* out;
+    size_t out_stride;
+    size_t width;
+
+    // All scalar input ports (sum and mux)
+    size_t n_inputs;
+    const real_t** inputs;
+    size_t* strides;
+    const real_t* gains;
+
+    dsp_diagram_function_t function;
+    void* context;
+} diagram_instruction_t;
+
+struct BlockDiagram {
+
+    size_t max_blocks;
+    size_t max_samples;
+    size_t n_blocks;
+    diagram_block_t* blocks;
+
+    // ----- Compiled -----
+
+    bool compiled;
+
+    // All instructions for one sample, then the next sample (feedback), or one instruction for all samples
+    bool sample_major;
+
+    diagram_instruction_t* instructions;
+    size_t n_instructions;
+
+    // Internal: instructions, buffers and input lists in one allocation
+    void* compiled_block;
+
+    // Internal: struct and block records in one allocation
+    void* block;
+};
+
+
+// Part of a block executed by one instruction
+typedef enum DiagramPhase {
+    PhaseFull, // outputs and state
+    PhaseOutput, // outputs only (state space model without feedthrough)
+    PhaseUpdate, // state only
+} diagram_phase_t;
+
+typedef struct DiagramNode {
+    size_t block;
+    diagram_phase_t phase;
+} diagram_node_t;
+
+
+
+// Create
+dsp_diagram_t* dsp_diagram_create(const size_t max_blocks, const size_t max_samples) {
+    if (max_blocks == 0 || max_samples == 0) { return NULL; }
+
+    // Layout: the diagram struct, then the block records
+    unsigned char* const block = (unsigned char*) dsp_malloc(sizeof(struct BlockDiagram) + max_blocks * sizeof(diagram_block_t));
+    if (block == NULL) { return NULL; }
+
+    struct BlockDiagram* const diagram = (struct BlockDiagram*) block;
+    memset(diagram, 0, sizeof(struct BlockDiagram));
+    diagram->max_blocks = max_blocks;
+    diagram->max_samples = max_samples;
+    diagram->blocks = (diagram_block_t*) &block[sizeof(struct BlockDiagram)];
+    diagram->block = block;
+    return diagram;
+}
+
+// Destroy
+bool dsp_diagram_destroy(dsp_diagram_t* const diagram) {
+    if (diagram == NULL) { return false; }
+
+    for (size_t k = 0; k < diagram->n_blocks; ++k) { dsp_free(diagram->blocks[k].memory); }
+    if (diagram->compiled_block != NULL) { dsp_free(diagram->compiled_block); }
+
+    // The struct lives at the beginning of the block
+    dsp_free(diagram->block);
+    return true;
+}
+
+
+
+// ----- Blocks -----
+
+// Add a block with 'n_in' input ports of 'in_width' values and 'n_out' output ports of 'out_width' values
+static diagram_block_t* add_block(dsp_diagram_t* const diagram, const diagram_kind_t kind, void* const block,
+    const size_t n_in, const size_t in_width, const size_t n_out, const size_t out_width, size_t* const id) {
+
+    if (diagram == NULL) { return NULL; }
+    if (diagram->n_blocks >= diagram->max_blocks) { return NULL; }
+    if ((n_in != 0 && in_width == 0) || (n_out != 0 && out_width == 0)) { return NULL; }
+
+    // Layout: in_width, out_width, sources, buffers, gains
+    const size_t bytes = (n_in + n_out) * sizeof(size_t) + n_in * sizeof(diagram_source_t) + (n_out + 1) * sizeof(diagram_buffer_t) + n_in * REAL_SIZE;
+    unsigned char* const memory = (unsigned char*) dsp_malloc(bytes);
+    if (memory == NULL) { return NULL; }
+
+    diagram_block_t* const record = &diagram->blocks[diagram->n_blocks];
+    memset(record, 0, sizeof(diagram_block_t));
+    record->kind = kind;
+    record->block = block;
+    record->n_in = n_in;
+    record->n_out = n_out;
+    record->in_width = (size_t*) memory;
+    record->out_width = &record->in_width[n_in];
+    record->sources = (diagram_source_t*) &record->out_width[n_out];
+    record->outputs = (diagram_buffer_t*) &record->sources[n_in];
+    record->gains = (real_t*) &record->outputs[n_out + 1];
+    record->memory = memory;
+
+    for (size_t i = 0; i < n_in; ++i) {
+        record->in_width[i] = in_width;
+        record->sources[i].block = NONE;
+        record->sources[i].port = NONE;
+        record->gains[i] = 1;
+    }
+    for (size_t i = 0; i < n_out; ++i) { record->out_width[i] = out_width; }
+
+    if (id != NULL) { *id = diagram->n_blocks; }
+    diagram->n_blocks += 1;
+    diagram->compiled = false;
+    return record;
+}
+
+bool dsp_diagram_add_input(dsp_diagram_t* const diagram, const size_t width, size_t* const id) {
+    return add_block(diagram, DiagramInput, NULL, 0, 0, 1, width, id) != NULL;
+}
+
+bool dsp_diagram_add_output(dsp_diagram_t* const diagram, const size_t width, size_t* const id) {
+    return add_block(diagram, DiagramOutput, NULL, 1, width, 0, 0, id) != NULL;
+}
+
+bool dsp_diagram_add_pid(dsp_diagram_t* const diagram, dsp_pid_t* const pid, size_t* const id) {
+    if (pid == NULL) { return false; }
+    return add_block(diagram, DiagramPid, pid, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_ztf(dsp_diagram_t* const diagram, dsp_ztf_t* const ztf, size_t* const id) {
+    if (ztf == NULL) { return false; }
+    return add_block(diagram, DiagramZtf, ztf, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_saturation(dsp_diagram_t* const diagram, dsp_saturation_t* const saturation, size_t* const id) {
+    if (saturation == NULL) { return false; }
+    return add_block(diagram, DiagramSaturation, saturation, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_dead_zone(dsp_diagram_t* const diagram, dsp_dead_zone_t* const dead_zone, size_t* const id) {
+    if (dead_zone == NULL) { return false; }
+    return add_block(diagram, DiagramDeadZone, dead_zone, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_rate_limiter(dsp_diagram_t* const diagram, dsp_rate_limiter_t* const rate_limiter, size_t* const id) {
+    if (rate_limiter == NULL) { return false; }
+    return add_block(diagram, DiagramRateLimiter, rate_limiter, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_quantizer(dsp_diagram_t* const diagram, dsp_quantization_t* const quantizer, size_t* const id) {
+    if (quantizer == NULL) { return false; }
+    return add_block(diagram, DiagramQuantizer, quantizer, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_schmitt_trigger(dsp_diagram_t* const diagram, dsp_schmitt_trigger_t* const trigger, size_t* const id) {
+    if (trigger == NULL) { return false; }
+    return add_block(diagram, DiagramSchmittTrigger, trigger, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_schmitt_quantizer(dsp_diagram_t* const diagram, dsp_schmitt_quantization_t* const quantizer, size_t* const id) {
+    if (quantizer == NULL) { return false; }
+    return add_block(diagram, DiagramSchmittQuantizer, quantizer, 1, 1, 1, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_zss(dsp_diagram_t* const diagram, dsp_zss_t* const zss, size_t* const id) {
+    if (zss == NULL || zss->B == NULL || zss->C == NULL || zss->D == NULL) { return false; }
+    return add_block(diagram, DiagramZss, zss, 1, zss->B->columns, 1, zss->C->rows, id) != NULL;
+}
+
+bool dsp_diagram_add_sum(dsp_diagram_t* const diagram, const size_t n, const real_t* const gains, size_t* const id) {
+    if (n == 0) { return false; }
+
+    diagram_block_t* const record = add_block(diagram, DiagramSum, NULL, n, 1, 1, 1, id);
+    if (record == NULL) { return false; }
+    if (gains != NULL) { memcpy(record->gains, gains, n * REAL_SIZE); }
+    return true;
+}
+
+bool dsp_diagram_add_mux(dsp_diagram_t* const diagram, const size_t n, size_t* const id) {
+    if (n == 0) { return false; }
+    return add_block(diagram, DiagramMux, NULL, n, 1, 1, n, id) != NULL;
+}
+
+bool dsp_diagram_add_demux(dsp_diagram_t* const diagram, const size_t n, size_t* const id) {
+    if (n == 0) { return false; }
+    return add_block(diagram, DiagramDemux, NULL, 1, n, n, 1, id) != NULL;
+}
+
+bool dsp_diagram_add_function(dsp_diagram_t* const diagram, dsp_diagram_function_t function, void* const context,
+    const size_t in_width, const size_t out_width, size_t* const id) {
+
+    if (function == NULL) { return false; }
+
+    diagram_block_t* const record = add_block(diagram, DiagramFunction, NULL, 1, in_width, 1, out_width, id);
+    if (record == NULL) { return false; }
+    record->function = function;
+    record->context = context;
+    return true;
+}
+
+
+
+// Connect
+bool dsp_diagram_connect(dsp_diagram_t* const diagram, const size_t from, const size_t from_port, const size_t to, const size_t to_port) {
+    if (diagram == NULL) { return false; }
+    if (from >= diagram->n_blocks || to >= diagram->n_blocks) { return false; }
+
+    const diagram_block_t* const source = &diagram->blocks[from];
+    diagram_block_t* const sink = &diagram->blocks[to];
+    if (from_port >= source->n_out || to_port >= sink->n_in) { return false; }
+    if (sink->sources[to_port].block != NONE) { return false; }
+    if (source->out_width[from_port] != sink->in_width[to_port]) { return false; }
+
+    sink->sources[to_port].block = from;
+    sink->sources[to_port].port = from_port;
+    diagram->compiled = false;
+    return true;
+}
+
+
+
+// ----- Kernels -----
+
+// Blocks with one scalar input and one scalar output
+#define SCALAR_KERNEL(name, type, update) \
+static void name(const diagram_instruction_t* const instruction, const size_t first, const size_t n) { \
+    type* const block = (type*) instruction->block; \
+    for (size_t j = first; j < first + n; ++j) { \
+        instruction->out[j * instruction->out_stride] = update(block, instruction->in[j * instruction->in_stride]); \
+    } \
+}
+
+SCALAR_KERNEL(run_pid, dsp_pid_t, dsp_pid_update)
+SCALAR_KERNEL(run_ztf, dsp_ztf_t, dsp_ztf_update)
+SCALAR_KERNEL(run_saturation, dsp_saturation_t, dsp_saturation_update)
+SCALAR_KERNEL(run_dead_zone, dsp_dead_zone_t, dsp_dead_zone_update)
+SCALAR_KERNEL(run_rate_limiter, dsp_rate_limiter_t, dsp_rate_limiter_update)
+SCALAR_KERNEL(run_quantizer, dsp_quantization_t, dsp_quantizer_update)
+SCALAR_KERNEL(run_schmitt_trigger, dsp_schmitt_trigger_t, dsp_schmitt_trigger_update)
+SCALAR_KERNEL(run_schmitt_quantizer, dsp_schmitt_quantization_t, dsp_schmitt_quantizer_update)
+
+// Transfer function on contiguous samples
+static void run_ztf_block(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_ztf_process_block((dsp_ztf_t*) instruction->block, &instruction->in[first], &instruction->out[first], n);
+}
+
+// Without feedthrough: the output does not need the input
+static void run_ztf_output(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_ztf_t* const ztf = (dsp_ztf_t*) instruction->block;
+    for (size_t j = first; j < first + n; ++j) {
+        instruction->out[j * instruction->out_stride] = dsp_ztf_next_output(ztf);
+    }
+}
+
+static void run_ztf_update(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_ztf_t* const ztf = (dsp_ztf_t*) instruction->block;
+    for (size_t j = first; j < first + n; ++j) {
+        dsp_ztf_update(ztf, instruction->in[j * instruction->in_stride]);
+    }
+}
+
+static void run_zss(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_zss_t* const zss = (dsp_zss_t*) instruction->block;
+    for (size_t j = first; j < first + n; ++j) {
+        dsp_zss_update(zss, &instruction->in[j * instruction->in_stride], &instruction->out[j * instruction->out_stride]);
+    }
+}
+
+// Without feedthrough: the input is a zero vector
+static void run_zss_output(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_zss_t* const zss = (dsp_zss_t*) instruction->block;
+    for (size_t j = first; j < first + n; ++j) {
+        dsp_zss_get_output(zss, instruction->in, &instruction->out[j * instruction->out_stride]);
+    }
+}
+
+static void run_zss_update(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    dsp_zss_t* const zss = (dsp_zss_t*) instruction->block;
+    for (size_t j = first; j < first + n; ++j) {
+        dsp_zss_update_state(zss, &instruction->in[j * instruction->in_stride]);
+    }
+}
+
+static void run_sum(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    for (size_t j = first; j < first + n; ++j) {
+        real_t sum = 0;
+        for (size_t i = 0; i < instruction->n_inputs; ++i) {
+            sum += instruction->gains[i] * instruction->inputs[i][j * instruction->strides[i]];
+        }
+        instruction->out[j * instruction->out_stride] = sum;
+    }
+}
+
+static void run_mux(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    for (size_t j = first; j < first + n; ++j) {
+        for (size_t i = 0; i < instruction->n_inputs; ++i) {
+            instruction->out[j * instruction->out_stride + i] = instruction->inputs[i][j * instruction->strides[i]];
+        }
+    }
+}
+
+static void run_function(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    for (size_t j = first; j < first + n; ++j) {
+        instruction->function(instruction->context, &instruction->in[j * instruction->in_stride], &instruction->out[j * instruction->out_stride]);
+    }
+}
+
+// Copy into the buffer of a diagram output
+static void run_output(const diagram_instruction_t* const instruction, const size_t first, const size_t n) {
+    for (size_t j = first; j < first + n; ++j) {
+        memcpy(&instruction->out[j * instruction->width], &instruction->in[j * instruction->in_stride], instruction->width * REAL_SIZE);
+    }
+}
+
+
+
+// ----- Compile -----
+
+// Buffer of an output port, demultiplexed ports point into the input of the demux
+static diagram_buffer_t source_buffer(const dsp_diagram_t* const diagram, const diagram_source_t source) {
+    const diagram_block_t* const record = &diagram->blocks[source.block];
+    if (record->kind != DiagramDemux) { return record->outputs[source.port]; }
+
+    diagram_buffer_t buffer = source_buffer(diagram, record->sources[0]);
+    buffer.data += source.port;
+    return buffer;
+}
+
+// Node computing an output port (NONE: inputs of the diagram)
+static size_t source_node(const dsp_diagram_t* const diagram, const diagram_source_t source) {
+    const diagram_block_t* const record = &diagram->blocks[source.block];
+    if (record->kind == DiagramDemux) { return source_node(diagram, record->sources[0]); }
+    return record->output_node;
+}
+
+// Blocks without feedthrough, their output can be computed before their input
+static bool split_block(const diagram_block_t* const record) {
+    if (record->kind == DiagramZss) { return !dsp_zss_has_feedthrough((const dsp_zss_t*) record->block); }
+    if (record->kind == DiagramZtf) { return !dsp_ztf_has_feedthrough((const dsp_ztf_t*) record->block); }
+    return false;
+}
+
+// Nodes of all blocks, sorted so every node comes after the nodes computing its inputs.
+// Returns the number of nodes or NONE if there is a loop.
+static size_t sort_nodes(dsp_diagram_t* const diagram, const bool split, diagram_node_t* const nodes, diagram_node_t* const order, bool* const done) {
+    size_t n_nodes = 0;
+    for (size_t b = 0; b < diagram->n_blocks; ++b) {
+        diagram_block_t* const record = &diagram->blocks[b];
+        record->output_node = NONE;
+        record->update_node = NONE;
+        if (record->kind == DiagramInput || record->kind == DiagramDemux) { continue; }
+
+        if (split && split_block(record)) {
+            nodes[n_nodes].block = b;
+            nodes[n_nodes].phase = PhaseOutput;
+            record->output_node = n_nodes++;
+            nodes[n_nodes].block = b;
+            nodes[n_nodes].phase = PhaseUpdate;
+            record->update_node = n_nodes++;
+        }
+        else {
+            nodes[n_nodes].block = b;
+            nodes[n_nodes].phase = PhaseFull;
+            record->output_node = n_nodes;
+            record->update_node = n_nodes++;
+        }
+    }
+
+    // Repeatedly take every node whose inputs are done, until nothing changes
+    memset(done, 0, n_nodes * sizeof(bool));
+    size_t n_sorted = 0;
+    bool progress = true;
+    while (n_sorted < n_nodes && progress) {
+        progress = false;
+        for (size_t k = 0; k < n_nodes; ++k) {
+            if (done[k]) { continue; }
+
+            const diagram_block_t* const record = &diagram->blocks[nodes[k].block];
+            bool ready = (nodes[k].phase != PhaseUpdate || done[record->output_node]);
+            if (nodes[k].phase != PhaseOutput) {
+                for (size_t i = 0; i < record->n_in && ready; ++i) {
+                    const size_t node = source_node(diagram, record->sources[i]);
+                    ready = (node == NONE || done[node]);
+                }
+            }
+            if (ready) {
+                done[k] = true;
+                order[n_sorted++] = nodes[k];
+                progress = true;
+            }
+        }
+    }
+    return (n_sorted == n_nodes ? n_nodes : NONE);
+}
+
+bool dsp_diagram_compile(dsp_diagram_t* const diagram) {
+    if (diagram == NULL) { return false; }
+
+    if (diagram->compiled_block != NULL) { dsp_free(diagram->compiled_block); }
+    diagram->compiled_block = NULL;
+    diagram->compiled = false;
+
+    // Every input port needs a source
+    size_t n_values = 0;
+    size_t n_inputs = 0;
+    size_t max_nu = 0;
+    for (size_t b = 0; b < diagram->n_blocks; ++b) {
+        const diagram_block_t* const record = &diagram->blocks[b];
+        for (size_t i = 0; i < record->n_in; ++i) {
+            if (record->sources[i].block == NONE) { return false; }
+        }
+
+        if (record->kind == DiagramOutput) { n_values += record->in_width[0]; }
+        else if (record->kind != DiagramDemux) {
+            for (size_t i = 0; i < record->n_out; ++i) { n_values += record->out_width[i]; }
+        }
+        if (record->kind == DiagramSum || record->kind == DiagramMux) { n_inputs += record->n_in; }
+        if (record->kind == DiagramZss && record->in_width[0] > max_nu) { max_nu = record->in_width[0]; }
+    }
+
+    // Execution order: whole blocks of samples if possible, otherwise sample by sample with split models
+    const size_t max_nodes = 2 * diagram->n_blocks;
+    unsigned char* const scratch = (unsigned char*) dsp_malloc(max_nodes * (2 * sizeof(diagram_node_t) + sizeof(bool)) + 1);
+    if (scratch == NULL) { return false; }
+    diagram_node_t* const nodes = (diagram_node_t*) scratch;
+    diagram_node_t* const order = &nodes[max_nodes];
+    bool* const done = (bool*) &order[max_nodes];
+
+    bool sample_major = false;
+    size_t n_nodes = sort_nodes(diagram, false, nodes, order, done);
+    if (n_nodes == NONE) {
+        sample_major = true;
+        n_nodes = sort_nodes(diagram, true, nodes, order, done);
+    }
+    if (n_nodes == NONE) {
+        dsp_free(scratch);
+        return false;
+    }
+
+    // Layout: instructions, input lists, strides, buffers, zero vector
+    const size_t instructions_size = n_nodes * sizeof(diagram_instruction_t);
+    const size_t inputs_size = n_inputs * (sizeof(const real_t*) + sizeof(size_t));
+    const size_t buffers_size = (n_values * diagram->max_samples + max_nu) * REAL_SIZE;
+    unsigned char* const block = (unsigned char*) dsp_malloc(instructions_size + inputs_size + buffers_size + 1);
+    if (block == NULL) {
+        dsp_free(scratch);
+        return false;
+    }
+    memset(block, 0, instructions_size + inputs_size + buffers_size);
+
+    diagram_instruction_t* const instructions = (diagram_instruction_t*) block;
+    const real_t** input_list = (const real_t**) &block[instructions_size];
+    size_t* stride_list = (size_t*) &input_list[n_inputs];
+    real_t* values = (real_t*) &stride_list[n_inputs];
+    const real_t* const zero = values;
+    values += max_nu;
+
+    // Buffers of all output ports
+    for (size_t b = 0; b < diagram->n_blocks; ++b) {
+        diagram_block_t* const record = &diagram->blocks[b];
+        if (record->kind == DiagramDemux) { continue; }
+        for (size_t i = 0; i < record->n_out; ++i) {
+            record->outputs[i].data = values;
+            record->outputs[i].stride = record->out_width[i];
+            values += record->out_width[i] * diagram->max_samples;
+        }
+        if (record->kind == DiagramOutput) {
+            record->outputs[0].data = values;
+            record->outputs[0].stride = record->in_width[0];
+            values += record->in_width[0] * diagram->max_samples;
+        }
+    }
+
+    // One instruction per node with all pointers resolved
+    for (size_t k = 0; k < n_nodes; ++k) {
+        const diagram_block_t* const record = &diagram->blocks[order[k].block];
+        diagram_instruction_t* const instruction = &instructions[k];
+        instruction->block = record->block;
+        instruction->out = record->outputs[0].data;
+        instruction->out_stride = record->outputs[0].stride;
+        if (record->n_in != 0) {
+            const diagram_buffer_t in = source_buffer(diagram, record->sources[0]);
+            instruction->in = in.data;
+            instruction->in_stride = in.stride;
+        }
+
+        switch (record->kind) {
+            case DiagramPid: instruction->run = run_pid; break;
+            case DiagramSaturation: instruction->run = run_saturation; break;
+            case DiagramDeadZone: instruction->run = run_dead_zone; break;
+            case DiagramRateLimiter: instruction->run = run_rate_limiter; break;
+            case DiagramQuantizer: instruction->run = run_quantizer; break;
+            case DiagramSchmittTrigger: instruction->run = run_schmitt_trigger; break;
+            case DiagramSchmittQuantizer: instruction->run = run_schmitt_quantizer; break;
+            case DiagramZtf:
+                if (order[k].phase == PhaseOutput) { instruction->run = run_ztf_output; }
+                else if (order[k].phase == PhaseUpdate) { instruction->run = run_ztf_update; }
+                else { instruction->run = (instruction->in_stride == 1 && instruction->out_stride == 1 ? run_ztf_block : run_ztf); }
+                break;
+            case DiagramZss:
+                if (order[k].phase == PhaseOutput) { instruction->run = run_zss_output; instruction->in = zero; }
+                else if (order[k].phase == PhaseUpdate) { instruction->run = run_zss_update; }
+                else { instruction->run = run_zss; }
+                break;
+            case DiagramSum:
+            case DiagramMux:
+                instruction->run = (record->kind == DiagramSum ? run_sum : run_mux);
+                instruction->n_inputs = record->n_in;
+                instruction->inputs = input_list;
+                instruction->strides = stride_list;
+                instruction->gains = record->gains;
+                for (size_t i = 0; i < record->n_in; ++i) {
+                    const diagram_buffer_t in = source_buffer(diagram, record->sources[i]);
+                    input_list[i] = in.data;
+                    stride_list[i] = in.stride;
+                }
+                input_list += record->n_in;
+                stride_list += record->n_in;
+                break;
+            case DiagramFunction:
+                instruction->run = run_function;
+                instruction->function = record->function;
+                instruction->context = record->context;
+                break;
+            case DiagramOutput:
+                instruction->run = run_output;
+                instruction->width = record->in_width[0];
+                break;
+            case DiagramInput:
+            case DiagramDemux:
+                break;
+        }
+    }
+
+    dsp_free(scratch);
+    diagram->instructions = instructions;
+    diagram->n_instructions = n_nodes;
+    diagram->sample_major = sample_major;
+    diagram->compiled_block = block;
+    diagram->compiled = true;
+    return true;
+}
+
+
+
+// ----- Execution -----
+
+real_t* dsp_diagram_input(dsp_diagram_t* const diagram, const size_t id) {
+    if (diagram == NULL || !diagram->compiled || id >= diagram->n_blocks) { return NULL; }
+    if (diagram->blocks[id].kind != DiagramInput) { return NULL; }
+    return diagram->blocks[id].outputs[0].data;
+}
+
+const real_t* dsp_diagram_output(const dsp_diagram_t* const diagram, const size_t id) {
+    if (diagram == NULL || !diagram->compiled || id >= diagram->n_blocks) { return NULL; }
+    if (diagram->blocks[id].kind != DiagramOutput) { return NULL; }
+    return diagram->blocks[id].outputs[0].data;
+}
+
+size_t dsp_diagram_width(const dsp_diagram_t* const diagram, const size_t id) {
+    if (diagram == NULL || id >= diagram->n_blocks) { return 0; }
+    const diagram_block_t* const record = &diagram->blocks[id];
+    if (record->kind == DiagramInput) { return record->out_width[0]; }
+    if (record->kind == DiagramOutput) { return record->in_width[0]; }
+    return 0;
+}
+
+size_t dsp_diagram_max_samples(const dsp_diagram_t* const diagram) {
+    return (diagram == NULL ? 0 : diagram->max_samples);
+}
+
+bool dsp_diagram_step(dsp_diagram_t* const diagram) {
+    return dsp_diagram_process(diagram, 1);
+}
+
+bool dsp_diagram_process(dsp_diagram_t* const diagram, const size_t n) {
+    if (diagram == NULL || !diagram->compiled) { return false; }
+    if (n > diagram->max_samples) { return false; }
+
+    const diagram_instruction_t* const instructions = diagram->instructions;
+    const size_t n_instructions = diagram->n_instructions;
+    if (diagram->sample_major) {
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t k = 0; k < n_instructions; ++k) { instructions[k].run(&instructions[k], j, 1); }
+        }
+    }
+    else {
+        for (size_t k = 0; k < n_instructions; ++k) { instructions[k].run(&instructions[k], 0, n); }
+    }
+    return true;
+}
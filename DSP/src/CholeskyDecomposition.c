@@ -0,0 +1,84 @@
+#include <string.h> // memcpy
+#include <math.h> // sqrtf, sqrt
+#include "DSP/Math/CholeskyDecomposition.h"
+#include "DSP/Math/Simd.h" // dsp_simd_dot_product, dsp_simd_axpy
+
+#define REAL_SIZE sizeof(real_t)
+#define ELEMENT(chol, row_index, column_index) ((chol)->elements[(row_index) * (chol)->size + (column_index)])
+
+
+// Workspace
+size_t dsp_matrix_chol_workspace_size(const size_t size) {
+    return dsp_workspace_block_size(size * size * REAL_SIZE);
+}
+
+bool dsp_matrix_chol_init(dsp_matrix_chol_t* const chol, const size_t size, dsp_workspace_t* const ws) {
+    if (chol == NULL || ws == NULL) { return false; }
+    if (size == 0) { return false; }
+
+    chol->size = size;
+    chol->indefinite = true;
+    chol->elements = (real_t*) dsp_workspace_take(ws, size * size * REAL_SIZE);
+    return (chol->elements != NULL);
+}
+
+
+
+// Factor
+bool dsp_matrix_chol_factor(dsp_matrix_chol_t* const chol, const dsp_matrix_t* const mat) {
+    if (chol == NULL || mat == NULL) { return false; }
+    if (mat->rows != chol->size || mat->columns != chol->size) { return false; }
+
+    const size_t n = chol->size;
+    chol->indefinite = false;
+
+    // Row by row, L(i,j) only needs the rows i and j left of column j
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            const real_t s = mat->elements[i * n + j] - dsp_simd_dot_product(&ELEMENT(chol, i, 0), &ELEMENT(chol, j, 0), j);
+            if (i == j) {
+                if (!(s > 0)) { chol->indefinite = true; return false; }
+                ELEMENT(chol, i, i) = REAL_SQRT(s);
+            }
+            else {
+                ELEMENT(chol, i, j) = s / ELEMENT(chol, j, j);
+            }
+        }
+    }
+
+    return true;
+}
+
+real_t dsp_matrix_chol_det(const dsp_matrix_chol_t* const chol) {
+    if (chol == NULL) { return 0; }
+    if (chol->indefinite) { return 0; }
+
+    real_t det = 1;
+    for (size_t k = 0; k < chol->size; ++k) { det *= ELEMENT(chol, k, k); }
+    return det * det;
+}
+
+
+
+// Solve
+bool dsp_matrix_chol_solve(const dsp_matrix_chol_t* const chol, real_t* const x, const real_t* const b) {
+    if (chol == NULL || x == NULL || b == NULL) { return false; }
+    if (chol->indefinite) { return false; }
+
+    const size_t n = chol->size;
+    if (x != b) { memcpy(x, b, n * REAL_SIZE); }
+
+    // L * y = b (forward substitution)
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = (x[i] - dsp_simd_dot_product(&ELEMENT(chol, i, 0), x, i)) / ELEMENT(chol, i, i);
+    }
+
+    // L^T * x = y (backward substitution), row i of L is column i of L^T
+    for (size_t i = n; i > 0; /*--i*/) {
+        --i;
+        x[i] /= ELEMENT(chol, i, i);
+        dsp_simd_axpy(x, -x[i], &ELEMENT(chol, i, 0), i);
+    }
+
+    return true;
+}
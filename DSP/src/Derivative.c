@@ -1,5 +1,5 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/Derivative.h"
 #include "DSP/Discrete/Discontinuous.h"
 
@@ -7,14 +7,14 @@
 dsp_derivative_t* dsp_derivative_create(const real_t K, const real_t N, const real_t Ts, const s_approximation_t DF, const bool limit_output, const real_t upper_limit, const real_t lower_limit) {
 
     // Create a new derivative
-    dsp_derivative_t* const derivative = (dsp_derivative_t*) malloc(sizeof(dsp_derivative_t));
+    dsp_derivative_t* const derivative = (dsp_derivative_t*) dsp_malloc(sizeof(dsp_derivative_t));
     if (derivative == NULL) { return 0; }
 
     if (dsp_derivative_configure(derivative, K, N, Ts, DF, limit_output, upper_limit, lower_limit)) {
         return derivative;
     }
     else {
-        free(derivative);
+        dsp_free(derivative);
         return NULL;
     }
 }
@@ -23,14 +23,14 @@ dsp_derivative_t* dsp_derivative_create_copy(const dsp_derivative_t* const other
     if (other == NULL) { return NULL; }
 
     // Create a new derivative
-    dsp_derivative_t* const derivative = (dsp_derivative_t*) malloc(sizeof(dsp_derivative_t));
+    dsp_derivative_t* const derivative = (dsp_derivative_t*) dsp_malloc(sizeof(dsp_derivative_t));
     if (derivative == NULL) { return NULL; }
 
     if (dsp_derivative_copy_assign(derivative, other)) {
         return derivative;
     }
     else {
-        free(derivative);
+        dsp_free(derivative);
         return NULL;
     }
 }
@@ -74,7 +74,7 @@ bool dsp_derivative_swap(dsp_derivative_t* const a, dsp_derivative_t* const b) {
 bool dsp_derivative_destroy(dsp_derivative_t* const derivative) {
     if (derivative == NULL) { return false; }
 
-    free(derivative);
+    dsp_free(derivative);
     return true;
 }
 
@@ -1,6 +1,6 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memset
 #include <math.h> // round, ceil, floor, pow
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 
 #include "DSP/Discrete/Discontinuous.h"
 
@@ -35,7 +35,7 @@ real_t dsp_discontinuous_clamp_if(const bool enabled, const real_t x, const real
 
 
 dsp_saturation_t* dsp_saturation_create(const real_t upper_limit, const real_t lower_limit) {
-    dsp_saturation_t* const saturation = (dsp_saturation_t*) malloc(sizeof(dsp_saturation_t));
+    dsp_saturation_t* const saturation = (dsp_saturation_t*) dsp_malloc(sizeof(dsp_saturation_t));
     if (saturation == NULL) { return NULL; } 
 
     dsp_saturation_set_limits(saturation, upper_limit, lower_limit);
@@ -67,7 +67,7 @@ real_t dsp_saturation_get_output(dsp_saturation_t* const saturation) {
 
 bool dsp_saturation_destroy(dsp_saturation_t* const saturation) {
     if (saturation == NULL) { return false; } 
-    free(saturation);
+    dsp_free(saturation);
     return true;
 }
 
@@ -77,7 +77,7 @@ bool dsp_saturation_destroy(dsp_saturation_t* const saturation) {
 
 
 dsp_dead_zone_t* dsp_dead_zone_create(const real_t upper_limit, const real_t lower_limit) {
-    dsp_dead_zone_t* const dead_zone = (dsp_dead_zone_t*) malloc(sizeof(dsp_dead_zone_t));
+    dsp_dead_zone_t* const dead_zone = (dsp_dead_zone_t*) dsp_malloc(sizeof(dsp_dead_zone_t));
     if (dead_zone == NULL) { return NULL; } 
 
     dsp_dead_zone_set_limits(dead_zone, upper_limit, lower_limit);
@@ -108,7 +108,7 @@ real_t dsp_dead_zone_get_output(dsp_dead_zone_t* const dead_zone) {
 
 bool dsp_dead_zone_destroy(dsp_dead_zone_t* const dead_zone) {
     if (dead_zone == NULL) { return false; } 
-    free(dead_zone);
+    dsp_free(dead_zone);
     return true;
 }
 
@@ -116,7 +116,7 @@ bool dsp_dead_zone_destroy(dsp_dead_zone_t* const dead_zone) {
 
 
 dsp_rate_limiter_t* dsp_rate_limiter_create(const real_t upper_rate, const real_t lower_rate, const real_t Ts, const real_t initial_output) {
-    dsp_rate_limiter_t* const rate_limiter = (dsp_rate_limiter_t*) malloc(sizeof(dsp_rate_limiter_t));
+    dsp_rate_limiter_t* const rate_limiter = (dsp_rate_limiter_t*) dsp_malloc(sizeof(dsp_rate_limiter_t));
     if (rate_limiter == NULL) { return NULL; }
 
     dsp_rate_limiter_set_limits(rate_limiter, upper_rate, lower_rate, Ts);
@@ -161,7 +161,7 @@ real_t dsp_rate_limiter_get_output(dsp_rate_limiter_t* const rate_limiter) {
 
 bool dsp_rate_limiter_destroy(dsp_rate_limiter_t* const rate_limiter) {
     if (rate_limiter == NULL) { return false; }
-    free(rate_limiter);
+    dsp_free(rate_limiter);
     return true;
 }
 
@@ -170,7 +170,7 @@ bool dsp_rate_limiter_destroy(dsp_rate_limiter_t* const rate_limiter) {
 
 
 dsp_quantization_t* dsp_quantizer_create(const real_t offset, const real_t interval, const rounding_method_t method) {
-    dsp_quantization_t* const quantizer = (dsp_quantization_t*) malloc(sizeof(dsp_quantization_t));
+    dsp_quantization_t* const quantizer = (dsp_quantization_t*) dsp_malloc(sizeof(dsp_quantization_t));
     if (quantizer == NULL) { return NULL; }
 
     dsp_quantizer_set_parameters(quantizer, offset, interval, method);
@@ -178,12 +178,12 @@ dsp_quantization_t* dsp_quantizer_create(const real_t offset, const real_t inter
 }
 
 dsp_quantization_t* dsp_rounding_create(const size_t precision, const rounding_method_t method) {
-    const real_t interval = powf(10, (-1) * ((real_t) precision));
+    const real_t interval = REAL_POW(10, (-1) * ((real_t) precision));
     return dsp_quantizer_create(0, interval, method);
 }
 
 bool dsp_rounding_set_precision(dsp_quantization_t* const rounder, const size_t precision, const rounding_method_t method) {
-    const real_t interval = powf(10, (-1) * ((real_t) precision));
+    const real_t interval = REAL_POW(10, (-1) * ((real_t) precision));
     return dsp_quantizer_set_parameters(rounder, 0, interval, method);
 }
 
@@ -194,16 +194,16 @@ bool dsp_quantizer_set_parameters(dsp_quantization_t* const quantizer, const rea
     quantizer->interval = interval;
     switch (method) {
         case RoundDown:
-            quantizer->round_func = floorf;
+            quantizer->round_func = REAL_FLOOR;
             break;
         case RoundUp:
-            quantizer->round_func = ceilf;
+            quantizer->round_func = REAL_CEIL;
             break;
         case RoundMath:
-            quantizer->round_func = roundf;
+            quantizer->round_func = REAL_ROUND;
             break;
         default:
-            quantizer->round_func = roundf;
+            quantizer->round_func = REAL_ROUND;
             break;
     }
     return true;
@@ -226,7 +226,7 @@ real_t dsp_quantizer_get_output(dsp_quantization_t* const quantizer) {
 
 bool dsp_quantizer_destroy(dsp_quantization_t* const quantizer) {
     if (quantizer == NULL) { return false; }
-    free(quantizer);
+    dsp_free(quantizer);
     return true;
 }
 
@@ -247,7 +247,7 @@ dsp_schmitt_trigger_t* dsp_schmitt_trigger_create (
     if (low_level_output >= high_level_output) { return NULL; }
 
     // Allocate a new Schmitt Trigger
-    dsp_schmitt_trigger_t* trigger = (dsp_schmitt_trigger_t*) malloc(sizeof(dsp_schmitt_trigger_t));
+    dsp_schmitt_trigger_t* trigger = (dsp_schmitt_trigger_t*) dsp_malloc(sizeof(dsp_schmitt_trigger_t));
     if (trigger == NULL) { return NULL; }
 
     // Configure Schmitt Trigger
@@ -341,7 +341,7 @@ real_t dsp_schmitt_trigger_update(dsp_schmitt_trigger_t* const trigger, const re
 
 bool dsp_schmitt_trigger_destroy(dsp_schmitt_trigger_t* const trigger) {
     if (trigger == NULL) { return false; }
-    free(trigger);
+    dsp_free(trigger);
     return true;
 }
 
@@ -353,7 +353,7 @@ bool dsp_schmitt_trigger_destroy(dsp_schmitt_trigger_t* const trigger) {
 dsp_schmitt_quantization_t* dsp_schmitt_quantizer_create(const real_t offset, const real_t interval, const real_t high_level_hysteresis, const real_t low_level_hysteresis, const real_t initial_output) {
 
     // Allocate a new Schmitt Quantizer
-    dsp_schmitt_quantization_t* const quantizer = (dsp_schmitt_quantization_t*) malloc(sizeof(dsp_schmitt_quantization_t));
+    dsp_schmitt_quantization_t* const quantizer = (dsp_schmitt_quantization_t*) dsp_malloc(sizeof(dsp_schmitt_quantization_t));
     if (quantizer == NULL) { return NULL; }
 
     // Configure Schmitt Quantizer
@@ -422,7 +422,7 @@ bool dsp_schmitt_quantizer_set_hysteresis(dsp_schmitt_quantization_t* const quan
 bool dsp_schmitt_quantizer_set_output(dsp_schmitt_quantization_t* const quantizer, const real_t initial_output) {
     if (quantizer == NULL) { return false; }
     // y = c + q * round((u - c) / q)
-    quantizer->output = quantizer->offset + quantizer->interval * roundf((initial_output - quantizer->offset) / quantizer->interval);
+    quantizer->output = quantizer->offset + quantizer->interval * REAL_ROUND((initial_output - quantizer->offset) / quantizer->interval);
     return true;
 }
 
@@ -455,6 +455,6 @@ real_t dsp_schmitt_quantizer_update(dsp_schmitt_quantization_t* const quantizer,
 
 bool dsp_schmitt_quantizer_destroy(dsp_schmitt_quantization_t* const quantizer) {
     if (quantizer == NULL) { return false; }
-    free(quantizer);
+    dsp_free(quantizer);
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,543 @@
+#include <string.h> // memset
+#include <math.h> // roundf, floorf, ceilf, round, floor, ceil
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Math/Simd.h" // dsp_simd_selected
+#include "DSP/Discrete/DiscontinuousBank.h"
+
+// The vector kernels work on 32-bit floats
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(DSP_PRECISION_DOUBLE)
+#define BANK_X86 1
+#include <immintrin.h>
+#endif
+
+
+// Packed arrays: every array starts on its own cache line
+#define BANK_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (BANK_ALIGNMENT - 1)) & ~((uintptr_t) BANK_ALIGNMENT - 1))
+#define PACKED_SIZE(count) ((((count) * sizeof(real_t)) + (BANK_ALIGNMENT - 1)) & ~((size_t) BANK_ALIGNMENT - 1))
+
+#define MASK(enabled) ((enabled) ? 0xFFFFFFFFu : 0u)
+
+// Allocate a bank struct followed by 'count' zeroed arrays of 'channels' elements,
+// 'arrays' receives the address of the first one (the others follow every 'PACKED_SIZE(channels)' bytes)
+static void* create_bank(const size_t bank_size, const size_t channels, const size_t count, unsigned char** const arrays) {
+    if (channels == 0) { return NULL; }
+
+    const size_t arrays_size = count * PACKED_SIZE(channels);
+    unsigned char* const block = (unsigned char*) dsp_malloc(bank_size + BANK_ALIGNMENT + arrays_size);
+    if (block == NULL) { return NULL; }
+
+    *arrays = (unsigned char*) ALIGN_UP((uintptr_t) &block[bank_size]);
+    memset(*arrays, 0, arrays_size);
+    return block;
+}
+
+// Take the next array of a bank
+static real_t* next_array(unsigned char** const arrays, const size_t channels) {
+    real_t* const array = (real_t*) *arrays;
+    *arrays += PACKED_SIZE(channels);
+    return array;
+}
+
+#ifdef BANK_X86
+// Use the 8-lane AVX kernels
+static bool use_avx() {
+    const dsp_simd_isa_t isa = dsp_simd_selected();
+    return (isa == SimdAVX2 || isa == SimdAVX512);
+}
+#endif
+
+
+#ifdef BANK_X86
+
+#define AVX_SELECT(mask, a, b) _mm256_blendv_ps((b), (a), (mask))
+#define AVX_MASK(array, k) _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*) &(array)[k]))
+
+// roundf(): round half away from zero (x - trunc(x) is exact)
+__attribute__((target("avx")))
+static inline __m256 avx_roundf(const __m256 x) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 t = _mm256_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256 away = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(x, t)), _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    const __m256 one = _mm256_or_ps(_mm256_and_ps(sign, x), _mm256_set1_ps(1.0f));
+    return _mm256_add_ps(t, _mm256_and_ps(away, one));
+}
+
+#endif // BANK_X86
+
+
+
+
+// ----- Saturation -----
+
+dsp_saturation_bank_t* dsp_saturation_bank_create(const size_t channels, const real_t upper_limit, const real_t lower_limit) {
+    unsigned char* arrays = NULL;
+    dsp_saturation_bank_t* const bank = (dsp_saturation_bank_t*) create_bank(sizeof(dsp_saturation_bank_t), channels, 3, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->UpperLimit = next_array(&arrays, channels);
+    bank->LowerLimit = next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) { bank->UpperLimit[k] = upper_limit; bank->LowerLimit[k] = lower_limit; }
+    return bank;
+}
+
+bool dsp_saturation_bank_set_channel(dsp_saturation_bank_t* const bank, const size_t channel, const dsp_saturation_t* const saturation) {
+    if (bank == NULL || saturation == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->UpperLimit[channel] = saturation->UpperLimit;
+    bank->LowerLimit[channel] = saturation->LowerLimit;
+    return true;
+}
+
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_saturation(dsp_saturation_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 u = _mm256_loadu_ps(&in[k]);
+        const __m256 upper = _mm256_loadu_ps(&bank->UpperLimit[k]);
+        const __m256 lower = _mm256_loadu_ps(&bank->LowerLimit[k]);
+        __m256 y = AVX_SELECT(_mm256_cmp_ps(u, lower, _CMP_LE_OQ), lower, u);
+        y = AVX_SELECT(_mm256_cmp_ps(u, upper, _CMP_GE_OQ), upper, y);
+        _mm256_storeu_ps(&bank->output[k], y);
+        _mm256_storeu_ps(&out[k], y);
+    }
+    return k;
+}
+#endif
+
+bool dsp_saturation_bank_update(dsp_saturation_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_saturation(bank, in, out); }
+#endif
+    for (; k < bank->channels; ++k) {
+        const real_t u = in[k];
+        real_t y = (u <= bank->LowerLimit[k] ? bank->LowerLimit[k] : u);
+        y = (u >= bank->UpperLimit[k] ? bank->UpperLimit[k] : y);
+        bank->output[k] = y;
+        out[k] = y;
+    }
+    return true;
+}
+
+bool dsp_saturation_bank_destroy(dsp_saturation_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+
+// ----- Dead Zone -----
+
+dsp_dead_zone_bank_t* dsp_dead_zone_bank_create(const size_t channels, const real_t upper_limit, const real_t lower_limit) {
+    unsigned char* arrays = NULL;
+    dsp_dead_zone_bank_t* const bank = (dsp_dead_zone_bank_t*) create_bank(sizeof(dsp_dead_zone_bank_t), channels, 3, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->UpperLimit = next_array(&arrays, channels);
+    bank->LowerLimit = next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) { bank->UpperLimit[k] = upper_limit; bank->LowerLimit[k] = lower_limit; }
+    return bank;
+}
+
+bool dsp_dead_zone_bank_set_channel(dsp_dead_zone_bank_t* const bank, const size_t channel, const dsp_dead_zone_t* const dead_zone) {
+    if (bank == NULL || dead_zone == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->UpperLimit[channel] = dead_zone->UpperLimit;
+    bank->LowerLimit[channel] = dead_zone->LowerLimit;
+    return true;
+}
+
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_dead_zone(dsp_dead_zone_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 u = _mm256_loadu_ps(&in[k]);
+        const __m256 upper = _mm256_loadu_ps(&bank->UpperLimit[k]);
+        const __m256 lower = _mm256_loadu_ps(&bank->LowerLimit[k]);
+        __m256 y = AVX_SELECT(_mm256_cmp_ps(u, lower, _CMP_LT_OQ), _mm256_sub_ps(u, lower), _mm256_setzero_ps());
+        y = AVX_SELECT(_mm256_cmp_ps(u, upper, _CMP_GT_OQ), _mm256_sub_ps(u, upper), y);
+        _mm256_storeu_ps(&bank->output[k], y);
+        _mm256_storeu_ps(&out[k], y);
+    }
+    return k;
+}
+#endif
+
+bool dsp_dead_zone_bank_update(dsp_dead_zone_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_dead_zone(bank, in, out); }
+#endif
+    for (; k < bank->channels; ++k) {
+        const real_t u = in[k];
+        real_t y = (u < bank->LowerLimit[k] ? u - bank->LowerLimit[k] : 0);
+        y = (u > bank->UpperLimit[k] ? u - bank->UpperLimit[k] : y);
+        bank->output[k] = y;
+        out[k] = y;
+    }
+    return true;
+}
+
+bool dsp_dead_zone_bank_destroy(dsp_dead_zone_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+
+// ----- Rate Limiter -----
+
+dsp_rate_limiter_bank_t* dsp_rate_limiter_bank_create(const size_t channels, const real_t upper_rate, const real_t lower_rate, const real_t Ts, const real_t initial_output) {
+    unsigned char* arrays = NULL;
+    dsp_rate_limiter_bank_t* const bank = (dsp_rate_limiter_bank_t*) create_bank(sizeof(dsp_rate_limiter_bank_t), channels, 3, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->UpperLimit = next_array(&arrays, channels);
+    bank->LowerLimit = next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) {
+        bank->UpperLimit[k] = upper_rate * Ts;
+        bank->LowerLimit[k] = lower_rate * Ts;
+        bank->output[k] = initial_output;
+    }
+    return bank;
+}
+
+bool dsp_rate_limiter_bank_set_channel(dsp_rate_limiter_bank_t* const bank, const size_t channel, const dsp_rate_limiter_t* const rate_limiter) {
+    if (bank == NULL || rate_limiter == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->UpperLimit[channel] = rate_limiter->UpperLimit;
+    bank->LowerLimit[channel] = rate_limiter->LowerLimit;
+    bank->output[channel] = rate_limiter->output;
+    return true;
+}
+
+bool dsp_rate_limiter_bank_reset(dsp_rate_limiter_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    memset(bank->output, 0, bank->channels * sizeof(real_t));
+    return true;
+}
+
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_rate_limiter(dsp_rate_limiter_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 y = _mm256_loadu_ps(&bank->output[k]);
+        const __m256 upper = _mm256_loadu_ps(&bank->UpperLimit[k]);
+        const __m256 lower = _mm256_loadu_ps(&bank->LowerLimit[k]);
+        const __m256 change = _mm256_sub_ps(_mm256_loadu_ps(&in[k]), y);
+        __m256 step = AVX_SELECT(_mm256_cmp_ps(change, lower, _CMP_LT_OQ), lower, change);
+        step = AVX_SELECT(_mm256_cmp_ps(change, upper, _CMP_GT_OQ), upper, step);
+        const __m256 yn = _mm256_add_ps(y, step);
+        _mm256_storeu_ps(&bank->output[k], yn);
+        _mm256_storeu_ps(&out[k], yn);
+    }
+    return k;
+}
+#endif
+
+bool dsp_rate_limiter_bank_update(dsp_rate_limiter_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_rate_limiter(bank, in, out); }
+#endif
+    for (; k < bank->channels; ++k) {
+        const real_t change = in[k] - bank->output[k];
+        real_t step = (change < bank->LowerLimit[k] ? bank->LowerLimit[k] : change);
+        step = (change > bank->UpperLimit[k] ? bank->UpperLimit[k] : step);
+        bank->output[k] += step;
+        out[k] = bank->output[k];
+    }
+    return true;
+}
+
+bool dsp_rate_limiter_bank_destroy(dsp_rate_limiter_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+
+// ----- Quantization -----
+
+dsp_quantization_bank_t* dsp_quantizer_bank_create(const size_t channels, const real_t offset, const real_t interval, const rounding_method_t method) {
+    unsigned char* arrays = NULL;
+    dsp_quantization_bank_t* const bank = (dsp_quantization_bank_t*) create_bank(sizeof(dsp_quantization_bank_t), channels, 3, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->method = (method == RoundDown || method == RoundUp ? method : RoundMath);
+    bank->offset = next_array(&arrays, channels);
+    bank->interval = next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) { bank->offset[k] = offset; bank->interval[k] = interval; }
+    return bank;
+}
+
+bool dsp_quantizer_bank_set_channel(dsp_quantization_bank_t* const bank, const size_t channel, const real_t offset, const real_t interval) {
+    if (bank == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->offset[channel] = offset;
+    bank->interval[channel] = interval;
+    return true;
+}
+
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_quantizer(dsp_quantization_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 offset = _mm256_loadu_ps(&bank->offset[k]);
+        const __m256 interval = _mm256_loadu_ps(&bank->interval[k]);
+        const __m256 x = _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(&in[k]), offset), interval);
+        __m256 r;
+        switch (bank->method) {
+            case RoundDown: r = _mm256_floor_ps(x); break;
+            case RoundUp: r = _mm256_ceil_ps(x); break;
+            default: r = avx_roundf(x); break;
+        }
+        const __m256 y = _mm256_add_ps(offset, _mm256_mul_ps(interval, r));
+        _mm256_storeu_ps(&bank->output[k], y);
+        _mm256_storeu_ps(&out[k], y);
+    }
+    return k;
+}
+#endif
+
+bool dsp_quantizer_bank_update(dsp_quantization_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_quantizer(bank, in, out); }
+#endif
+    const round_func_t round_func = (bank->method == RoundDown ? REAL_FLOOR : (bank->method == RoundUp ? REAL_CEIL : REAL_ROUND));
+    for (; k < bank->channels; ++k) {
+        // y = c + q * round((u - c) / q)
+        bank->output[k] = bank->offset[k] + bank->interval[k] * round_func((in[k] - bank->offset[k]) / bank->interval[k]);
+        out[k] = bank->output[k];
+    }
+    return true;
+}
+
+bool dsp_quantizer_bank_destroy(dsp_quantization_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+
+// ----- Schmitt Trigger -----
+
+dsp_schmitt_trigger_bank_t* dsp_schmitt_trigger_bank_create(const size_t channels, const dsp_schmitt_trigger_t* const trigger) {
+    if (trigger == NULL) { return NULL; }
+
+    unsigned char* arrays = NULL;
+    dsp_schmitt_trigger_bank_t* const bank = (dsp_schmitt_trigger_bank_t*) create_bank(sizeof(dsp_schmitt_trigger_bank_t), channels, 7, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->low_level_input = next_array(&arrays, channels);
+    bank->high_level_input = next_array(&arrays, channels);
+    bank->low_level_output = next_array(&arrays, channels);
+    bank->high_level_output = next_array(&arrays, channels);
+    bank->inverted = (uint32_t*) next_array(&arrays, channels);
+    bank->high = (uint32_t*) next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) { dsp_schmitt_trigger_bank_set_channel(bank, k, trigger); }
+    return bank;
+}
+
+bool dsp_schmitt_trigger_bank_set_channel(dsp_schmitt_trigger_bank_t* const bank, const size_t channel, const dsp_schmitt_trigger_t* const trigger) {
+    if (bank == NULL || trigger == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->low_level_input[channel] = trigger->low_level_input;
+    bank->high_level_input[channel] = trigger->high_level_input;
+    bank->low_level_output[channel] = trigger->low_level_output;
+    bank->high_level_output[channel] = trigger->high_level_output;
+    bank->inverted[channel] = MASK(trigger->inverted);
+    bank->high[channel] = MASK(trigger->normal_output == trigger->high_level_output);
+    bank->output[channel] = dsp_schmitt_trigger_get_output((dsp_schmitt_trigger_t*) trigger);
+    return true;
+}
+
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_schmitt_trigger(dsp_schmitt_trigger_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 u = _mm256_loadu_ps(&in[k]);
+        const __m256 low = _mm256_cmp_ps(u, _mm256_loadu_ps(&bank->low_level_input[k]), _CMP_LT_OQ);
+        const __m256 high = _mm256_cmp_ps(u, _mm256_loadu_ps(&bank->high_level_input[k]), _CMP_GT_OQ);
+        const __m256 state = _mm256_andnot_ps(low, _mm256_or_ps(high, AVX_MASK(bank->high, k)));
+        const __m256 y = AVX_SELECT(_mm256_xor_ps(state, AVX_MASK(bank->inverted, k)),
+            _mm256_loadu_ps(&bank->high_level_output[k]), _mm256_loadu_ps(&bank->low_level_output[k]));
+        _mm256_storeu_si256((__m256i*) &bank->high[k], _mm256_castps_si256(state));
+        _mm256_storeu_ps(&bank->output[k], y);
+        _mm256_storeu_ps(&out[k], y);
+    }
+    return k;
+}
+#endif
+
+bool dsp_schmitt_trigger_bank_update(dsp_schmitt_trigger_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_schmitt_trigger(bank, in, out); }
+#endif
+    for (; k < bank->channels; ++k) {
+        const uint32_t low = MASK(in[k] < bank->low_level_input[k]);
+        const uint32_t high = MASK(in[k] > bank->high_level_input[k]);
+        bank->high[k] = ~low & (high | bank->high[k]);
+        bank->output[k] = ((bank->high[k] ^ bank->inverted[k]) != 0 ? bank->high_level_output[k] : bank->low_level_output[k]);
+        out[k] = bank->output[k];
+    }
+    return true;
+}
+
+bool dsp_schmitt_trigger_bank_destroy(dsp_schmitt_trigger_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+
+// ----- Schmitt Quantization -----
+
+dsp_schmitt_quantization_bank_t* dsp_schmitt_quantizer_bank_create(const size_t channels, const dsp_schmitt_quantization_t* const quantizer) {
+    if (quantizer == NULL) { return NULL; }
+
+    unsigned char* arrays = NULL;
+    dsp_schmitt_quantization_bank_t* const bank = (dsp_schmitt_quantization_bank_t*) create_bank(sizeof(dsp_schmitt_quantization_bank_t), channels, 5, &arrays);
+    if (bank == NULL) { return NULL; }
+
+    bank->channels = channels;
+    bank->offset = next_array(&arrays, channels);
+    bank->interval = next_array(&arrays, channels);
+    bank->high_level_hysteresis = next_array(&arrays, channels);
+    bank->low_level_hysteresis = next_array(&arrays, channels);
+    bank->output = next_array(&arrays, channels);
+    bank->block = bank;
+
+    for (size_t k = 0; k < channels; ++k) { dsp_schmitt_quantizer_bank_set_channel(bank, k, quantizer); }
+    return bank;
+}
+
+bool dsp_schmitt_quantizer_bank_set_channel(dsp_schmitt_quantization_bank_t* const bank, const size_t channel, const dsp_schmitt_quantization_t* const quantizer) {
+    if (bank == NULL || quantizer == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    bank->offset[channel] = quantizer->offset;
+    bank->interval[channel] = quantizer->interval;
+    bank->high_level_hysteresis[channel] = quantizer->high_level_hysteresis;
+    bank->low_level_hysteresis[channel] = quantizer->low_level_hysteresis;
+    bank->output[channel] = quantizer->output;
+    return true;
+}
+
+// The single-channel update steps by one interval until the input is within the hysteresis.
+// Here all lanes step together, lanes that are done are masked out until every lane is done.
+#ifdef BANK_X86
+__attribute__((target("avx")))
+static size_t avx_schmitt_quantizer(dsp_schmitt_quantization_bank_t* const bank, const real_t* const in, real_t* const out) {
+    size_t k = 0;
+    for (; k + 8 <= bank->channels; k += 8) {
+        const __m256 u = _mm256_loadu_ps(&in[k]);
+        const __m256 offset = _mm256_loadu_ps(&bank->offset[k]);
+        const __m256 interval = _mm256_loadu_ps(&bank->interval[k]);
+        const __m256 high_level = _mm256_loadu_ps(&bank->high_level_hysteresis[k]);
+        const __m256 low_level = _mm256_loadu_ps(&bank->low_level_hysteresis[k]);
+        __m256 y = _mm256_loadu_ps(&bank->output[k]);
+
+        const __m256 up = _mm256_cmp_ps(_mm256_sub_ps(u, y), high_level, _CMP_GT_OQ);
+        const __m256 down = _mm256_andnot_ps(up, _mm256_cmp_ps(_mm256_sub_ps(y, u), low_level, _CMP_GT_OQ));
+        while (true) {
+            const __m256 step_up = _mm256_and_ps(up, _mm256_cmp_ps(_mm256_sub_ps(u, y), high_level, _CMP_GT_OQ));
+            const __m256 step_down = _mm256_and_ps(down, _mm256_cmp_ps(_mm256_sub_ps(y, u), low_level, _CMP_GT_OQ));
+            if (_mm256_movemask_ps(_mm256_or_ps(step_up, step_down)) == 0) { break; }
+            y = AVX_SELECT(step_up, _mm256_add_ps(y, interval), y);
+            y = AVX_SELECT(step_down, _mm256_sub_ps(y, interval), y);
+        }
+
+        // y = c + q * round((y - c) / q)
+        y = _mm256_add_ps(offset, _mm256_mul_ps(interval, avx_roundf(_mm256_div_ps(_mm256_sub_ps(y, offset), interval))));
+        _mm256_storeu_ps(&bank->output[k], y);
+        _mm256_storeu_ps(&out[k], y);
+    }
+    return k;
+}
+#endif
+
+bool dsp_schmitt_quantizer_bank_update(dsp_schmitt_quantization_bank_t* const bank, const real_t* const in, real_t* const out) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    size_t k = 0;
+#ifdef BANK_X86
+    if (use_avx()) { k = avx_schmitt_quantizer(bank, in, out); }
+#endif
+    for (; k < bank->channels; ++k) {
+        const real_t u = in[k];
+        const real_t interval = bank->interval[k];
+        real_t y = bank->output[k];
+        if (u - y > bank->high_level_hysteresis[k]) {
+            while (u - y > bank->high_level_hysteresis[k]) { y += interval; }
+        }
+        else {
+            while (y - u > bank->low_level_hysteresis[k]) { y -= interval; }
+        }
+
+        // y = c + q * round((y - c) / q)
+        bank->output[k] = bank->offset[k] + interval * REAL_ROUND((y - bank->offset[k]) / interval);
+        out[k] = bank->output[k];
+    }
+    return true;
+}
+
+bool dsp_schmitt_quantizer_bank_destroy(dsp_schmitt_quantization_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+    dsp_free(bank->block);
+    return true;
+}
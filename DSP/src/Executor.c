@@ -0,0 +1,371 @@
+#ifdef DSP_THREADS
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include <pthread.h>
+#include <sched.h> // cpu_set_t
+#include <unistd.h> // sysconf
+#endif
+
+#include <string.h> // memset
+#include <stdint.h> // uintptr_t
+#include <time.h> // clock_gettime
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Parallel/Executor.h"
+
+// Every worker record on its own cache lines, so timing and flags of two workers never share a line
+#define EXECUTOR_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (EXECUTOR_ALIGNMENT - 1)) & ~((uintptr_t) EXECUTOR_ALIGNMENT - 1))
+
+// Polls of the job counter before a waiting thread goes to sleep
+#define SPIN_COUNT 4096
+
+// Ranges of the banks: a cache line of values
+#define BANK_GRANULARITY (EXECUTOR_ALIGNMENT / sizeof(real_t))
+
+
+typedef struct ExecutorWorker {
+    dsp_executor_stats_t stats;
+    struct Executor* executor;
+    size_t index;
+#ifdef DSP_THREADS
+    pthread_t thread;
+#endif
+} executor_worker_t;
+
+#define WORKER_SIZE ALIGN_UP(sizeof(executor_worker_t))
+
+struct Executor {
+
+    size_t workers;
+    size_t inline_threshold;
+
+    // Current job
+    dsp_executor_task_t task;
+    void* context;
+    size_t n;
+    size_t chunk;
+
+    // Incremented for every job (and to stop the workers), background workers still busy with the job
+    uint64_t generation;
+    size_t pending;
+    bool stop;
+
+#ifdef DSP_THREADS
+    pthread_mutex_t lock;
+    pthread_cond_t start; // new generation
+    pthread_cond_t done; // pending reached zero
+#endif
+
+    // 'workers' records of WORKER_SIZE bytes
+    unsigned char* worker;
+
+    // Internal: struct and worker records in one allocation
+    void* block;
+};
+
+#define WORKER(executor, k) ((executor_worker_t*) &((executor)->worker[(k) * WORKER_SIZE]))
+
+
+
+static uint64_t now_ns() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+// Run the range of one worker of the current job and record its timing
+static void run_range(struct Executor* const executor, executor_worker_t* const worker) {
+    const size_t first = worker->index * executor->chunk;
+    if (first >= executor->n) { return; }
+    const size_t count = (executor->n - first < executor->chunk ? executor->n - first : executor->chunk);
+
+    const uint64_t start = now_ns();
+    executor->task(executor->context, first, count);
+    const uint64_t elapsed = now_ns() - start;
+
+    worker->stats.ticks += 1;
+    worker->stats.items += count;
+    worker->stats.last_ns = elapsed;
+    worker->stats.total_ns += elapsed;
+    if (elapsed > worker->stats.max_ns) { worker->stats.max_ns = elapsed; }
+}
+
+
+
+#ifdef DSP_THREADS
+
+static void* worker_main(void* const argument) {
+    executor_worker_t* const worker = (executor_worker_t*) argument;
+    struct Executor* const executor = worker->executor;
+    uint64_t seen = 0;
+
+    while (true) {
+
+        // Wait for the next job: spin first (short ticks), then sleep
+        uint64_t generation = __atomic_load_n(&executor->generation, __ATOMIC_ACQUIRE);
+        for (size_t k = 0; k < SPIN_COUNT && generation == seen; ++k) {
+            generation = __atomic_load_n(&executor->generation, __ATOMIC_ACQUIRE);
+        }
+        if (generation == seen) {
+            pthread_mutex_lock(&executor->lock);
+            while ((generation = __atomic_load_n(&executor->generation, __ATOMIC_ACQUIRE)) == seen) {
+                pthread_cond_wait(&executor->start, &executor->lock);
+            }
+            pthread_mutex_unlock(&executor->lock);
+        }
+        seen = generation;
+        if (executor->stop) { break; }
+
+        run_range(executor, worker);
+
+        // The last worker wakes the caller
+        if (__atomic_sub_fetch(&executor->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&executor->lock);
+            pthread_cond_signal(&executor->done);
+            pthread_mutex_unlock(&executor->lock);
+        }
+    }
+    return NULL;
+}
+
+// Publish the job (or the stop flag) to the background workers
+static void start_generation(struct Executor* const executor) {
+    pthread_mutex_lock(&executor->lock);
+    __atomic_add_fetch(&executor->generation, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&executor->start);
+    pthread_mutex_unlock(&executor->lock);
+}
+
+// Barrier: wait until all background workers are done
+static void wait_for_workers(struct Executor* const executor) {
+    for (size_t k = 0; k < SPIN_COUNT; ++k) {
+        if (__atomic_load_n(&executor->pending, __ATOMIC_ACQUIRE) == 0) { return; }
+    }
+    pthread_mutex_lock(&executor->lock);
+    while (__atomic_load_n(&executor->pending, __ATOMIC_ACQUIRE) != 0) {
+        pthread_cond_wait(&executor->done, &executor->lock);
+    }
+    pthread_mutex_unlock(&executor->lock);
+}
+
+// Stop and join the background workers [1, started)
+static void stop_workers(struct Executor* const executor, const size_t started) {
+    executor->stop = true;
+    start_generation(executor);
+    for (size_t k = 1; k < started; ++k) {
+        pthread_join(WORKER(executor, k)->thread, NULL);
+    }
+    pthread_cond_destroy(&executor->done);
+    pthread_cond_destroy(&executor->start);
+    pthread_mutex_destroy(&executor->lock);
+}
+
+#endif // DSP_THREADS
+
+
+
+// Create
+dsp_executor_t* dsp_executor_create(const size_t workers, const int* const cpus) {
+
+#ifdef DSP_THREADS
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t n_workers = (workers != 0 ? workers : (online > 0 ? (size_t) online : 1));
+#else
+    (void) workers;
+    (void) cpus;
+    const size_t n_workers = 1;
+#endif
+
+    // Layout: the executor struct, then the worker records
+    unsigned char* const block = (unsigned char*) dsp_malloc(sizeof(struct Executor) + EXECUTOR_ALIGNMENT + n_workers * WORKER_SIZE);
+    if (block == NULL) { return NULL; }
+
+    struct Executor* const executor = (struct Executor*) block;
+    memset(executor, 0, sizeof(struct Executor));
+    executor->workers = n_workers;
+    executor->inline_threshold = DSP_EXECUTOR_INLINE_ITEMS;
+    executor->worker = (unsigned char*) ALIGN_UP((uintptr_t) &block[sizeof(struct Executor)]);
+    executor->block = block;
+    memset(executor->worker, 0, n_workers * WORKER_SIZE);
+    for (size_t k = 0; k < n_workers; ++k) {
+        WORKER(executor, k)->executor = executor;
+        WORKER(executor, k)->index = k;
+    }
+
+#ifdef DSP_THREADS
+    pthread_mutex_init(&executor->lock, NULL);
+    pthread_cond_init(&executor->start, NULL);
+    pthread_cond_init(&executor->done, NULL);
+
+    for (size_t k = 1; k < n_workers; ++k) {
+        executor_worker_t* const worker = WORKER(executor, k);
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+#ifdef __linux__
+        // Pinned before the thread starts, so it never runs on another CPU
+        if (cpus != NULL && cpus[k - 1] >= 0 && cpus[k - 1] < CPU_SETSIZE) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[k - 1], &set);
+            pthread_attr_setaffinity_np(&attributes, sizeof(cpu_set_t), &set);
+        }
+#else
+        (void) cpus;
+#endif
+        const bool started = (pthread_create(&worker->thread, &attributes, worker_main, worker) == 0);
+        pthread_attr_destroy(&attributes);
+
+        if (!started) {
+            stop_workers(executor, k);
+            dsp_free(block);
+            return NULL;
+        }
+    }
+#endif
+
+    return executor;
+}
+
+// Destroy
+bool dsp_executor_destroy(dsp_executor_t* const executor) {
+    if (executor == NULL) { return false; }
+
+#ifdef DSP_THREADS
+    stop_workers(executor, executor->workers);
+#endif
+
+    // The struct lives at the beginning of the block
+    dsp_free(executor->block);
+    return true;
+}
+
+size_t dsp_executor_workers(const dsp_executor_t* const executor) {
+    return (executor == NULL ? 0 : executor->workers);
+}
+
+bool dsp_executor_set_inline_threshold(dsp_executor_t* const executor, const size_t items) {
+    if (executor == NULL) { return false; }
+    executor->inline_threshold = items;
+    return true;
+}
+
+
+
+// Run the current job on all workers
+static void dispatch(struct Executor* const executor) {
+#ifdef DSP_THREADS
+    if (executor->workers > 1) {
+        __atomic_store_n(&executor->pending, executor->workers - 1, __ATOMIC_RELEASE);
+        start_generation(executor);
+        run_range(executor, WORKER(executor, 0));
+        wait_for_workers(executor);
+        return;
+    }
+#endif
+    run_range(executor, WORKER(executor, 0));
+}
+
+// Run
+bool dsp_executor_run(dsp_executor_t* const executor, const size_t n, const size_t granularity, dsp_executor_task_t task, void* const context) {
+    if (executor == NULL || task == NULL) { return false; }
+    if (n == 0) { return true; }
+
+    executor->task = task;
+    executor->context = context;
+    executor->n = n;
+
+    // Small jobs: the caller alone, no synchronization
+    if (executor->workers == 1 || n < executor->inline_threshold) {
+        executor->chunk = n;
+        run_range(executor, WORKER(executor, 0));
+        return true;
+    }
+
+    // One range per worker, rounded up to the granularity
+    const size_t step = (granularity == 0 ? 1 : granularity);
+    const size_t chunk = (n + executor->workers - 1) / executor->workers;
+    executor->chunk = ((chunk + step - 1) / step) * step;
+
+    dispatch(executor);
+    return true;
+}
+
+bool dsp_executor_broadcast(dsp_executor_t* const executor, dsp_executor_task_t task, void* const context) {
+    if (executor == NULL || task == NULL) { return false; }
+
+    // Range of worker k: [k, k + 1)
+    executor->task = task;
+    executor->context = context;
+    executor->n = executor->workers;
+    executor->chunk = 1;
+
+    dispatch(executor);
+    return true;
+}
+
+
+
+// Stats
+bool dsp_executor_get_stats(const dsp_executor_t* const executor, const size_t worker, dsp_executor_stats_t* const stats) {
+    if (executor == NULL || stats == NULL) { return false; }
+    if (worker >= executor->workers) { return false; }
+
+    *stats = WORKER(executor, worker)->stats;
+    return true;
+}
+
+bool dsp_executor_reset_stats(dsp_executor_t* const executor) {
+    if (executor == NULL) { return false; }
+
+    for (size_t k = 0; k < executor->workers; ++k) {
+        memset(&WORKER(executor, k)->stats, 0, sizeof(dsp_executor_stats_t));
+    }
+    return true;
+}
+
+
+
+// ----- Banks -----
+
+typedef struct ExecutorBankJob {
+    void* bank;
+    const real_t* u;
+    real_t* y;
+} executor_bank_job_t;
+
+static void pid_bank_task(void* const context, const size_t first, const size_t count) {
+    executor_bank_job_t* const job = (executor_bank_job_t*) context;
+    dsp_pid_bank_update_range((dsp_pid_bank_t*) job->bank, first, count, job->u, job->y);
+}
+
+static void ztf_bank_task(void* const context, const size_t first, const size_t count) {
+    executor_bank_job_t* const job = (executor_bank_job_t*) context;
+    dsp_ztf_bank_update_range((dsp_ztf_bank_t*) job->bank, first, count, job->u, job->y);
+}
+
+static void zss_bank_task(void* const context, const size_t first, const size_t count) {
+    executor_bank_job_t* const job = (executor_bank_job_t*) context;
+    dsp_zss_bank_update_range((dsp_zss_bank_t*) job->bank, first, count, job->u, job->y);
+}
+
+bool dsp_executor_pid_bank_update(dsp_executor_t* const executor, dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (executor == NULL || bank == NULL || u == NULL || y == NULL) { return false; }
+
+    executor_bank_job_t job = {bank, u, y};
+    return dsp_executor_run(executor, bank->size, BANK_GRANULARITY, pid_bank_task, &job);
+}
+
+bool dsp_executor_ztf_bank_update(dsp_executor_t* const executor, dsp_ztf_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (executor == NULL || bank == NULL || u == NULL || y == NULL) { return false; }
+
+    // The history head is shared by all channels: advance it once before the ranges
+    executor_bank_job_t job = {bank, u, y};
+    return dsp_ztf_bank_next_sample(bank) && dsp_executor_run(executor, bank->channels, BANK_GRANULARITY, ztf_bank_task, &job);
+}
+
+bool dsp_executor_zss_bank_update(dsp_executor_t* const executor, dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (executor == NULL || bank == NULL || u == NULL || y == NULL) { return false; }
+
+    executor_bank_job_t job = {bank, u, y};
+    return dsp_executor_run(executor, bank->lanes, BANK_GRANULARITY, zss_bank_task, &job);
+}
@@ -0,0 +1,280 @@
+#include <string.h> // memcpy, memset
+#include <math.h> // cos, sin
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Math/FFT.h"
+
+#define REAL_SIZE sizeof(real_t)
+#define NEW_ARRAY(size) ((real_t*) dsp_malloc((size) * REAL_SIZE))
+
+#define FFT_PI 3.14159265358979323846
+#define FFT_MAX_LOG2_SIZE (8 * sizeof(size_t))
+
+
+
+size_t dsp_fft_size(const size_t n) {
+    size_t size = 1;
+    while (size < n && size != 0) { size <<= 1; }
+    return size;
+}
+
+static bool is_power_of_two(const size_t n) {
+    return (n != 0 && (n & (n - 1)) == 0);
+}
+
+static size_t log2_of(size_t n) {
+    size_t log2 = 0;
+    while (n > 1) { n >>= 1; ++log2; }
+    return log2;
+}
+
+
+
+dsp_fft_plan_t* dsp_fft_plan_create(const size_t size) {
+    if (size < 4 || !is_power_of_two(size)) { return NULL; }
+
+    dsp_fft_plan_t* const plan = (dsp_fft_plan_t*) dsp_malloc(sizeof(dsp_fft_plan_t));
+    if (plan == NULL) { return NULL; }
+
+    const size_t half = size / 2;
+    plan->size = size;
+    plan->twiddles = NEW_ARRAY(size);
+    plan->bitrev = (size_t*) dsp_malloc(half * sizeof(size_t));
+    if (plan->twiddles == NULL || plan->bitrev == NULL) {
+        dsp_fft_plan_destroy(plan);
+        return NULL;
+    }
+
+    // Twiddle factors (computed in double precision)
+    for (size_t k = 0; k < half; ++k) {
+        const double phi = -2.0 * FFT_PI * (double) k / (double) size;
+        plan->twiddles[2*k] = (real_t) cos(phi);
+        plan->twiddles[2*k+1] = (real_t) sin(phi);
+    }
+
+    // Bit reversal of the 'half' point complex FFT
+    const size_t bits = log2_of(half);
+    for (size_t k = 0; k < half; ++k) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (k & ((size_t) 1 << b)) { reversed |= (size_t) 1 << (bits - 1 - b); }
+        }
+        plan->bitrev[k] = reversed;
+    }
+
+    return plan;
+}
+
+bool dsp_fft_plan_destroy(dsp_fft_plan_t* const plan) {
+    if (plan == NULL) { return false; }
+
+    if (plan->twiddles != NULL) { dsp_free(plan->twiddles); }
+    if (plan->bitrev != NULL) { dsp_free(plan->bitrev); }
+    dsp_free(plan);
+    return true;
+}
+
+
+
+// ----- Plan cache -----
+
+static dsp_fft_plan_t* cached_plans[FFT_MAX_LOG2_SIZE] = {NULL};
+
+const dsp_fft_plan_t* dsp_fft_plan_cached(const size_t size) {
+    if (size < 4 || !is_power_of_two(size)) { return NULL; }
+    dsp_fft_plan_t** const slot = &(cached_plans[log2_of(size)]);
+
+#if defined(__GNUC__)
+    dsp_fft_plan_t* plan = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (plan != NULL) { return plan; }
+
+    // Publish a new plan, unless another thread was faster
+    dsp_fft_plan_t* const new_plan = dsp_fft_plan_create(size);
+    if (new_plan == NULL) { return NULL; }
+    if (__atomic_compare_exchange_n(slot, &plan, new_plan, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return new_plan;
+    }
+    dsp_fft_plan_destroy(new_plan);
+    return plan;
+#else
+    if (*slot == NULL) { *slot = dsp_fft_plan_create(size); }
+    return *slot;
+#endif
+}
+
+void dsp_fft_release_cached_plans() {
+    for (size_t k = 0; k < FFT_MAX_LOG2_SIZE; ++k) {
+        if (cached_plans[k] != NULL) {
+            dsp_fft_plan_destroy(cached_plans[k]);
+            cached_plans[k] = NULL;
+        }
+    }
+}
+
+
+
+// ----- Complex FFT -----
+
+// In-place radix-2 FFT of 'size/2' interleaved complex values
+// (sign = -1: forward, sign = +1: inverse without scaling)
+static void complex_fft(const dsp_fft_plan_t* const plan, real_t* const z, const real_t sign) {
+    const size_t n = plan->size / 2;
+
+    // Bit reversal
+    for (size_t k = 0; k < n; ++k) {
+        const size_t j = plan->bitrev[k];
+        if (j > k) {
+            const real_t re = z[2*k], im = z[2*k+1];
+            z[2*k] = z[2*j]; z[2*k+1] = z[2*j+1];
+            z[2*j] = re; z[2*j+1] = im;
+        }
+    }
+
+    // Butterflies, the 'n' point FFT uses every second twiddle of the plan
+    for (size_t span = 1; span < n; span <<= 1) {
+        const size_t stride = n / span;
+        for (size_t start = 0; start < n; start += 2 * span) {
+            for (size_t k = 0; k < span; ++k) {
+                const real_t wr = plan->twiddles[2 * k * stride];
+                const real_t wi = -sign * plan->twiddles[2 * k * stride + 1];
+                real_t* const a = &(z[2 * (start + k)]);
+                real_t* const b = &(z[2 * (start + k + span)]);
+                const real_t tr = wr * b[0] - wi * b[1];
+                const real_t ti = wr * b[1] + wi * b[0];
+                b[0] = a[0] - tr; b[1] = a[1] - ti;
+                a[0] = a[0] + tr; a[1] = a[1] + ti;
+            }
+        }
+    }
+}
+
+
+
+// ----- Real FFT -----
+
+bool dsp_fft_real_forward(const dsp_fft_plan_t* const plan, const real_t* const x, real_t* const X) {
+    if (plan == NULL || x == NULL || X == NULL) { return false; }
+    const size_t n = plan->size;
+    const size_t half = n / 2;
+    const real_t* const w = plan->twiddles;
+
+    // Even and odd samples as one complex sequence z[k] = x[2k] + i * x[2k+1]
+    if (X != x) { memcpy(X, x, n * REAL_SIZE); }
+    complex_fft(plan, X, -1);
+
+    // Split: X[k] = E[k] + W^k * O[k] and X[half-k] = conj(E[k] - W^k * O[k])
+    // with E[k] = (Z[k] + conj(Z[half-k])) / 2 and O[k] = -i * (Z[k] - conj(Z[half-k])) / 2
+    const real_t z0r = X[0], z0i = X[1];
+    X[0] = z0r + z0i; X[1] = 0;
+    X[n] = z0r - z0i; X[n+1] = 0;
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const size_t j = half - k;
+        const real_t ar = X[2*k], ai = X[2*k+1];
+        const real_t br = X[2*j], bi = -X[2*j+1];
+        const real_t er = (ar + br) / 2, ei = (ai + bi) / 2;
+        const real_t odd_r = (ai - bi) / 2, odd_i = -(ar - br) / 2;
+        const real_t wor = w[2*k] * odd_r - w[2*k+1] * odd_i;
+        const real_t woi = w[2*k] * odd_i + w[2*k+1] * odd_r;
+        X[2*k] = er + wor; X[2*k+1] = ei + woi;
+        X[2*j] = er - wor; X[2*j+1] = -(ei - woi);
+    }
+    return true;
+}
+
+bool dsp_fft_real_inverse(const dsp_fft_plan_t* const plan, const real_t* const X, real_t* const x) {
+    if (plan == NULL || X == NULL || x == NULL) { return false; }
+    const size_t n = plan->size;
+    const size_t half = n / 2;
+    const real_t* const w = plan->twiddles;
+
+    // Merge: E[k] = (X[k] + conj(X[half-k])) / 2, O[k] = conj(W^k) * (X[k] - conj(X[half-k])) / 2
+    // and Z[k] = E[k] + i * O[k], Z[half-k] = conj(E[k]) + i * conj(O[k])
+    const real_t x0 = X[0], xh = X[n];
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const size_t j = half - k;
+        const real_t ar = X[2*k], ai = X[2*k+1];
+        const real_t br = X[2*j], bi = -X[2*j+1];
+        const real_t er = (ar + br) / 2, ei = (ai + bi) / 2;
+        const real_t dr = (ar - br) / 2, di = (ai - bi) / 2;
+        const real_t odd_r = w[2*k] * dr + w[2*k+1] * di;
+        const real_t odd_i = w[2*k] * di - w[2*k+1] * dr;
+        x[2*k] = er - odd_i; x[2*k+1] = ei + odd_r;
+        x[2*j] = er + odd_i; x[2*j+1] = -ei + odd_r;
+    }
+    x[0] = (x0 + xh) / 2;
+    x[1] = (x0 - xh) / 2;
+
+    // Inverse complex FFT and scaling
+    complex_fft(plan, x, 1);
+    const real_t scale = (real_t) 2 / (real_t) n;
+    for (size_t k = 0; k < n; ++k) { x[k] *= scale; }
+    return true;
+}
+
+
+
+// ----- Convolution -----
+
+size_t dsp_fft_conv(
+    const real_t* const u, const size_t u_size,
+    const real_t* const v, const size_t v_size,
+    real_t* const w, const size_t w_size) {
+
+    // Check
+    if (u == NULL || v == NULL || w == NULL) { return 0; }
+    if (u_size == 0 || v_size == 0) { return 0; }
+    const size_t conv_size = (u_size + v_size - 1);
+    if (w_size < conv_size) { return 0; }
+
+    // Filter the longer sequence 'x' with the shorter one 'h'
+    const real_t* const x = (u_size >= v_size ? u : v);
+    const real_t* const h = (u_size >= v_size ? v : u);
+    const size_t x_size = (u_size >= v_size ? u_size : v_size);
+    const size_t h_size = (u_size >= v_size ? v_size : u_size);
+
+    // Blocks of 'fft_size - h_size + 1' samples (about 3/4 of the FFT is new output)
+    size_t fft_size = dsp_fft_size(4 * h_size);
+    if (fft_size > dsp_fft_size(conv_size)) { fft_size = dsp_fft_size(conv_size); }
+    if (fft_size < 4) { fft_size = 4; }
+    const size_t block_size = fft_size - h_size + 1;
+
+    const dsp_fft_plan_t* const plan = dsp_fft_plan_cached(fft_size);
+    real_t* const H = NEW_ARRAY(fft_size + 2);
+    real_t* const B = NEW_ARRAY(fft_size + 2);
+    if (plan == NULL || H == NULL || B == NULL) {
+        if (H != NULL) { dsp_free(H); }
+        if (B != NULL) { dsp_free(B); }
+        return 0;
+    }
+
+    // Spectrum of 'h'
+    memcpy(H, h, h_size * REAL_SIZE);
+    memset(&(H[h_size]), 0, (fft_size - h_size) * REAL_SIZE);
+    dsp_fft_real_forward(plan, H, H);
+
+    // Overlap-add
+    memset(w, 0, conv_size * REAL_SIZE);
+    for (size_t start = 0; start < x_size; start += block_size) {
+        const size_t n = (x_size - start < block_size ? x_size - start : block_size);
+
+        // Spectrum of the block
+        memcpy(B, &(x[start]), n * REAL_SIZE);
+        memset(&(B[n]), 0, (fft_size - n) * REAL_SIZE);
+        dsp_fft_real_forward(plan, B, B);
+
+        // Multiply
+        for (size_t k = 0; k <= fft_size / 2; ++k) {
+            const real_t re = B[2*k] * H[2*k] - B[2*k+1] * H[2*k+1];
+            const real_t im = B[2*k] * H[2*k+1] + B[2*k+1] * H[2*k];
+            B[2*k] = re; B[2*k+1] = im;
+        }
+
+        // Add the 'n + h_size - 1' output samples of the block
+        dsp_fft_real_inverse(plan, B, B);
+        const size_t m = n + h_size - 1;
+        for (size_t k = 0; k < m; ++k) { w[start + k] += B[k]; }
+    }
+
+    dsp_free(H);
+    dsp_free(B);
+    return conv_size;
+}
@@ -1,5 +1,5 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/Integrator.h"
 #include "DSP/Discrete/Discontinuous.h"
 
@@ -10,14 +10,14 @@
 dsp_integrator_t* dsp_integrator_create(const real_t K, const real_t Ts, const s_approximation_t IF, const bool limit_output, const real_t upper_limit, const real_t lower_limit) {
 
     // Create a new integrator
-    dsp_integrator_t* const integrator = (dsp_integrator_t*) malloc(sizeof(dsp_integrator_t));
+    dsp_integrator_t* const integrator = (dsp_integrator_t*) dsp_malloc(sizeof(dsp_integrator_t));
     if (integrator == NULL) { return NULL; }
 
     if (dsp_integrator_configure(integrator, K, Ts, IF, limit_output, upper_limit, lower_limit)) {
         return integrator;
     }
     else {
-        free(integrator);
+        dsp_free(integrator);
         return NULL;
     }
 }
@@ -26,14 +26,14 @@ dsp_integrator_t* dsp_integrator_create_copy(const dsp_integrator_t* const other
     if (other == NULL) { return NULL; }
 
     // Create a new integrator
-    dsp_integrator_t* const integrator = (dsp_integrator_t*) malloc(sizeof(dsp_integrator_t));
+    dsp_integrator_t* const integrator = (dsp_integrator_t*) dsp_malloc(sizeof(dsp_integrator_t));
     if (integrator == NULL) { return NULL; }
 
     if (dsp_integrator_copy_assign(integrator, other)) {
         return integrator;
     }
     else {
-        free(integrator);
+        dsp_free(integrator);
         return NULL;
     }
 }
@@ -77,7 +77,7 @@ bool dsp_integrator_swap(dsp_integrator_t* const a, dsp_integrator_t* const b) {
 bool dsp_integrator_destroy(dsp_integrator_t* const integrator) {
     if (integrator == NULL) { return false; }
 
-    free(integrator);
+    dsp_free(integrator);
     return true;
 }
 
@@ -0,0 +1,223 @@
+#include <string.h> // memcpy
+#include <math.h> // fabsf, fabs
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Math/LUDecomposition.h"
+#include "DSP/Math/Simd.h" // dsp_simd_dot_product, dsp_simd_axpy
+
+#define LU_SIZE sizeof(dsp_matrix_lu_t)
+#define NEW_LU() ((dsp_matrix_lu_t*) dsp_malloc(LU_SIZE))
+
+#define REAL_SIZE sizeof(real_t)
+#define ELEMENT(lu, row_index, column_index) ((lu)->elements[(row_index) * (lu)->size + (column_index)])
+
+
+// Create
+dsp_matrix_lu_t* dsp_matrix_lu_create(const size_t size) {
+    if (size == 0) { return NULL; }
+
+    dsp_matrix_lu_t* const lu = NEW_LU();
+    if (lu == NULL) { return NULL; }
+
+    lu->size = size;
+    lu->elements = (real_t*) dsp_malloc(size * size * REAL_SIZE);
+    lu->pivots = (size_t*) dsp_malloc(size * sizeof(size_t));
+    lu->sign = 1;
+    lu->singular = true;
+
+    // If memeory allocation failed
+    if (lu->elements == NULL || lu->pivots == NULL) {
+        dsp_matrix_lu_destroy(lu);
+        return NULL;
+    }
+    return lu;
+}
+
+dsp_matrix_lu_t* dsp_matrix_lu_create_from_matrix(const dsp_matrix_t* const mat) {
+    if (mat == NULL) { return NULL; }
+    if (mat->rows != mat->columns) { return NULL; }
+
+    dsp_matrix_lu_t* const lu = dsp_matrix_lu_create(mat->rows);
+    if (lu == NULL) { return NULL; }
+
+    // A singular matrix still has a valid (zero) determinant
+    dsp_matrix_lu_factor(lu, mat);
+    return lu;
+}
+
+// Destroy
+bool dsp_matrix_lu_destroy(dsp_matrix_lu_t* const lu) {
+    if (lu == NULL) { return false; }
+
+    if (lu->elements != NULL) { dsp_free(lu->elements); }
+    if (lu->pivots != NULL) { dsp_free(lu->pivots); }
+    dsp_free(lu);
+    return true;
+}
+
+// Workspace
+size_t dsp_matrix_lu_workspace_size(const size_t size) {
+    return dsp_workspace_block_size(size * size * REAL_SIZE) + dsp_workspace_block_size(size * sizeof(size_t));
+}
+bool dsp_matrix_lu_init(dsp_matrix_lu_t* const lu, const size_t size, dsp_workspace_t* const ws) {
+    if (lu == NULL || ws == NULL) { return false; }
+    if (size == 0) { return false; }
+
+    lu->size = size;
+    lu->sign = 1;
+    lu->singular = true;
+
+    const size_t mark = dsp_workspace_mark(ws);
+    lu->elements = (real_t*) dsp_workspace_take(ws, size * size * REAL_SIZE);
+    lu->pivots = (size_t*) dsp_workspace_take(ws, size * sizeof(size_t));
+
+    // If the workspace is exhausted
+    if (lu->elements == NULL || lu->pivots == NULL) {
+        dsp_workspace_release(ws, mark);
+        return false;
+    }
+    return true;
+}
+
+
+
+// Factor
+bool dsp_matrix_lu_factor(dsp_matrix_lu_t* const lu, const dsp_matrix_t* const mat) {
+    if (lu == NULL || mat == NULL) { return false; }
+    if (mat->rows != lu->size || mat->columns != lu->size) { return false; }
+
+    const size_t n = lu->size;
+    if (lu->elements != mat->elements) { memcpy(lu->elements, mat->elements, n * n * REAL_SIZE); }
+    lu->sign = 1;
+    lu->singular = false;
+
+    for (size_t k = 0; k < n; ++k) {
+
+        // Partial pivoting: largest element of column k on or below the diagonal
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; ++i) {
+            if (REAL_FABS(ELEMENT(lu, i, k)) > REAL_FABS(ELEMENT(lu, pivot, k))) { pivot = i; }
+        }
+        lu->pivots[k] = pivot;
+
+        if (pivot != k) {
+            for (size_t j = 0; j < n; ++j) {
+                const real_t temp = ELEMENT(lu, k, j);
+                ELEMENT(lu, k, j) = ELEMENT(lu, pivot, j);
+                ELEMENT(lu, pivot, j) = temp;
+            }
+            lu->sign = -lu->sign;
+        }
+
+        // Singular: nothing to eliminate in this column
+        if (ELEMENT(lu, k, k) == 0) { lu->singular = true; continue; }
+
+        // Eliminate below the diagonal, row k of U updates every row below
+        for (size_t i = k + 1; i < n; ++i) {
+            const real_t l = ELEMENT(lu, i, k) / ELEMENT(lu, k, k);
+            ELEMENT(lu, i, k) = l;
+            dsp_simd_axpy(&ELEMENT(lu, i, k+1), -l, &ELEMENT(lu, k, k+1), n - k - 1);
+        }
+    }
+
+    return !lu->singular;
+}
+
+bool dsp_matrix_lu_is_singular(const dsp_matrix_lu_t* const lu) {
+    if (lu == NULL) { return true; }
+    return lu->singular;
+}
+
+real_t dsp_matrix_lu_det(const dsp_matrix_lu_t* const lu) {
+    if (lu == NULL) { return 0; }
+    if (lu->singular) { return 0; }
+
+    real_t det = lu->sign;
+    for (size_t k = 0; k < lu->size; ++k) { det *= ELEMENT(lu, k, k); }
+    return det;
+}
+
+
+
+// Solve
+bool dsp_matrix_lu_solve(const dsp_matrix_lu_t* const lu, real_t* const x, const real_t* const b) {
+    if (lu == NULL || x == NULL || b == NULL) { return false; }
+    if (lu->singular) { return false; }
+
+    const size_t n = lu->size;
+    if (x != b) { memcpy(x, b, n * REAL_SIZE); }
+
+    // x = P * b
+    for (size_t k = 0; k < n; ++k) {
+        const size_t p = lu->pivots[k];
+        if (p != k) { const real_t temp = x[k]; x[k] = x[p]; x[p] = temp; }
+    }
+
+    // L * y = P * b (forward substitution)
+    for (size_t i = 1; i < n; ++i) {
+        x[i] -= dsp_simd_dot_product(&ELEMENT(lu, i, 0), x, i);
+    }
+
+    // U * x = y (backward substitution)
+    for (size_t i = n; i > 0; /*--i*/) {
+        --i;
+        x[i] = (x[i] - dsp_simd_dot_product(&ELEMENT(lu, i, i+1), &x[i+1], n - i - 1)) / ELEMENT(lu, i, i);
+    }
+
+    return true;
+}
+
+bool dsp_matrix_lu_solve_vector(const dsp_matrix_lu_t* const lu, dsp_vector_t* const x, const dsp_vector_t* const b) {
+    if (lu == NULL || x == NULL || b == NULL) { return false; }
+    if (x->size != lu->size || b->size != lu->size) { return false; }
+    return dsp_matrix_lu_solve(lu, x->elements, b->elements);
+}
+
+bool dsp_matrix_lu_solve_matrix(const dsp_matrix_lu_t* const lu, dsp_matrix_t* const X, const dsp_matrix_t* const B) {
+    if (lu == NULL || X == NULL || B == NULL) { return false; }
+    if (X->rows != lu->size || B->rows != lu->size) { return false; }
+    if (X->columns != B->columns) { return false; }
+    if (lu->singular) { return false; }
+
+    const size_t n = lu->size;
+    const size_t m = X->columns;
+    if (X->elements != B->elements) { memcpy(X->elements, B->elements, n * m * REAL_SIZE); }
+    real_t* const x = X->elements;
+
+    // X = P * B
+    for (size_t k = 0; k < n; ++k) {
+        const size_t p = lu->pivots[k];
+        if (p == k) { continue; }
+        for (size_t j = 0; j < m; ++j) {
+            const real_t temp = x[k * m + j]; x[k * m + j] = x[p * m + j]; x[p * m + j] = temp;
+        }
+    }
+
+    // L * Y = P * B, whole rows at once
+    for (size_t i = 1; i < n; ++i) {
+        for (size_t k = 0; k < i; ++k) {
+            dsp_simd_axpy(&x[i * m], -ELEMENT(lu, i, k), &x[k * m], m);
+        }
+    }
+
+    // U * X = Y
+    for (size_t i = n; i > 0; /*--i*/) {
+        --i;
+        for (size_t k = i + 1; k < n; ++k) {
+            dsp_simd_axpy(&x[i * m], -ELEMENT(lu, i, k), &x[k * m], m);
+        }
+        const real_t diagonal = ELEMENT(lu, i, i);
+        for (size_t j = 0; j < m; ++j) { x[i * m + j] /= diagonal; }
+    }
+
+    return true;
+}
+
+bool dsp_matrix_lu_inv(const dsp_matrix_lu_t* const lu, dsp_matrix_t* const result) {
+    if (lu == NULL || result == NULL) { return false; }
+    if (result->rows != lu->size || result->columns != lu->size) { return false; }
+    if (lu->singular) { return false; }
+
+    // Solve A * X = I
+    dsp_matrix_set_to_eye(result);
+    return dsp_matrix_lu_solve_matrix(lu, result, result);
+}
@@ -0,0 +1,197 @@
+#include <string.h> // memset, strncpy
+#include <time.h> // clock_gettime
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Diagnostics/LatencyHistogram.h"
+
+// Time of the calibration of the time stamp counter against CLOCK_MONOTONIC
+#define CALIBRATION_NS 10000000u
+
+
+struct LatencyHistogram {
+
+    // Summary, updated with relaxed atomics by every recording thread
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t overruns;
+
+    // Deadline in ticks (0: none)
+    uint64_t deadline;
+
+    const void* block;
+    char name[DSP_LATENCY_NAME_SIZE];
+
+    uint64_t buckets[DSP_LATENCY_BUCKETS];
+};
+
+
+// Nanoseconds per tick of 'dsp_latency_ticks()' (0: not calibrated yet)
+static double ns_per_tick = 0;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+static double tick_duration(void) {
+    double duration;
+    __atomic_load(&ns_per_tick, &duration, __ATOMIC_ACQUIRE);
+    if (duration > 0) { return duration; }
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // Busy wait against the monotonic clock (threads racing here store about the same value)
+    const uint64_t start_ns = monotonic_ns();
+    const uint64_t start_ticks = dsp_latency_ticks();
+    uint64_t stop_ns;
+    do { stop_ns = monotonic_ns(); } while (stop_ns - start_ns < CALIBRATION_NS);
+    const uint64_t stop_ticks = dsp_latency_ticks();
+    duration = (stop_ticks > start_ticks ? (double) (stop_ns - start_ns) / (double) (stop_ticks - start_ticks) : 1);
+#else
+    duration = 1;
+#endif
+    __atomic_store(&ns_per_tick, &duration, __ATOMIC_RELEASE);
+    return duration;
+}
+
+// Exact below DSP_LATENCY_SUB_BUCKETS, then DSP_LATENCY_SUB_BUCKETS buckets per power of 2
+static size_t bucket_index(const uint64_t ticks) {
+    if (ticks < DSP_LATENCY_SUB_BUCKETS) { return (size_t) ticks; }
+    if (ticks >> DSP_LATENCY_MAX_BITS) { return DSP_LATENCY_BUCKETS - 1; }
+    const size_t shift = (size_t) (63 - __builtin_clzll(ticks)) - DSP_LATENCY_SUB_BITS;
+    return DSP_LATENCY_SUB_BUCKETS * (shift + 1) + (size_t) ((ticks >> shift) - DSP_LATENCY_SUB_BUCKETS);
+}
+
+// Largest duration in a bucket
+static uint64_t bucket_upper_edge(const size_t index) {
+    if (index < DSP_LATENCY_SUB_BUCKETS) { return index; }
+    const size_t shift = index / DSP_LATENCY_SUB_BUCKETS - 1;
+    const uint64_t sub = DSP_LATENCY_SUB_BUCKETS + index % DSP_LATENCY_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+
+dsp_latency_t* dsp_latency_create(const void* const block, const char* const name) {
+    dsp_latency_t* const histogram = (dsp_latency_t*) dsp_malloc(sizeof(dsp_latency_t));
+    if (histogram == NULL) { return NULL; }
+    memset(histogram, 0, sizeof(dsp_latency_t));
+    histogram->min = UINT64_MAX;
+    histogram->block = block;
+    if (name != NULL) { strncpy(histogram->name, name, DSP_LATENCY_NAME_SIZE - 1); }
+    tick_duration();
+    return histogram;
+}
+
+bool dsp_latency_destroy(dsp_latency_t* const histogram) {
+    if (histogram == NULL) { return false; }
+    dsp_free(histogram);
+    return true;
+}
+
+const void* dsp_latency_block(const dsp_latency_t* const histogram) {
+    return (histogram == NULL ? NULL : histogram->block);
+}
+
+bool dsp_latency_set_deadline(dsp_latency_t* const histogram, const double deadline_ns) {
+    if (histogram == NULL || !(deadline_ns >= 0)) { return false; }
+    const uint64_t deadline = (uint64_t) (deadline_ns / tick_duration() + 0.5);
+    __atomic_store_n(&histogram->deadline, deadline, __ATOMIC_RELAXED);
+    return true;
+}
+
+void dsp_latency_record(dsp_latency_t* const histogram, const uint64_t ticks) {
+    if (histogram == NULL) { return; }
+    __atomic_fetch_add(&histogram->buckets[bucket_index(ticks)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, ticks, __ATOMIC_RELAXED);
+
+    // New extremes are rare after the first calls, so the loops almost never run
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (ticks > max && !__atomic_compare_exchange_n(&histogram->max, &max, ticks, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    uint64_t min = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    while (ticks < min && !__atomic_compare_exchange_n(&histogram->min, &min, ticks, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+
+    const uint64_t deadline = __atomic_load_n(&histogram->deadline, __ATOMIC_RELAXED);
+    if (deadline != 0 && ticks > deadline) { __atomic_fetch_add(&histogram->overruns, 1, __ATOMIC_RELAXED); }
+}
+
+// Upper edge of the bucket with the 'q' quantile in ticks, limited to the maximum
+static uint64_t quantile_ticks(const dsp_latency_t* const histogram, const uint64_t* const counts, const uint64_t total, const double q) {
+    uint64_t rank = (uint64_t) (q * (double) total);
+    if ((double) rank < q * (double) total) { ++rank; }
+    if (rank < 1) { rank = 1; }
+    const uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    uint64_t seen = 0;
+    for (size_t k = 0; k < DSP_LATENCY_BUCKETS; ++k) {
+        seen += counts[k];
+        if (seen >= rank) {
+            const uint64_t edge = bucket_upper_edge(k);
+            return (edge < max ? edge : max);
+        }
+    }
+    return max;
+}
+
+// Snapshot of the buckets, returns the number of durations
+static uint64_t load_counts(const dsp_latency_t* const histogram, uint64_t* const counts) {
+    uint64_t total = 0;
+    for (size_t k = 0; k < DSP_LATENCY_BUCKETS; ++k) {
+        counts[k] = __atomic_load_n(&histogram->buckets[k], __ATOMIC_RELAXED);
+        total += counts[k];
+    }
+    return total;
+}
+
+bool dsp_latency_get_stats(const dsp_latency_t* const histogram, dsp_latency_stats_t* const stats) {
+    if (histogram == NULL || stats == NULL) { return false; }
+    memset(stats, 0, sizeof(dsp_latency_stats_t));
+    uint64_t counts[DSP_LATENCY_BUCKETS];
+    const uint64_t total = load_counts(histogram, counts);
+    stats->overruns = __atomic_load_n(&histogram->overruns, __ATOMIC_RELAXED);
+    if (total == 0) { return true; }
+
+    const double scale = tick_duration();
+    stats->count = total;
+    stats->min_ns = scale * (double) __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    stats->mean_ns = scale * (double) __atomic_load_n(&histogram->sum, __ATOMIC_RELAXED) / (double) total;
+    stats->p50_ns = scale * (double) quantile_ticks(histogram, counts, total, 0.5);
+    stats->p99_ns = scale * (double) quantile_ticks(histogram, counts, total, 0.99);
+    stats->p999_ns = scale * (double) quantile_ticks(histogram, counts, total, 0.999);
+    stats->max_ns = scale * (double) __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    stats->jitter_ns = stats->p999_ns - stats->p50_ns;
+    return true;
+}
+
+double dsp_latency_percentile(const dsp_latency_t* const histogram, const double q) {
+    if (histogram == NULL || !(q >= 0 && q <= 1)) { return 0; }
+    uint64_t counts[DSP_LATENCY_BUCKETS];
+    const uint64_t total = load_counts(histogram, counts);
+    return (total == 0 ? 0 : tick_duration() * (double) quantile_ticks(histogram, counts, total, q));
+}
+
+bool dsp_latency_reset(dsp_latency_t* const histogram) {
+    if (histogram == NULL) { return false; }
+    for (size_t k = 0; k < DSP_LATENCY_BUCKETS; ++k) { __atomic_store_n(&histogram->buckets[k], 0, __ATOMIC_RELAXED); }
+    __atomic_store_n(&histogram->sum, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->min, UINT64_MAX, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->max, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->overruns, 0, __ATOMIC_RELAXED);
+    return true;
+}
+
+bool dsp_latency_report(const dsp_latency_t* const* const histograms, const size_t count, FILE* const stream) {
+    if ((histograms == NULL && count != 0) || stream == NULL) { return false; }
+    fprintf(stream, "%-31s %12s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+        "block", "calls", "min [ns]", "mean [ns]", "p50 [ns]", "p99 [ns]", "p99.9 [ns]", "max [ns]", "jitter", "overruns");
+    for (size_t k = 0; k < count; ++k) {
+        dsp_latency_stats_t stats;
+        if (!dsp_latency_get_stats(histograms[k], &stats)) { continue; }
+        fprintf(stream, "%-31s %12llu %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f %10.0f %10llu\n",
+            histograms[k]->name, (unsigned long long) stats.count, stats.min_ns, stats.mean_ns,
+            stats.p50_ns, stats.p99_ns, stats.p999_ns, stats.max_ns, stats.jitter_ns, (unsigned long long) stats.overruns);
+    }
+    return true;
+}
+
+double dsp_latency_ticks_to_ns(const uint64_t ticks) {
+    return tick_duration() * (double) ticks;
+}
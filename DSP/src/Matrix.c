@@ -1,13 +1,16 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset, memmove
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Math/Matrix.h"
+#include "DSP/Math/Simd.h" // dsp_simd_gemm, dsp_simd_dot_product
+#include "DSP/Math/LUDecomposition.h" // dsp_matrix_lu_t
+#include "DSP/Math/QRDecomposition.h" // dsp_matrix_qr_t
 
 #define MATRIX_SIZE sizeof(dsp_matrix_t)
-#define NEW_MATRIX() ((dsp_matrix_t*) malloc(MATRIX_SIZE))
+#define NEW_MATRIX() ((dsp_matrix_t*) dsp_malloc(MATRIX_SIZE))
 
 #define REAL_SIZE sizeof(real_t)
 #define ARRAY_SIZE(rows, columns) ((rows) * (columns) * REAL_SIZE)
-#define NEW_ARRAY(rows, columns) ((real_t*) malloc(ARRAY_SIZE(rows, columns)))
+#define NEW_ARRAY(rows, columns) ((real_t*) dsp_malloc(ARRAY_SIZE(rows, columns)))
 #define ELEMENT(mat, row_index, column_index) ((mat)->elements[(row_index) * mat->columns + (column_index)])
 
 
@@ -25,7 +28,7 @@ dsp_matrix_t* dsp_matrix_create(const size_t rows, const size_t columns) {
             return mat; 
         }
         else { 
-            free(mat); 
+            dsp_free(mat); 
             return NULL; 
         }
     }
@@ -335,7 +338,7 @@ bool dsp_matrix_allocate_internal_array(dsp_matrix_t* const mat, const size_t ro
 bool dsp_matrix_release_internal_array(dsp_matrix_t* const mat) {
     if (mat == NULL) { return false; }
     if (mat->elements != NULL) {
-        free(mat->elements);
+        dsp_free(mat->elements);
         mat->elements = NULL;
         mat->rows = 0;
         mat->columns = 0;
@@ -344,8 +347,8 @@ bool dsp_matrix_release_internal_array(dsp_matrix_t* const mat) {
 }
 bool dsp_matrix_destroy(dsp_matrix_t* const mat) {
     if (mat == NULL) { return false; }
-    if (mat->elements != NULL) { free(mat->elements); }
-    free(mat);
+    if (mat->elements != NULL) { dsp_free(mat->elements); }
+    dsp_free(mat);
     return true;
 }
 
@@ -446,16 +449,59 @@ bool dsp_matrix_multiply(dsp_matrix_t* result, const dsp_matrix_t* const mat1, c
     if (result->rows != mat1->rows) {return false; }
     if (result->columns != mat2->columns) {return false; }
     if (mat1->columns != mat2->rows) {return false; }
+    if (result == mat1 || result == mat2) { return false; }
+
+    // result = 0 + mat1 * mat2
+    dsp_matrix_set_to_zero(result);
+    dsp_simd_gemm(result->rows, result->columns, mat1->columns,
+        mat1->elements, mat1->columns, 1,
+        mat2->elements, mat2->columns,
+        result->elements, result->columns
+    );
+    return true;
+}
+bool dsp_matrix_multiply_and_add(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2) {
+    if (result == NULL || mat1 == NULL || mat2 == NULL) { return false; }
+    if (result->rows != mat1->rows) {return false; }
+    if (result->columns != mat2->columns) {return false; }
+    if (mat1->columns != mat2->rows) {return false; }
+    if (result == mat1 || result == mat2) { return false; }
+
+    // result = result + mat1 * mat2
+    dsp_simd_gemm(result->rows, result->columns, mat1->columns,
+        mat1->elements, mat1->columns, 1,
+        mat2->elements, mat2->columns,
+        result->elements, result->columns
+    );
+    return true;
+}
+bool dsp_matrix_transpose_multiply(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2) {
+    if (result == NULL || mat1 == NULL || mat2 == NULL) { return false; }
+    if (result->rows != mat1->columns) {return false; }
+    if (result->columns != mat2->columns) {return false; }
+    if (mat1->rows != mat2->rows) {return false; }
+    if (result == mat1 || result == mat2) { return false; }
+
+    // result = 0 + mat1^T * mat2 (mat1 is read column by column)
+    dsp_matrix_set_to_zero(result);
+    dsp_simd_gemm(result->rows, result->columns, mat1->rows,
+        mat1->elements, 1, mat1->columns,
+        mat2->elements, mat2->columns,
+        result->elements, result->columns
+    );
+    return true;
+}
+bool dsp_matrix_multiply_transpose(dsp_matrix_t* result, const dsp_matrix_t* const mat1, const dsp_matrix_t* const mat2) {
+    if (result == NULL || mat1 == NULL || mat2 == NULL) { return false; }
+    if (result->rows != mat1->rows) {return false; }
+    if (result->columns != mat2->rows) {return false; }
+    if (mat1->columns != mat2->columns) {return false; }
+    if (result == mat1 || result == mat2) { return false; }
 
+    // Element (i,j) is the dot product of the rows i of mat1 and j of mat2 (both contiguous)
     for (size_t i = 0; i < result->rows; ++i) {
         for (size_t j = 0; j < result->columns; ++j) {
-
-            // Calculate element (i,j)
-            ELEMENT(result, i, j) = ELEMENT(mat1, i, 0) * ELEMENT(mat2, 0, j);
-            for (size_t k = 1; k < mat1->columns; k++) {
-                ELEMENT(result, i, j) += ELEMENT(mat1, i, k) * ELEMENT(mat2, k, j);
-            }
-
+            ELEMENT(result, i, j) = dsp_simd_dot_product(&ELEMENT(mat1, i, 0), &ELEMENT(mat2, j, 0), mat1->columns);
         }
     }
     return true;
@@ -514,18 +560,13 @@ bool dsp_matrix_divide_by_scalar_and_assign(dsp_matrix_t* mat, const real_t scal
 // Determinante
 real_t dsp_matrix_det(const dsp_matrix_t* const mat) {
     if (mat == NULL) { return 0; }
+    if (mat->rows != mat->columns) { return 0; }
 
-    // Copy mat
-    dsp_matrix_t* A = dsp_matrix_create_copy(mat);
-    if (A == NULL) { return 0;}
-
-    // gauß
-    const real_t det_A = dsp_matrix_gauss_jordan(A, NULL);
-
-    // destroy copy
-    dsp_matrix_destroy(A);
+    dsp_workspace_t* const ws = dsp_workspace_create(dsp_matrix_det_workspace_size(mat->rows));
+    if (ws == NULL) { return 0; }
 
-    // return
+    const real_t det_A = dsp_matrix_det_with_workspace(mat, ws);
+    dsp_workspace_destroy(ws);
     return det_A;
 }
 
@@ -546,85 +587,129 @@ bool dsp_matrix_transpose(dsp_matrix_t* const result, const dsp_matrix_t* const
 // Inverse
 bool dsp_matrix_inv(dsp_matrix_t* const result, const dsp_matrix_t* const mat) {
     if (result == NULL || mat == NULL) { return false; }
-    if (result->rows != mat->rows) { return false; }
-    if (result->columns != mat->columns) { return false; }
     if (mat->rows != mat->columns) { return false; }
 
-    // Create copy of mat
-    dsp_matrix_t* A = dsp_matrix_create_copy(mat);
-    if (A == NULL) { return false; }
-
-    // Set to eye
-    dsp_matrix_set_to_eye(result);
+    dsp_workspace_t* const ws = dsp_workspace_create(dsp_matrix_inv_workspace_size(mat->rows));
+    if (ws == NULL) { return false; }
 
-    // gauß
-    const real_t det_A = dsp_matrix_gauss_jordan(A, result);
-
-    // destroy copy
-    dsp_matrix_destroy(A);
-
-    // return
-    return (det_A != 0);
+    const bool success = dsp_matrix_inv_with_workspace(result, mat, ws);
+    dsp_workspace_destroy(ws);
+    return success;
 }
 bool dsp_matrix_pinv(dsp_matrix_t* const result, const dsp_matrix_t* const mat) {
     if (result == NULL || mat == NULL) { return false; }
-    if (result->rows != mat->columns) { return false; }
-    if (result->columns != mat->rows) { return false; }
 
-    // Überbestimmt: ~C = ~(C^T * C) * C^T
-    if (mat->rows > mat->columns) {
+    dsp_workspace_t* const ws = dsp_workspace_create(dsp_matrix_pinv_workspace_size(mat->rows, mat->columns));
+    if (ws == NULL) { return false; }
 
-        // Transpose matrix
-        dsp_matrix_t* mat_transposed = dsp_matrix_create_transpose(mat);
-        if (mat_transposed == NULL) { return false; }
+    const bool success = dsp_matrix_pinv_with_workspace(result, mat, ws);
+    dsp_workspace_destroy(ws);
+    return success;
+}
 
-        // Calculate a square matrix
-        dsp_matrix_t* mat_n = dsp_matrix_create_product(mat_transposed, mat);
-        if (mat_n == NULL) { dsp_matrix_destroy(mat_transposed); return false; }
 
-        // Inverse the square matrix
-        dsp_matrix_t* inv_mat_n = dsp_matrix_create_inv(mat_n);
-        if (inv_mat_n == NULL) { dsp_matrix_destroy(mat_n); dsp_matrix_destroy(mat_transposed); return false; }
 
-        // Calculate the product
-        dsp_matrix_multiply(result, inv_mat_n, mat_transposed);
+// Workspace
+size_t dsp_matrix_workspace_size(const size_t rows, const size_t columns) {
+    return dsp_workspace_block_size(MATRIX_SIZE) + dsp_workspace_block_size(ARRAY_SIZE(rows, columns));
+}
+dsp_matrix_t* dsp_matrix_create_in_workspace(const size_t rows, const size_t columns, dsp_workspace_t* const ws) {
+    if (rows * columns == 0) { return NULL; }
 
-        // Release
-        dsp_matrix_destroy(inv_mat_n);
-        dsp_matrix_destroy(mat_n);
-        dsp_matrix_destroy(mat_transposed);
-        return true;
-        
-    }
-    // Unterbestimmt: ~C = C^T * ~(C * C^T)
-    else if (mat->rows < mat->columns) {
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_t* const mat = (dsp_matrix_t*) dsp_workspace_take(ws, MATRIX_SIZE);
+    real_t* const elements = (real_t*) dsp_workspace_take(ws, ARRAY_SIZE(rows, columns));
+    if (mat == NULL || elements == NULL) { dsp_workspace_release(ws, mark); return NULL; }
 
-        // Transpose matrix
-        dsp_matrix_t* mat_transposed = dsp_matrix_create_transpose(mat);
-        if (mat_transposed == NULL) { return false; }
+    mat->rows = rows;
+    mat->columns = columns;
+    mat->elements = elements;
+    return mat;
+}
 
-        // Calculate a square matrix
-        dsp_matrix_t* mat_n = dsp_matrix_create_product(mat, mat_transposed);
-        if (mat_n == NULL) { dsp_matrix_destroy(mat_transposed); return false; }
+size_t dsp_matrix_det_workspace_size(const size_t size) {
+    return dsp_matrix_lu_workspace_size(size);
+}
+real_t dsp_matrix_det_with_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws) {
+    if (mat == NULL || ws == NULL) { return 0; }
+    if (mat->rows != mat->columns) { return 0; }
+
+    // Factor mat
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_lu_t lu;
+    if (!dsp_matrix_lu_init(&lu, mat->rows, ws)) { return 0; }
+    dsp_matrix_lu_factor(&lu, mat);
+
+    // det(A) = sign(P) * prod(diag(U))
+    const real_t det_A = dsp_matrix_lu_det(&lu);
+    dsp_workspace_release(ws, mark);
+    return det_A;
+}
 
-        // Inverse the square matrix
-        dsp_matrix_t* inv_mat_n = dsp_matrix_create_inv(mat_n);
-        if (inv_mat_n == NULL) { dsp_matrix_destroy(mat_n); dsp_matrix_destroy(mat_transposed); return false; }
+size_t dsp_matrix_inv_workspace_size(const size_t size) {
+    return dsp_matrix_lu_workspace_size(size);
+}
+bool dsp_matrix_inv_with_workspace(dsp_matrix_t* const result, const dsp_matrix_t* const mat, dsp_workspace_t* const ws) {
+    if (result == NULL || mat == NULL || ws == NULL) { return false; }
+    if (result->rows != mat->rows) { return false; }
+    if (result->columns != mat->columns) { return false; }
+    if (mat->rows != mat->columns) { return false; }
 
-        // Calculate the product
-        dsp_matrix_multiply(result, mat_transposed, inv_mat_n);
+    // Factor mat and solve mat * result = I
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_lu_t lu;
+    const bool success = dsp_matrix_lu_init(&lu, mat->rows, ws)
+        && dsp_matrix_lu_factor(&lu, mat)
+        && dsp_matrix_lu_inv(&lu, result);
 
-        // Release
-        dsp_matrix_destroy(inv_mat_n);
-        dsp_matrix_destroy(mat_n);
-        dsp_matrix_destroy(mat_transposed);
-        return true;
+    dsp_workspace_release(ws, mark);
+    return success;
+}
+dsp_matrix_t* dsp_matrix_create_inv_in_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws) {
+    if (mat == NULL) { return NULL; }
+
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_t* const inv_mat = dsp_matrix_create_in_workspace(mat->columns, mat->rows, ws);
+    if (inv_mat == NULL) { return NULL; }
+
+    if (dsp_matrix_inv_with_workspace(inv_mat, mat, ws)) { return inv_mat; }
+    dsp_workspace_release(ws, mark);
+    return NULL;
+}
+
+size_t dsp_matrix_pinv_workspace_size(const size_t rows, const size_t columns) {
+    if (rows == columns) { return dsp_matrix_inv_workspace_size(rows); }
+    return dsp_matrix_qr_workspace_size(rows, columns);
+}
+bool dsp_matrix_pinv_with_workspace(dsp_matrix_t* const result, const dsp_matrix_t* const mat, dsp_workspace_t* const ws) {
+    if (result == NULL || mat == NULL || ws == NULL) { return false; }
+    if (result->rows != mat->columns) { return false; }
+    if (result->columns != mat->rows) { return false; }
 
-    }
     // row == columns -> pinv(C) == inv(C)
-    else {
-        return dsp_matrix_inv(result, mat);
-    }
+    if (mat->rows == mat->columns) { return dsp_matrix_inv_with_workspace(result, mat, ws); }
+
+    // Überbestimmt: ~C = R^-1 * Q^T with C = Q * R
+    // Unterbestimmt: ~C = Q * R^-T with C^T = Q * R
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_qr_t qr;
+    const bool success = dsp_matrix_qr_init(&qr, mat->rows, mat->columns, ws)
+        && dsp_matrix_qr_factor(&qr, mat)
+        && dsp_matrix_qr_pinv(&qr, result);
+
+    dsp_workspace_release(ws, mark);
+    return success;
+}
+dsp_matrix_t* dsp_matrix_create_pinv_in_workspace(const dsp_matrix_t* const mat, dsp_workspace_t* const ws) {
+    if (mat == NULL) { return NULL; }
+
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_t* const inv_mat = dsp_matrix_create_in_workspace(mat->columns, mat->rows, ws);
+    if (inv_mat == NULL) { return NULL; }
+
+    if (dsp_matrix_pinv_with_workspace(inv_mat, mat, ws)) { return inv_mat; }
+    dsp_workspace_release(ws, mark);
+    return NULL;
 }
 
 
@@ -0,0 +1,120 @@
+#include <stdlib.h> // malloc, realloc, free
+#include <string.h> // memcpy
+#include "DSP/Memory/Memory.h"
+#include "DSP/Memory/Allocator.h"
+
+#ifdef DSP_COUNT_ALLOCATIONS
+static _Thread_local size_t allocation_count = 0;
+#define COUNT_ALLOCATION(ptr) do { if ((ptr) != NULL) { ++allocation_count; } } while (0)
+#else
+#define COUNT_ALLOCATION(ptr) do { (void) (ptr); } while (0)
+#endif
+
+// Every block starts with the allocator it came from and its size
+typedef struct BlockHeader {
+    const dsp_allocator_t* allocator;
+    size_t size;
+} block_header_t;
+
+#define HEADER_SIZE DSP_ALLOCATOR_ALIGNMENT
+#define HEADER(ptr) ((block_header_t*) ((unsigned char*) (ptr) - HEADER_SIZE))
+#define PAYLOAD(header) ((void*) ((unsigned char*) (header) + HEADER_SIZE))
+
+_Static_assert(sizeof(block_header_t) <= HEADER_SIZE, "block header doesn't fit into the alignment");
+
+
+
+// Default allocator
+static void* heap_alloc(void* const context, const size_t size) {
+    (void) context;
+    void* const ptr = malloc(size);
+    COUNT_ALLOCATION(ptr);
+    return ptr;
+}
+static void* heap_realloc(void* const context, void* const ptr, const size_t size) {
+    (void) context;
+    void* const new_ptr = realloc(ptr, size);
+    COUNT_ALLOCATION(new_ptr);
+    return new_ptr;
+}
+static void heap_free(void* const context, void* const ptr) {
+    (void) context;
+    free(ptr);
+}
+
+static const dsp_allocator_t heap_allocator = { heap_alloc, heap_realloc, heap_free, NULL };
+static _Thread_local const dsp_allocator_t* selected_allocator = NULL;
+
+const dsp_allocator_t* dsp_allocator_default() {
+    return &heap_allocator;
+}
+const dsp_allocator_t* dsp_allocator_select(const dsp_allocator_t* const allocator) {
+    const dsp_allocator_t* const previous = dsp_allocator_selected();
+    selected_allocator = allocator;
+    return previous;
+}
+const dsp_allocator_t* dsp_allocator_selected() {
+    return (selected_allocator != NULL ? selected_allocator : &heap_allocator);
+}
+
+
+
+// Allocate
+void* dsp_malloc(const size_t size) {
+    const dsp_allocator_t* const allocator = dsp_allocator_selected();
+
+    block_header_t* const header = (block_header_t*) allocator->alloc(allocator->context, HEADER_SIZE + size);
+    if (header == NULL) { return NULL; }
+
+    header->allocator = allocator;
+    header->size = size;
+    return PAYLOAD(header);
+}
+void* dsp_realloc(void* const ptr, const size_t size) {
+    if (ptr == NULL) { return dsp_malloc(size); }
+
+    // Stay with the allocator of the block
+    block_header_t* const header = HEADER(ptr);
+    const dsp_allocator_t* const allocator = header->allocator;
+
+    if (allocator->realloc != NULL) {
+        block_header_t* const new_header = (block_header_t*) allocator->realloc(allocator->context, header, HEADER_SIZE + size);
+        if (new_header == NULL) { return NULL; }
+        new_header->size = size;
+        return PAYLOAD(new_header);
+    }
+    else {
+        block_header_t* const new_header = (block_header_t*) allocator->alloc(allocator->context, HEADER_SIZE + size);
+        if (new_header == NULL) { return NULL; }
+        new_header->allocator = allocator;
+        new_header->size = size;
+        memcpy(PAYLOAD(new_header), ptr, (header->size < size ? header->size : size));
+        if (allocator->free != NULL) { allocator->free(allocator->context, header); }
+        return PAYLOAD(new_header);
+    }
+}
+void dsp_free(void* const ptr) {
+    if (ptr == NULL) { return; }
+
+    block_header_t* const header = HEADER(ptr);
+    const dsp_allocator_t* const allocator = header->allocator;
+    if (allocator->free != NULL) { allocator->free(allocator->context, header); }
+}
+
+
+
+// Counter
+bool dsp_memory_counting_enabled() {
+#ifdef DSP_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+size_t dsp_memory_allocation_count() {
+#ifdef DSP_COUNT_ALLOCATIONS
+    return allocation_count;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,289 @@
+#if defined(DSP_PERF_COUNTERS) && defined(__linux__)
+#define _GNU_SOURCE // syscall
+#include <linux/perf_event.h> // perf_event_attr
+#include <sys/ioctl.h> // ioctl
+#include <sys/syscall.h> // SYS_perf_event_open
+#include <unistd.h> // syscall, read, close
+#include <errno.h> // errno
+#include <stdlib.h> // qsort
+#define PERF_LINUX
+#endif
+
+#include <string.h> // memset, strncpy, strerror
+#include <time.h> // clock_gettime
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Diagnostics/PerfCounters.h"
+
+
+#ifdef PERF_LINUX
+
+// Empty measurements for the cost of a measurement
+#define CALIBRATION_RUNS 255
+
+struct PerfInstance {
+    const void* block;
+    char name[DSP_PERF_NAME_SIZE];
+    dsp_perf_stats_t stats;
+};
+
+struct PerfSession {
+
+    size_t capacity;
+    size_t count;
+    struct PerfInstance* instances;
+
+    // Group leader (-1: no event available) and the file descriptor of every event
+    int leader;
+    int fds[DSP_PERF_EVENTS];
+
+    // Event of every value of a group read, in the order the events joined the group
+    size_t members;
+    dsp_perf_event_t order[DSP_PERF_EVENTS];
+
+    // Error of the first event that could not be opened (0: all opened)
+    int error;
+
+    // Counters at the start of the running measurement
+    uint64_t start_ns;
+    uint64_t start[DSP_PERF_EVENTS];
+
+    // Median counters of an empty measurement
+    uint64_t overhead_ns;
+    uint64_t overhead[DSP_PERF_EVENTS];
+
+    // Internal: struct and instances packed into one allocation
+    void* block;
+};
+
+static const uint64_t event_configs[DSP_PERF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+
+static uint64_t now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+static int open_event(const uint64_t config, const int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static int compare_counts(const void* const a, const void* const b) {
+    const uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+// Median of CALIBRATION_RUNS values (sorted in place)
+static uint64_t median(uint64_t* const values) {
+    qsort(values, CALIBRATION_RUNS, sizeof(uint64_t), compare_counts);
+    return values[CALIBRATION_RUNS / 2];
+}
+
+// Read all events of the group into 'counts' (indexed by event)
+static void read_group(const dsp_perf_t* const perf, uint64_t* const counts) {
+    if (perf->leader == -1) { return; }
+    uint64_t values[1 + DSP_PERF_EVENTS];
+    if (read(perf->leader, values, sizeof(values)) <= 0) { return; }
+    for (size_t k = 0; k < perf->members && k < values[0]; ++k) { counts[perf->order[k]] = values[1 + k]; }
+}
+
+
+dsp_perf_t* dsp_perf_create(const size_t capacity) {
+    if (capacity == 0) { return NULL; }
+    const size_t size = sizeof(dsp_perf_t) + capacity * sizeof(struct PerfInstance);
+    void* const block = dsp_malloc(size);
+    if (block == NULL) { return NULL; }
+    memset(block, 0, size);
+
+    dsp_perf_t* const perf = (dsp_perf_t*) block;
+    perf->block = block;
+    perf->capacity = capacity;
+    perf->instances = (struct PerfInstance*) (perf + 1);
+    perf->leader = -1;
+    for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) {
+        const int fd = open_event(event_configs[e], perf->leader);
+        perf->fds[e] = fd;
+        if (fd == -1) {
+            if (perf->error == 0) { perf->error = errno; }
+            continue;
+        }
+        if (perf->leader == -1) { perf->leader = fd; }
+        perf->order[perf->members++] = (dsp_perf_event_t) e;
+    }
+    if (perf->leader != -1) {
+        ioctl(perf->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(perf->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // Cost of an empty measurement: median of every counter
+    uint64_t samples[1 + DSP_PERF_EVENTS][CALIBRATION_RUNS];
+    struct PerfInstance calibration;
+    memset(&calibration, 0, sizeof(calibration));
+    for (size_t run = 0; run < CALIBRATION_RUNS; ++run) {
+        const dsp_perf_stats_t before = calibration.stats;
+        dsp_perf_start(perf);
+        dsp_perf_stop(perf, &calibration);
+        samples[0][run] = calibration.stats.nanoseconds - before.nanoseconds;
+        for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) { samples[1 + e][run] = calibration.stats.counts[e] - before.counts[e]; }
+    }
+    perf->overhead_ns = median(samples[0]);
+    for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) { perf->overhead[e] = median(samples[1 + e]); }
+    return perf;
+}
+
+bool dsp_perf_destroy(dsp_perf_t* const perf) {
+    if (perf == NULL) { return false; }
+    for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) {
+        if (perf->fds[e] != -1 && perf->fds[e] != perf->leader) { close(perf->fds[e]); }
+    }
+    if (perf->leader != -1) { close(perf->leader); }
+    dsp_free(perf->block);
+    return true;
+}
+
+bool dsp_perf_event_available(const dsp_perf_t* const perf, const dsp_perf_event_t event) {
+    return perf != NULL && event < DSP_PERF_EVENTS && perf->fds[event] != -1;
+}
+
+dsp_perf_instance_t* dsp_perf_instance(dsp_perf_t* const perf, const void* const block, const char* const name) {
+    if (perf == NULL || block == NULL) { return NULL; }
+    for (size_t k = 0; k < perf->count; ++k) {
+        if (perf->instances[k].block == block) { return &perf->instances[k]; }
+    }
+    if (perf->count == perf->capacity) { return NULL; }
+
+    struct PerfInstance* const instance = &perf->instances[perf->count++];
+    instance->block = block;
+    if (name != NULL) { strncpy(instance->name, name, DSP_PERF_NAME_SIZE - 1); }
+    return instance;
+}
+
+void dsp_perf_start(dsp_perf_t* const perf) {
+    if (perf == NULL) { return; }
+    read_group(perf, perf->start);
+    perf->start_ns = now_ns();
+}
+
+void dsp_perf_stop(dsp_perf_t* const perf, dsp_perf_instance_t* const instance) {
+    if (perf == NULL) { return; }
+    const uint64_t stop_ns = now_ns();
+    uint64_t stop[DSP_PERF_EVENTS] = {0};
+    read_group(perf, stop);
+    if (instance == NULL) { return; }
+
+    dsp_perf_stats_t* const stats = &instance->stats;
+    const uint64_t ns = stop_ns - perf->start_ns;
+    stats->calls += 1;
+    stats->nanoseconds += (ns > perf->overhead_ns ? ns - perf->overhead_ns : 0);
+    for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) {
+        const uint64_t count = stop[e] - perf->start[e];
+        stats->counts[e] += (count > perf->overhead[e] ? count - perf->overhead[e] : 0);
+    }
+}
+
+bool dsp_perf_get_stats(const dsp_perf_instance_t* const instance, dsp_perf_stats_t* const stats) {
+    if (instance == NULL || stats == NULL) { return false; }
+    *stats = instance->stats;
+    return true;
+}
+
+bool dsp_perf_reset(dsp_perf_t* const perf) {
+    if (perf == NULL) { return false; }
+    for (size_t k = 0; k < perf->count; ++k) { memset(&perf->instances[k].stats, 0, sizeof(dsp_perf_stats_t)); }
+    return true;
+}
+
+// Events per call or "n/a"
+static void print_per_call(const dsp_perf_t* const perf, FILE* const stream, const dsp_perf_stats_t* const stats, const dsp_perf_event_t event) {
+    if (perf->fds[event] == -1 || stats->calls == 0) { fprintf(stream, " %12s", "n/a"); }
+    else { fprintf(stream, " %12.1f", (double) stats->counts[event] / (double) stats->calls); }
+}
+
+bool dsp_perf_report(const dsp_perf_t* const perf, FILE* const stream) {
+    if (perf == NULL || stream == NULL) { return false; }
+    if (perf->error != 0) { fprintf(stream, "# some events are not available: %s\n", strerror(perf->error)); }
+    fprintf(stream, "%-31s %12s %12s %12s %12s %12s %12s %6s\n",
+        "block", "calls", "ns/call", "cycles/call", "instr/call", "cmiss/call", "bmiss/call", "IPC");
+    for (size_t k = 0; k < perf->count; ++k) {
+        const dsp_perf_stats_t* const stats = &perf->instances[k].stats;
+        const double calls = (stats->calls == 0 ? 1 : (double) stats->calls);
+        fprintf(stream, "%-31s %12llu %12.1f", perf->instances[k].name, (unsigned long long) stats->calls, (double) stats->nanoseconds / calls);
+        print_per_call(perf, stream, stats, PerfCycles);
+        print_per_call(perf, stream, stats, PerfInstructions);
+        print_per_call(perf, stream, stats, PerfCacheMisses);
+        print_per_call(perf, stream, stats, PerfBranchMisses);
+        if (perf->fds[PerfCycles] == -1 || perf->fds[PerfInstructions] == -1 || stats->counts[PerfCycles] == 0) { fprintf(stream, " %6s\n", "n/a"); }
+        else { fprintf(stream, " %6.2f\n", (double) stats->counts[PerfInstructions] / (double) stats->counts[PerfCycles]); }
+    }
+    return true;
+}
+
+
+#else // without DSP_PERF_COUNTERS (or not on Linux) there is nothing to measure
+
+
+dsp_perf_t* dsp_perf_create(const size_t capacity) {
+    (void) capacity;
+    return NULL;
+}
+
+bool dsp_perf_destroy(dsp_perf_t* const perf) {
+    (void) perf;
+    return false;
+}
+
+bool dsp_perf_event_available(const dsp_perf_t* const perf, const dsp_perf_event_t event) {
+    (void) perf;
+    (void) event;
+    return false;
+}
+
+dsp_perf_instance_t* dsp_perf_instance(dsp_perf_t* const perf, const void* const block, const char* const name) {
+    (void) perf;
+    (void) block;
+    (void) name;
+    return NULL;
+}
+
+void dsp_perf_start(dsp_perf_t* const perf) {
+    (void) perf;
+}
+
+void dsp_perf_stop(dsp_perf_t* const perf, dsp_perf_instance_t* const instance) {
+    (void) perf;
+    (void) instance;
+}
+
+bool dsp_perf_get_stats(const dsp_perf_instance_t* const instance, dsp_perf_stats_t* const stats) {
+    (void) instance;
+    (void) stats;
+    return false;
+}
+
+bool dsp_perf_reset(dsp_perf_t* const perf) {
+    (void) perf;
+    return false;
+}
+
+bool dsp_perf_report(const dsp_perf_t* const perf, FILE* const stream) {
+    (void) perf;
+    (void) stream;
+    return false;
+}
+
+
+#endif // PERF_LINUX
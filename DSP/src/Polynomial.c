@@ -1,14 +1,16 @@
-#include <stdlib.h> // malloc, realloc, free
 #include <string.h> // memcpy, memset, memmove
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_realloc, dsp_free
 #include "DSP/Math/Polynomial.h"
-#include "DSP/Math/Vector.h" // dsp_vector_solve
+#include "DSP/Math/QRDecomposition.h" // dsp_matrix_qr_t
+#include "DSP/Math/Simd.h" // dsp_simd_axpy
+#include "DSP/Discrete/Signal.h" // dsp_conv
 
 #define POLYNOMIAL_SIZE sizeof(dsp_poly_t)
-#define NEW_POLY() ((dsp_poly_t*) malloc(POLYNOMIAL_SIZE))
+#define NEW_POLY() ((dsp_poly_t*) dsp_malloc(POLYNOMIAL_SIZE))
 
 #define REAL_SIZE sizeof(real_t)
 #define ARRAY_SIZE(order) (((order)+1) * REAL_SIZE)
-#define NEW_ARRAY(order) ((real_t*) malloc(ARRAY_SIZE(order)))
+#define NEW_ARRAY(order) ((real_t*) dsp_malloc(ARRAY_SIZE(order)))
 
 // Create a polynomial of size 'order' but don't initilize its coeffs
 dsp_poly_t* dsp_polynomial_create(const size_t order) {
@@ -20,7 +22,7 @@ dsp_poly_t* dsp_polynomial_create(const size_t order) {
         // Allocate space for the coeffs
         p->a = NEW_ARRAY(order);
         if (p->a != NULL) { p->order = order; return p; }
-        else { free(p); return NULL; }
+        else { dsp_free(p); return NULL; }
     }
     else {
         return NULL;
@@ -132,7 +134,7 @@ bool dsp_polynomial_swap(dsp_poly_t* const a, dsp_poly_t* const b) {
 bool dsp_polynomial_release_internal_array(dsp_poly_t* const p) {
     if (p == NULL) { return false; }
     if (p->a != NULL) {
-        free(p->a);
+        dsp_free(p->a);
         p->a = NULL;
         p->order = 0;
     }
@@ -141,7 +143,7 @@ bool dsp_polynomial_release_internal_array(dsp_poly_t* const p) {
 bool dsp_polynomial_destroy(dsp_poly_t* const p) {
     if (p == NULL) { return false; }
     dsp_polynomial_release_internal_array(p);
-    free(p);
+    dsp_free(p);
     return true;
 }
 
@@ -248,16 +250,7 @@ bool dsp_polynomial_multiply(dsp_poly_t* const w, const dsp_poly_t* const u, con
     // w = conv(u,v) returns the convolution of vectors u and v. 
     // If u and v are vectors of polynomial coefficients, 
     // convolving them is equivalent to multiplying the two polynomials.
-    for (size_t	k = 0; k <= (u->order + v->order); k++) {
-
-        const size_t start = (k <= u->order ? 0 : k - u->order);
-        const size_t end = (k <= v->order ? k : v->order);
-        w->a[k] = 0;
-
-        for (size_t j = start; j <= end; ++j) {
-            w->a[k] += v->a[j] * u->a[k-j];
-        }
-    }
+    dsp_conv(u->a, u->order + 1, v->a, v->order + 1, w->a, w->order + 1);
 
     return true;
 }
@@ -280,9 +273,7 @@ bool dsp_polynomial_divide(dsp_poly_t* const q, dsp_poly_t* const r, const dsp_p
 
         // Subtract
         r->a[n] = 0;
-        for (size_t j = 0; j < m; ++j) {
-            r->a[j + k] -= q->a[k] * v->a[j];
-        }
+        dsp_simd_axpy(&(r->a[k]), -q->a[k], v->a, m);
 
         // Reduce
         --n;
@@ -292,53 +283,46 @@ bool dsp_polynomial_divide(dsp_poly_t* const q, dsp_poly_t* const r, const dsp_p
 }
 
 // Fit
-bool dsp_polynomial_fit(dsp_poly_t* const p, const real_t* const x, const real_t* const y, const size_t size) {
-
-    // Create a vandermonde matrix
-    dsp_matrix_t* const V = dsp_matrix_create_vandermonde(p->order, x, size);
-
-    // Put y into a Vector struct
-    //const dsp_vector_t Y = {
-    //    .elements = (real_t*) y,
-    //    .size = size
-    //};
-
-    // Put y into a Vector struct
-    const dsp_vector_t Y = {size, (real_t*) y};
+size_t dsp_polyfit_workspace_size(const size_t order, const size_t size) {
+    return dsp_workspace_block_size(size * ARRAY_SIZE(order)) + dsp_matrix_qr_workspace_size(size, order + 1);
+}
+bool dsp_polyfit_with_workspace(real_t* const p, const size_t order, const real_t* const x, const real_t* const y, const size_t size, dsp_workspace_t* const ws) {
+    if (p == NULL || x == NULL || y == NULL || ws == NULL) { return false; }
+    if (size == 0) { return false; }
 
-    // Put p into a Vector struct
-    //dsp_vector_t P = {
-    //    .elements = p->a,
-    //    .size = p->order + 1
-    //};
+    // Vandermonde matrix
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_matrix_t V = {size, order + 1, (real_t*) dsp_workspace_take(ws, size * ARRAY_SIZE(order))};
+    if (V.elements == NULL) { return false; }
+    for (size_t i = 0; i < size; ++i) {
+        real_t* const row = &(V.elements[i * (order + 1)]);
+        row[0] = 1;
+        for (size_t j = 1; j <= order; ++j) { row[j] = row[j-1] * x[i]; }
+    }
 
-	// Put p into a Vector struct
-    dsp_vector_t P = {p->order + 1, p->a};
+    // Least squares by QR
+    dsp_matrix_qr_t qr;
+    const bool success = dsp_matrix_qr_init(&qr, size, order + 1, ws)
+        && dsp_matrix_qr_factor(&qr, &V)
+        && dsp_matrix_qr_solve(&qr, p, y);
 
-    // Solve
-    if (dsp_vector_solve_lse(&P, V, &Y)) {
-        dsp_matrix_destroy(V);
-        return true;
-    }
-    else {
-        dsp_matrix_destroy(V);
-        return false;
-    }
+    dsp_workspace_release(ws, mark);
+    return success;
+}
+bool dsp_polynomial_fit(dsp_poly_t* const p, const real_t* const x, const real_t* const y, const size_t size) {
+    if (p == NULL) { return false; }
+    return dsp_polyfit(p->a, p->order, x, y, size);
 }
 bool dsp_polyfit(real_t* const p, const size_t order, const real_t* const x, const real_t* const y, const size_t size) {
     if (p == NULL || x == NULL || y == NULL) { return false; }
     if (size == 0) { return false; }
 
-    //// Put p into a Polynomial struct
-    //dsp_poly_t P = {
-    //    .a = p,
-    //    .order = order
-    //};
-
-    // Put p into a Polynomial struct
-    dsp_poly_t P = { order, p };
+    dsp_workspace_t* const ws = dsp_workspace_create(dsp_polyfit_workspace_size(order, size));
+    if (ws == NULL) { return false; }
 
-    return dsp_polynomial_fit(&P, x, y, size);
+    const bool success = dsp_polyfit_with_workspace(p, order, x, y, size, ws);
+    dsp_workspace_destroy(ws);
+    return success;
 }
 
 // Evaluate
@@ -385,7 +369,7 @@ bool dsp_polynomial_shrink_to_fit(dsp_poly_t* const p) {
         if ((p->a[k] != 0)) {
 
             // shrink array
-            real_t* const new_array = (real_t*) realloc(p->a, ARRAY_SIZE(k));
+            real_t* const new_array = (real_t*) dsp_realloc(p->a, ARRAY_SIZE(k));
 
             // check
             if (new_array != NULL) { 
@@ -400,7 +384,7 @@ bool dsp_polynomial_shrink_to_fit(dsp_poly_t* const p) {
     }
 
     // shrink array to size 1 (order = 0)
-    real_t* const new_array = (real_t*) realloc(p->a, REAL_SIZE);
+    real_t* const new_array = (real_t*) dsp_realloc(p->a, REAL_SIZE);
 
     // check
     if (new_array != NULL) { 
@@ -417,7 +401,7 @@ bool dsp_polynomial_grow_to(dsp_poly_t* const p, const size_t new_order) {
     const size_t old_order = p->order;
 
     // grow array
-    real_t* const new_array = (real_t*) realloc(p->a, ARRAY_SIZE(new_order));
+    real_t* const new_array = (real_t*) dsp_realloc(p->a, ARRAY_SIZE(new_order));
 
     // check
     if (new_array != NULL) { 
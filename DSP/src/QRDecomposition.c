@@ -0,0 +1,202 @@
+#include <string.h> // memcpy, memset
+#include <math.h> // sqrtf, fabsf, copysignf, sqrt, fabs, copysign
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include "DSP/Math/QRDecomposition.h"
+#include "DSP/Math/Simd.h" // dsp_simd_dot_product, dsp_simd_axpy
+
+#define REAL_SIZE sizeof(real_t)
+
+// Number of columns (q) and length of each column (p) of the factored matrix
+#define QR_MIN(qr) ((qr)->rows < (qr)->columns ? (qr)->rows : (qr)->columns)
+#define QR_MAX(qr) ((qr)->rows < (qr)->columns ? (qr)->columns : (qr)->rows)
+
+// Element (i,j) of the factored matrix, column j is stored contiguously
+#define FACTORED(qr, p, i, j) ((qr)->elements[(j) * (p) + (i)])
+
+
+// Workspace
+size_t dsp_matrix_qr_workspace_size(const size_t rows, const size_t columns) {
+    const size_t q = (rows < columns ? rows : columns);
+    const size_t p = (rows < columns ? columns : rows);
+    return dsp_workspace_block_size(p * q * REAL_SIZE)
+        + dsp_workspace_block_size(q * REAL_SIZE)
+        + dsp_workspace_block_size(p * REAL_SIZE);
+}
+
+bool dsp_matrix_qr_init(dsp_matrix_qr_t* const qr, const size_t rows, const size_t columns, dsp_workspace_t* const ws) {
+    if (qr == NULL || ws == NULL) { return false; }
+    if (rows == 0 || columns == 0) { return false; }
+
+    qr->rows = rows;
+    qr->columns = columns;
+    qr->rank_deficient = true;
+
+    const size_t mark = dsp_workspace_mark(ws);
+    qr->elements = (real_t*) dsp_workspace_take(ws, QR_MAX(qr) * QR_MIN(qr) * REAL_SIZE);
+    qr->tau = (real_t*) dsp_workspace_take(ws, QR_MIN(qr) * REAL_SIZE);
+    qr->temp = (real_t*) dsp_workspace_take(ws, QR_MAX(qr) * REAL_SIZE);
+
+    // If the workspace is exhausted
+    if (qr->elements == NULL || qr->tau == NULL || qr->temp == NULL) {
+        dsp_workspace_release(ws, mark);
+        return false;
+    }
+    return true;
+}
+
+
+
+// Apply the reflection H_k = I - tau_k * v_k * v_k^T to the array y ('p' elements)
+static void apply_reflection(const dsp_matrix_qr_t* const qr, const size_t p, const size_t k, real_t* const y) {
+    const real_t* const v = &FACTORED(qr, p, k, k);
+    if (qr->tau[k] == 0) { return; }
+
+    // v[0] == 1 is implicit, the diagonal holds R
+    const real_t s = qr->tau[k] * (y[k] + dsp_simd_dot_product(&v[1], &y[k+1], p - k - 1));
+    y[k] -= s;
+    dsp_simd_axpy(&y[k+1], -s, &v[1], p - k - 1);
+}
+
+// Factor
+bool dsp_matrix_qr_factor(dsp_matrix_qr_t* const qr, const dsp_matrix_t* const mat) {
+    if (qr == NULL || mat == NULL) { return false; }
+    if (mat->rows != qr->rows || mat->columns != qr->columns) { return false; }
+
+    const size_t q = QR_MIN(qr);
+    const size_t p = QR_MAX(qr);
+
+    // Store the columns of A (or A^T) contiguously
+    if (mat->rows >= mat->columns) {
+        for (size_t i = 0; i < mat->rows; ++i) {
+            for (size_t j = 0; j < mat->columns; ++j) {
+                FACTORED(qr, p, i, j) = mat->elements[i * mat->columns + j];
+            }
+        }
+    }
+    else {
+        memcpy(qr->elements, mat->elements, p * q * REAL_SIZE);
+    }
+
+    // Pivots below this are treated as zero
+    real_t largest = 0;
+    for (size_t j = 0; j < q; ++j) {
+        const real_t* const column = &FACTORED(qr, p, 0, j);
+        const real_t norm = REAL_SQRT(dsp_simd_dot_product(column, column, p));
+        if (norm > largest) { largest = norm; }
+    }
+    const real_t tolerance = (real_t) p * REAL_EPSILON * largest;
+    qr->rank_deficient = (largest == 0);
+
+    for (size_t k = 0; k < q; ++k) {
+        real_t* const v = &FACTORED(qr, p, k, k);
+        const size_t length = p - k;
+
+        // Reflection that maps column k onto beta * e_k
+        const real_t alpha = v[0];
+        const real_t sigma = dsp_simd_dot_product(&v[1], &v[1], length - 1);
+        if (sigma == 0) {
+            qr->tau[k] = 0;
+        }
+        else {
+            const real_t beta = -REAL_COPYSIGN(REAL_SQRT(alpha * alpha + sigma), alpha);
+            qr->tau[k] = (beta - alpha) / beta;
+
+            const real_t scale = 1 / (alpha - beta);
+            for (size_t i = 1; i < length; ++i) { v[i] *= scale; }
+            v[0] = beta;
+        }
+        if (REAL_FABS(v[0]) <= tolerance) { qr->rank_deficient = true; }
+
+        // Apply it to the remaining columns
+        for (size_t j = k + 1; j < q; ++j) {
+            apply_reflection(qr, p, k, &FACTORED(qr, p, 0, j));
+        }
+    }
+
+    return !qr->rank_deficient;
+}
+
+bool dsp_matrix_qr_is_rank_deficient(const dsp_matrix_qr_t* const qr) {
+    if (qr == NULL) { return true; }
+    return qr->rank_deficient;
+}
+
+
+
+// Solve
+bool dsp_matrix_qr_solve(dsp_matrix_qr_t* const qr, real_t* const x, const real_t* const b) {
+    if (qr == NULL || x == NULL || b == NULL) { return false; }
+    if (qr->rank_deficient) { return false; }
+
+    const size_t q = QR_MIN(qr);
+    const size_t p = QR_MAX(qr);
+    real_t* const y = qr->temp;
+
+    // Overdetermined: R * x = Q^T * b
+    if (qr->rows >= qr->columns) {
+
+        // y = Q^T * b = H_(q-1) * ... * H_0 * b
+        memcpy(y, b, p * REAL_SIZE);
+        for (size_t k = 0; k < q; ++k) { apply_reflection(qr, p, k, y); }
+
+        // Backward substitution, column j of R updates all rows above
+        for (size_t j = q; j > 0; /*--j*/) {
+            --j;
+            x[j] = y[j] / FACTORED(qr, p, j, j);
+            dsp_simd_axpy(y, -x[j], &FACTORED(qr, p, 0, j), j);
+        }
+    }
+    // Underdetermined: x = Q * [z; 0] with R^T * z = b
+    else {
+
+        // Forward substitution, row i of R^T is column i of R
+        for (size_t i = 0; i < q; ++i) {
+            y[i] = (b[i] - dsp_simd_dot_product(&FACTORED(qr, p, 0, i), y, i)) / FACTORED(qr, p, i, i);
+        }
+        memset(&y[q], 0, (p - q) * REAL_SIZE);
+
+        // x = H_0 * ... * H_(q-1) * [z; 0]
+        for (size_t k = q; k > 0; /*--k*/) {
+            --k;
+            apply_reflection(qr, p, k, y);
+        }
+        memcpy(x, y, p * REAL_SIZE);
+    }
+
+    return true;
+}
+
+bool dsp_matrix_qr_pinv(dsp_matrix_qr_t* const qr, dsp_matrix_t* const result) {
+    if (qr == NULL || result == NULL) { return false; }
+    if (result->rows != qr->columns || result->columns != qr->rows) { return false; }
+    if (qr->rank_deficient) { return false; }
+
+    const size_t q = QR_MIN(qr);
+    const size_t p = QR_MAX(qr);
+    real_t* const w = qr->temp;
+
+    // w_i = Q * [R^-T * e_i; 0] is row i of R^-1 * Q^T (overdetermined)
+    // or column i of Q * R^-T (underdetermined)
+    for (size_t i = 0; i < q; ++i) {
+
+        memset(w, 0, p * REAL_SIZE);
+        w[i] = 1 / FACTORED(qr, p, i, i);
+        for (size_t j = i + 1; j < q; ++j) {
+            w[j] = -dsp_simd_dot_product(&FACTORED(qr, p, i, j), &w[i], j - i) / FACTORED(qr, p, j, j);
+        }
+
+        for (size_t k = q; k > 0; /*--k*/) {
+            --k;
+            apply_reflection(qr, p, k, w);
+        }
+
+        if (qr->rows >= qr->columns) {
+            memcpy(&(result->elements[i * p]), w, p * REAL_SIZE);
+        }
+        else {
+            for (size_t j = 0; j < p; ++j) { result->elements[j * q + i] = w[j]; }
+        }
+    }
+
+    return true;
+}
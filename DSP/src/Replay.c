@@ -0,0 +1,220 @@
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h> // mmap, munmap, madvise
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#define REPLAY_MMAP
+#endif
+
+#include <string.h> // memcpy, memcmp, memset
+#include <time.h> // clock_gettime
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Diagnostics/Replay.h"
+
+// Values converted per 'fwrite()' if the value type differs from real_t
+#define WRITE_CHUNK 512
+
+
+struct ReplayFile {
+    dsp_replay_file_header_t header;
+
+    // First value of the first sample
+    const unsigned char* values;
+
+    // Mapped file (or the file read into 'block')
+    void* mapping;
+    size_t mapping_size;
+
+    // Internal: struct (and the file without mmap) in one allocation
+    void* block;
+};
+
+
+static double seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+}
+
+// Header of this version and a file of at least the size it announces
+static bool valid_header(const dsp_replay_file_header_t* const header, const size_t size) {
+    if (memcmp(header->magic, DSP_REPLAY_MAGIC, sizeof(header->magic)) != 0 || header->version != DSP_REPLAY_VERSION) { return false; }
+    if (header->value_size != sizeof(float) && header->value_size != sizeof(double)) { return false; }
+    if (header->width == 0 || header->width > SIZE_MAX / header->value_size) { return false; }
+    const uint64_t available = (size - sizeof(dsp_replay_file_header_t)) / (header->width * header->value_size);
+    return header->samples <= available;
+}
+
+
+dsp_replay_file_t* dsp_replay_open(const char* const path) {
+    if (path == NULL) { return NULL; }
+
+#ifdef REPLAY_MMAP
+    const int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) { return NULL; }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t) sizeof(dsp_replay_file_header_t)) {
+        close(descriptor);
+        return NULL;
+    }
+    const size_t size = (size_t) status.st_size;
+    void* const mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor); // the mapping keeps the file open
+    if (mapping == MAP_FAILED) { return NULL; }
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, size, MADV_SEQUENTIAL);
+#endif
+
+    dsp_replay_file_t* const file = (dsp_replay_file_t*) dsp_malloc(sizeof(dsp_replay_file_t));
+    if (file == NULL) {
+        munmap(mapping, size);
+        return NULL;
+    }
+    file->block = file;
+    file->mapping = mapping;
+    file->mapping_size = size;
+#else
+    FILE* const stream = fopen(path, "rb");
+    if (stream == NULL) { return NULL; }
+    long end = -1;
+    if (fseek(stream, 0, SEEK_END) == 0) { end = ftell(stream); }
+    if (end < (long) sizeof(dsp_replay_file_header_t) || fseek(stream, 0, SEEK_SET) != 0) {
+        fclose(stream);
+        return NULL;
+    }
+    const size_t size = (size_t) end;
+
+    // Layout: struct, file (the values stay aligned to 8 bytes)
+    void* const block = dsp_malloc(sizeof(dsp_replay_file_t) + size);
+    if (block == NULL) {
+        fclose(stream);
+        return NULL;
+    }
+    dsp_replay_file_t* const file = (dsp_replay_file_t*) block;
+    file->block = block;
+    file->mapping = (unsigned char*) block + sizeof(dsp_replay_file_t);
+    file->mapping_size = size;
+    const bool read = (fread(file->mapping, 1, size, stream) == size);
+    fclose(stream);
+    if (!read) {
+        dsp_free(block);
+        return NULL;
+    }
+#endif
+
+    memcpy(&file->header, file->mapping, sizeof(dsp_replay_file_header_t));
+    file->values = (const unsigned char*) file->mapping + sizeof(dsp_replay_file_header_t);
+    if (!valid_header(&file->header, size)) {
+        dsp_replay_close(file);
+        return NULL;
+    }
+    return file;
+}
+
+bool dsp_replay_close(dsp_replay_file_t* const file) {
+    if (file == NULL) { return false; }
+#ifdef REPLAY_MMAP
+    munmap(file->mapping, file->mapping_size);
+#endif
+    dsp_free(file->block);
+    return true;
+}
+
+const dsp_replay_file_header_t* dsp_replay_header(const dsp_replay_file_t* const file) {
+    return (file == NULL ? NULL : &file->header);
+}
+
+size_t dsp_replay_read(const dsp_replay_file_t* const file, const uint64_t first, const size_t n, real_t* const values) {
+    if (file == NULL || values == NULL || first >= file->header.samples) { return 0; }
+    const size_t samples = (n < file->header.samples - first ? n : (size_t) (file->header.samples - first));
+    const size_t width = (size_t) file->header.width;
+    const size_t count = samples * width;
+    const unsigned char* const source = file->values + (size_t) first * width * file->header.value_size;
+
+    // The values start at byte 40 of the mapping, so both value types are aligned
+    if (file->header.value_size == sizeof(real_t)) {
+        memcpy(values, source, count * sizeof(real_t));
+    }
+    else if (file->header.value_size == sizeof(float)) {
+        const float* const single = (const float*) source;
+        for (size_t k = 0; k < count; ++k) { values[k] = (real_t) single[k]; }
+    }
+    else {
+        const double* const wide = (const double*) source;
+        for (size_t k = 0; k < count; ++k) { values[k] = (real_t) wide[k]; }
+    }
+    return samples;
+}
+
+bool dsp_replay_write_header(FILE* const stream, const size_t width, const uint64_t samples, const size_t value_size, const double sample_time) {
+    if (stream == NULL || width == 0 || (value_size != sizeof(float) && value_size != sizeof(double))) { return false; }
+    dsp_replay_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DSP_REPLAY_MAGIC, sizeof(header.magic));
+    header.version = DSP_REPLAY_VERSION;
+    header.value_size = (uint32_t) value_size;
+    header.samples = samples;
+    header.width = width;
+    header.sample_time = sample_time;
+    return fwrite(&header, sizeof(header), 1, stream) == 1;
+}
+
+bool dsp_replay_write(FILE* const stream, const real_t* const values, const size_t n, const size_t value_size) {
+    if (stream == NULL || (values == NULL && n != 0)) { return false; }
+    if (value_size == sizeof(real_t)) { return fwrite(values, sizeof(real_t), n, stream) == n; }
+
+    for (size_t first = 0; first < n; first += WRITE_CHUNK) {
+        const size_t count = (n - first < WRITE_CHUNK ? n - first : WRITE_CHUNK);
+        if (value_size == sizeof(float)) {
+            float single[WRITE_CHUNK];
+            for (size_t k = 0; k < count; ++k) { single[k] = (float) values[first + k]; }
+            if (fwrite(single, sizeof(float), count, stream) != count) { return false; }
+        }
+        else if (value_size == sizeof(double)) {
+            double wide[WRITE_CHUNK];
+            for (size_t k = 0; k < count; ++k) { wide[k] = (double) values[first + k]; }
+            if (fwrite(wide, sizeof(double), count, stream) != count) { return false; }
+        }
+        else { return false; }
+    }
+    return true;
+}
+
+bool dsp_replay_run(dsp_diagram_t* const diagram, const size_t input, const size_t output,
+    const dsp_replay_file_t* const file, FILE* const stream, const size_t batch, dsp_replay_stats_t* const stats) {
+
+    if (diagram == NULL || file == NULL) { return false; }
+    real_t* const in = dsp_diagram_input(diagram, input);
+    const real_t* const out = dsp_diagram_output(diagram, output);
+    if (in == NULL || out == NULL || dsp_diagram_width(diagram, input) != file->header.width) { return false; }
+    const size_t out_width = dsp_diagram_width(diagram, output);
+    const size_t max_samples = dsp_diagram_max_samples(diagram);
+    const size_t n_batch = (batch == 0 || batch > max_samples ? max_samples : batch);
+
+    const uint64_t samples = file->header.samples;
+    const size_t value_size = file->header.value_size;
+    if (stream != NULL && !dsp_replay_write_header(stream, out_width, samples, value_size, file->header.sample_time)) { return false; }
+
+    uint64_t batches = 0;
+    double process_seconds = 0;
+    const double start = seconds();
+    for (uint64_t first = 0; first < samples; first += n_batch) {
+        const size_t n = dsp_replay_read(file, first, n_batch, in);
+        const double process_start = seconds();
+        if (!dsp_diagram_process(diagram, n)) { return false; }
+        process_seconds += seconds() - process_start;
+        if (stream != NULL && !dsp_replay_write(stream, out, n * out_width, value_size)) { return false; }
+        ++batches;
+    }
+    if (stream != NULL && fflush(stream) != 0) { return false; }
+    const double elapsed = seconds() - start;
+
+    if (stats != NULL) {
+        stats->samples = samples;
+        stats->batches = batches;
+        stats->seconds = elapsed;
+        stats->process_seconds = process_seconds;
+        stats->samples_per_second = (elapsed > 0 ? (double) samples / elapsed : 0);
+    }
+    return true;
+}
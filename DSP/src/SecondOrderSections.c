@@ -0,0 +1,466 @@
+#include <string.h> // memset
+#include <math.h> // fabs, sqrt, pow, cos, sin
+#include <float.h> // DBL_EPSILON
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Discrete/SecondOrderSections.h"
+
+#define SOS_SIZE sizeof(dsp_sos_t)
+#define REAL_SIZE sizeof(real_t)
+#define ACCUM_SIZE sizeof(accum_t)
+
+// Coefficients and state values per section
+#define SECTION_COEFFICIENTS 5
+#define SECTION_STATE 2
+
+// Aberth-Ehrlich iteration
+#define ROOT_ITERATIONS 200
+#define ROOT_TOLERANCE 1e-15
+
+// Roots with a smaller imaginary part (relative to their magnitude) are real
+#define REAL_TOLERANCE 1e-9
+
+// Rounding errors (in units of DBL_EPSILON) that hide the difference between close roots
+#define CLUSTER_NOISE 4
+#define CLUSTER_ITERATIONS 4
+
+#define NONE ((size_t) -1)
+
+
+// Create
+dsp_sos_t* dsp_sos_create(const size_t sections) {
+    if (sections == 0) { return NULL; }
+
+    // Layout: the struct, then state and coefficients
+    unsigned char* const block = (unsigned char*) dsp_malloc(SOS_SIZE + sections * (SECTION_STATE * ACCUM_SIZE + SECTION_COEFFICIENTS * REAL_SIZE));
+    if (block == NULL) { return NULL; }
+
+    dsp_sos_t* const sos = (dsp_sos_t*) block;
+    sos->sections = sections;
+    sos->state = (accum_t*) &block[SOS_SIZE];
+    sos->coefficients = (real_t*) &sos->state[sections * SECTION_STATE];
+    sos->block = block;
+
+    // G_k(z) = 1 with cleared state
+    for (size_t k = 0; k < sections; ++k) { dsp_sos_set_section(sos, k, NULL, NULL); }
+    dsp_sos_reset(sos);
+    return sos;
+}
+
+dsp_sos_t* dsp_sos_create_from_arrays(const size_t sections, const real_t* const sos) {
+
+    dsp_sos_t* const cascade = dsp_sos_create(sections);
+    if (cascade == NULL || sos == NULL) { return cascade; }
+
+    for (size_t k = 0; k < sections; ++k) {
+        if (!dsp_sos_set_section(cascade, k, &sos[6 * k], &sos[6 * k + 3])) {
+            dsp_sos_destroy(cascade);
+            return NULL;
+        }
+    }
+    return cascade;
+}
+
+// Destroy
+bool dsp_sos_destroy(dsp_sos_t* const sos) {
+    if (sos == NULL) { return false; }
+
+    // The struct lives at the beginning of the block
+    dsp_free(sos->block);
+    return true;
+}
+
+
+
+// ----- Roots -----
+
+typedef struct { double re; double im; } complex_t;
+
+static inline complex_t c_make(const double re, const double im) { const complex_t z = {re, im}; return z; }
+static inline complex_t c_add(const complex_t x, const complex_t y) { return c_make(x.re + y.re, x.im + y.im); }
+static inline complex_t c_sub(const complex_t x, const complex_t y) { return c_make(x.re - y.re, x.im - y.im); }
+static inline complex_t c_mul(const complex_t x, const complex_t y) { return c_make(x.re * y.re - x.im * y.im, x.re * y.im + x.im * y.re); }
+static inline double c_abs(const complex_t z) { return sqrt(z.re * z.re + z.im * z.im); }
+
+static inline complex_t c_div(const complex_t x, const complex_t y) {
+    const double d = y.re * y.re + y.im * y.im;
+    return c_make((x.re * y.re + x.im * y.im) / d, (x.im * y.re - x.re * y.im) / d);
+}
+
+// Roots of p[0] * z^n + p[1] * z^(n-1) + ... + p[n] with p[0] != 0
+static void find_roots(const double* const p, size_t degree, complex_t* roots) {
+
+    // Roots at the origin are exact
+    while (degree > 0 && p[degree] == 0) { *roots++ = c_make(0, 0); --degree; }
+    if (degree == 0) { return; }
+    if (degree == 1) { roots[0] = c_make(-p[1] / p[0], 0); return; }
+
+    // Start on a circle with the mean radius of the roots, off the real axis
+    const double radius = pow(fabs(p[degree] / p[0]), 1.0 / (double) degree);
+    for (size_t k = 0; k < degree; ++k) {
+        const double angle = 6.283185307179586 * (double) k / (double) degree + 0.4;
+        roots[k] = c_make(radius * cos(angle), radius * sin(angle));
+    }
+
+    // Aberth-Ehrlich: Newton steps that repel each root from all others
+    for (size_t iteration = 0; iteration < ROOT_ITERATIONS; ++iteration) {
+        double change = 0;
+        for (size_t k = 0; k < degree; ++k) {
+
+            // p(z) and p'(z) by Horner
+            const complex_t z = roots[k];
+            complex_t value = c_make(p[0], 0);
+            complex_t slope = c_make(0, 0);
+            for (size_t i = 1; i <= degree; ++i) {
+                slope = c_add(c_mul(slope, z), value);
+                value = c_add(c_mul(value, z), c_make(p[i], 0));
+            }
+            if (c_abs(value) == 0 || c_abs(slope) == 0) { continue; }
+
+            complex_t repulsion = c_make(0, 0);
+            for (size_t j = 0; j < degree; ++j) {
+                const complex_t distance = c_sub(z, roots[j]);
+                if (j != k && c_abs(distance) != 0) { repulsion = c_add(repulsion, c_div(c_make(1, 0), distance)); }
+            }
+
+            const complex_t ratio = c_div(value, slope);
+            const complex_t step = c_div(ratio, c_sub(c_make(1, 0), c_mul(ratio, repulsion)));
+            roots[k] = c_sub(z, step);
+
+            const double magnitude = c_abs(roots[k]);
+            const double relative = c_abs(step) / (magnitude > 1 ? magnitude : 1);
+            if (relative > change) { change = relative; }
+        }
+        if (change <= ROOT_TOLERANCE) { break; }
+    }
+}
+
+// Rounding noise of evaluating p in double precision within radius 'r'
+static double noise_level(const double* const p, const size_t degree, const double r) {
+    double sum = 0, power = 1;
+    for (size_t i = degree + 1; i-- > 0;) { sum += fabs(p[i]) * power; power *= r; }
+    return CLUSTER_NOISE * DBL_EPSILON * sum;
+}
+
+// Taylor coefficients p(c + h) = t[0] + t[1] * h + ... + t[m-1] * h^(m-1) by repeated synthetic division
+// ('shift' holds 'degree+1' values)
+static void taylor_coefficients(const double* const p, const size_t degree, const complex_t c, const size_t m, complex_t* const shift, complex_t* const t) {
+    for (size_t i = 0; i <= degree; ++i) { shift[i] = c_make(p[i], 0); }
+    for (size_t j = 0; j < m; ++j) {
+        for (size_t i = 1; i <= degree - j; ++i) { shift[i] = c_add(shift[i], c_mul(c, shift[i - 1])); }
+        t[j] = shift[degree - j];
+    }
+}
+
+// A root of multiplicity m comes out of the iteration as a ring of m roots within the rounding noise.
+// Grow a cluster around every root as long as the polynomial can not tell it from one root
+// of the same multiplicity at the centroid (the first m Taylor coefficients stay within the noise
+// over the radius of the cluster), then replace it by the simple root of the (m-1)-th derivative.
+static void merge_clusters(const double* const p, const size_t degree, complex_t* const roots, size_t* const members, bool* const merged, complex_t* const shift, complex_t* const t) {
+
+    memset(merged, 0, degree * sizeof(bool));
+    for (size_t k = 0; k < degree; ++k) {
+        if (merged[k]) { continue; }
+
+        size_t m = 1, best = 1;
+        members[0] = k;
+        complex_t sum = roots[k], best_centroid = roots[k];
+        while (m < degree) {
+
+            // Nearest root outside of the cluster
+            const complex_t centroid = c_make(sum.re / (double) m, sum.im / (double) m);
+            size_t next = NONE;
+            for (size_t j = 0; j < degree; ++j) {
+                bool member = merged[j];
+                for (size_t i = 0; i < m && !member; ++i) { member = (members[i] == j); }
+                if (!member && (next == NONE || c_abs(c_sub(roots[j], centroid)) < c_abs(c_sub(roots[next], centroid)))) { next = j; }
+            }
+            if (next == NONE) { break; }
+            members[m++] = next;
+            sum = c_add(sum, roots[next]);
+
+            const complex_t c = c_make(sum.re / (double) m, sum.im / (double) m);
+            double radius = 0;
+            for (size_t i = 0; i < m; ++i) {
+                const double distance = c_abs(c_sub(roots[members[i]], c));
+                if (distance > radius) { radius = distance; }
+            }
+
+            taylor_coefficients(p, degree, c, m, shift, t);
+            double residual = 0, power = 1;
+            for (size_t j = 0; j < m; ++j) { residual += c_abs(t[j]) * power; power *= radius; }
+            if (residual <= noise_level(p, degree, c_abs(c) + radius)) {
+                best = m;
+                best_centroid = c;
+            }
+        }
+
+        // Newton steps on the (m-1)-th derivative: p^(m-1)(c + h) = (m-1)! * (t[m-1] + m * t[m] * h + ...)
+        for (size_t iteration = 0; best > 1 && iteration < CLUSTER_ITERATIONS; ++iteration) {
+            taylor_coefficients(p, degree, best_centroid, best + 1, shift, t);
+            const complex_t denominator = c_mul(c_make((double) best, 0), t[best]);
+            if (c_abs(denominator) == 0) { break; }
+            best_centroid = c_sub(best_centroid, c_div(t[best - 1], denominator));
+        }
+
+        for (size_t i = 0; i < best; ++i) {
+            roots[members[i]] = best_centroid;
+            merged[members[i]] = true;
+        }
+    }
+}
+
+// Match every complex root with its conjugate ('partner'), real roots are their own partner
+static void pair_conjugates(complex_t* const roots, size_t* const partner, const size_t n) {
+
+    for (size_t k = 0; k < n; ++k) {
+        const double magnitude = c_abs(roots[k]);
+        if (fabs(roots[k].im) <= REAL_TOLERANCE * (magnitude > 1 ? magnitude : 1)) { roots[k].im = 0; }
+        partner[k] = NONE;
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+        if (roots[k].im <= 0 || partner[k] != NONE) { continue; }
+
+        size_t best = NONE;
+        double best_distance = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (roots[j].im >= 0 || partner[j] != NONE) { continue; }
+            const double distance = c_abs(c_sub(roots[j], c_make(roots[k].re, -roots[k].im)));
+            if (best == NONE || distance < best_distance) { best = j; best_distance = distance; }
+        }
+        if (best != NONE) { partner[k] = best; partner[best] = k; }
+    }
+
+    // Unmatched complex roots can only come from rounding, keep their real part
+    for (size_t k = 0; k < n; ++k) {
+        if (partner[k] == NONE) { roots[k].im = 0; partner[k] = k; }
+    }
+}
+
+// Unused root with the largest magnitude (only real ones if 'real_only')
+static size_t largest_root(const complex_t* const roots, const size_t* const partner, const bool* const used, const size_t n, const bool real_only) {
+    size_t best = NONE;
+    for (size_t k = 0; k < n; ++k) {
+        if (used[k] || (real_only && partner[k] != k)) { continue; }
+        if (best == NONE || c_abs(roots[k]) > c_abs(roots[best])) { best = k; }
+    }
+    return best;
+}
+
+// Unused root closest to 'target' (only real ones if 'real_only')
+static size_t nearest_root(const complex_t* const roots, const size_t* const partner, const bool* const used, const size_t n, const complex_t target, const bool real_only) {
+    size_t best = NONE;
+    double best_distance = 0;
+    for (size_t k = 0; k < n; ++k) {
+        if (used[k] || (real_only && partner[k] != k)) { continue; }
+        const double distance = c_abs(c_sub(roots[k], target));
+        if (best == NONE || distance < best_distance) { best = k; best_distance = distance; }
+    }
+    return best;
+}
+
+// p(z^-1) *= (c0 + c1 * z^-1), 'p' has 3 coefficients
+static void multiply_first_order(double* const p, const double c0, const double c1) {
+    p[2] = c0 * p[2] + c1 * p[1];
+    p[1] = c0 * p[1] + c1 * p[0];
+    p[0] = c0 * p[0];
+}
+
+// Take the root 'k' (with its conjugate) into the section polynomial 'p', returns the number of roots taken
+static size_t take_root(double* const p, const complex_t* const roots, const size_t* const partner, bool* const used, const size_t k) {
+    used[k] = true;
+    if (partner[k] == k) {
+        multiply_first_order(p, 1, -roots[k].re);
+        return 1;
+    }
+
+    // (1 - r * z^-1) * (1 - conj(r) * z^-1)
+    used[partner[k]] = true;
+    p[0] = 1;
+    p[1] = -c_add(roots[k], roots[partner[k]]).re;
+    p[2] = c_mul(roots[k], roots[partner[k]]).re;
+    return 2;
+}
+
+
+
+// ----- Factorization -----
+
+dsp_sos_t* dsp_sos_create_from_tf(const size_t order, const real_t* const num, const real_t* const den) {
+    const size_t n = order + 1;
+    const size_t sections = (order + 1) / 2 > 0 ? (order + 1) / 2 : 1;
+
+    // Workspace: roots of both, Taylor shifts, b and a, the coefficients of all sections, partners and flags
+    const size_t workspace_size = (2 * order + 2 * n) * sizeof(complex_t) + (2 * n + 6 * sections) * sizeof(double) + 2 * order * (sizeof(size_t) + sizeof(bool));
+    unsigned char* const workspace = (unsigned char*) dsp_malloc(workspace_size);
+    if (workspace == NULL) { return NULL; }
+
+    complex_t* const zeros = (complex_t*) workspace;
+    complex_t* const poles = &zeros[order];
+    complex_t* const shift = &poles[order];
+    complex_t* const taylor = &shift[n];
+    double* const b = (double*) &taylor[n];
+    double* const a = &b[n];
+    double* const coefficients = &a[n];
+    size_t* const zero_partner = (size_t*) &coefficients[6 * sections];
+    size_t* const pole_partner = &zero_partner[order];
+    bool* const zero_used = (bool*) &pole_partner[order];
+    bool* const pole_used = &zero_used[order];
+
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = (num == NULL ? (i == 0 ? 1 : 0) : num[i]);
+        a[i] = (den == NULL ? (i == 0 ? 1 : 0) : den[i]);
+    }
+    if (a[0] == 0) { dsp_free(workspace); return NULL; }
+
+    // b(z^-1) = z^-m * b[m] * (1 - z1 * z^-1) * ... with the first non-zero coefficient b[m]:
+    // 'm' zeros at infinity (delays) and 'order - m' finite zeros
+    size_t m = 0;
+    while (m < n && b[m] == 0) { ++m; }
+    const double gain = (m < n ? b[m] / a[0] : 0);
+    const size_t finite_zeros = (m < n ? order - m : 0);
+    size_t delays = (m < n ? m : 0);
+
+    find_roots(&b[m < n ? m : 0], finite_zeros, zeros);
+    find_roots(a, order, poles);
+    merge_clusters(&b[m < n ? m : 0], finite_zeros, zeros, zero_partner, zero_used, shift, taylor);
+    merge_clusters(a, order, poles, pole_partner, pole_used, shift, taylor);
+    pair_conjugates(zeros, zero_partner, finite_zeros);
+    pair_conjugates(poles, pole_partner, order);
+    memset(zero_used, 0, finite_zeros * sizeof(bool));
+    memset(pole_used, 0, order * sizeof(bool));
+
+    // Poles closest to the unit circle first, with the nearest zeros
+    size_t zeros_left = finite_zeros;
+    for (size_t s = 0; s < sections; ++s) {
+        double* const sb = &coefficients[6 * (sections - 1 - s)];
+        double* const sa = &sb[3];
+        sb[0] = sa[0] = 1;
+        sb[1] = sb[2] = sa[1] = sa[2] = 0;
+
+        size_t section_poles = 0;
+        complex_t target = c_make(0, 0);
+        const size_t p1 = largest_root(poles, pole_partner, pole_used, order, false);
+        if (p1 != NONE) {
+            target = poles[p1];
+            section_poles = take_root(sa, poles, pole_partner, pole_used, p1);
+            if (section_poles == 1) {
+                const size_t p2 = largest_root(poles, pole_partner, pole_used, order, true);
+                if (p2 != NONE) { section_poles += take_root(sa, poles, pole_partner, pole_used, p2); }
+            }
+        }
+
+        size_t section_zeros = 0;
+        const size_t z1 = nearest_root(zeros, zero_partner, zero_used, finite_zeros, target, false);
+        if (z1 != NONE) {
+            section_zeros = take_root(sb, zeros, zero_partner, zero_used, z1);
+            if (section_zeros == 1) {
+                const size_t z2 = nearest_root(zeros, zero_partner, zero_used, finite_zeros, target, true);
+                if (z2 != NONE) { section_zeros += take_root(sb, zeros, zero_partner, zero_used, z2); }
+            }
+            zeros_left -= section_zeros;
+        }
+
+        // Delays fill up the numerator
+        while (section_zeros < 2 && delays > 0 && (section_zeros < section_poles || zeros_left == 0)) {
+            multiply_first_order(sb, 0, 1);
+            ++section_zeros;
+            --delays;
+        }
+    }
+
+    // Every root must have found a section
+    if (zeros_left != 0 || delays != 0 || largest_root(poles, pole_partner, pole_used, order, false) != NONE) {
+        dsp_free(workspace);
+        return NULL;
+    }
+    for (size_t i = 0; i < 3; ++i) { coefficients[i] *= gain; }
+
+    dsp_sos_t* const sos = dsp_sos_create(sections);
+    if (sos != NULL) {
+        for (size_t k = 0; k < sections; ++k) {
+            const double* const c = &coefficients[6 * k];
+            const real_t section_num[3] = {(real_t) c[0], (real_t) c[1], (real_t) c[2]};
+            const real_t section_den[3] = {1, (real_t) c[4], (real_t) c[5]};
+            dsp_sos_set_section(sos, k, section_num, section_den);
+        }
+    }
+    dsp_free(workspace);
+    return sos;
+}
+
+dsp_sos_t* dsp_sos_create_from_ztf(const dsp_ztf_t* const ztf) {
+    if (ztf == NULL) { return NULL; }
+    return dsp_sos_create_from_tf(ztf->order, ztf->b, ztf->a);
+}
+
+dsp_sos_t* dsp_sos_create_from_poly(const dsp_poly_t* const num, const dsp_poly_t* const den) {
+    if (num == NULL || den == NULL) { return NULL; }
+
+    // Pad the lower order polynomial with zeros
+    const size_t order = (num->order > den->order ? num->order : den->order);
+    real_t* const arrays = (real_t*) dsp_malloc(2 * (order + 1) * REAL_SIZE);
+    if (arrays == NULL) { return NULL; }
+
+    real_t* const b = arrays;
+    real_t* const a = &arrays[order + 1];
+    for (size_t i = 0; i <= order; ++i) {
+        b[i] = (i <= num->order ? num->a[i] : 0);
+        a[i] = (i <= den->order ? den->a[i] : 0);
+    }
+
+    dsp_sos_t* const sos = dsp_sos_create_from_tf(order, b, a);
+    dsp_free(arrays);
+    return sos;
+}
+
+
+
+// ----- Processing -----
+
+bool dsp_sos_set_section(dsp_sos_t* const sos, const size_t section, const real_t* const num, const real_t* const den) {
+    if (sos == NULL) { return false; }
+    if (section >= sos->sections) { return false; }
+    const real_t a0 = (den == NULL ? 1 : den[0]);
+    if (a0 == 0) { return false; }
+
+    real_t* const c = &sos->coefficients[section * SECTION_COEFFICIENTS];
+    c[0] = (num == NULL ? 1 : num[0] / a0);
+    c[1] = (num == NULL ? 0 : num[1] / a0);
+    c[2] = (num == NULL ? 0 : num[2] / a0);
+    c[3] = (den == NULL ? 0 : den[1] / a0);
+    c[4] = (den == NULL ? 0 : den[2] / a0);
+    return true;
+}
+
+bool dsp_sos_reset(dsp_sos_t* const sos) {
+    if (sos == NULL) { return false; }
+    memset(sos->state, 0, sos->sections * SECTION_STATE * ACCUM_SIZE);
+    return true;
+}
+
+real_t dsp_sos_update(dsp_sos_t* const sos, const real_t u) {
+    if (sos == NULL) { return 0; }
+
+    accum_t x = u;
+    for (size_t k = 0; k < sos->sections; ++k) {
+        const real_t* const c = &sos->coefficients[k * SECTION_COEFFICIENTS];
+        accum_t* const s = &sos->state[k * SECTION_STATE];
+
+        // Direct Form II Transposed
+        const accum_t y = c[0] * x + s[0];
+        s[0] = c[1] * x - c[3] * y + s[1];
+        s[1] = c[2] * x - c[4] * y;
+        x = y;
+    }
+    return (real_t) x;
+}
+
+bool dsp_sos_process_block(dsp_sos_t* const sos, const real_t* const in, real_t* const out, const size_t n) {
+    if (sos == NULL || in == NULL || out == NULL) { return false; }
+
+    // Sample by sample through all sections: the recursions of consecutive sections overlap in the pipeline,
+    // one section at a time over the whole block would wait for its own feedback on every sample
+    for (size_t i = 0; i < n; ++i) { out[i] = dsp_sos_update(sos, in[i]); }
+    return true;
+}
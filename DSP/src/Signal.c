@@ -1,9 +1,11 @@
-#include <stdlib.h> // malloc, realloc, free
 #include <string.h> // memset, memcpy, memmove
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_realloc, dsp_free
 #include "DSP/Discrete/Signal.h"
+#include "DSP/Math/Simd.h" // dsp_simd_dot_product, dsp_simd_axpy
+#include "DSP/Math/FFT.h" // dsp_fft_conv
 
 #define SIGNAL_SIZE sizeof(dsp_signal_t)
-#define NEW_SIGNAL() ((dsp_signal_t*) malloc(SIGNAL_SIZE))
+#define NEW_SIGNAL() ((dsp_signal_t*) dsp_malloc(SIGNAL_SIZE))
 
 #define REAL_SIZE sizeof(real_t)
 #define ARRAY_SIZE(size) ((size) * REAL_SIZE)
@@ -23,16 +25,8 @@ real_t dsp_dot_product(
     if (u == NULL || v == NULL) { return 0; }
     if (size == 0) { return 0; }
 
-    // Init
-    real_t sum = v[0] * u[0];
-
-    // Add
-    for (size_t k = 1; k < size; ++k) {
-        sum += v[k] * u[k];
-    }
-
-    // Return
-    return sum;
+    // Vectorized kernel
+    return dsp_simd_dot_product(u, v, size);
 }
 
 
@@ -57,20 +51,19 @@ size_t dsp_conv(
     // w = conv(u,v) returns the convolution of vectors u and v. 
     // If u and v are vectors of polynomial coefficients, 
     // convolving them is equivalent to multiplying the two polynomials.
-    size_t start, end;
-    for (size_t	k = 0; k < conv_size; k++) {
 
-        // Determine start and end
-        start = (k < u_size ? 0 : k - (u_size - 1));
-        end = (k < v_size ? k : (v_size - 1));
+    // Long sequences: overlap-add FFT convolution (the direct sum is the fallback if it fails)
+    if (u_size >= DSP_FFT_CONV_MIN_SIZE && v_size >= DSP_FFT_CONV_MIN_SIZE) {
+        if (dsp_fft_conv(u, u_size, v, v_size, w, w_size) == conv_size) { return conv_size; }
+    }
 
-        // Init
-        w[k] = 0;
+    // Direct sum
+    memset(w, 0, conv_size * sizeof(real_t));
 
-        // Calculate k-th element
-        for (size_t j = start; j <= end; ++j) {
-            w[k] += v[j] * u[k-j];
-        }
+    // w[j + i] += v[j] * u[i], one contiguous update per element of 'v'
+    // (Every w[k] sums its products in the same order as the direct formula)
+    for (size_t j = 0; j < v_size; ++j) {
+        dsp_simd_axpy(&(w[j]), v[j], u, u_size);
     }
 
     return conv_size;
@@ -111,9 +104,7 @@ size_t dsp_deconv(
 
         // Subtract
         r[k] = 0;
-        for (size_t j = 1; j < v_size; ++j) {
-            r[k+j] -= q[k] * v[j]; 
-        }
+        dsp_simd_axpy(&(r[k+1]), -q[k], &(v[1]), v_size - 1);
     }
 
     return r_size;
@@ -133,7 +124,7 @@ dsp_signal_t* dsp_signal_create(const size_t initial_capacity) {
         return signal;
     }
     else{
-        free(signal);
+        dsp_free(signal);
         return NULL;
     }
 }
@@ -147,7 +138,7 @@ dsp_signal_t dsp_signal_construct(const size_t initial_capacity) {
     //};
     dsp_signal_t vec = { NULL, 0, 0};
     if (initial_capacity > 0) {
-        vec.elements = (real_t*) malloc(initial_capacity * (sizeof(*(vec.elements))));
+        vec.elements = (real_t*) dsp_malloc(initial_capacity * (sizeof(*(vec.elements))));
         if (vec.elements != NULL) {
             vec.capacity = initial_capacity;
         }
@@ -221,7 +212,7 @@ bool dsp_signal_move_assign(dsp_signal_t* const  dest, dsp_signal_t* const src)
 bool dsp_signal_destruct(dsp_signal_t* const signal) {
     if (signal == NULL) { return false; }
     if (signal->elements != NULL) {
-        free(signal->elements);
+        dsp_free(signal->elements);
         signal->elements = NULL;
     }
     signal->capacity = 0;
@@ -233,7 +224,7 @@ bool dsp_signal_destruct(dsp_signal_t* const signal) {
 bool dsp_signal_destroy(dsp_signal_t* const signal) {
     if (signal == NULL) { return false; }
     dsp_signal_destruct(signal);
-    free(signal);
+    dsp_free(signal);
     return true;
 }
 
@@ -278,7 +269,7 @@ size_t dsp_signal_deconv(dsp_signal_t* const q, dsp_signal_t* const r, const dsp
 void dsp_signal_reserve(dsp_signal_t* const signal, const size_t new_capacity) {
     if (signal == NULL) { return; }
     if (new_capacity <= signal->capacity) { return; }
-    real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(*(signal->elements)));
+    real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(*(signal->elements)));
     if (reallocated_elements != NULL) {
         signal->elements = reallocated_elements;
         signal->capacity = new_capacity;
@@ -307,7 +298,7 @@ void dsp_signal_resize(dsp_signal_t* const signal, const size_t new_size, const
     }
     else {
         const size_t new_capacity = new_size;
-        real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+        real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
         if (reallocated_elements != NULL) {
             signal->elements = reallocated_elements;
             signal->capacity = new_capacity;
@@ -329,12 +320,12 @@ void dsp_signal_shrink_to_fit(dsp_signal_t* const signal) {
     if (signal == NULL) { return; }
     const size_t new_capacity = signal->size;
     if (new_capacity == 0) {
-        free(signal->elements);
+        dsp_free(signal->elements);
         signal->elements = NULL;
         signal->capacity = 0;
     }
     else {
-        real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(*(signal->elements)));
+        real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(*(signal->elements)));
         if (reallocated_elements != NULL) {
             signal->elements = reallocated_elements;
             signal->capacity = new_capacity;
@@ -409,9 +400,9 @@ void dsp_signal_assign(dsp_signal_t* const signal, const real_t* const new_eleme
         signal->size = new_size;
     }
     else {
-        real_t* const reallocated_array = (real_t*) malloc(new_size * sizeof(real_t));
+        real_t* const reallocated_array = (real_t*) dsp_malloc(new_size * sizeof(real_t));
         if (reallocated_array != NULL) {
-            if (signal->elements != NULL) { free(signal->elements); }
+            if (signal->elements != NULL) { dsp_free(signal->elements); }
             signal->elements = reallocated_array;
             memcpy(signal->elements, new_elements, new_size * sizeof(real_t));
             signal->size = new_size;
@@ -426,7 +417,7 @@ void dsp_signal_push_back(dsp_signal_t* const signal, const real_t* const new_el
     if (new_element == NULL) { return; }
     if (signal->size == SIGNAL_MAX_CAPACITY) { return; }
     if (signal->capacity == 0) {
-        signal->elements = (real_t*) malloc(sizeof(real_t));
+        signal->elements = (real_t*) dsp_malloc(sizeof(real_t));
         if (signal->elements != NULL) {
             memcpy(signal->elements, new_element, sizeof(real_t));
             signal->size = 1;
@@ -439,7 +430,7 @@ void dsp_signal_push_back(dsp_signal_t* const signal, const real_t* const new_el
     }
     else {
         const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-        real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+        real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
         if (reallocated_elements != NULL) {
             signal->elements = reallocated_elements;
             signal->capacity = new_capacity;
@@ -461,7 +452,7 @@ void dsp_signal_pop_back(dsp_signal_t* const signal) {
             const size_t new_size = signal->size - 1;
             const size_t new_capacity = signal->capacity / 2;
             if (new_capacity > new_size) {
-                real_t* const new_array = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+                real_t* const new_array = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
                 if (new_array != NULL) {
                     signal->elements = new_array;
                     signal->size = new_size;
@@ -488,7 +479,7 @@ real_t* dsp_signal_insert(dsp_signal_t* const signal, const size_t position, con
     if (position > signal->size) { return NULL; }
     else if (position == signal->size) {
         if (signal->capacity == 0) {
-            signal->elements = (real_t*) malloc(sizeof(real_t));
+            signal->elements = (real_t*) dsp_malloc(sizeof(real_t));
             if (signal->elements != NULL) {
                 memcpy(signal->elements, new_element, sizeof(real_t));
                 signal->size = 1;
@@ -506,7 +497,7 @@ real_t* dsp_signal_insert(dsp_signal_t* const signal, const size_t position, con
         }
         else {
             const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-            real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+            real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
             if (reallocated_elements != NULL) {
                 signal->elements = reallocated_elements;
                 signal->capacity = new_capacity;
@@ -528,7 +519,7 @@ real_t* dsp_signal_insert(dsp_signal_t* const signal, const size_t position, con
         }
         else {
             const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-            real_t* const reallocated_array = (real_t*) malloc(new_capacity * sizeof(real_t));
+            real_t* const reallocated_array = (real_t*) dsp_malloc(new_capacity * sizeof(real_t));
             if (reallocated_array != NULL) {
                 if (position > 0) {
                     memcpy(reallocated_array, signal->elements, position * sizeof(real_t));
@@ -537,7 +528,7 @@ real_t* dsp_signal_insert(dsp_signal_t* const signal, const size_t position, con
                 if (position < signal->size) {
                     memcpy(&(reallocated_array[position+1]), &(signal->elements[position]), (signal->size - position) * sizeof(real_t));
                 }
-                free(signal->elements);
+                dsp_free(signal->elements);
                 signal->elements = reallocated_array;
                 signal->capacity = new_capacity;
                 signal->size += 1;
@@ -563,7 +554,7 @@ void dsp_signal_erase(dsp_signal_t* const signal, const size_t position) {
             const size_t new_size = signal->size - 1;
             const size_t new_capacity = signal->capacity / 2;
             if (new_capacity > new_size) {
-                real_t* const new_array = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+                real_t* const new_array = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
                 if (new_array != NULL) {
                     signal->elements = new_array;
                     signal->size = new_size;
@@ -584,11 +575,11 @@ void dsp_signal_erase(dsp_signal_t* const signal, const size_t position) {
         const size_t new_size = signal->size - 1;
         const size_t new_capacity = signal->capacity / 2;
         if (new_capacity >= 4 && new_capacity > new_size) {
-            real_t* const new_array = (real_t*) malloc(new_capacity * sizeof(real_t));
+            real_t* const new_array = (real_t*) dsp_malloc(new_capacity * sizeof(real_t));
             if (new_array != NULL) {
                 if (position > 0) { memcpy(new_array, signal->elements, position * sizeof(real_t)); }
                 memcpy(&(new_array[position]), &(signal->elements[position+1]), (signal->size - (position + 1)) * sizeof(real_t));
-                free(signal->elements);
+                dsp_free(signal->elements);
                 signal->elements = new_array;
                 signal->size = new_size;
                 signal->capacity = new_capacity;
@@ -633,7 +624,7 @@ real_t* dsp_signal_emplace(dsp_signal_t* const signal, const size_t position, co
     if (position > signal->size) { return NULL; }
     else if (position == signal->size) {
         if (signal->capacity == 0) {
-            signal->elements = (real_t*) malloc(sizeof(real_t));
+            signal->elements = (real_t*) dsp_malloc(sizeof(real_t));
             if (signal->elements != NULL) {
                 if (fill_zeros) { memset(signal->elements, 0, sizeof(real_t)); }
                 signal->size = 1;
@@ -651,7 +642,7 @@ real_t* dsp_signal_emplace(dsp_signal_t* const signal, const size_t position, co
         }
         else {
             const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-            real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+            real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
             if (reallocated_elements != NULL) {
                 signal->elements = reallocated_elements;
                 signal->capacity = new_capacity;
@@ -673,7 +664,7 @@ real_t* dsp_signal_emplace(dsp_signal_t* const signal, const size_t position, co
         }
         else {
             const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-            real_t* const reallocated_array = (real_t*) malloc(new_capacity * sizeof(real_t));
+            real_t* const reallocated_array = (real_t*) dsp_malloc(new_capacity * sizeof(real_t));
             if (reallocated_array != NULL) {
                 if (position > 0) {
                     memcpy(reallocated_array, signal->elements, position * sizeof(real_t));
@@ -682,7 +673,7 @@ real_t* dsp_signal_emplace(dsp_signal_t* const signal, const size_t position, co
                 if (position < signal->size) {
                     memcpy(&(reallocated_array[position+1]), &(signal->elements[position]), (signal->size - position) * sizeof(real_t));
                 }
-                free(signal->elements);
+                dsp_free(signal->elements);
                 signal->elements = reallocated_array;
                 signal->capacity = new_capacity;
                 signal->size += 1;
@@ -700,7 +691,7 @@ real_t* dsp_signal_emplace_back(dsp_signal_t* const signal, const bool fill_zero
     if (signal == NULL) { return NULL; }
     if (signal->size == SIGNAL_MAX_CAPACITY) { return NULL; }
     if (signal->capacity == 0) {
-        signal->elements = (real_t*) malloc(sizeof(real_t));
+        signal->elements = (real_t*) dsp_malloc(sizeof(real_t));
         if (signal->elements != NULL) {
             if (fill_zeros) { memset(signal->elements, 0, sizeof(real_t)); }
             signal->size = 1;
@@ -718,7 +709,7 @@ real_t* dsp_signal_emplace_back(dsp_signal_t* const signal, const bool fill_zero
     }
     else {
         const size_t new_capacity = (((SIGNAL_MAX_CAPACITY / 2) < signal->capacity) ? SIGNAL_MAX_CAPACITY : 2 * signal->capacity);
-        real_t* const reallocated_elements = (real_t*) realloc(signal->elements, new_capacity * sizeof(real_t));
+        real_t* const reallocated_elements = (real_t*) dsp_realloc(signal->elements, new_capacity * sizeof(real_t));
         if (reallocated_elements != NULL) {
             signal->elements = reallocated_elements;
             signal->capacity = new_capacity;
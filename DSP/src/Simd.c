@@ -0,0 +1,516 @@
+#include <stddef.h> // NULL
+#include "DSP/Math/Simd.h"
+
+// The vector kernels work on 32-bit floats, double builds only have the scalar kernels
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(DSP_PRECISION_DOUBLE)
+#define DSP_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(DSP_PRECISION_DOUBLE)
+#define DSP_SIMD_ARM 1
+#include <arm_neon.h>
+#endif
+
+// Instruction set fixed by the build (CMake option 'DSP_SIMD')
+#if defined(DSP_SIMD_FORCE_SCALAR)
+#define DSP_SIMD_FORCED SimdScalar
+#elif defined(DSP_SIMD_FORCE_SSE)
+#define DSP_SIMD_FORCED SimdSSE
+#elif defined(DSP_SIMD_FORCE_AVX2)
+#define DSP_SIMD_FORCED SimdAVX2
+#elif defined(DSP_SIMD_FORCE_AVX512)
+#define DSP_SIMD_FORCED SimdAVX512
+#elif defined(DSP_SIMD_FORCE_NEON)
+#define DSP_SIMD_FORCED SimdNEON
+#endif
+
+
+typedef real_t (*dot_product_kernel_t)(const real_t* const u, const real_t* const v, const size_t size);
+typedef void (*axpy_kernel_t)(real_t* const y, const real_t a, const real_t* const x, const size_t size);
+typedef void (*multiply_add_kernel_t)(real_t* const y, const real_t* const a, const real_t* const x, const size_t size);
+
+// C[GEMM_MR x nr] += A[GEMM_MR x k] * B[k x nr] for one register tile ('nr' is fixed per instruction set)
+typedef void (*gemm_kernel_t)(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc);
+
+// Register tile: rows per tile (columns per tile depend on the vector width)
+#define GEMM_MR 4
+
+// Cache blocks: 'GEMM_KC' rows of B and 'GEMM_NC' columns stay in L2 while all rows of A pass by
+#define GEMM_KC 256
+#define GEMM_NC 512
+
+
+
+// ----- Scalar -----
+
+static real_t scalar_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    accum_t sum = (accum_t) v[0] * u[0];
+    for (size_t k = 1; k < size; ++k) {
+        sum += (accum_t) v[k] * u[k];
+    }
+    return (real_t) sum;
+}
+
+static void scalar_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    for (size_t k = 0; k < size; ++k) {
+        y[k] += a * x[k];
+    }
+}
+
+static void scalar_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    for (size_t k = 0; k < size; ++k) {
+        y[k] += a[k] * x[k];
+    }
+}
+
+// Any block of C (also used for the edges of the vectorized tiles)
+static void scalar_gemm_block(const size_t m, const size_t n, const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t p = 0; p < k; ++p) {
+            const real_t aip = a[i * a_rs + p * a_cs];
+            for (size_t j = 0; j < n; ++j) {
+                c[i * ldc + j] += aip * b[p * ldb + j];
+            }
+        }
+    }
+}
+
+#define SCALAR_NR 4
+static void scalar_gemm(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    scalar_gemm_block(GEMM_MR, SCALAR_NR, k, a, a_rs, a_cs, b, ldb, c, ldc);
+}
+
+
+
+// ----- x86 -----
+
+#ifdef DSP_SIMD_X86
+
+__attribute__((target("sse")))
+static real_t sse_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t k = 0;
+    for (; k + 8 <= size; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(&u[k]), _mm_loadu_ps(&v[k])));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(&u[k+4]), _mm_loadu_ps(&v[k+4])));
+    }
+    for (; k + 4 <= size; k += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(&u[k]), _mm_loadu_ps(&v[k])));
+    }
+
+    // Horizontal sum
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    real_t sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+    for (; k < size; ++k) { sum += u[k] * v[k]; }
+    return sum;
+}
+
+__attribute__((target("sse")))
+static void sse_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    const __m128 va = _mm_set1_ps(a);
+    size_t k = 0;
+    for (; k + 4 <= size; k += 4) {
+        _mm_storeu_ps(&y[k], _mm_add_ps(_mm_loadu_ps(&y[k]), _mm_mul_ps(va, _mm_loadu_ps(&x[k]))));
+    }
+    for (; k < size; ++k) { y[k] += a * x[k]; }
+}
+
+__attribute__((target("sse")))
+static void sse_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    size_t k = 0;
+    for (; k + 4 <= size; k += 4) {
+        _mm_storeu_ps(&y[k], _mm_add_ps(_mm_loadu_ps(&y[k]), _mm_mul_ps(_mm_loadu_ps(&a[k]), _mm_loadu_ps(&x[k]))));
+    }
+    for (; k < size; ++k) { y[k] += a[k] * x[k]; }
+}
+
+#define SSE_NR 8
+__attribute__((target("sse")))
+static void sse_gemm(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    __m128 acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        acc[r][0] = _mm_loadu_ps(&c[r * ldc]);
+        acc[r][1] = _mm_loadu_ps(&c[r * ldc + 4]);
+    }
+    for (size_t p = 0; p < k; ++p) {
+        const __m128 b0 = _mm_loadu_ps(&b[p * ldb]);
+        const __m128 b1 = _mm_loadu_ps(&b[p * ldb + 4]);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            const __m128 arp = _mm_set1_ps(a[r * a_rs + p * a_cs]);
+            acc[r][0] = _mm_add_ps(acc[r][0], _mm_mul_ps(arp, b0));
+            acc[r][1] = _mm_add_ps(acc[r][1], _mm_mul_ps(arp, b1));
+        }
+    }
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        _mm_storeu_ps(&c[r * ldc], acc[r][0]);
+        _mm_storeu_ps(&c[r * ldc + 4], acc[r][1]);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static real_t avx2_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t k = 0;
+    for (; k + 16 <= size; k += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&u[k]), _mm256_loadu_ps(&v[k]), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(&u[k+8]), _mm256_loadu_ps(&v[k+8]), acc1);
+    }
+    for (; k + 8 <= size; k += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(&u[k]), _mm256_loadu_ps(&v[k]), acc0);
+    }
+
+    // Horizontal sum
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    real_t sum = _mm_cvtss_f32(half);
+
+    for (; k < size; ++k) { sum += u[k] * v[k]; }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static void avx2_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    const __m256 va = _mm256_set1_ps(a);
+    size_t k = 0;
+    for (; k + 8 <= size; k += 8) {
+        _mm256_storeu_ps(&y[k], _mm256_fmadd_ps(va, _mm256_loadu_ps(&x[k]), _mm256_loadu_ps(&y[k])));
+    }
+    for (; k < size; ++k) { y[k] += a * x[k]; }
+}
+
+__attribute__((target("avx2,fma")))
+static void avx2_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    size_t k = 0;
+    for (; k + 8 <= size; k += 8) {
+        _mm256_storeu_ps(&y[k], _mm256_fmadd_ps(_mm256_loadu_ps(&a[k]), _mm256_loadu_ps(&x[k]), _mm256_loadu_ps(&y[k])));
+    }
+    for (; k < size; ++k) { y[k] += a[k] * x[k]; }
+}
+
+#define AVX2_NR 16
+__attribute__((target("avx2,fma")))
+static void avx2_gemm(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    __m256 acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        acc[r][0] = _mm256_loadu_ps(&c[r * ldc]);
+        acc[r][1] = _mm256_loadu_ps(&c[r * ldc + 8]);
+    }
+    for (size_t p = 0; p < k; ++p) {
+        const __m256 b0 = _mm256_loadu_ps(&b[p * ldb]);
+        const __m256 b1 = _mm256_loadu_ps(&b[p * ldb + 8]);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            const __m256 arp = _mm256_set1_ps(a[r * a_rs + p * a_cs]);
+            acc[r][0] = _mm256_fmadd_ps(arp, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(arp, b1, acc[r][1]);
+        }
+    }
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        _mm256_storeu_ps(&c[r * ldc], acc[r][0]);
+        _mm256_storeu_ps(&c[r * ldc + 8], acc[r][1]);
+    }
+}
+
+__attribute__((target("avx512f")))
+static real_t avx512_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t k = 0;
+    for (; k + 32 <= size; k += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(&u[k]), _mm512_loadu_ps(&v[k]), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(&u[k+16]), _mm512_loadu_ps(&v[k+16]), acc1);
+    }
+
+    // Remaining elements with a masked load
+    if (k < size) {
+        const size_t rest = size - k;
+        const __mmask16 mask = (__mmask16) (rest >= 16 ? 0xFFFF : ((1u << rest) - 1));
+        acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, &u[k]), _mm512_maskz_loadu_ps(mask, &v[k]), acc0);
+        if (rest > 16) {
+            const __mmask16 mask1 = (__mmask16) ((1u << (rest - 16)) - 1);
+            acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask1, &u[k+16]), _mm512_maskz_loadu_ps(mask1, &v[k+16]), acc1);
+        }
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f")))
+static void avx512_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    const __m512 va = _mm512_set1_ps(a);
+    size_t k = 0;
+    for (; k + 16 <= size; k += 16) {
+        _mm512_storeu_ps(&y[k], _mm512_fmadd_ps(va, _mm512_loadu_ps(&x[k]), _mm512_loadu_ps(&y[k])));
+    }
+    if (k < size) {
+        const __mmask16 mask = (__mmask16) ((1u << (size - k)) - 1);
+        const __m512 vy = _mm512_maskz_loadu_ps(mask, &y[k]);
+        _mm512_mask_storeu_ps(&y[k], mask, _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, &x[k]), vy));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void avx512_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    size_t k = 0;
+    for (; k + 16 <= size; k += 16) {
+        _mm512_storeu_ps(&y[k], _mm512_fmadd_ps(_mm512_loadu_ps(&a[k]), _mm512_loadu_ps(&x[k]), _mm512_loadu_ps(&y[k])));
+    }
+    if (k < size) {
+        const __mmask16 mask = (__mmask16) ((1u << (size - k)) - 1);
+        const __m512 vy = _mm512_maskz_loadu_ps(mask, &y[k]);
+        _mm512_mask_storeu_ps(&y[k], mask, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, &a[k]), _mm512_maskz_loadu_ps(mask, &x[k]), vy));
+    }
+}
+
+#define AVX512_NR 32
+__attribute__((target("avx512f")))
+static void avx512_gemm(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    __m512 acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        acc[r][0] = _mm512_loadu_ps(&c[r * ldc]);
+        acc[r][1] = _mm512_loadu_ps(&c[r * ldc + 16]);
+    }
+    for (size_t p = 0; p < k; ++p) {
+        const __m512 b0 = _mm512_loadu_ps(&b[p * ldb]);
+        const __m512 b1 = _mm512_loadu_ps(&b[p * ldb + 16]);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            const __m512 arp = _mm512_set1_ps(a[r * a_rs + p * a_cs]);
+            acc[r][0] = _mm512_fmadd_ps(arp, b0, acc[r][0]);
+            acc[r][1] = _mm512_fmadd_ps(arp, b1, acc[r][1]);
+        }
+    }
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        _mm512_storeu_ps(&c[r * ldc], acc[r][0]);
+        _mm512_storeu_ps(&c[r * ldc + 16], acc[r][1]);
+    }
+}
+
+#endif // DSP_SIMD_X86
+
+
+
+// ----- ARM -----
+
+#ifdef DSP_SIMD_ARM
+
+static real_t neon_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    float32x4_t acc0 = vdupq_n_f32(0);
+    float32x4_t acc1 = vdupq_n_f32(0);
+    size_t k = 0;
+    for (; k + 8 <= size; k += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&u[k]), vld1q_f32(&v[k]));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(&u[k+4]), vld1q_f32(&v[k+4]));
+    }
+    for (; k + 4 <= size; k += 4) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(&u[k]), vld1q_f32(&v[k]));
+    }
+
+    // Horizontal sum
+    float lanes[4];
+    vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+    real_t sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+    for (; k < size; ++k) { sum += u[k] * v[k]; }
+    return sum;
+}
+
+static void neon_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    const float32x4_t va = vdupq_n_f32(a);
+    size_t k = 0;
+    for (; k + 4 <= size; k += 4) {
+        vst1q_f32(&y[k], vmlaq_f32(vld1q_f32(&y[k]), va, vld1q_f32(&x[k])));
+    }
+    for (; k < size; ++k) { y[k] += a * x[k]; }
+}
+
+static void neon_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    size_t k = 0;
+    for (; k + 4 <= size; k += 4) {
+        vst1q_f32(&y[k], vmlaq_f32(vld1q_f32(&y[k]), vld1q_f32(&a[k]), vld1q_f32(&x[k])));
+    }
+    for (; k < size; ++k) { y[k] += a[k] * x[k]; }
+}
+
+#define NEON_NR 8
+static void neon_gemm(const size_t k, const real_t* const a, const size_t a_rs, const size_t a_cs, const real_t* const b, const size_t ldb, real_t* const c, const size_t ldc) {
+    float32x4_t acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        acc[r][0] = vld1q_f32(&c[r * ldc]);
+        acc[r][1] = vld1q_f32(&c[r * ldc + 4]);
+    }
+    for (size_t p = 0; p < k; ++p) {
+        const float32x4_t b0 = vld1q_f32(&b[p * ldb]);
+        const float32x4_t b1 = vld1q_f32(&b[p * ldb + 4]);
+        for (size_t r = 0; r < GEMM_MR; ++r) {
+            const float32x4_t arp = vdupq_n_f32(a[r * a_rs + p * a_cs]);
+            acc[r][0] = vmlaq_f32(acc[r][0], arp, b0);
+            acc[r][1] = vmlaq_f32(acc[r][1], arp, b1);
+        }
+    }
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+        vst1q_f32(&c[r * ldc], acc[r][0]);
+        vst1q_f32(&c[r * ldc + 4], acc[r][1]);
+    }
+}
+
+#endif // DSP_SIMD_ARM
+
+
+
+// ----- Dispatch -----
+
+typedef struct SimdKernels {
+    dsp_simd_isa_t isa;
+    dot_product_kernel_t dot_product;
+    axpy_kernel_t axpy;
+    multiply_add_kernel_t multiply_add;
+    gemm_kernel_t gemm;
+    size_t gemm_nr;
+} simd_kernels_t;
+
+static const simd_kernels_t scalar_kernels = {SimdScalar, scalar_dot_product, scalar_axpy, scalar_multiply_add, scalar_gemm, SCALAR_NR};
+#ifdef DSP_SIMD_X86
+static const simd_kernels_t sse_kernels = {SimdSSE, sse_dot_product, sse_axpy, sse_multiply_add, sse_gemm, SSE_NR};
+static const simd_kernels_t avx2_kernels = {SimdAVX2, avx2_dot_product, avx2_axpy, avx2_multiply_add, avx2_gemm, AVX2_NR};
+static const simd_kernels_t avx512_kernels = {SimdAVX512, avx512_dot_product, avx512_axpy, avx512_multiply_add, avx512_gemm, AVX512_NR};
+#endif
+#ifdef DSP_SIMD_ARM
+static const simd_kernels_t neon_kernels = {SimdNEON, neon_dot_product, neon_axpy, neon_multiply_add, neon_gemm, NEON_NR};
+#endif
+
+// Kernels in use (resolved on first use, accessed atomically)
+static const simd_kernels_t* active_kernels = NULL;
+
+static const simd_kernels_t* kernels_of(const dsp_simd_isa_t isa) {
+    switch (isa) {
+        case SimdScalar: return &scalar_kernels;
+#ifdef DSP_SIMD_X86
+        case SimdSSE: return (__builtin_cpu_supports("sse") ? &sse_kernels : NULL);
+        case SimdAVX2: return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? &avx2_kernels : NULL);
+        case SimdAVX512: return (__builtin_cpu_supports("avx512f") ? &avx512_kernels : NULL);
+#endif
+#ifdef DSP_SIMD_ARM
+        case SimdNEON: return &neon_kernels;
+#endif
+        default: return NULL;
+    }
+}
+
+static const simd_kernels_t* resolve_kernels() {
+#ifdef DSP_SIMD_FORCED
+    const dsp_simd_isa_t preferred[] = {DSP_SIMD_FORCED};
+#else
+    const dsp_simd_isa_t preferred[] = {SimdAVX512, SimdAVX2, SimdNEON, SimdSSE};
+#endif
+    for (size_t k = 0; k < sizeof(preferred) / sizeof(preferred[0]); ++k) {
+        const simd_kernels_t* const kernels = kernels_of(preferred[k]);
+        if (kernels != NULL) { return kernels; }
+    }
+    return &scalar_kernels;
+}
+
+// Threads racing on the first use resolve the same kernels, a selection made meanwhile is kept
+static inline const simd_kernels_t* kernels() {
+    const simd_kernels_t* active = __atomic_load_n(&active_kernels, __ATOMIC_ACQUIRE);
+    if (active != NULL) { return active; }
+    const simd_kernels_t* const resolved = resolve_kernels();
+    if (__atomic_compare_exchange_n(&active_kernels, &active, resolved, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) { return resolved; }
+    return active;
+}
+
+
+
+bool dsp_simd_is_supported(const dsp_simd_isa_t isa) {
+#ifdef DSP_SIMD_FORCED
+    if (isa != SimdScalar && isa != DSP_SIMD_FORCED) { return false; }
+#endif
+    return (kernels_of(isa) != NULL);
+}
+
+bool dsp_simd_select(const dsp_simd_isa_t isa) {
+    if (!dsp_simd_is_supported(isa)) { return false; }
+    __atomic_store_n(&active_kernels, kernels_of(isa), __ATOMIC_RELEASE);
+    return true;
+}
+
+dsp_simd_isa_t dsp_simd_selected() {
+    return kernels()->isa;
+}
+
+const char* dsp_simd_isa_name(const dsp_simd_isa_t isa) {
+    switch (isa) {
+        case SimdScalar: return "Scalar";
+        case SimdSSE: return "SSE";
+        case SimdAVX2: return "AVX2";
+        case SimdAVX512: return "AVX512";
+        case SimdNEON: return "NEON";
+        default: return "Unknown";
+    }
+}
+
+
+
+real_t dsp_simd_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    if (u == NULL || v == NULL) { return 0; }
+    if (size == 0) { return 0; }
+#ifdef DSP_PRECISION_MIXED
+    // Only the scalar kernel accumulates in accum_t
+    return scalar_dot_product(u, v, size);
+#else
+    if (size < DSP_SIMD_MIN_SIZE) { return scalar_dot_product(u, v, size); }
+    return kernels()->dot_product(u, v, size);
+#endif
+}
+
+void dsp_simd_axpy(real_t* const y, const real_t a, const real_t* const x, const size_t size) {
+    if (y == NULL || x == NULL) { return; }
+    if (size == 0) { return; }
+    kernels()->axpy(y, a, x, size);
+}
+
+void dsp_simd_multiply_add(real_t* const y, const real_t* const a, const real_t* const x, const size_t size) {
+    if (y == NULL || a == NULL || x == NULL) { return; }
+    if (size == 0) { return; }
+    kernels()->multiply_add(y, a, x, size);
+}
+
+void dsp_simd_gemm(const size_t m, const size_t n, const size_t k,
+    const real_t* const a, const size_t a_row_stride, const size_t a_column_stride,
+    const real_t* const b, const size_t ldb,
+    real_t* const c, const size_t ldc) {
+
+    if (a == NULL || b == NULL || c == NULL) { return; }
+    const simd_kernels_t* const active = kernels();
+    const size_t nr = active->gemm_nr;
+
+    // Cache blocks of B
+    for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+        const size_t kc = (k - pc < GEMM_KC ? k - pc : GEMM_KC);
+        for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+            const size_t nc = (n - jc < GEMM_NC ? n - jc : GEMM_NC);
+
+            // Register tiles of C
+            for (size_t i = 0; i < m; i += GEMM_MR) {
+                const size_t mr = (m - i < GEMM_MR ? m - i : GEMM_MR);
+                const real_t* const a_block = &(a[i * a_row_stride + pc * a_column_stride]);
+                const real_t* const b_block = &(b[pc * ldb + jc]);
+                real_t* const c_block = &(c[i * ldc + jc]);
+
+                size_t j = 0;
+                if (mr == GEMM_MR) {
+                    for (; j + nr <= nc; j += nr) {
+                        active->gemm(kc, a_block, a_row_stride, a_column_stride, &(b_block[j]), ldb, &(c_block[j]), ldc);
+                    }
+                }
+                if (j < nc) {
+                    scalar_gemm_block(mr, nc - j, kc, a_block, a_row_stride, a_column_stride, &(b_block[j]), ldb, &(c_block[j]), ldc);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,493 @@
+#ifdef DSP_THREADS
+#include <sched.h> // sched_yield
+#endif
+
+#include <string.h> // memset, memcpy
+#include <stdint.h> // uintptr_t, SIZE_MAX
+#include <time.h> // clock_gettime
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Parallel/TaskGraph.h"
+
+// Block records and deques on their own cache lines, so two workers never write the same line
+#define GRAPH_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (GRAPH_ALIGNMENT - 1)) & ~((uintptr_t) GRAPH_ALIGNMENT - 1))
+
+// Signal without a writer (input of the graph)
+#define NO_WRITER SIZE_MAX
+
+// Result of an empty deque
+#define NO_TASK SIZE_MAX
+
+
+typedef enum TaskKind {
+    TaskPid,
+    TaskZtf,
+    TaskSaturation,
+    TaskZso,
+    TaskFunction,
+} task_kind_t;
+
+typedef struct TaskBlock {
+    task_kind_t kind;
+    void* block;
+    dsp_task_function_t function;
+    void* context;
+
+    // Signals: 'n_in' inputs followed by 'n_out' outputs, and room to gather their values
+    size_t n_in;
+    size_t n_out;
+    size_t* signals;
+    real_t* values;
+
+    // Blocks reading an output of this block (set by 'dsp_task_graph_compile()')
+    size_t* successors;
+    size_t n_successors;
+
+    // Blocks writing an input of this block, and how many of them are still running in this tick
+    size_t indegree;
+    size_t pending;
+
+    dsp_task_stats_t stats;
+} task_block_t;
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, thieves take from the top.
+// Every block is pushed at most once per tick, so the array never wraps around.
+// Sequentially consistent accesses of 'top' and 'bottom' take the place of the fences of the original algorithm.
+typedef struct TaskDeque {
+    int64_t top;
+    unsigned char top_line[GRAPH_ALIGNMENT - sizeof(int64_t)];
+    int64_t bottom;
+    size_t* tasks;
+} task_deque_t;
+
+#define BLOCK_SIZE ALIGN_UP(sizeof(task_block_t))
+#define DEQUE_SIZE ALIGN_UP(sizeof(task_deque_t))
+
+struct TaskGraph {
+
+    size_t n_signals;
+    real_t* signal;
+
+    // Block writing each signal
+    size_t* writer;
+
+    size_t max_blocks;
+    size_t n_blocks;
+    unsigned char* blocks;
+
+    // ----- Compiled -----
+
+    bool compiled;
+    dsp_executor_t* executor;
+    size_t workers;
+
+    // Blocks in dependency order, the blocks without dependencies first
+    size_t* order;
+    size_t n_roots;
+
+    // 'workers' deques of DEQUE_SIZE bytes
+    unsigned char* deques;
+
+    // Blocks not finished in this tick
+    size_t remaining;
+
+    // Internal: successors, order and deques in one allocation
+    void* compiled_block;
+
+    // Internal: struct, signals, writers and block records in one allocation
+    void* block;
+};
+
+#define BLOCK(graph, k) ((task_block_t*) &((graph)->blocks[(k) * BLOCK_SIZE]))
+#define DEQUE(graph, k) ((task_deque_t*) &((graph)->deques[(k) * DEQUE_SIZE]))
+
+
+
+static uint64_t now_ns() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+
+
+// Create
+dsp_task_graph_t* dsp_task_graph_create(const size_t signals, const size_t max_blocks) {
+    if (signals == 0 || max_blocks == 0) { return NULL; }
+
+    // Layout: the graph struct, then the block records, the signals and their writers
+    const size_t blocks_size = max_blocks * BLOCK_SIZE;
+    const size_t signals_size = ALIGN_UP(signals * sizeof(real_t));
+    unsigned char* const block = (unsigned char*) dsp_malloc(sizeof(struct TaskGraph) + GRAPH_ALIGNMENT + blocks_size + signals_size + signals * sizeof(size_t));
+    if (block == NULL) { return NULL; }
+
+    struct TaskGraph* const graph = (struct TaskGraph*) block;
+    memset(graph, 0, sizeof(struct TaskGraph));
+    graph->n_signals = signals;
+    graph->max_blocks = max_blocks;
+    graph->blocks = (unsigned char*) ALIGN_UP((uintptr_t) &block[sizeof(struct TaskGraph)]);
+    graph->signal = (real_t*) &graph->blocks[blocks_size];
+    graph->writer = (size_t*) &graph->blocks[blocks_size + signals_size];
+    graph->block = block;
+
+    memset(graph->blocks, 0, blocks_size + signals_size);
+    for (size_t s = 0; s < signals; ++s) { graph->writer[s] = NO_WRITER; }
+    return graph;
+}
+
+// Destroy
+bool dsp_task_graph_destroy(dsp_task_graph_t* const graph) {
+    if (graph == NULL) { return false; }
+
+    for (size_t k = 0; k < graph->n_blocks; ++k) { dsp_free(BLOCK(graph, k)->signals); }
+    if (graph->compiled_block != NULL) { dsp_free(graph->compiled_block); }
+
+    // The struct lives at the beginning of the block
+    dsp_free(graph->block);
+    return true;
+}
+
+
+
+// Add a block reading 'n_in' signals and writing 'n_out' signals
+static bool add_block(dsp_task_graph_t* const graph, const task_kind_t kind, void* const block,
+    const size_t n_in, const size_t* const inputs, const size_t n_out, const size_t* const outputs) {
+
+    if (graph->n_blocks >= graph->max_blocks) { return false; }
+    for (size_t i = 0; i < n_in; ++i) {
+        if (inputs[i] >= graph->n_signals) { return false; }
+    }
+    for (size_t i = 0; i < n_out; ++i) {
+        if (outputs[i] >= graph->n_signals || graph->writer[outputs[i]] != NO_WRITER) { return false; }
+        for (size_t j = 0; j < i; ++j) {
+            if (outputs[j] == outputs[i]) { return false; }
+        }
+    }
+
+    // Signal numbers and values in one allocation
+    const size_t n = n_in + n_out;
+    unsigned char* const memory = (unsigned char*) dsp_malloc(n * (sizeof(size_t) + sizeof(real_t)) + 1);
+    if (memory == NULL) { return false; }
+
+    task_block_t* const task = BLOCK(graph, graph->n_blocks);
+    memset(task, 0, sizeof(task_block_t));
+    task->kind = kind;
+    task->block = block;
+    task->n_in = n_in;
+    task->n_out = n_out;
+    task->signals = (size_t*) memory;
+    task->values = (real_t*) &memory[n * sizeof(size_t)];
+    if (n_in != 0) { memcpy(task->signals, inputs, n_in * sizeof(size_t)); }
+    if (n_out != 0) { memcpy(&task->signals[n_in], outputs, n_out * sizeof(size_t)); }
+
+    for (size_t i = 0; i < n_out; ++i) { graph->writer[outputs[i]] = graph->n_blocks; }
+    graph->n_blocks += 1;
+    graph->compiled = false;
+    return true;
+}
+
+bool dsp_task_graph_add_pid(dsp_task_graph_t* const graph, dsp_pid_t* const pid, const size_t input, const size_t output) {
+    if (graph == NULL || pid == NULL) { return false; }
+    return add_block(graph, TaskPid, pid, 1, &input, 1, &output);
+}
+
+bool dsp_task_graph_add_ztf(dsp_task_graph_t* const graph, dsp_ztf_t* const ztf, const size_t input, const size_t output) {
+    if (graph == NULL || ztf == NULL) { return false; }
+    return add_block(graph, TaskZtf, ztf, 1, &input, 1, &output);
+}
+
+bool dsp_task_graph_add_saturation(dsp_task_graph_t* const graph, dsp_saturation_t* const saturation, const size_t input, const size_t output) {
+    if (graph == NULL || saturation == NULL) { return false; }
+    return add_block(graph, TaskSaturation, saturation, 1, &input, 1, &output);
+}
+
+bool dsp_task_graph_add_zso(dsp_task_graph_t* const graph, dsp_zso_t* const zso, const size_t* const u, const size_t* const y, const size_t* const xh) {
+    if (graph == NULL || zso == NULL || u == NULL || y == NULL || xh == NULL) { return false; }
+    if (zso->B == NULL || zso->C == NULL) { return false; }
+
+    // Inputs: u, then y
+    const size_t nx = zso->C->columns;
+    const size_t nu = zso->B->columns;
+    const size_t ny = zso->C->rows;
+    size_t inputs[nu + ny];
+    memcpy(inputs, u, nu * sizeof(size_t));
+    memcpy(&inputs[nu], y, ny * sizeof(size_t));
+    return add_block(graph, TaskZso, zso, nu + ny, inputs, nx, xh);
+}
+
+bool dsp_task_graph_add_function(dsp_task_graph_t* const graph, dsp_task_function_t function, void* const context,
+    const size_t n_in, const size_t* const inputs, const size_t n_out, const size_t* const outputs) {
+
+    if (graph == NULL || function == NULL) { return false; }
+    if ((n_in != 0 && inputs == NULL) || (n_out != 0 && outputs == NULL)) { return false; }
+    if (!add_block(graph, TaskFunction, NULL, n_in, inputs, n_out, outputs)) { return false; }
+
+    task_block_t* const task = BLOCK(graph, graph->n_blocks - 1);
+    task->function = function;
+    task->context = context;
+    return true;
+}
+
+
+
+// Compile
+bool dsp_task_graph_compile(dsp_task_graph_t* const graph, dsp_executor_t* const executor) {
+    if (graph == NULL) { return false; }
+
+    if (graph->compiled_block != NULL) { dsp_free(graph->compiled_block); }
+    graph->compiled_block = NULL;
+    graph->compiled = false;
+
+    const size_t n_blocks = graph->n_blocks;
+    const size_t workers = (executor == NULL ? 1 : dsp_executor_workers(executor));
+
+    // Edges from the writer of every input to the reader
+    size_t n_edges = 0;
+    for (size_t k = 0; k < n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        task->n_successors = 0;
+        task->indegree = 0;
+    }
+    for (size_t k = 0; k < n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        for (size_t i = 0; i < task->n_in; ++i) {
+            const size_t writer = graph->writer[task->signals[i]];
+            if (writer == NO_WRITER) { continue; }
+            if (writer == k) { return false; }
+            BLOCK(graph, writer)->n_successors += 1;
+            task->indegree += 1;
+            n_edges += 1;
+        }
+    }
+
+    // Layout: successors, order, deques, the tasks of the deques
+    const size_t edges_size = ALIGN_UP(n_edges * sizeof(size_t));
+    const size_t order_size = ALIGN_UP(n_blocks * sizeof(size_t));
+    const size_t deques_size = workers * DEQUE_SIZE;
+    unsigned char* const block = (unsigned char*) dsp_malloc(GRAPH_ALIGNMENT + edges_size + order_size + deques_size + workers * n_blocks * sizeof(size_t));
+    if (block == NULL) { return false; }
+
+    unsigned char* const memory = (unsigned char*) ALIGN_UP((uintptr_t) block);
+    size_t* const edges = (size_t*) memory;
+    graph->order = (size_t*) &memory[edges_size];
+    graph->deques = &memory[edges_size + order_size];
+    size_t* const tasks = (size_t*) &memory[edges_size + order_size + deques_size];
+    for (size_t w = 0; w < workers; ++w) {
+        memset(DEQUE(graph, w), 0, sizeof(task_deque_t));
+        DEQUE(graph, w)->tasks = &tasks[w * n_blocks];
+    }
+
+    size_t offset = 0;
+    for (size_t k = 0; k < n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        task->successors = &edges[offset];
+        offset += task->n_successors;
+        task->n_successors = 0;
+    }
+    for (size_t k = 0; k < n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        for (size_t i = 0; i < task->n_in; ++i) {
+            const size_t writer = graph->writer[task->signals[i]];
+            if (writer == NO_WRITER) { continue; }
+            task_block_t* const source = BLOCK(graph, writer);
+            source->successors[source->n_successors++] = k;
+        }
+    }
+
+    // Dependency order (Kahn), the roots first
+    size_t n_ordered = 0;
+    for (size_t k = 0; k < n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        task->pending = task->indegree;
+        if (task->indegree == 0) { graph->order[n_ordered++] = k; }
+    }
+    graph->n_roots = n_ordered;
+    for (size_t next = 0; next < n_ordered; ++next) {
+        const task_block_t* const task = BLOCK(graph, graph->order[next]);
+        for (size_t i = 0; i < task->n_successors; ++i) {
+            task_block_t* const successor = BLOCK(graph, task->successors[i]);
+            if (--successor->pending == 0) { graph->order[n_ordered++] = task->successors[i]; }
+        }
+    }
+
+    // Blocks left over depend on each other in a cycle (with or without state on the way)
+    graph->compiled_block = block;
+    if (n_ordered != n_blocks) { return false; }
+
+    graph->executor = executor;
+    graph->workers = workers;
+    graph->compiled = true;
+    return true;
+}
+
+
+
+// Run one block on a worker
+static void run_block(dsp_task_graph_t* const graph, task_block_t* const task, const size_t worker) {
+    real_t* const signal = graph->signal;
+    const size_t* const signals = task->signals;
+    const uint64_t start = now_ns();
+
+    switch (task->kind) {
+        case TaskPid:
+            signal[signals[1]] = dsp_pid_update((dsp_pid_t*) task->block, signal[signals[0]]);
+            break;
+        case TaskZtf:
+            signal[signals[1]] = dsp_ztf_update((dsp_ztf_t*) task->block, signal[signals[0]]);
+            break;
+        case TaskSaturation:
+            signal[signals[1]] = dsp_saturation_update((dsp_saturation_t*) task->block, signal[signals[0]]);
+            break;
+        case TaskZso:
+        case TaskFunction: {
+            real_t* const values = task->values;
+            for (size_t i = 0; i < task->n_in; ++i) { values[i] = signal[signals[i]]; }
+            if (task->kind == TaskZso) {
+                dsp_zso_t* const zso = (dsp_zso_t*) task->block;
+                dsp_zso_update(zso, values, &values[zso->B->columns], &values[task->n_in]);
+            }
+            else { task->function(task->context, values, &values[task->n_in]); }
+            for (size_t i = 0; i < task->n_out; ++i) { signal[signals[task->n_in + i]] = values[task->n_in + i]; }
+            break;
+        }
+    }
+
+    const uint64_t elapsed = now_ns() - start;
+    task->stats.ticks += 1;
+    task->stats.last_ns = elapsed;
+    task->stats.total_ns += elapsed;
+    if (elapsed > task->stats.max_ns) { task->stats.max_ns = elapsed; }
+    task->stats.worker = worker;
+}
+
+
+
+// ----- Deque -----
+
+static void deque_push(task_deque_t* const deque, const size_t task) {
+    const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    deque->tasks[bottom] = task;
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+}
+
+static size_t deque_pop(task_deque_t* const deque) {
+    const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NO_TASK;
+    }
+    size_t task = deque->tasks[bottom];
+    if (top == bottom) {
+        // Last task: race against the thieves
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) { task = NO_TASK; }
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return task;
+}
+
+static size_t deque_steal(task_deque_t* const deque) {
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+    const int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+    if (top >= bottom) { return NO_TASK; }
+
+    const size_t task = deque->tasks[top];
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) { return NO_TASK; }
+    return task;
+}
+
+
+
+// Loop of every worker in a tick: own blocks first (newest first), then steal, until all blocks are done
+static void worker_loop(void* const context, const size_t worker, const size_t count) {
+    (void) count;
+    dsp_task_graph_t* const graph = (dsp_task_graph_t*) context;
+    task_deque_t* const own = DEQUE(graph, worker);
+
+    while (__atomic_load_n(&graph->remaining, __ATOMIC_ACQUIRE) != 0) {
+
+        size_t next = deque_pop(own);
+        for (size_t k = 1; k < graph->workers && next == NO_TASK; ++k) {
+            next = deque_steal(DEQUE(graph, (worker + k) % graph->workers));
+        }
+        if (next == NO_TASK) {
+#ifdef DSP_THREADS
+            sched_yield();
+#endif
+            continue;
+        }
+
+        task_block_t* const task = BLOCK(graph, next);
+        run_block(graph, task, worker);
+
+        // Blocks whose last dependency this was are ready
+        for (size_t i = 0; i < task->n_successors; ++i) {
+            task_block_t* const successor = BLOCK(graph, task->successors[i]);
+            if (__atomic_sub_fetch(&successor->pending, 1, __ATOMIC_ACQ_REL) == 0) { deque_push(own, task->successors[i]); }
+        }
+        __atomic_sub_fetch(&graph->remaining, 1, __ATOMIC_ACQ_REL);
+    }
+}
+
+// Tick
+bool dsp_task_graph_tick(dsp_task_graph_t* const graph) {
+    if (graph == NULL || !graph->compiled) { return false; }
+
+    // One worker: dependency order, no synchronization
+    if (graph->workers == 1) {
+        for (size_t k = 0; k < graph->n_blocks; ++k) { run_block(graph, BLOCK(graph, graph->order[k]), 0); }
+        return true;
+    }
+
+    // Roots dealt round robin, the workers publish everything else themselves
+    for (size_t k = 0; k < graph->n_blocks; ++k) {
+        task_block_t* const task = BLOCK(graph, k);
+        task->pending = task->indegree;
+    }
+    for (size_t w = 0; w < graph->workers; ++w) {
+        DEQUE(graph, w)->top = 0;
+        DEQUE(graph, w)->bottom = 0;
+    }
+    for (size_t k = 0; k < graph->n_roots; ++k) {
+        deque_push(DEQUE(graph, k % graph->workers), graph->order[k]);
+    }
+    graph->remaining = graph->n_blocks;
+
+    return dsp_executor_broadcast(graph->executor, worker_loop, graph);
+}
+
+
+
+// Signals
+bool dsp_task_graph_set_signal(dsp_task_graph_t* const graph, const size_t signal, const real_t value) {
+    if (graph == NULL || signal >= graph->n_signals) { return false; }
+    graph->signal[signal] = value;
+    return true;
+}
+
+real_t dsp_task_graph_get_signal(const dsp_task_graph_t* const graph, const size_t signal) {
+    if (graph == NULL || signal >= graph->n_signals) { return 0; }
+    return graph->signal[signal];
+}
+
+
+
+// Stats
+bool dsp_task_graph_get_stats(const dsp_task_graph_t* const graph, const size_t block, dsp_task_stats_t* const stats) {
+    if (graph == NULL || stats == NULL) { return false; }
+    if (block >= graph->n_blocks) { return false; }
+
+    *stats = BLOCK(graph, block)->stats;
+    return true;
+}
+
+bool dsp_task_graph_reset_stats(dsp_task_graph_t* const graph) {
+    if (graph == NULL) { return false; }
+
+    for (size_t k = 0; k < graph->n_blocks; ++k) {
+        memset(&BLOCK(graph, k)->stats, 0, sizeof(dsp_task_stats_t));
+    }
+    return true;
+}
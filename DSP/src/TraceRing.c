@@ -0,0 +1,185 @@
+#include <string.h> // memset, memcpy
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Diagnostics/LatencyHistogram.h" // dsp_latency_ticks
+#include "DSP/Diagnostics/TraceRing.h"
+
+
+struct TraceRing {
+
+    // Number of records written, only stored by the owning thread
+    uint64_t head;
+
+    // Timestamp of the following records
+    uint64_t timestamp;
+
+    // Capacity - 1 (power of 2)
+    size_t mask;
+
+    dsp_trace_record_t* records;
+
+    // Internal: struct and records packed into one allocation
+    void* block;
+};
+
+
+// Ring of the calling thread (initial-exec: read without a call to __tls_get_addr in the shared library)
+static _Thread_local dsp_trace_t* selected_trace __attribute__((tls_model("initial-exec"))) = NULL;
+
+
+dsp_trace_t* dsp_trace_create(const size_t capacity) {
+    if (capacity == 0 || capacity > ((size_t) 1 << (8 * sizeof(size_t) - 2))) { return NULL; }
+    size_t size = 1;
+    while (size < capacity) { size <<= 1; }
+
+    const size_t bytes = sizeof(dsp_trace_t) + size * sizeof(dsp_trace_record_t);
+    void* const block = dsp_malloc(bytes);
+    if (block == NULL) { return NULL; }
+    memset(block, 0, bytes);
+
+    dsp_trace_t* const trace = (dsp_trace_t*) block;
+    trace->block = block;
+    trace->mask = size - 1;
+    trace->records = (dsp_trace_record_t*) (trace + 1);
+    return trace;
+}
+
+bool dsp_trace_destroy(dsp_trace_t* const trace) {
+    if (trace == NULL) { return false; }
+    if (selected_trace == trace) { selected_trace = NULL; }
+    dsp_free(trace->block);
+    return true;
+}
+
+size_t dsp_trace_capacity(const dsp_trace_t* const trace) {
+    return (trace == NULL ? 0 : trace->mask + 1);
+}
+
+uint64_t dsp_trace_written(const dsp_trace_t* const trace) {
+    return (trace == NULL ? 0 : __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE));
+}
+
+bool dsp_trace_select(dsp_trace_t* const trace) {
+    selected_trace = trace;
+    return true;
+}
+
+dsp_trace_t* dsp_trace_selected() {
+    return selected_trace;
+}
+
+void dsp_trace_stamp(dsp_trace_t* const trace) {
+    dsp_trace_t* const ring = (trace == NULL ? selected_trace : trace);
+    if (ring == NULL) { return; }
+    ring->timestamp = dsp_latency_ticks();
+}
+
+// Records are copied in 64-bit words: the sequence, the timestamp, the header and the values in pairs
+#define RECORD_WORDS (sizeof(dsp_trace_record_t) / sizeof(uint64_t))
+_Static_assert(sizeof(dsp_trace_record_t) == RECORD_WORDS * sizeof(uint64_t), "dsp_trace_record_t musst be a whole number of words");
+
+typedef union {
+    struct { uint16_t source; uint16_t kind; uint32_t count; } header;
+    float values[2];
+    uint64_t word;
+} record_word_t;
+
+static uint64_t header_word(const uint16_t source, const uint16_t kind, const uint32_t count) {
+    record_word_t w;
+    w.header.source = source;
+    w.header.kind = kind;
+    w.header.count = count;
+    return w.word;
+}
+
+static uint64_t values_word(const real_t first, const real_t second) {
+    record_word_t w;
+    w.values[0] = (float) first;
+    w.values[1] = (float) second;
+    return w.word;
+}
+
+// Sequence lock: clear the sequence, store the words, publish the sequence and the head.
+// The words are release stores (plain stores on x86), so a reader that sees a new word also sees the cleared sequence.
+static void write_record(dsp_trace_t* const ring, const uint64_t header, const uint64_t v01, const uint64_t v23, const uint64_t v45) {
+    const uint64_t head = ring->head + 1;
+    uint64_t* const slot = (uint64_t*) &ring->records[ring->head & ring->mask];
+    __atomic_store_n(&slot[0], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot[1], ring->timestamp, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot[2], header, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot[3], v01, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot[4], v23, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot[5], v45, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot[0], head, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+}
+
+void dsp_trace_write(dsp_trace_t* const trace, const uint16_t source, const uint16_t kind, const real_t* const values, const size_t count) {
+    dsp_trace_t* const ring = (trace == NULL ? selected_trace : trace);
+    if (ring == NULL || (values == NULL && count != 0)) { return; }
+    const size_t n = (count < DSP_TRACE_VALUES ? count : DSP_TRACE_VALUES);
+
+    real_t v[DSP_TRACE_VALUES] = {0};
+    for (size_t k = 0; k < n; ++k) { v[k] = values[k]; }
+    write_record(ring, header_word(source, kind, (uint32_t) n), values_word(v[0], v[1]), values_word(v[2], v[3]), values_word(v[4], v[5]));
+}
+
+void dsp_trace_pid(dsp_trace_t* const trace, const uint16_t source, const dsp_pid_t* const pid) {
+    dsp_trace_t* const ring = (trace == NULL ? selected_trace : trace);
+    if (ring == NULL || pid == NULL) { return; }
+
+    write_record(ring, header_word(source, TracePid, DSP_TRACE_VALUES),
+        values_word(pid->input, pid->pidsum), values_word(pid->output, pid->Xi), values_word(pid->Xd, pid->Xr));
+}
+
+// Copy record number 'number' (false if it was overwritten or is being written)
+static bool copy_record(const dsp_trace_t* const trace, const uint64_t number, dsp_trace_record_t* const copy) {
+    const uint64_t* const slot = (const uint64_t*) &trace->records[number & trace->mask];
+    uint64_t words[RECORD_WORDS];
+    words[0] = __atomic_load_n(&slot[0], __ATOMIC_ACQUIRE);
+    if (words[0] != number + 1) { return false; }
+
+    // Acquire loads keep the second load of the sequence behind the words
+    for (size_t k = 1; k < RECORD_WORDS; ++k) { words[k] = __atomic_load_n(&slot[k], __ATOMIC_ACQUIRE); }
+    if (__atomic_load_n(&slot[0], __ATOMIC_RELAXED) != words[0]) { return false; }
+    memcpy(copy, words, sizeof(words));
+    return true;
+}
+
+// Numbers of the records in the ring: [first, head)
+static uint64_t first_record(const dsp_trace_t* const trace, const uint64_t head, const size_t capacity) {
+    const uint64_t size = (capacity < trace->mask + 1 ? capacity : trace->mask + 1);
+    return (head > size ? head - size : 0);
+}
+
+size_t dsp_trace_snapshot(const dsp_trace_t* const trace, dsp_trace_record_t* const records, const size_t capacity) {
+    if (trace == NULL || records == NULL) { return 0; }
+    const uint64_t head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+    size_t copied = 0;
+    for (uint64_t number = first_record(trace, head, capacity); number < head; ++number) {
+        if (copy_record(trace, number, &records[copied])) { ++copied; }
+    }
+    return copied;
+}
+
+bool dsp_trace_dump(const dsp_trace_t* const trace, FILE* const stream) {
+    if (trace == NULL || stream == NULL) { return false; }
+    const uint64_t head = __atomic_load_n(&trace->head, __ATOMIC_ACQUIRE);
+    const uint64_t first = first_record(trace, head, trace->mask + 1);
+
+    // Records overwritten during the dump are written with sequence 0, so no allocation is needed
+    dsp_trace_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DSP_TRACE_MAGIC, sizeof(header.magic));
+    header.version = DSP_TRACE_VERSION;
+    header.record_size = sizeof(dsp_trace_record_t);
+    header.records = head - first;
+    header.ns_per_tick = dsp_latency_ticks_to_ns(1);
+    if (fwrite(&header, sizeof(header), 1, stream) != 1) { return false; }
+
+    for (uint64_t number = first; number < head; ++number) {
+        dsp_trace_record_t record;
+        if (!copy_record(trace, number, &record)) { memset(&record, 0, sizeof(record)); }
+        if (fwrite(&record, sizeof(record), 1, stream) != 1) { return false; }
+    }
+    return fflush(stream) == 0;
+}
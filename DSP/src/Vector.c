@@ -1,17 +1,20 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset, memmove
-#include <math.h> // sqrtf, acosf
+#include <math.h> // sqrtf, acosf, sqrt, acos
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Math/Vector.h"
+#include "DSP/Discrete/Signal.h" // dsp_dot_product, dsp_conv, dsp_deconv
+#include "DSP/Math/LUDecomposition.h" // dsp_matrix_lu_t
+#include "DSP/Math/QRDecomposition.h" // dsp_matrix_qr_t
 
 
 
 
 #define VECTOR_SIZE sizeof(dsp_vector_t)
-#define NEW_VECTOR() ((dsp_vector_t*) malloc(VECTOR_SIZE))
+#define NEW_VECTOR() ((dsp_vector_t*) dsp_malloc(VECTOR_SIZE))
 
 #define REAL_SIZE sizeof(real_t)
 #define ARRAY_SIZE(size) ((size) * REAL_SIZE)
-#define NEW_ARRAY(size) ((real_t*) malloc(ARRAY_SIZE(size)))
+#define NEW_ARRAY(size) ((real_t*) dsp_malloc(ARRAY_SIZE(size)))
 #define ELEMENT(vec, index) ((vec)->elements[(index)])
 
 
@@ -36,7 +39,7 @@ dsp_vector_t* dsp_vector_create(const size_t size) {
             return vec; 
         }
         else { 
-            free(vec); 
+            dsp_free(vec); 
             return NULL; 
         }
     }
@@ -294,7 +297,7 @@ bool dsp_vector_allocate_internal_array(dsp_vector_t* const vec, const size_t si
 bool dsp_vector_release_internal_array(dsp_vector_t* const vec) {
     if (vec == NULL) { return false; }
     if (vec->elements != NULL) {
-        free(vec->elements);
+        dsp_free(vec->elements);
         vec->elements = NULL;
         vec->size = 0;
     }
@@ -302,8 +305,8 @@ bool dsp_vector_release_internal_array(dsp_vector_t* const vec) {
 }
 bool dsp_vector_destroy(dsp_vector_t* const vec) {
     if (vec == NULL) { return false; }
-    if (vec->elements != NULL) { free(vec->elements); }
-    free(vec);
+    if (vec->elements != NULL) { dsp_free(vec->elements); }
+    dsp_free(vec);
     return true;
 }
 
@@ -409,18 +412,14 @@ real_t dsp_vector_length_squared(const dsp_vector_t* const vec) {
     return dsp_vector_dot_product(vec, vec);
 }
 real_t dsp_vector_length(const dsp_vector_t* const vec) {
-    return sqrtf(dsp_vector_length_squared(vec));
+    return REAL_SQRT(dsp_vector_length_squared(vec));
 }
 real_t dsp_vector_dot_product(const dsp_vector_t* const a, const dsp_vector_t* const b) {
     if (a == NULL || b == NULL) { return 0; }
     if (a->size != b->size) { return 0; }
     if (a->size == 0) { return 0; }
 
-    real_t acc = a->elements[0] * b->elements[0];  
-    for (size_t k = 1; k < a->size; ++k) {
-        acc += a->elements[k] * b->elements[k];
-    }
-    return acc;
+    return dsp_dot_product(a->elements, b->elements, a->size);
 }
 real_t dsp_vector_cosphi(const dsp_vector_t* const a, const dsp_vector_t* const b) {
     if (a == NULL || b == NULL) { return 0; }
@@ -436,7 +435,7 @@ real_t dsp_vector_cosphi(const dsp_vector_t* const a, const dsp_vector_t* const
     else { return dot_ab / (len_a * len_b); }
 }
 real_t dsp_vector_angle(const dsp_vector_t* const a, const dsp_vector_t* const b) {
-    return acosf(dsp_vector_cosphi(a, b));
+    return REAL_ACOS(dsp_vector_cosphi(a, b));
 }
 real_t dsp_vector_project(const dsp_vector_t* const a, const dsp_vector_t* const b) {
     if (a == NULL || b == NULL) { return 0; }
@@ -588,23 +587,7 @@ bool dsp_vector_conv(dsp_vector_t* const w, const dsp_vector_t* const u, const d
     const size_t conv_size = u->size + v->size - 1;
     if (w->size != conv_size) { return false; }
 
-    size_t start, end;
-    for (size_t	k = 0; k < conv_size; k++) {
-
-        // Determine start and end
-        start = (k < u->size ? 0 : k - (u->size - 1));
-        end = (k < v->size ? k : (v->size - 1));
-
-        // Init
-        w->elements[k] = 0;
-
-        // Calculate k-th element
-        for (size_t j = start; j <= end; ++j) {
-            w->elements[k] += v->elements[j] * u->elements[k-j];
-        }
-    }
-
-    return true;
+    return (dsp_conv(u->elements, u->size, v->elements, v->size, w->elements, w->size) == conv_size);
 }
 
 // Deconvolution and polynomial division
@@ -626,21 +609,8 @@ bool dsp_vector_deconv(dsp_vector_t* const q, dsp_vector_t* const r, const dsp_v
     }
     if (q->size != (u->size - v->size + 1)) { return false;}
 
-    // We copy 'u' into 'r' at the start
-    dsp_vector_copy_assign(r, u);
-
-    // Deconvolution 
-    for (size_t k = 0; k < q->size; ++k) {
-
-        // Divide
-        q->elements[k] = r->elements[k] / v->elements[0];
-
-        // Subtract
-        r->elements[k] = 0;
-        for (size_t j = 1; j < v->size; ++j) {
-            r->elements[k+j] -= q->elements[k] * v->elements[j]; 
-        }
-    }
+    // Copies 'u' into 'r' and divides
+    dsp_deconv(u->elements, u->size, v->elements, v->size, q->elements, q->size, r->elements, r->size);
     return true;
 }
 
@@ -671,10 +641,11 @@ bool dsp_matrix_vector_multiply(dsp_vector_t* const result, const dsp_matrix_t*
 
     for (size_t k = 0; k < result->size; ++k) {
 
-        VECTOR_ELEMENT(result, k) = MATRIX_ELEMENT(mat, k, 0) * VECTOR_ELEMENT(vec, 0);
+        accum_t sum = (accum_t) MATRIX_ELEMENT(mat, k, 0) * VECTOR_ELEMENT(vec, 0);
         for (size_t j = 1; j < vec->size; ++j) {
-            VECTOR_ELEMENT(result, k) += MATRIX_ELEMENT(mat, k, j) * VECTOR_ELEMENT(vec, j);
+            sum += (accum_t) MATRIX_ELEMENT(mat, k, j) * VECTOR_ELEMENT(vec, j);
         }
+        VECTOR_ELEMENT(result, k) = (real_t) sum;
     }
 
     return true;
@@ -688,9 +659,11 @@ bool dsp_matrix_vector_multiply_and_add_to_vector(dsp_vector_t* const acc, const
     if (mat->columns != vec->size) { return false; }
 
     for (size_t k = 0; k < acc->size; ++k) {
+        accum_t sum = VECTOR_ELEMENT(acc, k);
         for (size_t j = 0; j < vec->size; ++j) {
-            VECTOR_ELEMENT(acc, k) += MATRIX_ELEMENT(mat, k, j) * VECTOR_ELEMENT(vec, j);
+            sum += (accum_t) MATRIX_ELEMENT(mat, k, j) * VECTOR_ELEMENT(vec, j);
         }
+        VECTOR_ELEMENT(acc, k) = (real_t) sum;
     }
 
     return true;
@@ -782,57 +755,13 @@ bool dsp_matrix_subract_of_column_vector(dsp_matrix_t* const mat, const size_t c
 // x == pinv(A) * b
 bool dsp_vector_solve_lse(dsp_vector_t* const x, const dsp_matrix_t* const A, const dsp_vector_t* const b) {
     if (x == NULL || A == NULL || b == NULL) { return false; }
-    if (A->columns != x->size) { return false; }
-    if (b->size != A->rows) { return false; }
 
-    if (A->rows == A->columns) {
-
-        // Copy b into x
-        dsp_vector_copy_assign(x, b);
-
-        // Let B borrow the elements from x
-        //dsp_matrix_t B = {
-        //    .rows = x->size,
-        //    .columns = 1,
-        //    .elements = x->elements
-        //};
-
-        // Let B borrow the elements from x
-        dsp_matrix_t B = { x->size, 1, x->elements};
-
-        // create a copy of A
-        dsp_matrix_t* const A_copy =  dsp_matrix_create_copy(A);
-        if (A_copy == NULL) { return false; }
-        
-        if (dsp_matrix_gauss_jordan(A_copy, &B)) {
-
-            // Now B contains the solution to A+x = b
-            // And since B borrowed its elements from x,
-            // x also contains the solution
-            dsp_matrix_destroy(A_copy);
-            // B wasn't created by a call to 'dsp_vector_create_xxx()'
-            // so we don't need to destroy it.
-            return true;
-        }
-        else {
-            // No sulution exists.
-            dsp_matrix_destroy(A_copy);
-            // B wasn't created by a call to 'dsp_vector_create_xxx()'
-            // so we don't need to destroy it.
-            return false;
-        }
-    }
-    else {
-
-        // Calculate the pseudo inverse matrix
-        dsp_matrix_t* const pinv_A = dsp_matrix_create_pinv(A);
-        if (pinv_A == NULL) { return false; }
+    dsp_workspace_t* const ws = dsp_workspace_create(dsp_vector_solve_lse_workspace_size(A->rows, A->columns));
+    if (ws == NULL) { return false; }
 
-        // calculate the solution
-        dsp_matrix_vector_multiply(x, pinv_A, b);
-        dsp_matrix_destroy(pinv_A);
-        return true;
-    }
+    const bool success = dsp_vector_solve_lse_with_workspace(x, A, b, ws);
+    dsp_workspace_destroy(ws);
+    return success;
 }
 
 bool dsp_solve(real_t* const x, const size_t x_size, const real_t* const A, const real_t* const b, const size_t b_size) {
@@ -848,3 +777,73 @@ bool dsp_solve(real_t* const x, const size_t x_size, const real_t* const A, cons
     const dsp_vector_t B = {b_size, (real_t* const) b};
     return dsp_vector_solve_lse(&X, &M, &B);
 }
+
+
+// Workspace
+size_t dsp_vector_workspace_size(const size_t size) {
+    return dsp_workspace_block_size(VECTOR_SIZE) + dsp_workspace_block_size(ARRAY_SIZE(size));
+}
+dsp_vector_t* dsp_vector_create_in_workspace(const size_t size, dsp_workspace_t* const ws) {
+    if (size == 0) { return NULL; }
+
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_vector_t* const vec = (dsp_vector_t*) dsp_workspace_take(ws, VECTOR_SIZE);
+    real_t* const elements = (real_t*) dsp_workspace_take(ws, ARRAY_SIZE(size));
+    if (vec == NULL || elements == NULL) { dsp_workspace_release(ws, mark); return NULL; }
+
+    vec->size = size;
+    vec->elements = elements;
+    return vec;
+}
+
+size_t dsp_vector_solve_lse_workspace_size(const size_t rows, const size_t columns) {
+    if (rows == columns) { return dsp_matrix_lu_workspace_size(rows); }
+    return dsp_matrix_qr_workspace_size(rows, columns);
+}
+bool dsp_vector_solve_lse_with_workspace(dsp_vector_t* const x, const dsp_matrix_t* const A, const dsp_vector_t* const b, dsp_workspace_t* const ws) {
+    if (x == NULL || A == NULL || b == NULL || ws == NULL) { return false; }
+    if (A->columns != x->size) { return false; }
+    if (b->size != A->rows) { return false; }
+
+    const size_t mark = dsp_workspace_mark(ws);
+    bool success = false;
+    if (A->rows == A->columns) {
+
+        // Factor A, then forward and backward substitution (false if no solution exists)
+        dsp_matrix_lu_t lu;
+        success = dsp_matrix_lu_init(&lu, A->rows, ws)
+            && dsp_matrix_lu_factor(&lu, A)
+            && dsp_matrix_lu_solve_vector(&lu, x, b);
+    }
+    else {
+
+        // Least squares (or minimum norm) solution by QR, without forming pinv(A)
+        dsp_matrix_qr_t qr;
+        success = dsp_matrix_qr_init(&qr, A->rows, A->columns, ws)
+            && dsp_matrix_qr_factor(&qr, A)
+            && dsp_matrix_qr_solve(&qr, x->elements, b->elements);
+    }
+
+    dsp_workspace_release(ws, mark);
+    return success;
+}
+bool dsp_solve_with_workspace(real_t* const x, const size_t x_size, const real_t* const A, const real_t* const b, const size_t b_size, dsp_workspace_t* const ws) {
+    if (x == NULL || A == NULL || b == NULL) { return false; }
+    if (x_size == 0 || b_size == 0) { return false; }
+
+    dsp_vector_t X = {x_size, x};
+    const dsp_matrix_t M = {b_size, x_size, (real_t* const) A};
+    const dsp_vector_t B = {b_size, (real_t* const) b};
+    return dsp_vector_solve_lse_with_workspace(&X, &M, &B, ws);
+}
+dsp_vector_t* dsp_vector_create_solution_in_workspace(const dsp_matrix_t* const A, const dsp_vector_t* const b, dsp_workspace_t* const ws) {
+    if (A == NULL || b == NULL) { return NULL; }
+
+    const size_t mark = dsp_workspace_mark(ws);
+    dsp_vector_t* const x = dsp_vector_create_in_workspace(A->columns, ws);
+    if (x == NULL) { return NULL; }
+
+    if (dsp_vector_solve_lse_with_workspace(x, A, b, ws)) { return x; }
+    dsp_workspace_release(ws, mark);
+    return NULL;
+}
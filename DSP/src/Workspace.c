@@ -0,0 +1,78 @@
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Workspace.h"
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+
+#define WORKSPACE_SIZE sizeof(dsp_workspace_t)
+#define ALIGN_UP(value) (((value) + (DSP_WORKSPACE_ALIGNMENT - 1)) & ~((size_t) DSP_WORKSPACE_ALIGNMENT - 1))
+
+
+// Size
+size_t dsp_workspace_block_size(const size_t size) {
+    return ALIGN_UP(size);
+}
+
+// Create
+dsp_workspace_t* dsp_workspace_create(const size_t size) {
+
+    // Header and memory in one allocation
+    unsigned char* const block = (unsigned char*) dsp_malloc(WORKSPACE_SIZE + DSP_WORKSPACE_ALIGNMENT + size);
+    if (block == NULL) { return NULL; }
+
+    dsp_workspace_t* const ws = (dsp_workspace_t*) block;
+    ws->memory = (unsigned char*) ALIGN_UP((uintptr_t) (block + WORKSPACE_SIZE));
+    ws->size = size;
+    ws->used = 0;
+    ws->peak = 0;
+    return ws;
+}
+
+// Destroy
+bool dsp_workspace_destroy(dsp_workspace_t* const ws) {
+    if (ws == NULL) { return false; }
+    dsp_free(ws);
+    return true;
+}
+
+// Init
+bool dsp_workspace_init(dsp_workspace_t* const ws, void* const memory, const size_t size) {
+    if (ws == NULL || memory == NULL) { return false; }
+
+    const size_t skip = ALIGN_UP((uintptr_t) memory) - (uintptr_t) memory;
+    if (skip > size) { return false; }
+
+    ws->memory = (unsigned char*) memory + skip;
+    ws->size = size - skip;
+    ws->used = 0;
+    ws->peak = 0;
+    return true;
+}
+
+
+
+// Take
+void* dsp_workspace_take(dsp_workspace_t* const ws, const size_t size) {
+    if (ws == NULL) { return NULL; }
+
+    const size_t block_size = ALIGN_UP(size);
+    if (block_size > ws->size - ws->used) { return NULL; }
+
+    void* const block = &(ws->memory[ws->used]);
+    ws->used += block_size;
+    if (ws->used > ws->peak) { ws->peak = ws->used; }
+    return block;
+}
+
+// Release
+size_t dsp_workspace_mark(const dsp_workspace_t* const ws) {
+    if (ws == NULL) { return 0; }
+    return ws->used;
+}
+bool dsp_workspace_release(dsp_workspace_t* const ws, const size_t mark) {
+    if (ws == NULL) { return false; }
+    if (mark > ws->used) { return false; }
+    ws->used = mark;
+    return true;
+}
+bool dsp_workspace_reset(dsp_workspace_t* const ws) {
+    return dsp_workspace_release(ws, 0);
+}
@@ -0,0 +1,450 @@
+#include <string.h> // memset
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Math/Simd.h" // dsp_simd_selected
+#include "DSP/Discrete/pidBank.h"
+
+// The vector kernels work on 32-bit floats
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(DSP_PRECISION_DOUBLE)
+#define PID_BANK_X86 1
+#include <immintrin.h>
+#endif
+
+
+#define BANK_SIZE sizeof(dsp_pid_bank_t)
+
+// Packed arrays: every array starts on its own cache line
+#define BANK_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (BANK_ALIGNMENT - 1)) & ~((uintptr_t) BANK_ALIGNMENT - 1))
+#define PACKED_SIZE(count) ((((count) * sizeof(real_t)) + (BANK_ALIGNMENT - 1)) & ~((size_t) BANK_ALIGNMENT - 1))
+
+// Number of real_t and mask arrays in a bank
+#define REAL_ARRAYS 21
+#define MASK_ARRAYS 4
+
+#define MASK(enabled) ((enabled) ? 0xFFFFFFFFu : 0u)
+
+// Parts of an update
+#define PID_OUTPUT 1u // dsp_pid_get_output()
+#define PID_STATE 2u // dsp_pid_update_state()
+
+
+// Create
+dsp_pid_bank_t* dsp_pid_bank_create(const size_t size) {
+    if (size == 0) { return NULL; }
+
+    // Layout: the bank struct, then all arrays
+    const size_t array_size = PACKED_SIZE(size);
+    const size_t arrays_size = (REAL_ARRAYS + MASK_ARRAYS) * array_size;
+    unsigned char* const block = (unsigned char*) dsp_malloc(BANK_SIZE + BANK_ALIGNMENT + arrays_size);
+    if (block == NULL) { return NULL; }
+
+    dsp_pid_bank_t* const bank = (dsp_pid_bank_t*) block;
+    unsigned char* array = (unsigned char*) ALIGN_UP((uintptr_t) &block[BANK_SIZE]);
+    memset(array, 0, arrays_size);
+
+    bank->size = size;
+    bank->block = block;
+
+    // Parameter
+    bank->Ts = (real_t*) array; array += array_size;
+    bank->Kp = (real_t*) array; array += array_size;
+    bank->Ki = (real_t*) array; array += array_size;
+    bank->Kd = (real_t*) array; array += array_size;
+    bank->N = (real_t*) array; array += array_size;
+    bank->upper_limit = (real_t*) array; array += array_size;
+    bank->lower_limit = (real_t*) array; array += array_size;
+    bank->rising_slew_rate = (real_t*) array; array += array_size;
+    bank->falling_slew_rate = (real_t*) array; array += array_size;
+    bank->Kb = (real_t*) array; array += array_size;
+    bank->Kt = (real_t*) array; array += array_size;
+    bank->limit_output = (uint32_t*) array; array += array_size;
+    bank->limit_rate = (uint32_t*) array; array += array_size;
+    bank->anti_windup_enabled = (uint32_t*) array; array += array_size;
+    bank->tracking_enabled = (uint32_t*) array; array += array_size;
+
+    // Internal
+    bank->Xi = (real_t*) array; array += array_size;
+    bank->Ad = (real_t*) array; array += array_size;
+    bank->Bd = (real_t*) array; array += array_size;
+    bank->Xd = (real_t*) array; array += array_size;
+    bank->rising_step_size = (real_t*) array; array += array_size;
+    bank->falling_step_size = (real_t*) array; array += array_size;
+    bank->Xr = (real_t*) array; array += array_size;
+    bank->input = (real_t*) array; array += array_size;
+    bank->pidsum = (real_t*) array; array += array_size;
+    bank->output = (real_t*) array;
+
+    return bank;
+}
+
+// Destroy
+bool dsp_pid_bank_destroy(dsp_pid_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    // The struct lives at the beginning of the block
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+// Set controller
+bool dsp_pid_bank_set_controller(dsp_pid_bank_t* const bank, const size_t index, const dsp_pid_t* const pid) {
+    if (bank == NULL || pid == NULL) { return false; }
+    if (index >= bank->size) { return false; }
+
+    bank->Ts[index] = pid->Ts;
+    bank->Kp[index] = pid->Kp;
+    bank->Ki[index] = pid->Ki;
+    bank->Kd[index] = pid->Kd;
+    bank->N[index] = pid->N;
+    bank->limit_output[index] = MASK(pid->limit_output);
+    bank->upper_limit[index] = pid->upper_limit;
+    bank->lower_limit[index] = pid->lower_limit;
+    bank->limit_rate[index] = MASK(pid->limit_rate);
+    bank->rising_slew_rate[index] = pid->rising_slew_rate;
+    bank->falling_slew_rate[index] = pid->falling_slew_rate;
+    bank->anti_windup_enabled[index] = MASK(pid->anti_windup_enabled);
+    bank->Kb[index] = pid->Kb;
+    bank->tracking_enabled[index] = MASK(pid->tracking_enabled);
+    bank->Kt[index] = pid->Kt;
+
+    bank->Xi[index] = pid->Xi;
+    bank->Ad[index] = pid->Ad;
+    bank->Bd[index] = pid->Bd;
+    bank->Xd[index] = pid->Xd;
+    bank->rising_step_size[index] = pid->rising_step_size;
+    bank->falling_step_size[index] = pid->falling_step_size;
+    bank->Xr[index] = pid->Xr;
+    bank->input[index] = pid->input;
+    bank->pidsum[index] = pid->pidsum;
+    bank->output[index] = pid->output;
+    return true;
+}
+
+// Get controller
+bool dsp_pid_bank_get_controller(const dsp_pid_bank_t* const bank, const size_t index, dsp_pid_t* const pid) {
+    if (bank == NULL || pid == NULL) { return false; }
+    if (index >= bank->size) { return false; }
+
+    pid->Ts = bank->Ts[index];
+    pid->Kp = bank->Kp[index];
+    pid->Ki = bank->Ki[index];
+    pid->Kd = bank->Kd[index];
+    pid->N = bank->N[index];
+    pid->limit_output = (bank->limit_output[index] != 0);
+    pid->upper_limit = bank->upper_limit[index];
+    pid->lower_limit = bank->lower_limit[index];
+    pid->limit_rate = (bank->limit_rate[index] != 0);
+    pid->rising_slew_rate = bank->rising_slew_rate[index];
+    pid->falling_slew_rate = bank->falling_slew_rate[index];
+    pid->anti_windup_enabled = (bank->anti_windup_enabled[index] != 0);
+    pid->Kb = bank->Kb[index];
+    pid->tracking_enabled = (bank->tracking_enabled[index] != 0);
+    pid->Kt = bank->Kt[index];
+
+    pid->Xi = bank->Xi[index];
+    pid->Ad = bank->Ad[index];
+    pid->Bd = bank->Bd[index];
+    pid->Xd = bank->Xd[index];
+    pid->rising_step_size = bank->rising_step_size[index];
+    pid->falling_step_size = bank->falling_step_size[index];
+    pid->Xr = bank->Xr[index];
+    pid->input = bank->input[index];
+    pid->pidsum = bank->pidsum[index];
+    pid->output = bank->output[index];
+    return true;
+}
+
+// Reset
+bool dsp_pid_bank_reset(dsp_pid_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    const size_t bytes = bank->size * sizeof(real_t);
+    memset(bank->Xi, 0, bytes);
+    memset(bank->Xd, 0, bytes);
+    memset(bank->Xr, 0, bytes);
+    memset(bank->input, 0, bytes);
+    memset(bank->pidsum, 0, bytes);
+    memset(bank->output, 0, bytes);
+    return true;
+}
+
+
+
+// ----- Kernels -----
+
+// The kernels follow 'dsp_pid_get_output()' and 'dsp_pid_update_state()' operation by operation,
+// every 'if' becomes a select so all lanes run the same instructions.
+// 'y_fb' is the tracking feedback (NULL: zero like in 'dsp_pid_update()').
+
+// Controllers [begin, end) one at a time, reference and remainder of the vectorized kernels
+static void scalar_pid_bank(dsp_pid_bank_t* const bank, const size_t begin, const size_t end,
+    const real_t* const u, const real_t* const y_fb, real_t* const y, const unsigned int stages) {
+
+    for (size_t k = begin; k < end; ++k) {
+
+        real_t input = bank->input[k];
+        real_t pidsum = bank->pidsum[k];
+        real_t output = bank->output[k];
+
+        if (stages & PID_OUTPUT) {
+
+            // P + I + D
+            input = u[k];
+            pidsum = (bank->Kp[k] * input) + bank->Xi[k] + (bank->N[k] * (bank->Kd[k] * input - bank->Xd[k]));
+            output = pidsum;
+
+            // Saturation
+            const bool limit_output = (bank->limit_output[k] != 0);
+            const bool above = limit_output && (pidsum > bank->upper_limit[k]);
+            const bool below = limit_output && !above && (pidsum < bank->lower_limit[k]);
+            output = (above ? bank->upper_limit[k] : output);
+            output = (below ? bank->lower_limit[k] : output);
+
+            // Rate Limitation
+            const bool limit_rate = (bank->limit_rate[k] != 0);
+            const real_t change = output - bank->Xr[k];
+            const real_t rising = bank->Xr[k] + bank->rising_step_size[k];
+            const real_t falling = bank->Xr[k] + bank->falling_step_size[k];
+            output = ((limit_rate && change > bank->rising_step_size[k]) ? rising : output);
+            output = ((limit_rate && change < bank->falling_step_size[k]) ? falling : output);
+
+            bank->input[k] = input;
+            bank->pidsum[k] = pidsum;
+            bank->output[k] = output;
+            if (y != NULL) { y[k] = output; }
+        }
+
+        if (stages & PID_STATE) {
+
+            // Integrator input, Tracking, Back-Calculation
+            const real_t tracked = (y_fb != NULL ? y_fb[k] : 0.0f);
+            const bool anti_windup = (bank->anti_windup_enabled[k] != 0);
+            real_t toInt = bank->Ki[k] * input;
+            toInt = ((bank->tracking_enabled[k] != 0) ? toInt + bank->Kt[k] * (tracked - output) : toInt);
+            toInt = (anti_windup ? toInt + bank->Kb[k] * (output - pidsum) : toInt);
+
+            // Clamping
+            const bool clamp = anti_windup && (bank->limit_output[k] != 0) && (
+                (pidsum >= bank->upper_limit[k] && toInt > 0.0f) ||
+                (pidsum <= bank->lower_limit[k] && toInt < 0.0f));
+            toInt = (clamp ? 0.0f : toInt);
+
+            bank->Xi[k] += bank->Ts[k] * toInt;
+            bank->Xd[k] = bank->Ad[k] * bank->Xd[k] + bank->Bd[k] * input;
+            bank->Xr[k] = output;
+        }
+    }
+}
+
+
+#ifdef PID_BANK_X86
+
+// No FMA: a fused multiply-add would round differently than 'dsp_pid_update()'
+
+// result = mask ? a : b
+#define SSE_SELECT(mask, a, b) _mm_or_ps(_mm_and_ps((mask), (a)), _mm_andnot_ps((mask), (b)))
+#define SSE_MASK(array, k) _mm_castsi128_ps(_mm_loadu_si128((const __m128i*) &(array)[k]))
+
+__attribute__((target("sse2")))
+static void sse_pid_bank(dsp_pid_bank_t* const bank, const size_t begin, const size_t end,
+    const real_t* const u, const real_t* const y_fb, real_t* const y, const unsigned int stages) {
+
+    const __m128 zero = _mm_setzero_ps();
+    size_t k = begin;
+    for (; k + 4 <= end; k += 4) {
+
+        __m128 input = _mm_loadu_ps(&bank->input[k]);
+        __m128 pidsum = _mm_loadu_ps(&bank->pidsum[k]);
+        __m128 output = _mm_loadu_ps(&bank->output[k]);
+        const __m128 limit_output = SSE_MASK(bank->limit_output, k);
+        const __m128 upper_limit = _mm_loadu_ps(&bank->upper_limit[k]);
+        const __m128 lower_limit = _mm_loadu_ps(&bank->lower_limit[k]);
+
+        if (stages & PID_OUTPUT) {
+
+            // P + I + D
+            input = _mm_loadu_ps(&u[k]);
+            const __m128 d = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&bank->Kd[k]), input), _mm_loadu_ps(&bank->Xd[k]));
+            pidsum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&bank->Kp[k]), input), _mm_loadu_ps(&bank->Xi[k])),
+                _mm_mul_ps(_mm_loadu_ps(&bank->N[k]), d));
+            output = pidsum;
+
+            // Saturation
+            const __m128 above = _mm_and_ps(limit_output, _mm_cmpgt_ps(pidsum, upper_limit));
+            const __m128 below = _mm_andnot_ps(above, _mm_and_ps(limit_output, _mm_cmplt_ps(pidsum, lower_limit)));
+            output = SSE_SELECT(above, upper_limit, output);
+            output = SSE_SELECT(below, lower_limit, output);
+
+            // Rate Limitation
+            const __m128 limit_rate = SSE_MASK(bank->limit_rate, k);
+            const __m128 Xr = _mm_loadu_ps(&bank->Xr[k]);
+            const __m128 rising_step = _mm_loadu_ps(&bank->rising_step_size[k]);
+            const __m128 falling_step = _mm_loadu_ps(&bank->falling_step_size[k]);
+            const __m128 change = _mm_sub_ps(output, Xr);
+            const __m128 rising = _mm_and_ps(limit_rate, _mm_cmpgt_ps(change, rising_step));
+            const __m128 falling = _mm_and_ps(limit_rate, _mm_cmplt_ps(change, falling_step));
+            output = SSE_SELECT(rising, _mm_add_ps(Xr, rising_step), output);
+            output = SSE_SELECT(falling, _mm_add_ps(Xr, falling_step), output);
+
+            _mm_storeu_ps(&bank->input[k], input);
+            _mm_storeu_ps(&bank->pidsum[k], pidsum);
+            _mm_storeu_ps(&bank->output[k], output);
+            if (y != NULL) { _mm_storeu_ps(&y[k], output); }
+        }
+
+        if (stages & PID_STATE) {
+
+            // Integrator input, Tracking, Back-Calculation
+            const __m128 tracked = (y_fb != NULL ? _mm_loadu_ps(&y_fb[k]) : zero);
+            const __m128 anti_windup = SSE_MASK(bank->anti_windup_enabled, k);
+            __m128 toInt = _mm_mul_ps(_mm_loadu_ps(&bank->Ki[k]), input);
+            toInt = SSE_SELECT(SSE_MASK(bank->tracking_enabled, k),
+                _mm_add_ps(toInt, _mm_mul_ps(_mm_loadu_ps(&bank->Kt[k]), _mm_sub_ps(tracked, output))), toInt);
+            toInt = SSE_SELECT(anti_windup,
+                _mm_add_ps(toInt, _mm_mul_ps(_mm_loadu_ps(&bank->Kb[k]), _mm_sub_ps(output, pidsum))), toInt);
+
+            // Clamping
+            const __m128 upper = _mm_and_ps(_mm_cmpge_ps(pidsum, upper_limit), _mm_cmpgt_ps(toInt, zero));
+            const __m128 lower = _mm_and_ps(_mm_cmple_ps(pidsum, lower_limit), _mm_cmplt_ps(toInt, zero));
+            const __m128 clamp = _mm_and_ps(_mm_and_ps(anti_windup, limit_output), _mm_or_ps(upper, lower));
+            toInt = _mm_andnot_ps(clamp, toInt);
+
+            _mm_storeu_ps(&bank->Xi[k], _mm_add_ps(_mm_loadu_ps(&bank->Xi[k]), _mm_mul_ps(_mm_loadu_ps(&bank->Ts[k]), toInt)));
+            _mm_storeu_ps(&bank->Xd[k], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&bank->Ad[k]), _mm_loadu_ps(&bank->Xd[k])),
+                _mm_mul_ps(_mm_loadu_ps(&bank->Bd[k]), input)));
+            _mm_storeu_ps(&bank->Xr[k], output);
+        }
+    }
+    scalar_pid_bank(bank, k, end, u, y_fb, y, stages);
+}
+
+#define AVX_SELECT(mask, a, b) _mm256_blendv_ps((b), (a), (mask))
+#define AVX_MASK(array, k) _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*) &(array)[k]))
+
+__attribute__((target("avx")))
+static void avx_pid_bank(dsp_pid_bank_t* const bank, const size_t begin, const size_t end,
+    const real_t* const u, const real_t* const y_fb, real_t* const y, const unsigned int stages) {
+
+    const __m256 zero = _mm256_setzero_ps();
+    size_t k = begin;
+    for (; k + 8 <= end; k += 8) {
+
+        __m256 input = _mm256_loadu_ps(&bank->input[k]);
+        __m256 pidsum = _mm256_loadu_ps(&bank->pidsum[k]);
+        __m256 output = _mm256_loadu_ps(&bank->output[k]);
+        const __m256 limit_output = AVX_MASK(bank->limit_output, k);
+        const __m256 upper_limit = _mm256_loadu_ps(&bank->upper_limit[k]);
+        const __m256 lower_limit = _mm256_loadu_ps(&bank->lower_limit[k]);
+
+        if (stages & PID_OUTPUT) {
+
+            // P + I + D
+            input = _mm256_loadu_ps(&u[k]);
+            const __m256 d = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(&bank->Kd[k]), input), _mm256_loadu_ps(&bank->Xd[k]));
+            pidsum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&bank->Kp[k]), input), _mm256_loadu_ps(&bank->Xi[k])),
+                _mm256_mul_ps(_mm256_loadu_ps(&bank->N[k]), d));
+            output = pidsum;
+
+            // Saturation
+            const __m256 above = _mm256_and_ps(limit_output, _mm256_cmp_ps(pidsum, upper_limit, _CMP_GT_OQ));
+            const __m256 below = _mm256_andnot_ps(above, _mm256_and_ps(limit_output, _mm256_cmp_ps(pidsum, lower_limit, _CMP_LT_OQ)));
+            output = AVX_SELECT(above, upper_limit, output);
+            output = AVX_SELECT(below, lower_limit, output);
+
+            // Rate Limitation
+            const __m256 limit_rate = AVX_MASK(bank->limit_rate, k);
+            const __m256 Xr = _mm256_loadu_ps(&bank->Xr[k]);
+            const __m256 rising_step = _mm256_loadu_ps(&bank->rising_step_size[k]);
+            const __m256 falling_step = _mm256_loadu_ps(&bank->falling_step_size[k]);
+            const __m256 change = _mm256_sub_ps(output, Xr);
+            const __m256 rising = _mm256_and_ps(limit_rate, _mm256_cmp_ps(change, rising_step, _CMP_GT_OQ));
+            const __m256 falling = _mm256_and_ps(limit_rate, _mm256_cmp_ps(change, falling_step, _CMP_LT_OQ));
+            output = AVX_SELECT(rising, _mm256_add_ps(Xr, rising_step), output);
+            output = AVX_SELECT(falling, _mm256_add_ps(Xr, falling_step), output);
+
+            _mm256_storeu_ps(&bank->input[k], input);
+            _mm256_storeu_ps(&bank->pidsum[k], pidsum);
+            _mm256_storeu_ps(&bank->output[k], output);
+            if (y != NULL) { _mm256_storeu_ps(&y[k], output); }
+        }
+
+        if (stages & PID_STATE) {
+
+            // Integrator input, Tracking, Back-Calculation
+            const __m256 tracked = (y_fb != NULL ? _mm256_loadu_ps(&y_fb[k]) : zero);
+            const __m256 anti_windup = AVX_MASK(bank->anti_windup_enabled, k);
+            __m256 toInt = _mm256_mul_ps(_mm256_loadu_ps(&bank->Ki[k]), input);
+            toInt = AVX_SELECT(AVX_MASK(bank->tracking_enabled, k),
+                _mm256_add_ps(toInt, _mm256_mul_ps(_mm256_loadu_ps(&bank->Kt[k]), _mm256_sub_ps(tracked, output))), toInt);
+            toInt = AVX_SELECT(anti_windup,
+                _mm256_add_ps(toInt, _mm256_mul_ps(_mm256_loadu_ps(&bank->Kb[k]), _mm256_sub_ps(output, pidsum))), toInt);
+
+            // Clamping
+            const __m256 upper = _mm256_and_ps(_mm256_cmp_ps(pidsum, upper_limit, _CMP_GE_OQ), _mm256_cmp_ps(toInt, zero, _CMP_GT_OQ));
+            const __m256 lower = _mm256_and_ps(_mm256_cmp_ps(pidsum, lower_limit, _CMP_LE_OQ), _mm256_cmp_ps(toInt, zero, _CMP_LT_OQ));
+            const __m256 clamp = _mm256_and_ps(_mm256_and_ps(anti_windup, limit_output), _mm256_or_ps(upper, lower));
+            toInt = _mm256_andnot_ps(clamp, toInt);
+
+            _mm256_storeu_ps(&bank->Xi[k], _mm256_add_ps(_mm256_loadu_ps(&bank->Xi[k]), _mm256_mul_ps(_mm256_loadu_ps(&bank->Ts[k]), toInt)));
+            _mm256_storeu_ps(&bank->Xd[k], _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&bank->Ad[k]), _mm256_loadu_ps(&bank->Xd[k])),
+                _mm256_mul_ps(_mm256_loadu_ps(&bank->Bd[k]), input)));
+            _mm256_storeu_ps(&bank->Xr[k], output);
+        }
+    }
+    scalar_pid_bank(bank, k, end, u, y_fb, y, stages);
+}
+
+#endif // PID_BANK_X86
+
+
+// Run the widest kernel of the selected instruction set on the controllers [begin, end)
+static void process(dsp_pid_bank_t* const bank, const size_t begin, const size_t end,
+    const real_t* const u, const real_t* const y_fb, real_t* const y, const unsigned int stages) {
+    switch (dsp_simd_selected()) {
+#ifdef PID_BANK_X86
+        case SimdAVX512:
+        case SimdAVX2:
+            avx_pid_bank(bank, begin, end, u, y_fb, y, stages);
+            return;
+        case SimdSSE:
+            if (__builtin_cpu_supports("sse2")) { sse_pid_bank(bank, begin, end, u, y_fb, y, stages); return; }
+            break;
+#endif
+        default:
+            break;
+    }
+    scalar_pid_bank(bank, begin, end, u, y_fb, y, stages);
+}
+
+
+
+// Get output
+bool dsp_pid_bank_get_output(dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    process(bank, 0, bank->size, u, NULL, y, PID_OUTPUT);
+    return true;
+}
+
+// Update state
+bool dsp_pid_bank_update_state(dsp_pid_bank_t* const bank, const real_t* const y) {
+    if (bank == NULL || y == NULL) { return false; }
+    process(bank, 0, bank->size, NULL, y, NULL, PID_STATE);
+    return true;
+}
+
+// Calculate outputs and update states
+bool dsp_pid_bank_update(dsp_pid_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    process(bank, 0, bank->size, u, NULL, y, PID_OUTPUT | PID_STATE);
+    return true;
+}
+
+bool dsp_pid_bank_update_range(dsp_pid_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    if (first > bank->size || count > bank->size - first) { return false; }
+    process(bank, first, first + count, u, NULL, y, PID_OUTPUT | PID_STATE);
+    return true;
+}
@@ -1,10 +1,10 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/pidController.h"
 
 
 #define PID_SIZE sizeof(dsp_pid_t)
-#define NEW_PID() ((dsp_pid_t*) malloc(PID_SIZE))
+#define NEW_PID() ((dsp_pid_t*) dsp_malloc(PID_SIZE))
 
 
 // Create
@@ -137,7 +137,7 @@ bool dsp_pid_swap(dsp_pid_t* const a, dsp_pid_t* const b) {
 bool dsp_pid_destroy(dsp_pid_t* const pid) {
     if (pid == NULL) { return false; }
 
-    free(pid);
+    dsp_free(pid);
     return true;
 }
 
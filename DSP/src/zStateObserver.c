@@ -1,14 +1,39 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset, memmove
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/zStateObserver.h"
 
 #define ZSO_SIZE sizeof(dsp_zso_t)
-#define NEW_ZSO() ((dsp_zso_t*) malloc(ZSO_SIZE))
+#define NEW_ZSO() ((dsp_zso_t*) dsp_malloc(ZSO_SIZE))
 
 #define ARRAY_ELEMEMT(array, index) ((array)[(index)])
 #define VECTOR_ELEMENT(vec, index) ((vec)->elements[(index)])
 #define MATRIX_ELEMENT(mat, row_index, column_index) ((mat)->elements[(row_index) * mat->columns + (column_index)])
 
+#ifdef DSP_PRECISION_MIXED
+#define NEW_ACCUM_ARRAY(size) ((accum_t*) dsp_malloc((size) * sizeof(accum_t)))
+
+// Take over a state written to 'xh'
+static void load_state(dsp_zso_t* const zso) {
+    for (size_t i = 0; i < zso->xh->size; ++i) { zso->xa[i] = zso->xh->elements[i]; }
+}
+
+// Row 'row' of M * v with v in double
+static inline accum_t accum_row(const dsp_matrix_t* const M, const size_t row, const accum_t* const v) {
+    accum_t sum = 0;
+    for (size_t j = 0; j < M->columns; ++j) { sum += (accum_t) MATRIX_ELEMENT(M, row, j) * v[j]; }
+    return sum;
+}
+
+// Row 'row' of M * v
+static inline accum_t real_row(const dsp_matrix_t* const M, const size_t row, const real_t* const v) {
+    accum_t sum = 0;
+    for (size_t j = 0; j < M->columns; ++j) { sum += (accum_t) MATRIX_ELEMENT(M, row, j) * v[j]; }
+    return sum;
+}
+#else
+#define load_state(zso) ((void) 0)
+#endif
+
 
 // Create state observer but don't initilize its internal arrrays
 dsp_zso_t* dsp_zso_create(const size_t nx,const size_t nu, const size_t ny) {
@@ -28,12 +53,16 @@ dsp_zso_t* dsp_zso_create(const size_t nx,const size_t nu, const size_t ny) {
     zso->xn = NULL;
     zso->yh = NULL;
     zso->e = NULL;
+#ifdef DSP_PRECISION_MIXED
+    zso->xa = NULL;
+    zso->xan = NULL;
+#endif
 
     if (dsp_zso_allocate_internal_arrays(zso, nx, nu, ny)) {
         return zso;
     }
     else {
-        free(zso);
+        dsp_free(zso);
         return NULL;
     }
 }
@@ -61,28 +90,27 @@ dsp_zso_t* dsp_zso_create_from_arrays(const size_t nx, const size_t nu, const si
     zso->xn = dsp_vector_create_from_array(nx, x0);
     zso->yh = dsp_vector_create(ny);
     zso->e = dsp_vector_create(ny);
+#ifdef DSP_PRECISION_MIXED
+    zso->xa = NEW_ACCUM_ARRAY(nx);
+    zso->xan = NEW_ACCUM_ARRAY(nx);
+    const bool accum_failed = (zso->xa == NULL || zso->xan == NULL);
+#else
+    const bool accum_failed = false;
+#endif
 
     // Check
     if (zso->A == NULL || zso->B == NULL || \
         zso->C == NULL || zso->D == NULL || \
         zso->L == NULL || \
         zso->xh == NULL || zso->xn == NULL || \
-        zso->yh == NULL || zso->e == NULL) {
-
-        dsp_matrix_destroy(zso->A);
-        dsp_matrix_destroy(zso->B);
-        dsp_matrix_destroy(zso->C);
-        dsp_matrix_destroy(zso->D);
-        dsp_matrix_destroy(zso->L);
-        dsp_vector_destroy(zso->xh);
-        dsp_vector_destroy(zso->xn);
-        dsp_vector_destroy(zso->yh);
-        dsp_vector_destroy(zso->e);
-
-        free(zso);
+        zso->yh == NULL || zso->e == NULL || accum_failed) {
+
+        dsp_zso_release_internal_arrays(zso);
+        dsp_free(zso);
         return NULL;
     }
     else {
+        load_state(zso);
         return zso;
     }
 }
@@ -128,6 +156,9 @@ dsp_zso_t* dsp_zso_create_copy(const dsp_zso_t* const other) {
     dsp_zso_t* const zso = dsp_zso_create_from_matrices(other->A, other->B, other->C, other->D, other->L, other->xn->elements);
     if (zso != NULL) {
         if (dsp_vector_copy_assign(zso->xh, other->xh)) {
+#ifdef DSP_PRECISION_MIXED
+            memcpy(zso->xa, other->xa, zso->xh->size * sizeof(accum_t));
+#endif
             return zso;
         }
         else {
@@ -162,6 +193,9 @@ bool dsp_zso_copy_assign(dsp_zso_t* const dest, const dsp_zso_t* const src) {
     dsp_vector_copy_assign(dest->xn, src->xn);
     dsp_vector_copy_assign(dest->yh, src->yh);
     dsp_vector_copy_assign(dest->e, src->e);
+#ifdef DSP_PRECISION_MIXED
+    memcpy(dest->xa, src->xa, dest->xh->size * sizeof(accum_t));
+#endif
     return true;
 }
 
@@ -183,6 +217,10 @@ dsp_zso_t* dsp_zso_create_move(dsp_zso_t* const other) {
     zso->xn = other->xn;
     zso->yh = other->yh;
     zso->e = other->e;
+#ifdef DSP_PRECISION_MIXED
+    zso->xa = other->xa;
+    zso->xan = other->xan;
+#endif
 
     // Invalidate other elements array pointer
     other->A = NULL;
@@ -194,6 +232,10 @@ dsp_zso_t* dsp_zso_create_move(dsp_zso_t* const other) {
     other->xn = NULL;
     other->yh = NULL;
     other->e = NULL;
+#ifdef DSP_PRECISION_MIXED
+    other->xa = NULL;
+    other->xan = NULL;
+#endif
 
     return zso;
 }
@@ -212,6 +254,10 @@ bool dsp_zso_move_assign(dsp_zso_t* const dest, dsp_zso_t* const src) {
     dest->xn = src->xn;
     dest->yh = src->yh;
     dest->e = src->e;
+#ifdef DSP_PRECISION_MIXED
+    dest->xa = src->xa;
+    dest->xan = src->xan;
+#endif
 
     // Invalidate other elements array pointer
     src->A = NULL;
@@ -223,6 +269,10 @@ bool dsp_zso_move_assign(dsp_zso_t* const dest, dsp_zso_t* const src) {
     src->xn = NULL;
     src->yh = NULL;
     src->e = NULL;
+#ifdef DSP_PRECISION_MIXED
+    src->xa = NULL;
+    src->xan = NULL;
+#endif
 
     return true;
 }
@@ -261,24 +311,22 @@ bool dsp_zso_allocate_internal_arrays(dsp_zso_t* const zso, const size_t nx, con
     zso->xn = dsp_vector_create(nx);
     zso->yh = dsp_vector_create(ny);
     zso->e = dsp_vector_create(ny);
+#ifdef DSP_PRECISION_MIXED
+    zso->xa = NEW_ACCUM_ARRAY(nx);
+    zso->xan = NEW_ACCUM_ARRAY(nx);
+    const bool accum_failed = (zso->xa == NULL || zso->xan == NULL);
+#else
+    const bool accum_failed = false;
+#endif
 
     // Check
     if (zso->A == NULL || zso->B == NULL || \
         zso->C == NULL || zso->D == NULL || \
         zso->L == NULL || \
         zso->xh == NULL || zso->xn == NULL || \
-        zso->yh == NULL || zso->e == NULL) {
-
-        dsp_matrix_destroy(zso->A);
-        dsp_matrix_destroy(zso->B);
-        dsp_matrix_destroy(zso->C);
-        dsp_matrix_destroy(zso->D);
-        dsp_matrix_destroy(zso->L);
-        dsp_vector_destroy(zso->xh);
-        dsp_vector_destroy(zso->xn);
-        dsp_vector_destroy(zso->yh);
-        dsp_vector_destroy(zso->e);
+        zso->yh == NULL || zso->e == NULL || accum_failed) {
 
+        dsp_zso_release_internal_arrays(zso);
         return false;
     }
     else {
@@ -298,6 +346,12 @@ bool dsp_zso_release_internal_arrays(dsp_zso_t* const zso) {
     dsp_vector_destroy(zso->xn);
     dsp_vector_destroy(zso->yh);
     dsp_vector_destroy(zso->e);
+#ifdef DSP_PRECISION_MIXED
+    if (zso->xa != NULL) { dsp_free(zso->xa); }
+    if (zso->xan != NULL) { dsp_free(zso->xan); }
+    zso->xa = NULL;
+    zso->xan = NULL;
+#endif
 
     zso->A = NULL;
     zso->B = NULL;
@@ -313,7 +367,7 @@ bool dsp_zso_release_internal_arrays(dsp_zso_t* const zso) {
 bool dsp_zso_destroy(dsp_zso_t* const zso) {
     if (zso == NULL) { return NULL; }
     dsp_zso_release_internal_arrays(zso);
-    free(zso);
+    dsp_free(zso);
     return true;
 }
 
@@ -321,9 +375,9 @@ bool dsp_zso_destroy(dsp_zso_t* const zso) {
 bool dsp_zso_set_state_to(dsp_zso_t* const zso, const dsp_vector_t* const x0) {
     if (zso == NULL) { return false; }
     if (x0 != NULL) {
-        return \
-            dsp_vector_copy_assign(zso->xn, x0) && \
-            dsp_vector_copy_assign(zso->xh, x0);
+        if (!dsp_vector_copy_assign(zso->xn, x0) || !dsp_vector_copy_assign(zso->xh, x0)) { return false; }
+        load_state(zso);
+        return true;
     }
     else { 
         return dsp_zso_reset(zso);
@@ -332,9 +386,9 @@ bool dsp_zso_set_state_to(dsp_zso_t* const zso, const dsp_vector_t* const x0) {
 bool dsp_zso_set_state(dsp_zso_t* const zso, const real_t* const x0) {
     if (zso == NULL) { return false; }
     if (x0 != NULL) {
-        return \
-            dsp_vector_copy_assign_array(zso->xn, x0) && \
-            dsp_vector_copy_assign_array(zso->xh, x0);
+        if (!dsp_vector_copy_assign_array(zso->xn, x0) || !dsp_vector_copy_assign_array(zso->xh, x0)) { return false; }
+        load_state(zso);
+        return true;
     }
     else { 
         return dsp_zso_reset(zso);
@@ -344,9 +398,9 @@ bool dsp_zso_set_state(dsp_zso_t* const zso, const real_t* const x0) {
 // Reset state
 bool dsp_zso_reset(dsp_zso_t* const zso) {
     if (zso == NULL) { return false; }
-    return \
-        dsp_vector_set_to_zero(zso->xn) && \
-        dsp_vector_set_to_zero(zso->xh);
+    if (!dsp_vector_set_to_zero(zso->xn) || !dsp_vector_set_to_zero(zso->xh)) { return false; }
+    load_state(zso);
+    return true;
 }
 
 
@@ -362,6 +416,22 @@ bool dsp_zso_vector_get_estimated_state(dsp_zso_t* const zso, dsp_vector_t* cons
 bool dsp_zso_vector_update_estimated_state(dsp_zso_t* const zso, const dsp_vector_t* const u, const dsp_vector_t* const y) {
     if (zso == NULL || u == NULL || y == NULL) { return NULL; }
 
+#ifdef DSP_PRECISION_MIXED
+    // The same equations with the estimated state in double, 'xh' gets the rounded state
+    if (u->size != zso->B->columns || y->size != zso->C->rows) { return false; }
+    for (size_t i = 0; i < zso->yh->size; ++i) {
+        const accum_t yh = accum_row(zso->C, i, zso->xa) + real_row(zso->D, i, u->elements);
+        zso->yh->elements[i] = (real_t) yh;
+        zso->e->elements[i] = (real_t) (y->elements[i] - yh);
+    }
+    for (size_t i = 0; i < zso->xh->size; ++i) {
+        zso->xan[i] = accum_row(zso->A, i, zso->xa) + real_row(zso->B, i, u->elements) + real_row(zso->L, i, zso->e->elements);
+    }
+    accum_t* const xa = zso->xa;
+    zso->xa = zso->xan;
+    zso->xan = xa;
+    for (size_t i = 0; i < zso->xh->size; ++i) { zso->xh->elements[i] = (real_t) zso->xa[i]; }
+#else
     // y^[n] = C * x^[n]
     dsp_matrix_vector_multiply(zso->yh, zso->C, zso->xh);
 
@@ -388,6 +458,7 @@ bool dsp_zso_vector_update_estimated_state(dsp_zso_t* const zso, const dsp_vecto
 
     // swap states
     dsp_vector_swap(zso->xh, zso->xn);
+#endif
 
     // xh now contains the updated state
     return true;
@@ -1,11 +1,21 @@
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset
-#include <math.h> // expf
+#include <math.h> // expf, exp
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/zStateSpace.h"
 
 
 #define ZSS_SIZE sizeof(dsp_zss_t)
-#define NEW_ZSS() ((dsp_zss_t*) malloc(ZSS_SIZE))
+#define NEW_ZSS() ((dsp_zss_t*) dsp_malloc(ZSS_SIZE))
+
+#define MATRIX_SIZE sizeof(dsp_matrix_t)
+#define VECTOR_SIZE sizeof(dsp_vector_t)
+
+// Packed arrays: the block starts on a cache line, every array on 16 bytes
+#define ZSS_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (ZSS_ALIGNMENT - 1)) & ~((uintptr_t) ZSS_ALIGNMENT - 1))
+#define PACKED_SIZE(count) ((((count) * sizeof(real_t)) + 15) & ~((size_t) 15))
+#define ACCUM_PACKED_SIZE(count) ((((count) * sizeof(accum_t)) + 15) & ~((size_t) 15))
 
 #define ARRAY_ELEMEMT(array, index) ((array)[(index)])
 #define POLYNOMIAL_ELEMENT(poly, index) ((poly)->a[(index)])
@@ -13,6 +23,30 @@
 #define MATRIX_ELEMENT(mat, row_index, column_index) ((mat)->elements[(row_index) * mat->columns + (column_index)])
 
 
+#ifdef DSP_PRECISION_MIXED
+// Take over a state written to 'x'
+static void load_state(dsp_zss_t* const zss) {
+    for (size_t i = 0; i < zss->x->size; ++i) { zss->xa[i] = zss->x->elements[i]; }
+}
+
+// Row 'row' of M * v with v in double
+static inline accum_t accum_row(const dsp_matrix_t* const M, const size_t row, const accum_t* const v) {
+    accum_t sum = 0;
+    for (size_t j = 0; j < M->columns; ++j) { sum += (accum_t) MATRIX_ELEMENT(M, row, j) * v[j]; }
+    return sum;
+}
+
+// Row 'row' of M * v
+static inline accum_t real_row(const dsp_matrix_t* const M, const size_t row, const real_t* const v) {
+    accum_t sum = 0;
+    for (size_t j = 0; j < M->columns; ++j) { sum += (accum_t) MATRIX_ELEMENT(M, row, j) * v[j]; }
+    return sum;
+}
+#else
+#define load_state(zss) ((void) 0)
+#endif
+
+
 // Create state space but don't initilize its internal arrrays
 dsp_zss_t* dsp_zss_create(const size_t nx, const size_t nu, const size_t ny) {
     if (nx == 0 || nu == 0 || ny == 0) { return NULL; }
@@ -28,12 +62,17 @@ dsp_zss_t* dsp_zss_create(const size_t nx, const size_t nu, const size_t ny) {
     zss->D = NULL;
     zss->x = NULL;
     zss->xn = NULL;
+#ifdef DSP_PRECISION_MIXED
+    zss->xa = NULL;
+    zss->xan = NULL;
+#endif
+    zss->block = NULL;
 
     if (dsp_zss_allocate_internal_arrays(zss, nx, nu, ny)) {
         return zss;
     }
     else {
-        free(zss);
+        dsp_free(zss);
         return NULL;
     }
 }
@@ -46,32 +85,16 @@ dsp_zss_t* dsp_zss_create_from_arrays(const size_t nx, const size_t nu, const si
     if (nx == 0 || nu == 0 || ny == 0) { return NULL; }
 
     // Allocate Space for a new StateSpace struct
-    dsp_zss_t* const zss = NEW_ZSS();
+    dsp_zss_t* const zss = dsp_zss_create(nx, nu, ny);
     if (zss == NULL) { return NULL; }
 
-    // Allocate space for internal arrays
-    zss->A = dsp_matrix_create_from_array(nx, nx, a);
-    zss->B = dsp_matrix_create_from_array(nx, nu, b);
-    zss->C = ((c != NULL) ? dsp_matrix_create_from_array(ny, nx, c) : dsp_matrix_create_eye(ny, nx));
-    zss->D = ((d != NULL) ? dsp_matrix_create_from_array(ny, nu, d) : dsp_matrix_create_zeros(ny, nu));
-    zss->x = dsp_vector_create_from_array(nx, x0);
-    zss->xn = dsp_vector_create_from_array(nx, x0);
-
-    // Check
-    if (zss->A == NULL || zss->B == NULL || zss->C == NULL || zss->D == NULL || zss->x == NULL || zss->xn == NULL) {
-        dsp_matrix_destroy(zss->A);
-        dsp_matrix_destroy(zss->B);
-        dsp_matrix_destroy(zss->C);
-        dsp_matrix_destroy(zss->D);
-        dsp_vector_destroy(zss->x);
-        dsp_vector_destroy(zss->xn);
-
-        free(zss);
-        return NULL;
-    }
-    else {
-        return zss;
-    }
+    // Initilize internal arrays
+    dsp_matrix_copy_assign_array(zss->A, a);
+    dsp_matrix_copy_assign_array(zss->B, b);
+    if (c != NULL) { dsp_matrix_copy_assign_array(zss->C, c); } else { dsp_matrix_set_to_eye(zss->C); }
+    if (d != NULL) { dsp_matrix_copy_assign_array(zss->D, d); } else { dsp_matrix_set_to_zero(zss->D); }
+    dsp_zss_set_state(zss, x0);
+    return zss;
 }
 
 // Create from matrices
@@ -84,36 +107,11 @@ dsp_zss_t* dsp_zss_create_from_matrices(const dsp_matrix_t* const A, const dsp_m
     if (D != NULL && D->rows != (C != NULL ? C->rows : A->rows)) { return NULL; }
     if (D != NULL && D->columns != B->columns) { return NULL; }
 
-    // Allocate Space for a new StateSpace struct
-    dsp_zss_t* const zss = NEW_ZSS();
-    if (zss == NULL) { return NULL; }
-
-    // Allocate space for internal arrays
-    zss->A = dsp_matrix_create_copy(A);
-    zss->B = dsp_matrix_create_copy(B);
-    zss->C = ((C != NULL) ? dsp_matrix_create_copy(C) : dsp_matrix_create_eye(A->rows, A->columns));
-    zss->D = ((D != NULL) ? dsp_matrix_create_copy(D) : ((C != NULL) ? dsp_matrix_create_zeros(C->rows, B->columns) : dsp_matrix_create_zeros(A->rows, B->columns)));
-    zss->x = dsp_vector_create_from_array(A->rows, x0);
-    zss->xn = dsp_vector_create_from_array(A->rows, x0);
-
-    // Check
-    if (zss->A == NULL || zss->B == NULL || \
-        zss->C == NULL || zss->D == NULL || \
-        zss->x == NULL || zss->xn == NULL) {
-
-        dsp_matrix_destroy(zss->A);
-        dsp_matrix_destroy(zss->B);
-        dsp_matrix_destroy(zss->C);
-        dsp_matrix_destroy(zss->D);
-        dsp_vector_destroy(zss->x);
-        dsp_vector_destroy(zss->xn);
-
-        free(zss);
-        return NULL;
-    }
-    else {
-        return zss;
-    }
+    return dsp_zss_create_from_arrays(A->rows, B->columns, (C != NULL ? C->rows : A->rows),
+        A->elements, B->elements,
+        (C != NULL ? C->elements : NULL), (D != NULL ? D->elements : NULL),
+        x0
+    );
 }
 
 // Create from transfer function G(Z) = num(z^-1) / den(z^-1) = (b0 + b1 * z^-1 + b2 * z^-2 + ... bn * z^-n) / (a0 + a1 * z^-1 + a2 * z^-2 + ... an * z^-n)
@@ -131,8 +129,7 @@ dsp_zss_t* dsp_zss_create_from_tf(const size_t order, const real_t* const num, c
     dsp_matrix_set_to_zero(zss->D);
 
     // Init
-    if (x0 == NULL) { dsp_vector_set_to_zero(zss->xn); }
-    else { dsp_vector_copy_assign_array(zss->xn, x0); }
+    dsp_zss_set_state(zss, x0);
 
     // Initilize
     MATRIX_ELEMENT(zss->B, 0, 0) = 1;
@@ -164,7 +161,7 @@ dsp_zss_t* dsp_zss_create_from_ztf(const dsp_ztf_t* const ztf, const real_t* con
 // Create a PT1 system
 dsp_zss_t* dsp_zss_create_pt1(const real_t K, const real_t T, const real_t Ts, const real_t x0) {
 
-    const real_t a = expf(-Ts / T);
+    const real_t a = REAL_EXP(-Ts / T);
     const real_t b = K * (1 - a);
 
     const real_t num[] = {0, b};
@@ -254,7 +251,11 @@ dsp_zss_t* dsp_zss_create_derivative(const real_t K, const real_t T, const real_
 // Copy
 dsp_zss_t* dsp_zss_create_copy(const dsp_zss_t* const other) {
     if (other == NULL) { return NULL; }
-    return dsp_zss_create_from_matrices(other->A, other->B, other->C, other->D, other->xn->elements);
+    dsp_zss_t* const zss = dsp_zss_create_from_matrices(other->A, other->B, other->C, other->D, other->x->elements);
+#ifdef DSP_PRECISION_MIXED
+    if (zss != NULL) { memcpy(zss->xa, other->xa, zss->x->size * sizeof(accum_t)); }
+#endif
+    return zss;
 }
 bool dsp_zss_copy_assign(dsp_zss_t* const dest, const dsp_zss_t* const src) {
     if (dest == NULL || src == NULL) { return false; }
@@ -273,6 +274,9 @@ bool dsp_zss_copy_assign(dsp_zss_t* const dest, const dsp_zss_t* const src) {
     dsp_matrix_copy_assign(dest->D, src->D);
     dsp_vector_copy_assign(dest->x, src->x);
     dsp_vector_copy_assign(dest->xn, src->xn);
+#ifdef DSP_PRECISION_MIXED
+    memcpy(dest->xa, src->xa, dest->x->size * sizeof(accum_t));
+#endif
     return true;
 }
 
@@ -291,6 +295,11 @@ dsp_zss_t* dsp_zss_create_move(dsp_zss_t* const other) {
     zss->D = other->D;
     zss->x = other->x;
     zss->xn = other->xn;
+#ifdef DSP_PRECISION_MIXED
+    zss->xa = other->xa;
+    zss->xan = other->xan;
+#endif
+    zss->block = other->block;
 
     // Invalidate other elements array pointer
     other->A = NULL;
@@ -299,6 +308,11 @@ dsp_zss_t* dsp_zss_create_move(dsp_zss_t* const other) {
     other->D = NULL;
     other->x = NULL;
     other->xn = NULL;
+#ifdef DSP_PRECISION_MIXED
+    other->xa = NULL;
+    other->xan = NULL;
+#endif
+    other->block = NULL;
 
     return zss;
 }
@@ -314,6 +328,11 @@ bool dsp_zss_move_assign(dsp_zss_t* const dest, dsp_zss_t* const src) {
     dest->D = src->D;
     dest->x = src->x;
     dest->xn = src->xn;
+#ifdef DSP_PRECISION_MIXED
+    dest->xa = src->xa;
+    dest->xan = src->xan;
+#endif
+    dest->block = src->block;
 
     // Invalidate other elements array pointer
     src->A = NULL;
@@ -322,6 +341,11 @@ bool dsp_zss_move_assign(dsp_zss_t* const dest, dsp_zss_t* const src) {
     src->D = NULL;
     src->x = NULL;
     src->xn = NULL;
+#ifdef DSP_PRECISION_MIXED
+    src->xa = NULL;
+    src->xan = NULL;
+#endif
+    src->block = NULL;
 
     return true;
 }
@@ -347,39 +371,68 @@ bool dsp_zss_allocate_internal_arrays(dsp_zss_t* const zss, const size_t nx, con
     if(zss->xn != NULL) { return false; }
     if (nx == 0 || nu == 0 || ny == 0) { return false; }
 
+    // Layout: 4 matrix structs, 2 vector structs, then the arrays x, xn, A, B, C, D (and xa, xan)
+    const size_t header_size = 4 * MATRIX_SIZE + 2 * VECTOR_SIZE;
+    const size_t x_size = PACKED_SIZE(nx);
+    const size_t A_size = PACKED_SIZE(nx * nx);
+    const size_t B_size = PACKED_SIZE(nx * nu);
+    const size_t C_size = PACKED_SIZE(ny * nx);
+    const size_t D_size = PACKED_SIZE(ny * nu);
+#ifdef DSP_PRECISION_MIXED
+    const size_t xa_size = ACCUM_PACKED_SIZE(nx);
+#else
+    const size_t xa_size = 0;
+#endif
+
     // Allocate
-    zss->A = dsp_matrix_create(nx, nx);
-    zss->B = dsp_matrix_create(nx, nu);
-    zss->C = dsp_matrix_create(ny, nx);
-    zss->D = dsp_matrix_create(ny, nu);
-    zss->x = dsp_vector_create(nx);
-    zss->xn = dsp_vector_create(nx);
+    unsigned char* const block = (unsigned char*) dsp_malloc(header_size + ZSS_ALIGNMENT + 2 * x_size + A_size + B_size + C_size + D_size + 2 * xa_size);
+    if (block == NULL) { return false; }
+    zss->block = block;
+
+    dsp_matrix_t* const matrices = (dsp_matrix_t*) block;
+    dsp_vector_t* const vectors = (dsp_vector_t*) &block[4 * MATRIX_SIZE];
+    unsigned char* array = (unsigned char*) ALIGN_UP((uintptr_t) &block[header_size]);
+
+    zss->x = &vectors[0];
+    zss->x->size = nx;
+    zss->x->elements = (real_t*) array; array += x_size;
+    zss->xn = &vectors[1];
+    zss->xn->size = nx;
+    zss->xn->elements = (real_t*) array; array += x_size;
+
+    zss->A = &matrices[0];
+    zss->A->rows = nx; zss->A->columns = nx;
+    zss->A->elements = (real_t*) array; array += A_size;
+    zss->B = &matrices[1];
+    zss->B->rows = nx; zss->B->columns = nu;
+    zss->B->elements = (real_t*) array; array += B_size;
+    zss->C = &matrices[2];
+    zss->C->rows = ny; zss->C->columns = nx;
+    zss->C->elements = (real_t*) array; array += C_size;
+    zss->D = &matrices[3];
+    zss->D->rows = ny; zss->D->columns = nu;
+    zss->D->elements = (real_t*) array; array += D_size;
+#ifdef DSP_PRECISION_MIXED
+    zss->xa = (accum_t*) array; array += xa_size;
+    zss->xan = (accum_t*) array;
+#endif
 
-    if (zss->A == NULL || zss->B == NULL || \
-        zss->C == NULL || zss->D == NULL || \
-        zss->x == NULL || zss->xn == NULL) {
+    return true;
+}
+bool dsp_zss_release_internal_arrays(dsp_zss_t* const zss) {
+    if (zss == NULL) { return false; }
 
+    if (zss->block != NULL) {
+        dsp_free(zss->block);
+    }
+    else {
         dsp_matrix_destroy(zss->A);
         dsp_matrix_destroy(zss->B);
         dsp_matrix_destroy(zss->C);
         dsp_matrix_destroy(zss->D);
         dsp_vector_destroy(zss->x);
         dsp_vector_destroy(zss->xn);
-        return false;
-    }
-    else {
-        return true;
     }
-}
-bool dsp_zss_release_internal_arrays(dsp_zss_t* const zss) {
-    if (zss == NULL) { return false; }
-
-    dsp_matrix_destroy(zss->A);
-    dsp_matrix_destroy(zss->B);
-    dsp_matrix_destroy(zss->C);
-    dsp_matrix_destroy(zss->D);
-    dsp_vector_destroy(zss->x);
-    dsp_vector_destroy(zss->xn);
 
     zss->A = NULL;
     zss->B = NULL;
@@ -387,12 +440,17 @@ bool dsp_zss_release_internal_arrays(dsp_zss_t* const zss) {
     zss->D = NULL;
     zss->x = NULL;
     zss->xn = NULL;
+#ifdef DSP_PRECISION_MIXED
+    zss->xa = NULL;
+    zss->xan = NULL;
+#endif
+    zss->block = NULL;
     return true;
 }
 bool dsp_zss_destroy(dsp_zss_t* const zss) {
     if (zss == NULL) { return NULL; }
     dsp_zss_release_internal_arrays(zss);
-    free(zss);
+    dsp_free(zss);
     return true;
 }
 
@@ -401,9 +459,9 @@ bool dsp_zss_destroy(dsp_zss_t* const zss) {
 bool dsp_zss_set_state_to(dsp_zss_t* const zss, const dsp_vector_t* const x0) {
     if (zss == NULL) { return false; }
     if (x0 != NULL) {
-        return \
-            dsp_vector_copy_assign(zss->xn, x0) && \
-            dsp_vector_copy_assign(zss->x, x0);
+        if (!dsp_vector_copy_assign(zss->xn, x0) || !dsp_vector_copy_assign(zss->x, x0)) { return false; }
+        load_state(zss);
+        return true;
     }
     else { 
         return dsp_zss_reset(zss);
@@ -412,9 +470,9 @@ bool dsp_zss_set_state_to(dsp_zss_t* const zss, const dsp_vector_t* const x0) {
 bool dsp_zss_set_state(dsp_zss_t* const zss, const real_t* const x0) {
     if (zss == NULL) { return false; }
     if (x0 != NULL) {
-        return \
-            dsp_vector_copy_assign_array(zss->xn, x0) && \
-            dsp_vector_copy_assign_array(zss->x, x0);
+        if (!dsp_vector_copy_assign_array(zss->xn, x0) || !dsp_vector_copy_assign_array(zss->x, x0)) { return false; }
+        load_state(zss);
+        return true;
     }
     else { 
         return dsp_zss_reset(zss);
@@ -427,7 +485,7 @@ bool dsp_zss_set_initial_conditions_to(dsp_zss_t* const zss, const dsp_vector_t*
 
     dsp_matrix_t* const inv_C = dsp_matrix_create_pinv(zss->C);
     dsp_vector_t* const acc = dsp_vector_create_copy(y0);
-    if (inv_C == NULL && acc == NULL) {
+    if (inv_C == NULL || acc == NULL) {
         dsp_vector_destroy(acc); // NULL safe
         dsp_matrix_destroy(inv_C); // NULL safe
         return false;
@@ -439,6 +497,7 @@ bool dsp_zss_set_initial_conditions_to(dsp_zss_t* const zss, const dsp_vector_t*
     // x0 = inv(c) * acc
     dsp_matrix_vector_multiply(zss->x, inv_C, acc);
     dsp_vector_copy_assign(zss->xn, zss->x);
+    load_state(zss);
 
     dsp_vector_destroy(acc);
     dsp_matrix_destroy(inv_C);
@@ -457,9 +516,9 @@ bool dsp_zss_set_initial_conditions(dsp_zss_t* const zss, const real_t* const u0
 // Reset state
 bool dsp_zss_reset(dsp_zss_t* const zss) {
     if (zss == NULL) { return false; }
-    return \
-        dsp_vector_set_to_zero(zss->xn) && \
-        dsp_vector_set_to_zero(zss->x);
+    if (!dsp_vector_set_to_zero(zss->xn) || !dsp_vector_set_to_zero(zss->x)) { return false; }
+    load_state(zss);
+    return true;
 }
 
 
@@ -481,11 +540,19 @@ bool dsp_zss_has_feedthrough(const dsp_zss_t* const zss) {
 bool dsp_zss_vector_get_output(dsp_zss_t* const zss, const dsp_vector_t* const u, dsp_vector_t* const y) {
     if (zss == NULL || u == NULL || y == NULL) { return false; }
 
+#ifdef DSP_PRECISION_MIXED
+    // y[n] = C * x[n] + D * u[n] from the state in double
+    if (y->size != zss->C->rows || u->size != zss->D->columns) { return false; }
+    for (size_t i = 0; i < y->size; ++i) {
+        y->elements[i] = (real_t) (accum_row(zss->C, i, zss->xa) + real_row(zss->D, i, u->elements));
+    }
+#else
     // y[n] = C * x[n]
     dsp_matrix_vector_multiply(y, zss->C, zss->x);
 
     // y[n] += D * u[n]
     dsp_matrix_vector_multiply_and_add_to_vector(y, zss->D, u);
+#endif
 
     return true;
 }
@@ -494,6 +561,17 @@ bool dsp_zss_vector_get_output(dsp_zss_t* const zss, const dsp_vector_t* const u
 bool dsp_zss_vector_update_state(dsp_zss_t* const zss, const dsp_vector_t* const u) {
     if (zss == NULL || u == NULL) { return false; }
 
+#ifdef DSP_PRECISION_MIXED
+    // x[n+1] = A * x[n] + B * u[n] in double, 'x' gets the rounded state
+    if (u->size != zss->B->columns) { return false; }
+    for (size_t i = 0; i < zss->x->size; ++i) {
+        zss->xan[i] = accum_row(zss->A, i, zss->xa) + real_row(zss->B, i, u->elements);
+    }
+    accum_t* const xa = zss->xa;
+    zss->xa = zss->xan;
+    zss->xan = xa;
+    for (size_t i = 0; i < zss->x->size; ++i) { zss->x->elements[i] = (real_t) zss->xa[i]; }
+#else
     // x[n+1] = A * x[n]
     dsp_matrix_vector_multiply(zss->xn, zss->A, zss->x);
 
@@ -502,6 +580,7 @@ bool dsp_zss_vector_update_state(dsp_zss_t* const zss, const dsp_vector_t* const
 
     // swap 
     dsp_vector_swap(zss->x, zss->xn);
+#endif
 
     // x now contains the updated state
     return true;
@@ -0,0 +1,218 @@
+#include <string.h> // memcpy, memset
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Math/Simd.h" // dsp_simd_multiply_add
+#include "DSP/Discrete/zStateSpaceBank.h"
+
+#ifdef DSP_THREADS
+#include <pthread.h>
+#endif
+
+#define BANK_SIZE sizeof(dsp_zss_bank_t)
+#define REAL_SIZE sizeof(real_t)
+
+// Packed arrays: every row of lanes starts on a cache line
+#define BANK_ALIGNMENT 64
+#define LANES_PER_LINE (BANK_ALIGNMENT / REAL_SIZE)
+#define ALIGN_UP(value) (((value) + (BANK_ALIGNMENT - 1)) & ~((uintptr_t) BANK_ALIGNMENT - 1))
+#define ROW_STRIDE(lanes) (((lanes) + LANES_PER_LINE - 1) & ~((size_t) LANES_PER_LINE - 1))
+
+// Lanes updated together, so the rows of a tile stay in the L1 cache
+#define BANK_TILE 256
+
+// Row of element (i,j) of a matrix with 'columns' columns
+#define ELEMENT_ROW(bank, mat, columns, i, j) (&((bank)->mat[((i) * (columns) + (j)) * (bank)->stride]))
+
+// Threads of 'dsp_zss_bank_update_parallel()'
+#define MAX_THREADS 64
+
+
+// Create
+dsp_zss_bank_t* dsp_zss_bank_create(const size_t nx, const size_t nu, const size_t ny, const size_t lanes) {
+    if (nx == 0 || nu == 0 || ny == 0 || lanes == 0) { return NULL; }
+
+    // Layout: the bank struct, then x, xn, A, B, C, D
+    const size_t stride = ROW_STRIDE(lanes);
+    const size_t rows = 2 * nx + nx * nx + nx * nu + ny * nx + ny * nu;
+    unsigned char* const block = (unsigned char*) dsp_malloc(BANK_SIZE + BANK_ALIGNMENT + rows * stride * REAL_SIZE);
+    if (block == NULL) { return NULL; }
+
+    dsp_zss_bank_t* const bank = (dsp_zss_bank_t*) block;
+    real_t* array = (real_t*) ALIGN_UP((uintptr_t) &block[BANK_SIZE]);
+    memset(array, 0, rows * stride * REAL_SIZE);
+
+    bank->nx = nx;
+    bank->nu = nu;
+    bank->ny = ny;
+    bank->lanes = lanes;
+    bank->stride = stride;
+    bank->x = array; array += nx * stride;
+    bank->xn = array; array += nx * stride;
+    bank->A = array; array += nx * nx * stride;
+    bank->B = array; array += nx * nu * stride;
+    bank->C = array; array += ny * nx * stride;
+    bank->D = array;
+    bank->block = block;
+    return bank;
+}
+
+// Destroy
+bool dsp_zss_bank_destroy(dsp_zss_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    // The struct lives at the beginning of the block
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+// Scatter a row-major matrix into one lane
+static void set_lane_matrix(const dsp_zss_bank_t* const bank, real_t* const elements, const size_t lane, const dsp_matrix_t* const mat) {
+    for (size_t k = 0; k < mat->rows * mat->columns; ++k) {
+        elements[k * bank->stride + lane] = mat->elements[k];
+    }
+}
+
+bool dsp_zss_bank_set_lane(dsp_zss_bank_t* const bank, const size_t lane, const dsp_zss_t* const zss) {
+    if (bank == NULL || zss == NULL) { return false; }
+    if (zss->A == NULL || zss->B == NULL || zss->C == NULL || zss->D == NULL || zss->x == NULL) { return false; }
+    if (lane >= bank->lanes) { return false; }
+    if (zss->A->rows != bank->nx || zss->B->columns != bank->nu || zss->C->rows != bank->ny) { return false; }
+
+    set_lane_matrix(bank, bank->A, lane, zss->A);
+    set_lane_matrix(bank, bank->B, lane, zss->B);
+    set_lane_matrix(bank, bank->C, lane, zss->C);
+    set_lane_matrix(bank, bank->D, lane, zss->D);
+    return dsp_zss_bank_set_state(bank, lane, zss->x->elements);
+}
+
+bool dsp_zss_bank_set_state(dsp_zss_bank_t* const bank, const size_t lane, const real_t* const x0) {
+    if (bank == NULL) { return false; }
+    if (lane >= bank->lanes) { return false; }
+
+    for (size_t i = 0; i < bank->nx; ++i) {
+        bank->x[i * bank->stride + lane] = (x0 == NULL ? 0 : x0[i]);
+    }
+    return true;
+}
+
+bool dsp_zss_bank_get_state(const dsp_zss_bank_t* const bank, const size_t lane, real_t* const x) {
+    if (bank == NULL || x == NULL) { return false; }
+    if (lane >= bank->lanes) { return false; }
+
+    for (size_t i = 0; i < bank->nx; ++i) {
+        x[i] = bank->x[i * bank->stride + lane];
+    }
+    return true;
+}
+
+
+
+// Lanes [first, first + count) of one tile
+static void update_tile(dsp_zss_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y) {
+    const size_t nx = bank->nx;
+    const size_t nu = bank->nu;
+    const size_t stride = bank->stride;
+    const size_t lanes = bank->lanes;
+
+    // y = C * x + D * u
+    for (size_t i = 0; i < bank->ny; ++i) {
+        real_t* const yi = &y[i * lanes + first];
+        memset(yi, 0, count * REAL_SIZE);
+        for (size_t j = 0; j < nx; ++j) {
+            dsp_simd_multiply_add(yi, &ELEMENT_ROW(bank, C, nx, i, j)[first], &bank->x[j * stride + first], count);
+        }
+        for (size_t j = 0; j < nu; ++j) {
+            dsp_simd_multiply_add(yi, &ELEMENT_ROW(bank, D, nu, i, j)[first], &u[j * lanes + first], count);
+        }
+    }
+
+    // xn = A * x + B * u
+    for (size_t i = 0; i < nx; ++i) {
+        real_t* const xi = &bank->xn[i * stride + first];
+        memset(xi, 0, count * REAL_SIZE);
+        for (size_t j = 0; j < nx; ++j) {
+            dsp_simd_multiply_add(xi, &ELEMENT_ROW(bank, A, nx, i, j)[first], &bank->x[j * stride + first], count);
+        }
+        for (size_t j = 0; j < nu; ++j) {
+            dsp_simd_multiply_add(xi, &ELEMENT_ROW(bank, B, nu, i, j)[first], &u[j * lanes + first], count);
+        }
+    }
+
+    // x = xn
+    for (size_t i = 0; i < nx; ++i) {
+        memcpy(&bank->x[i * stride + first], &bank->xn[i * stride + first], count * REAL_SIZE);
+    }
+}
+
+bool dsp_zss_bank_update_range(dsp_zss_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    if (first > bank->lanes || count > bank->lanes - first) { return false; }
+
+    for (size_t k = first; k < first + count; k += BANK_TILE) {
+        const size_t tile = (first + count - k < BANK_TILE ? first + count - k : BANK_TILE);
+        update_tile(bank, k, tile, u, y);
+    }
+    return true;
+}
+
+bool dsp_zss_bank_update(dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (bank == NULL) { return false; }
+    return dsp_zss_bank_update_range(bank, 0, bank->lanes, u, y);
+}
+
+
+
+#ifdef DSP_THREADS
+
+// Work of one thread
+typedef struct ZssBankRange {
+    dsp_zss_bank_t* bank;
+    size_t first;
+    size_t count;
+    const real_t* u;
+    real_t* y;
+} zss_bank_range_t;
+
+static void* update_range_thread(void* const argument) {
+    zss_bank_range_t* const range = (zss_bank_range_t*) argument;
+    dsp_zss_bank_update_range(range->bank, range->first, range->count, range->u, range->y);
+    return NULL;
+}
+
+#endif // DSP_THREADS
+
+bool dsp_zss_bank_update_parallel(dsp_zss_bank_t* const bank, const real_t* const u, real_t* const y, const size_t threads) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+
+#ifdef DSP_THREADS
+    // Ranges of whole cache lines, so no two threads write the same line of the states
+    const size_t n_threads = (threads < MAX_THREADS ? threads : MAX_THREADS);
+    const size_t chunk = (n_threads == 0 ? bank->lanes : ROW_STRIDE((bank->lanes + n_threads - 1) / n_threads));
+    if (n_threads <= 1 || chunk >= bank->lanes) { return dsp_zss_bank_update(bank, u, y); }
+
+    zss_bank_range_t ranges[MAX_THREADS];
+    pthread_t workers[MAX_THREADS];
+    bool started[MAX_THREADS];
+    size_t n_ranges = 0;
+    for (size_t first = 0; first < bank->lanes; first += chunk) {
+        const zss_bank_range_t range = {bank, first, (bank->lanes - first < chunk ? bank->lanes - first : chunk), u, y};
+        ranges[n_ranges++] = range;
+    }
+
+    // The caller takes the first range, a range whose thread can't be started as well
+    for (size_t k = 1; k < n_ranges; ++k) {
+        started[k] = (pthread_create(&workers[k], NULL, update_range_thread, &ranges[k]) == 0);
+    }
+    update_range_thread(&ranges[0]);
+    for (size_t k = 1; k < n_ranges; ++k) {
+        if (started[k]) { pthread_join(workers[k], NULL); }
+        else { update_range_thread(&ranges[k]); }
+    }
+    return true;
+#else
+    (void) threads;
+    return dsp_zss_bank_update(bank, u, y);
+#endif
+}
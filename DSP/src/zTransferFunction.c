@@ -1,24 +1,43 @@
 // #include "stdafx.h"
-#include <stdlib.h> // malloc, free
 #include <string.h> // memcpy, memset, memmove
-#include <math.h> // expf
+#include <math.h> // expf, exp
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
 #include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Math/Simd.h" // dsp_simd_dot_product
 
 #define ZFT_SIZE sizeof(dsp_ztf_t)
-#define NEW_ZTF() ((dsp_ztf_t*) malloc(ZFT_SIZE))
+#define NEW_ZTF() ((dsp_ztf_t*) dsp_malloc(ZFT_SIZE))
 
 #define REAL_SIZE sizeof(real_t)
 #define ARRAY_SIZE(order) ((order+1) * REAL_SIZE)
-#define NEW_ARRAY(order) ((real_t*) malloc(ARRAY_SIZE(order)))
+#define NEW_ARRAY(order) ((real_t*) dsp_malloc(ARRAY_SIZE(order)))
+#define NEW_HISTORY(order) ((real_t*) dsp_malloc(2 * ARRAY_SIZE(order)))
+#define NEW_OUTPUT_HISTORY(order) ((accum_t*) dsp_malloc(2 * (order+1) * sizeof(accum_t)))
+
+
+// Dot product of short windows without the dispatch of 'dsp_simd_dot_product()'
+// (same operations in the same order as its scalar kernel)
+static inline real_t dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    if (size == 0) { return 0; }
+    accum_t sum = (accum_t) v[0] * u[0];
+    for (size_t k = 1; k < size; ++k) { sum += (accum_t) v[k] * u[k]; }
+    return (real_t) sum;
+}
 
+#ifdef DSP_PRECISION_MIXED
+// Dot products without rounding the sum, for the history of the outputs in double
+static inline accum_t accum_dot_product(const real_t* const u, const real_t* const v, const size_t size) {
+    accum_t sum = 0;
+    for (size_t k = 0; k < size; ++k) { sum += (accum_t) v[k] * u[k]; }
+    return sum;
+}
 
-static real_t dot_product(const real_t* const v1, const real_t* const v2, const size_t size) {
-    real_t sum = 0;
-    for (size_t i = 0; i < size; ++i) {
-        sum += v1[i] * v2[i];
-    }
+static inline accum_t output_dot_product(const real_t* const u, const accum_t* const v, const size_t size) {
+    accum_t sum = 0;
+    for (size_t k = 0; k < size; ++k) { sum += v[k] * u[k]; }
     return sum;
 }
+#endif
 
 
 // Create
@@ -32,16 +51,17 @@ dsp_ztf_t* dsp_ztf_create(const size_t order) {
     ztf->order = order;
     ztf->a = NEW_ARRAY(order+1);
     ztf->b = NEW_ARRAY(order+1);
-    ztf->u = NEW_ARRAY(order+1);
-    ztf->y = NEW_ARRAY(order+1);
+    ztf->u = NEW_HISTORY(order);
+    ztf->y = NEW_OUTPUT_HISTORY(order);
+    ztf->index = 0;
 
     // If memeory allocation failed
     if (ztf->a == NULL || ztf->b == NULL || ztf->u == NULL || ztf->y == NULL) {
-        if (ztf->a != NULL) { free(ztf->a); }
-        if (ztf->b != NULL) { free(ztf->b); }
-        if (ztf->u != NULL) { free(ztf->u); }
-        if (ztf->y != NULL) { free(ztf->y); }
-        free(ztf);
+        if (ztf->a != NULL) { dsp_free(ztf->a); }
+        if (ztf->b != NULL) { dsp_free(ztf->b); }
+        if (ztf->u != NULL) { dsp_free(ztf->u); }
+        if (ztf->y != NULL) { dsp_free(ztf->y); }
+        dsp_free(ztf);
         return NULL;
     }
     else {
@@ -63,7 +83,7 @@ dsp_ztf_t* dsp_ztf_create_from_arrays(const size_t order, const real_t* const nu
 
 dsp_ztf_t* dsp_ztf_create_PT1(const real_t K, const real_t T, const real_t Ts, const real_t initial_u, const real_t initial_y) {
 
-    const real_t a = expf(- Ts / T);
+    const real_t a = REAL_EXP(- Ts / T);
     const real_t b = K * (1 - a);
 
     const real_t num[2] = {0, b};
@@ -142,11 +162,11 @@ dsp_ztf_t* dsp_ztf_create_derivative(const real_t K, const real_t T, const real_
 bool dsp_ztf_destroy(dsp_ztf_t* const ztf) {
     if (ztf == NULL) { return false; }
 
-    if (ztf->a != NULL) { free(ztf->a); }
-    if (ztf->b != NULL) { free(ztf->b); }
-    if (ztf->u != NULL) { free(ztf->u); }
-    if (ztf->y != NULL) { free(ztf->y); }
-    free(ztf);
+    if (ztf->a != NULL) { dsp_free(ztf->a); }
+    if (ztf->b != NULL) { dsp_free(ztf->b); }
+    if (ztf->u != NULL) { dsp_free(ztf->u); }
+    if (ztf->y != NULL) { dsp_free(ztf->y); }
+    dsp_free(ztf);
     return true;
 }
 
@@ -169,16 +189,52 @@ bool dsp_ztf_set_coefficients(dsp_ztf_t* const ztf, const real_t* const num, con
     return true;
 }
 
+// Write a new value to the head of a mirrored history
+static inline void push_history(real_t* const history, const size_t index, const size_t length, const real_t value) {
+    history[index] = value;
+    history[index + length] = value;
+}
+
+static inline void push_output_history(accum_t* const history, const size_t index, const size_t length, const accum_t value) {
+    history[index] = value;
+    history[index + length] = value;
+}
+
+// Rewrite a mirrored history with 'length-1' values (newest first), the last slot is cleared
+static void write_history(real_t* const history, const real_t* const values, const size_t length) {
+    if (values == NULL) { memset(history, 0, (length - 1) * sizeof(real_t)); }
+    else { memmove(history, values, (length - 1) * sizeof(real_t)); }
+    history[length - 1] = 0;
+    memcpy(&(history[length]), history, length * sizeof(real_t));
+}
+
+#ifdef DSP_PRECISION_MIXED
+// The same for the outputs in double ('values' can't point into them)
+static void write_output_history(accum_t* const history, const real_t* const values, const size_t length) {
+    for (size_t i = 0; i + 1 < length; ++i) { history[i] = (values == NULL ? 0 : values[i]); }
+    history[length - 1] = 0;
+    memcpy(&(history[length]), history, length * sizeof(accum_t));
+}
+#else
+#define write_output_history write_history
+#endif
+
 bool dsp_ztf_set_initial_condition(dsp_ztf_t* const ztf, const real_t* initial_u, const real_t* initial_y) {
     if (ztf == NULL) { return false; }
+    const size_t order = ztf->order;
 
-    // set initial 'u' values
-    if (initial_u == NULL) { memset(ztf->u, 0, ztf->order * sizeof(real_t)); }
-    else if (initial_u != ztf->u) { memcpy(ztf->u, initial_u, ztf->order * sizeof(real_t)); }
+    // An initial condition taken from the live window must be copied before it is overwritten
+    real_t* const window_u = &(ztf->u[ztf->index]);
+    if (initial_u == window_u) { memmove(ztf->u, window_u, order * sizeof(real_t)); initial_u = ztf->u; }
+#ifndef DSP_PRECISION_MIXED
+    real_t* const window_y = &(ztf->y[ztf->index]);
+    if (initial_y == window_y) { memmove(ztf->y, window_y, order * sizeof(real_t)); initial_y = ztf->y; }
+#endif
 
-    // set initial 'y' values
-    if (initial_y == NULL) { memset(ztf->y, 0, ztf->order * sizeof(real_t)); }
-    else if (initial_y != ztf->y) { memcpy(ztf->y, initial_y, ztf->order * sizeof(real_t)); }
+    // The slot at 'order' is the next one to be written
+    ztf->index = 0;
+    write_history(ztf->u, initial_u, order + 1);
+    write_output_history(ztf->y, initial_y, order + 1);
 
     return true;
 }
@@ -187,23 +243,112 @@ bool dsp_ztf_reset(dsp_ztf_t* const ztf) {
     return dsp_ztf_set_initial_condition(ztf, NULL, NULL);
 }
 
+// Difference equation for the input in the free history slot 'index'
+static accum_t difference_equation(const dsp_ztf_t* const ztf, const size_t index) {
+    const size_t length = ztf->order + 1;
+#ifdef DSP_PRECISION_MIXED
+    // Neither sum is rounded, so slow poles keep the precision of the history in double
+    const accum_t bu = accum_dot_product(ztf->b, &(ztf->u[index]), length);
+    const accum_t ay = output_dot_product(&(ztf->a[1]), &(ztf->y[index + 1]), ztf->order);
+    return (bu - ay) / ztf->a[0];
+#else
+    real_t bu, ay;
+    if (length < DSP_SIMD_MIN_SIZE) {
+        bu = dot_product(ztf->b, &(ztf->u[index]), length);
+        ay = dot_product(&(ztf->a[1]), &(ztf->y[index + 1]), ztf->order);
+    }
+    else {
+        bu = dsp_simd_dot_product(ztf->b, &(ztf->u[index]), length);
+        ay = dsp_simd_dot_product(&(ztf->a[1]), &(ztf->y[index + 1]), ztf->order);
+    }
+    return (bu - ay) / ztf->a[0];
+#endif
+}
+
 real_t dsp_ztf_update(dsp_ztf_t* const ztf, const real_t new_u) {
     if (ztf == NULL) { return 0; }
 
-    // shift values
-    memmove(&(ztf->u[1]), &(ztf->u[0]), ztf->order * sizeof(real_t));
-    memmove(&(ztf->y[1]), &(ztf->y[0]), ztf->order * sizeof(real_t));
+    // move the head back instead of shifting values
+    const size_t length = ztf->order + 1;
+    const size_t index = (ztf->index == 0 ? ztf->order : ztf->index - 1);
+    ztf->index = index;
 
     // calculate new value
-    ztf->u[0] = new_u;
-    const real_t bu = dot_product(ztf->b, ztf->u, (ztf->order + 1));
-    const real_t ay = dot_product(&(ztf->a[1]), &(ztf->y[1]), ztf->order);
-    ztf->y[0] = (bu - ay) / ztf->a[0];
-    return ztf->y[0];
+    push_history(ztf->u, index, length, new_u);
+    const accum_t new_y = difference_equation(ztf, index);
+    push_output_history(ztf->y, index, length, new_y);
+    return (real_t) new_y;
+}
+
+real_t dsp_ztf_next_output(dsp_ztf_t* const ztf) {
+    if (ztf == NULL) { return 0; }
+
+    // The slot of the next input is not part of the history yet, it holds 0 until the update
+    const size_t index = (ztf->index == 0 ? ztf->order : ztf->index - 1);
+    push_history(ztf->u, index, ztf->order + 1, 0);
+    return (real_t) difference_equation(ztf, index);
+}
+
+bool dsp_ztf_has_feedthrough(const dsp_ztf_t* const ztf) {
+    return (ztf != NULL && ztf->b[0] != 0);
+}
+
+bool dsp_ztf_process_block(dsp_ztf_t* const ztf, const real_t* const in, real_t* const out, const size_t n) {
+    if (ztf == NULL || in == NULL || out == NULL) { return false; }
+
+    const size_t order = ztf->order;
+
+    // In-place or too short: the frame can't hold the history.
+    // Long enough for the vector kernels: their summation order differs from the taps below.
+    // Mixed precision: the frame only holds the rounded outputs, not the history in double.
+#ifdef DSP_PRECISION_MIXED
+    const bool per_sample = true;
+#else
+    const bool per_sample = (in == out || n <= order || order + 1 >= DSP_SIMD_MIN_SIZE);
+#endif
+    if (per_sample) {
+        for (size_t k = 0; k < n; ++k) { out[k] = dsp_ztf_update(ztf, in[k]); }
+        return true;
+    }
+
+    // The first samples still depend on the stored history
+    for (size_t k = 0; k < order; ++k) { out[k] = dsp_ztf_update(ztf, in[k]); }
+
+    // From here on the history is part of the frame itself
+    // (Same operations in the same order as 'dsp_ztf_update()')
+    const real_t* const a = ztf->a;
+    const real_t* const b = ztf->b;
+    for (size_t k = order; k < n; ++k) {
+        accum_t bu = (accum_t) in[k] * b[0];
+        for (size_t i = 1; i <= order; ++i) { bu += (accum_t) in[k-i] * b[i]; }
+        accum_t ay = 0;
+        if (order > 0) {
+            ay = (accum_t) out[k-1] * a[1];
+            for (size_t i = 2; i <= order; ++i) { ay += (accum_t) out[k-i] * a[i]; }
+        }
+        out[k] = ((real_t) bu - (real_t) ay) / a[0];
+    }
+
+    // Store the history for the next call
+    ztf->index = 0;
+    for (size_t i = 0; i <= order; ++i) {
+        push_history(ztf->u, i, order + 1, in[n-1-i]);
+        push_output_history(ztf->y, i, order + 1, out[n-1-i]);
+    }
+    return true;
+}
+
+bool dsp_ztf_process_signal(dsp_ztf_t* const ztf, const dsp_signal_t* const in, dsp_signal_t* const out) {
+    if (ztf == NULL || in == NULL || out == NULL) { return false; }
+    if (in->size == 0) { dsp_signal_clear(out); return true; }
+
+    dsp_signal_resize(out, in->size, NULL);
+    if (out->size != in->size) { return false; }
+    return dsp_ztf_process_block(ztf, in->elements, out->elements, in->size);
 }
 
 real_t dsp_ztf_output(dsp_ztf_t* const ztf) {
     if (ztf == NULL) { return 0; }
-    return ztf->y[0];
+    return (real_t) ztf->y[ztf->index];
 }
 
@@ -0,0 +1,198 @@
+#include <string.h> // memcpy, memset
+#include <stdint.h> // uintptr_t
+#include "DSP/Memory/Memory.h" // dsp_malloc, dsp_free
+#include "DSP/Discrete/zTransferFunctionBank.h"
+#include "DSP/Math/Simd.h" // dsp_simd_axpy, dsp_simd_multiply_add
+
+#define BANK_SIZE sizeof(dsp_ztf_bank_t)
+#define REAL_SIZE sizeof(real_t)
+
+// Packed arrays: every row starts on a cache line
+#define BANK_ALIGNMENT 64
+#define ALIGN_UP(value) (((value) + (BANK_ALIGNMENT - 1)) & ~((uintptr_t) BANK_ALIGNMENT - 1))
+#define ROW_STRIDE(channels) (((channels) + (BANK_ALIGNMENT / REAL_SIZE) - 1) & ~((size_t) (BANK_ALIGNMENT / REAL_SIZE) - 1))
+
+// Row 'j' samples ago of a history, coefficient row 'i'
+#define HISTORY_ROW(bank, history, j) (&((bank)->history[(((bank)->index + (j)) % ((bank)->order + 1)) * (bank)->stride]))
+#define COEFFICIENT_ROW(bank, coefficients, i) (&((bank)->coefficients[(i) * (bank)->stride]))
+
+
+// Create
+dsp_ztf_bank_t* dsp_ztf_bank_create(const size_t order, const size_t channels, const bool shared) {
+    if (channels == 0) { return NULL; }
+
+    // Layout: the bank struct, then b, a, u, y
+    const size_t length = order + 1;
+    const size_t stride = ROW_STRIDE(channels);
+    const size_t coefficients_size = ALIGN_UP((shared ? length : length * stride) * REAL_SIZE);
+    const size_t history_size = length * stride * REAL_SIZE;
+
+    unsigned char* const block = (unsigned char*) dsp_malloc(BANK_SIZE + BANK_ALIGNMENT + 2 * coefficients_size + 2 * history_size);
+    if (block == NULL) { return NULL; }
+
+    dsp_ztf_bank_t* const bank = (dsp_ztf_bank_t*) block;
+    unsigned char* array = (unsigned char*) ALIGN_UP((uintptr_t) &block[BANK_SIZE]);
+
+    bank->order = order;
+    bank->channels = channels;
+    bank->stride = stride;
+    bank->shared = shared;
+    bank->b = (real_t*) array; array += coefficients_size;
+    bank->a = (real_t*) array; array += coefficients_size;
+    bank->u = (real_t*) array; array += history_size;
+    bank->y = (real_t*) array;
+    bank->index = 0;
+    bank->block = block;
+
+    // G(z) = 1 with cleared histories
+    dsp_ztf_bank_set_coefficients(bank, NULL, NULL);
+    dsp_ztf_bank_reset(bank);
+    return bank;
+}
+
+dsp_ztf_bank_t* dsp_ztf_bank_create_lowpass_filter(const size_t channels, const real_t K, const real_t T, const real_t Ts) {
+
+    dsp_ztf_bank_t* const bank = dsp_ztf_bank_create(1, channels, true);
+    if (bank == NULL) { return NULL; }
+
+    const real_t num[2] = {0, (K * Ts) / T};
+    const real_t den[2] = {1, (Ts / T - 1)};
+    dsp_ztf_bank_set_coefficients(bank, num, den);
+    return bank;
+}
+
+// Destroy
+bool dsp_ztf_bank_destroy(dsp_ztf_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    // The struct lives at the beginning of the block
+    dsp_free(bank->block);
+    return true;
+}
+
+
+
+// Coefficient 'i' of a numerator or denominator (NULL: 1)
+#define COEFFICIENT(poly, i) ((poly) == NULL ? ((i) == 0 ? 1 : 0) : (poly)[(i)])
+
+// Normalized coefficients: b[i] / a[0] and -a[i] / a[0]
+#define NORMALIZED_B(num, a0, i) (COEFFICIENT(num, i) / (a0))
+#define NORMALIZED_A(den, a0, i) ((i) == 0 ? 1 : -COEFFICIENT(den, i) / (a0))
+
+
+bool dsp_ztf_bank_set_coefficients(dsp_ztf_bank_t* const bank, const real_t* const num, const real_t* const den) {
+    if (bank == NULL) { return false; }
+    const real_t a0 = COEFFICIENT(den, 0);
+    if (a0 == 0) { return false; }
+
+    for (size_t i = 0; i <= bank->order; ++i) {
+        const real_t b = NORMALIZED_B(num, a0, i);
+        const real_t a = NORMALIZED_A(den, a0, i);
+        if (bank->shared) {
+            bank->b[i] = b;
+            bank->a[i] = a;
+        }
+        else {
+            real_t* const b_row = COEFFICIENT_ROW(bank, b, i);
+            real_t* const a_row = COEFFICIENT_ROW(bank, a, i);
+            for (size_t c = 0; c < bank->channels; ++c) { b_row[c] = b; a_row[c] = a; }
+        }
+    }
+    return true;
+}
+
+bool dsp_ztf_bank_set_channel_coefficients(dsp_ztf_bank_t* const bank, const size_t channel, const real_t* const num, const real_t* const den) {
+    if (bank == NULL) { return false; }
+    if (bank->shared || channel >= bank->channels) { return false; }
+    const real_t a0 = COEFFICIENT(den, 0);
+    if (a0 == 0) { return false; }
+
+    for (size_t i = 0; i <= bank->order; ++i) {
+        COEFFICIENT_ROW(bank, b, i)[channel] = NORMALIZED_B(num, a0, i);
+        COEFFICIENT_ROW(bank, a, i)[channel] = NORMALIZED_A(den, a0, i);
+    }
+    return true;
+}
+
+bool dsp_ztf_bank_set_channel_initial_condition(dsp_ztf_bank_t* const bank, const size_t channel, const real_t* const initial_u, const real_t* const initial_y) {
+    if (bank == NULL) { return false; }
+    if (channel >= bank->channels) { return false; }
+
+    // Like 'dsp_ztf_set_initial_condition()': the oldest slot is the next one to be written
+    for (size_t j = 0; j < bank->order; ++j) {
+        HISTORY_ROW(bank, u, j)[channel] = (initial_u == NULL ? 0 : initial_u[j]);
+        HISTORY_ROW(bank, y, j)[channel] = (initial_y == NULL ? 0 : initial_y[j]);
+    }
+    HISTORY_ROW(bank, u, bank->order)[channel] = 0;
+    HISTORY_ROW(bank, y, bank->order)[channel] = 0;
+    return true;
+}
+
+bool dsp_ztf_bank_set_channel(dsp_ztf_bank_t* const bank, const size_t channel, const dsp_ztf_t* const ztf) {
+    if (bank == NULL || ztf == NULL) { return false; }
+    if (channel >= bank->channels || ztf->order != bank->order) { return false; }
+    if (!bank->shared && !dsp_ztf_bank_set_channel_coefficients(bank, channel, ztf->b, ztf->a)) { return false; }
+
+    // The window of 'ztf' starts with the newest value
+    for (size_t j = 0; j <= bank->order; ++j) {
+        HISTORY_ROW(bank, u, j)[channel] = ztf->u[ztf->index + j];
+        HISTORY_ROW(bank, y, j)[channel] = (real_t) ztf->y[ztf->index + j];
+    }
+    return true;
+}
+
+bool dsp_ztf_bank_reset(dsp_ztf_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    const size_t history_size = (bank->order + 1) * bank->stride * REAL_SIZE;
+    memset(bank->u, 0, history_size);
+    memset(bank->y, 0, history_size);
+    bank->index = 0;
+    return true;
+}
+
+
+
+bool dsp_ztf_bank_next_sample(dsp_ztf_bank_t* const bank) {
+    if (bank == NULL) { return false; }
+
+    // Move the head back, the oldest row becomes the newest
+    bank->index = (bank->index == 0 ? bank->order : bank->index - 1);
+    return true;
+}
+
+bool dsp_ztf_bank_update_range(dsp_ztf_bank_t* const bank, const size_t first, const size_t count, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    if (first > bank->channels || count > bank->channels - first) { return false; }
+
+    memcpy(&HISTORY_ROW(bank, u, 0)[first], &u[first], count * REAL_SIZE);
+
+    // y[k] = b0 * u[k] + ... + bn * u[k-n] - a1 * y[k-1] - ... - an * y[k-n] (normalized)
+    real_t* const new_y = &HISTORY_ROW(bank, y, 0)[first];
+    memset(new_y, 0, count * REAL_SIZE);
+    for (size_t i = 0; i <= bank->order; ++i) {
+        if (bank->shared) { dsp_simd_axpy(new_y, bank->b[i], &HISTORY_ROW(bank, u, i)[first], count); }
+        else { dsp_simd_multiply_add(new_y, &COEFFICIENT_ROW(bank, b, i)[first], &HISTORY_ROW(bank, u, i)[first], count); }
+    }
+    for (size_t i = 1; i <= bank->order; ++i) {
+        if (bank->shared) { dsp_simd_axpy(new_y, bank->a[i], &HISTORY_ROW(bank, y, i)[first], count); }
+        else { dsp_simd_multiply_add(new_y, &COEFFICIENT_ROW(bank, a, i)[first], &HISTORY_ROW(bank, y, i)[first], count); }
+    }
+
+    memcpy(&y[first], new_y, count * REAL_SIZE);
+    return true;
+}
+
+bool dsp_ztf_bank_update(dsp_ztf_bank_t* const bank, const real_t* const u, real_t* const y) {
+    if (bank == NULL || u == NULL || y == NULL) { return false; }
+    return dsp_ztf_bank_next_sample(bank) && dsp_ztf_bank_update_range(bank, 0, bank->channels, u, y);
+}
+
+bool dsp_ztf_bank_process_block(dsp_ztf_bank_t* const bank, const real_t* const in, real_t* const out, const size_t n) {
+    if (bank == NULL || in == NULL || out == NULL) { return false; }
+
+    for (size_t k = 0; k < n; ++k) {
+        dsp_ztf_bank_update(bank, &in[k * bank->channels], &out[k * bank->channels]);
+    }
+    return true;
+}
@@ -0,0 +1,873 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DSP/Math/Matrix.h"
+#include "DSP/Math/Simd.h"
+#include "DSP/Math/FFT.h"
+#include "DSP/Math/LUDecomposition.h"
+#include "DSP/Math/QRDecomposition.h"
+#include "DSP/Math/CholeskyDecomposition.h"
+#include "DSP/Memory/Workspace.h"
+#include "DSP/Discrete/Signal.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zTransferFunctionBank.h"
+#include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/zStateSpaceBank.h"
+#include "DSP/Discrete/zStateObserver.h"
+#include "DSP/Discrete/Integrator.h"
+#include "DSP/Discrete/Derivative.h"
+#include "DSP/Discrete/pidController.h"
+#include "DSP/Discrete/pidBank.h"
+#include "DSP/Discrete/Discontinuous.h"
+#include "DSP/Discrete/DiscontinuousBank.h"
+#include "DSP/Discrete/SecondOrderSections.h"
+#include "DSP/Diagnostics/LatencyHistogram.h"
+#include "DSP/Diagnostics/TraceRing.h"
+
+// Microbenchmarks of the blocks and math kernels
+//
+//     dsp_bench [--filter <text>] [--repetitions <n>] [--min-time <us>] [--warmup <ms>] [--simd <isa>] [--json <file>]
+//
+// Every benchmark runs once per size (order, states, channels, ...).
+// After the warm-up the number of calls per repetition is doubled until one repetition takes 'min-time',
+// then every repetition is timed on its own. Reported are min, median, p99 and mean nanoseconds per call
+// and the items (samples, channels, elements) per second at the median.
+// The JSON file is compared against a baseline with 'bench_compare.py'.
+
+#define BENCH_SIGNAL 8192 // Samples of the input signal (power of 2)
+#define BENCH_MASK (BENCH_SIGNAL - 1)
+#define BENCH_MAX_SIZES 6
+#define BENCH_MAX_REPETITIONS 10000
+
+
+// State of one benchmark case, filled by 'setup' and released by 'teardown'
+typedef struct BenchState {
+    size_t size;  // Parameter of the case
+    size_t items; // Items per call, 1 unless set by 'setup'
+    const real_t* in; // BENCH_SIGNAL samples of noise in [-1, 1]
+    real_t* out; // BENCH_SIGNAL + 2 elements
+    void* object; // Block under test
+    dsp_matrix_t* A; // Operands of the matrix kernels (released by the driver)
+    dsp_matrix_t* B;
+    dsp_matrix_t* C;
+    dsp_workspace_t* ws;
+    dsp_matrix_lu_t* lu;
+    dsp_matrix_qr_t qr;
+    dsp_matrix_chol_t chol;
+} bench_state_t;
+
+typedef struct Benchmark {
+    const char* name;
+    const char* parameter; // Name of the size or NULL
+    size_t sizes[BENCH_MAX_SIZES]; // Zero terminated (at most BENCH_MAX_SIZES - 1 sizes)
+    bool (*setup)(bench_state_t* const s);
+    void (*run)(bench_state_t* const s, const size_t calls);
+    void (*teardown)(bench_state_t* const s); // NULL: nothing besides the matrices and the workspace
+} bench_t;
+
+typedef struct BenchResult {
+    size_t calls; // Calls per repetition
+    double min;   // Nanoseconds per call
+    double median;
+    double p99;
+    double mean;
+} bench_result_t;
+
+// Keeps the results of the blocks alive
+static volatile real_t sink;
+
+
+static double seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+}
+
+static real_t noise(unsigned int* const seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (real_t) ((*seed >> 8) & 0xFFFF) / 32768 - 1;
+}
+
+// Diagonally dominant and symmetric, so every decomposition succeeds
+static dsp_matrix_t* test_matrix(const size_t n) {
+    dsp_matrix_t* const mat = dsp_matrix_create(n, n);
+    if (mat == NULL) { return NULL; }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            const size_t distance = (i > j ? i - j : j - i);
+            mat->elements[i * n + j] = (i == j ? (real_t) n : 0) + 1 / (real_t) (1 + distance);
+        }
+    }
+    return mat;
+}
+
+
+
+// ----- Blocks -----
+
+// FIR average over (order+1) samples divided by (1 - 0.2 z^-1)^order
+static bool setup_ztf(bench_state_t* const s) {
+    real_t num[17], den[17] = {1};
+    for (size_t i = 0; i <= s->size; ++i) { num[i] = 1 / (real_t) (s->size + 1); }
+    for (size_t k = 0; k < s->size; ++k) {
+        for (size_t i = k + 1; i > 0; --i) { den[i] -= 0.2f * den[i - 1]; }
+    }
+    s->object = dsp_ztf_create_from_arrays(s->size, num, den, NULL, NULL);
+    return s->object != NULL;
+}
+
+static void teardown_ztf(bench_state_t* const s) { dsp_ztf_destroy(s->object); }
+
+static void run_ztf_update(bench_state_t* const s, const size_t calls) {
+    dsp_ztf_t* const ztf = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_ztf_update(ztf, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+// Order 4, 'size' samples per call
+static bool setup_ztf_block(bench_state_t* const s) {
+    const size_t samples = s->size;
+    s->size = 4;
+    const bool created = setup_ztf(s);
+    s->size = samples;
+    s->items = samples;
+    return created;
+}
+
+static void run_ztf_process_block(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_ztf_process_block(s->object, s->in, s->out, s->size); }
+    sink += s->out[0];
+}
+
+static bool setup_sos(bench_state_t* const s) {
+    dsp_sos_t* const sos = dsp_sos_create(s->size);
+    if (sos == NULL) { return false; }
+    const real_t num[3] = {0.2f, 0.4f, 0.2f};
+    for (size_t k = 0; k < s->size; ++k) {
+        const real_t den[3] = {1, -1.2f + 0.05f * (real_t) k, 0.5f};
+        dsp_sos_set_section(sos, k, num, den);
+    }
+    s->object = sos;
+    return true;
+}
+
+static void teardown_sos(bench_state_t* const s) { dsp_sos_destroy(s->object); }
+
+static void run_sos_update(bench_state_t* const s, const size_t calls) {
+    dsp_sos_t* const sos = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_sos_update(sos, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+// 'size' states, 1 input, 1 output, A = 0.5 * I + coupling
+static dsp_zss_t* create_zss(const size_t nx) {
+    real_t a[16 * 16], b[16], c[16];
+    const real_t d[1] = {0};
+    for (size_t i = 0; i < nx; ++i) {
+        for (size_t j = 0; j < nx; ++j) { a[i * nx + j] = (i == j ? 0.5f : 0) + 0.1f / (real_t) nx; }
+        b[i] = 1;
+        c[i] = 1 / (real_t) nx;
+    }
+    return dsp_zss_create_from_arrays(nx, 1, 1, a, b, c, d, NULL);
+}
+
+static bool setup_zss(bench_state_t* const s) {
+    s->object = create_zss(s->size);
+    return s->object != NULL;
+}
+
+static void teardown_zss(bench_state_t* const s) { dsp_zss_destroy(s->object); }
+
+static void run_zss_update(bench_state_t* const s, const size_t calls) {
+    dsp_zss_t* const zss = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) {
+        real_t y;
+        dsp_zss_update(zss, &s->in[k & BENCH_MASK], &y);
+        sum += y;
+    }
+    sink += sum;
+}
+
+static bool setup_zso(bench_state_t* const s) {
+    dsp_zss_t* const zss = create_zss(s->size);
+    if (zss == NULL) { return false; }
+    real_t l[16];
+    for (size_t i = 0; i < s->size; ++i) { l[i] = 0.1f; }
+    s->object = dsp_zso_create_from_zss(zss, l, NULL);
+    dsp_zss_destroy(zss);
+    return s->object != NULL;
+}
+
+static void teardown_zso(bench_state_t* const s) { dsp_zso_destroy(s->object); }
+
+static void run_zso_update(bench_state_t* const s, const size_t calls) {
+    dsp_zso_t* const zso = s->object;
+    real_t xh[16];
+    for (size_t k = 0; k < calls; ++k) { dsp_zso_update(zso, &s->in[k & BENCH_MASK], &s->in[(k + 1) & BENCH_MASK], xh); }
+    sink += xh[0];
+}
+
+static dsp_pid_t* create_pid(const bool limits) {
+    return dsp_pid_create_and_configure(0.001f, 2, 10, 0.01f, 100,
+        limits, 1, -1,
+        limits, 500, -400,
+        limits, 0.5f,
+        false, 0);
+}
+
+// 0: PID only, 1: with output saturation, rate limitation and anti-windup
+static bool setup_pid(bench_state_t* const s) {
+    s->object = create_pid(s->size != 0);
+    return s->object != NULL;
+}
+
+static void teardown_pid(bench_state_t* const s) { dsp_pid_destroy(s->object); }
+
+static void run_pid_update(bench_state_t* const s, const size_t calls) {
+    dsp_pid_t* const pid = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_pid_update(pid, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+// 'size' selects the approximation: 0 ForwardEuler, 1 BackwardEuler, 2 Trapezoidal
+static bool setup_integrator(bench_state_t* const s) {
+    s->object = dsp_integrator_create(10, 0.001f, (s_approximation_t) s->size, true, 1, -1);
+    return s->object != NULL;
+}
+
+static void teardown_integrator(bench_state_t* const s) { dsp_integrator_destroy(s->object); }
+
+static void run_integrator_update(bench_state_t* const s, const size_t calls) {
+    dsp_integrator_t* const integrator = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_integrator_update(integrator, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+static bool setup_derivative(bench_state_t* const s) {
+    s->object = dsp_derivative_create(0.01f, 100, 0.001f, (s_approximation_t) s->size, true, 1, -1);
+    return s->object != NULL;
+}
+
+static void teardown_derivative(bench_state_t* const s) { dsp_derivative_destroy(s->object); }
+
+static void run_derivative_update(bench_state_t* const s, const size_t calls) {
+    dsp_derivative_t* const derivative = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_derivative_update(derivative, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+static bool setup_saturation(bench_state_t* const s) {
+    s->object = dsp_saturation_create(0.5f, -0.5f);
+    return s->object != NULL;
+}
+
+static void teardown_saturation(bench_state_t* const s) { dsp_saturation_destroy(s->object); }
+
+static void run_saturation_update(bench_state_t* const s, const size_t calls) {
+    dsp_saturation_t* const saturation = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_saturation_update(saturation, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+static bool setup_rate_limiter(bench_state_t* const s) {
+    s->object = dsp_rate_limiter_create(500, -400, 0.001f, 0);
+    return s->object != NULL;
+}
+
+static void teardown_rate_limiter(bench_state_t* const s) { dsp_rate_limiter_destroy(s->object); }
+
+static void run_rate_limiter_update(bench_state_t* const s, const size_t calls) {
+    dsp_rate_limiter_t* const rate_limiter = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_rate_limiter_update(rate_limiter, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+// 'size' selects the rounding method: 0 RoundMath, 1 RoundDown, 2 RoundUp
+static bool setup_quantizer(bench_state_t* const s) {
+    s->object = dsp_quantizer_create(0, 0.125f, (rounding_method_t) s->size);
+    return s->object != NULL;
+}
+
+static void teardown_quantizer(bench_state_t* const s) { dsp_quantizer_destroy(s->object); }
+
+static void run_quantizer_update(bench_state_t* const s, const size_t calls) {
+    dsp_quantization_t* const quantizer = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_quantizer_update(quantizer, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+static bool setup_dead_zone(bench_state_t* const s) {
+    s->object = dsp_dead_zone_create(0.1f, -0.1f);
+    return s->object != NULL;
+}
+
+static void teardown_dead_zone(bench_state_t* const s) { dsp_dead_zone_destroy(s->object); }
+
+static void run_dead_zone_update(bench_state_t* const s, const size_t calls) {
+    dsp_dead_zone_t* const dead_zone = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_dead_zone_update(dead_zone, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+// Switches on about every tenth sample of the noise
+static dsp_schmitt_trigger_t* create_schmitt_trigger(void) {
+    return dsp_schmitt_trigger_create(-0.8f, 0.8f, 0, 1, false, false);
+}
+
+static bool setup_schmitt_trigger(bench_state_t* const s) {
+    s->object = create_schmitt_trigger();
+    return s->object != NULL;
+}
+
+static void teardown_schmitt_trigger(bench_state_t* const s) { dsp_schmitt_trigger_destroy(s->object); }
+
+static void run_schmitt_trigger_update(bench_state_t* const s, const size_t calls) {
+    dsp_schmitt_trigger_t* const trigger = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_schmitt_trigger_update(trigger, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+static dsp_schmitt_quantization_t* create_schmitt_quantizer(void) {
+    return dsp_schmitt_quantizer_create_relative(0, 0.125f, 0.5f, 0.1f, 0);
+}
+
+static bool setup_schmitt_quantizer(bench_state_t* const s) {
+    s->object = create_schmitt_quantizer();
+    return s->object != NULL;
+}
+
+static void teardown_schmitt_quantizer(bench_state_t* const s) { dsp_schmitt_quantizer_destroy(s->object); }
+
+static void run_schmitt_quantizer_update(bench_state_t* const s, const size_t calls) {
+    dsp_schmitt_quantization_t* const quantizer = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_schmitt_quantizer_update(quantizer, s->in[k & BENCH_MASK]); }
+    sink += sum;
+}
+
+
+
+// ----- Banks ('size' channels, one sample of every channel per call) -----
+
+// Consecutive calls read consecutive windows of the input signal
+#define BANK_INPUT(s, k) (&(s)->in[((k) * (s)->size) & (BENCH_MASK & ~(size_t) 511)])
+
+static bool setup_ztf_bank(bench_state_t* const s) {
+    const real_t num[3] = {0.2f, 0.4f, 0.2f}, den[3] = {1, -1.2f, 0.5f};
+    dsp_ztf_bank_t* const bank = dsp_ztf_bank_create(2, s->size, false);
+    if (bank == NULL) { return false; }
+    dsp_ztf_bank_set_coefficients(bank, num, den);
+    s->object = bank;
+    s->items = s->size;
+    return true;
+}
+
+static void teardown_ztf_bank(bench_state_t* const s) { dsp_ztf_bank_destroy(s->object); }
+
+static void run_ztf_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_ztf_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+// 4 states per lane
+static bool setup_zss_bank(bench_state_t* const s) {
+    dsp_zss_t* const zss = create_zss(4);
+    dsp_zss_bank_t* const bank = dsp_zss_bank_create(4, 1, 1, s->size);
+    bool created = (zss != NULL && bank != NULL);
+    for (size_t lane = 0; lane < s->size && created; ++lane) { created = dsp_zss_bank_set_lane(bank, lane, zss); }
+    dsp_zss_destroy(zss);
+    if (!created) {
+        dsp_zss_bank_destroy(bank);
+        return false;
+    }
+    s->object = bank;
+    s->items = s->size;
+    return true;
+}
+
+static void teardown_zss_bank(bench_state_t* const s) { dsp_zss_bank_destroy(s->object); }
+
+static void run_zss_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_zss_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+// Every second channel with limits
+static bool setup_pid_bank(bench_state_t* const s) {
+    dsp_pid_bank_t* const bank = dsp_pid_bank_create(s->size);
+    dsp_pid_t* const plain = create_pid(false);
+    dsp_pid_t* const limited = create_pid(true);
+    bool created = (bank != NULL && plain != NULL && limited != NULL);
+    for (size_t k = 0; k < s->size && created; ++k) { created = dsp_pid_bank_set_controller(bank, k, (k & 1) ? limited : plain); }
+    dsp_pid_destroy(plain);
+    dsp_pid_destroy(limited);
+    if (!created) {
+        dsp_pid_bank_destroy(bank);
+        return false;
+    }
+    s->object = bank;
+    s->items = s->size;
+    return true;
+}
+
+static void teardown_pid_bank(bench_state_t* const s) { dsp_pid_bank_destroy(s->object); }
+
+static void run_pid_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_pid_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_saturation_bank(bench_state_t* const s) {
+    s->object = dsp_saturation_bank_create(s->size, 0.5f, -0.5f);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_saturation_bank(bench_state_t* const s) { dsp_saturation_bank_destroy(s->object); }
+
+static void run_saturation_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_saturation_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_rate_limiter_bank(bench_state_t* const s) {
+    s->object = dsp_rate_limiter_bank_create(s->size, 500, -400, 0.001f, 0);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_rate_limiter_bank(bench_state_t* const s) { dsp_rate_limiter_bank_destroy(s->object); }
+
+static void run_rate_limiter_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_rate_limiter_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_quantizer_bank(bench_state_t* const s) {
+    s->object = dsp_quantizer_bank_create(s->size, 0, 0.125f, RoundMath);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_quantizer_bank(bench_state_t* const s) { dsp_quantizer_bank_destroy(s->object); }
+
+static void run_quantizer_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_quantizer_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_dead_zone_bank(bench_state_t* const s) {
+    s->object = dsp_dead_zone_bank_create(s->size, 0.1f, -0.1f);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_dead_zone_bank(bench_state_t* const s) { dsp_dead_zone_bank_destroy(s->object); }
+
+static void run_dead_zone_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_dead_zone_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_schmitt_trigger_bank(bench_state_t* const s) {
+    dsp_schmitt_trigger_t* const trigger = create_schmitt_trigger();
+    s->object = (trigger == NULL ? NULL : dsp_schmitt_trigger_bank_create(s->size, trigger));
+    dsp_schmitt_trigger_destroy(trigger);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_schmitt_trigger_bank(bench_state_t* const s) { dsp_schmitt_trigger_bank_destroy(s->object); }
+
+static void run_schmitt_trigger_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_schmitt_trigger_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_schmitt_quantizer_bank(bench_state_t* const s) {
+    dsp_schmitt_quantization_t* const quantizer = create_schmitt_quantizer();
+    s->object = (quantizer == NULL ? NULL : dsp_schmitt_quantizer_bank_create(s->size, quantizer));
+    dsp_schmitt_quantizer_destroy(quantizer);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_schmitt_quantizer_bank(bench_state_t* const s) { dsp_schmitt_quantizer_bank_destroy(s->object); }
+
+static void run_schmitt_quantizer_bank_update(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_schmitt_quantizer_bank_update(s->object, BANK_INPUT(s, k), s->out); }
+    sink += s->out[0];
+}
+
+
+
+// ----- Math kernels -----
+
+static bool setup_elements(bench_state_t* const s) {
+    s->items = s->size;
+    return true;
+}
+
+static void run_dot_product(bench_state_t* const s, const size_t calls) {
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) { sum += dsp_simd_dot_product(s->in, s->in + BENCH_SIGNAL / 2, s->size); }
+    sink += sum;
+}
+
+// Both operands of 'size' elements
+static void run_conv(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_conv(s->in, s->size, s->in + BENCH_SIGNAL / 2, s->size, s->out, 2 * s->size - 1); }
+    sink += s->out[0];
+}
+
+static bool setup_fft(bench_state_t* const s) {
+    s->object = dsp_fft_plan_create(s->size);
+    s->items = s->size;
+    return s->object != NULL;
+}
+
+static void teardown_fft(bench_state_t* const s) { dsp_fft_plan_destroy(s->object); }
+
+static void run_fft_real_forward(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_fft_real_forward(s->object, s->in, s->out); }
+    sink += s->out[0];
+}
+
+static bool setup_matrices(bench_state_t* const s) {
+    s->A = test_matrix(s->size);
+    s->B = test_matrix(s->size);
+    s->C = dsp_matrix_create(s->size, s->size);
+    return s->A != NULL && s->B != NULL && s->C != NULL;
+}
+
+static void run_matrix_multiply(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_multiply(s->C, s->A, s->B); }
+    sink += s->C->elements[0];
+}
+
+static void run_matrix_inv(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_inv(s->C, s->A); }
+    sink += s->C->elements[0];
+}
+
+static bool setup_lu(bench_state_t* const s) {
+    s->A = test_matrix(s->size);
+    s->lu = dsp_matrix_lu_create(s->size);
+    return s->A != NULL && s->lu != NULL && dsp_matrix_lu_factor(s->lu, s->A);
+}
+
+static void teardown_lu(bench_state_t* const s) { dsp_matrix_lu_destroy(s->lu); }
+
+static void run_lu_factor(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_lu_factor(s->lu, s->A); }
+    sink += s->lu->elements[0];
+}
+
+static void run_lu_solve(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_lu_solve(s->lu, s->out, s->in); }
+    sink += s->out[0];
+}
+
+static bool setup_qr(bench_state_t* const s) {
+    s->A = test_matrix(s->size);
+    s->ws = dsp_workspace_create(dsp_matrix_qr_workspace_size(s->size, s->size));
+    return s->A != NULL && s->ws != NULL && dsp_matrix_qr_init(&s->qr, s->size, s->size, s->ws);
+}
+
+static void run_qr_factor(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_qr_factor(&s->qr, s->A); }
+    sink += s->qr.elements[0];
+}
+
+static bool setup_chol(bench_state_t* const s) {
+    s->A = test_matrix(s->size);
+    s->ws = dsp_workspace_create(dsp_matrix_chol_workspace_size(s->size));
+    return s->A != NULL && s->ws != NULL && dsp_matrix_chol_init(&s->chol, s->size, s->ws);
+}
+
+static void run_chol_factor(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_matrix_chol_factor(&s->chol, s->A); }
+    sink += s->chol.elements[0];
+}
+
+
+
+// ----- Instrumentation -----
+
+// Cost of 'DSP_LATENCY_MEASURE()' around an empty statement
+static bool setup_latency(bench_state_t* const s) {
+    s->object = dsp_latency_create(NULL, "empty");
+    return s->object != NULL;
+}
+
+static void teardown_latency(bench_state_t* const s) { dsp_latency_destroy(s->object); }
+
+static void run_latency_measure(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { DSP_LATENCY_MEASURE(s->object, sink += 1); }
+}
+
+// Tracing of a pid controller into the selected ring, compare trace_pid with pid_update/0
+// The pid comes first: once it exists, the driver calls 'teardown' even if the ring can't be created
+static bool setup_trace(bench_state_t* const s) {
+    s->object = create_pid(false);
+    return s->object != NULL && dsp_trace_select(dsp_trace_create(4096)) && dsp_trace_selected() != NULL;
+}
+
+static void teardown_trace(bench_state_t* const s) {
+    dsp_trace_t* const trace = dsp_trace_selected();
+    dsp_trace_select(NULL);
+    dsp_trace_destroy(trace);
+    dsp_pid_destroy(s->object);
+}
+
+// Updates per 'dsp_trace_stamp()' in trace_pid (one tick of a loop running a batch of blocks)
+#define BENCH_TRACE_TICK 64
+
+// 'pid_update' plus a record per call and a timestamp per tick
+static void run_trace_pid(bench_state_t* const s, const size_t calls) {
+    dsp_pid_t* const pid = s->object;
+    real_t sum = 0;
+    for (size_t k = 0; k < calls; ++k) {
+        if ((k % BENCH_TRACE_TICK) == 0) { dsp_trace_stamp(NULL); }
+        sum += dsp_pid_update(pid, s->in[k & BENCH_MASK]);
+        dsp_trace_pid(NULL, 1, pid);
+    }
+    sink += sum;
+}
+
+// The record alone
+static void run_trace_record(bench_state_t* const s, const size_t calls) {
+    for (size_t k = 0; k < calls; ++k) { dsp_trace_pid(NULL, 1, s->object); }
+}
+
+// The timestamp alone
+static void run_trace_stamp(bench_state_t* const s, const size_t calls) {
+    (void) s;
+    for (size_t k = 0; k < calls; ++k) { dsp_trace_stamp(NULL); }
+}
+
+
+
+static const bench_t benchmarks[] = {
+    {"ztf_update", "order", {1, 2, 4, 8, 16}, setup_ztf, run_ztf_update, teardown_ztf},
+    {"ztf_process_block", "samples", {64, 256, 1024, 4096}, setup_ztf_block, run_ztf_process_block, teardown_ztf},
+    {"sos_update", "sections", {1, 2, 4, 8}, setup_sos, run_sos_update, teardown_sos},
+    {"zss_update", "states", {1, 2, 4, 8, 16}, setup_zss, run_zss_update, teardown_zss},
+    {"zso_update", "states", {1, 2, 4, 8, 16}, setup_zso, run_zso_update, teardown_zso},
+    {"pid_update", "limits", {0, 1}, setup_pid, run_pid_update, teardown_pid},
+    {"integrator_update", "approximation", {0, 1, 2}, setup_integrator, run_integrator_update, teardown_integrator},
+    {"derivative_update", "approximation", {0, 1, 2}, setup_derivative, run_derivative_update, teardown_derivative},
+    {"saturation_update", NULL, {1}, setup_saturation, run_saturation_update, teardown_saturation},
+    {"rate_limiter_update", NULL, {1}, setup_rate_limiter, run_rate_limiter_update, teardown_rate_limiter},
+    {"quantizer_update", "rounding", {0, 1, 2}, setup_quantizer, run_quantizer_update, teardown_quantizer},
+    {"dead_zone_update", NULL, {1}, setup_dead_zone, run_dead_zone_update, teardown_dead_zone},
+    {"schmitt_trigger_update", NULL, {1}, setup_schmitt_trigger, run_schmitt_trigger_update, teardown_schmitt_trigger},
+    {"schmitt_quantizer_update", NULL, {1}, setup_schmitt_quantizer, run_schmitt_quantizer_update, teardown_schmitt_quantizer},
+    {"ztf_bank_update", "channels", {8, 64, 512}, setup_ztf_bank, run_ztf_bank_update, teardown_ztf_bank},
+    {"zss_bank_update", "lanes", {8, 64, 512}, setup_zss_bank, run_zss_bank_update, teardown_zss_bank},
+    {"pid_bank_update", "channels", {8, 64, 512}, setup_pid_bank, run_pid_bank_update, teardown_pid_bank},
+    {"saturation_bank_update", "channels", {8, 64, 512}, setup_saturation_bank, run_saturation_bank_update, teardown_saturation_bank},
+    {"rate_limiter_bank_update", "channels", {8, 64, 512}, setup_rate_limiter_bank, run_rate_limiter_bank_update, teardown_rate_limiter_bank},
+    {"quantizer_bank_update", "channels", {8, 64, 512}, setup_quantizer_bank, run_quantizer_bank_update, teardown_quantizer_bank},
+    {"dead_zone_bank_update", "channels", {8, 64, 512}, setup_dead_zone_bank, run_dead_zone_bank_update, teardown_dead_zone_bank},
+    {"schmitt_trigger_bank_update", "channels", {8, 64, 512}, setup_schmitt_trigger_bank, run_schmitt_trigger_bank_update, teardown_schmitt_trigger_bank},
+    {"schmitt_quantizer_bank_update", "channels", {8, 64, 512}, setup_schmitt_quantizer_bank, run_schmitt_quantizer_bank_update, teardown_schmitt_quantizer_bank},
+    {"dot_product", "size", {16, 64, 256, 1024, 4096}, setup_elements, run_dot_product, NULL},
+    {"conv", "size", {16, 64, 256, 1024, 4096}, setup_elements, run_conv, NULL},
+    {"fft_real_forward", "size", {64, 256, 1024, 4096}, setup_fft, run_fft_real_forward, teardown_fft},
+    {"matrix_multiply", "size", {4, 8, 16, 32, 64}, setup_matrices, run_matrix_multiply, NULL},
+    {"matrix_inv", "size", {4, 8, 16, 32, 64}, setup_matrices, run_matrix_inv, NULL},
+    {"lu_factor", "size", {4, 8, 16, 32, 64}, setup_lu, run_lu_factor, teardown_lu},
+    {"lu_solve", "size", {4, 8, 16, 32, 64}, setup_lu, run_lu_solve, teardown_lu},
+    {"qr_factor", "size", {4, 8, 16, 32, 64}, setup_qr, run_qr_factor, NULL},
+    {"chol_factor", "size", {4, 8, 16, 32, 64}, setup_chol, run_chol_factor, NULL},
+    {"latency_measure", NULL, {1}, setup_latency, run_latency_measure, teardown_latency},
+    {"trace_pid", NULL, {1}, setup_trace, run_trace_pid, teardown_trace},
+    {"trace_record", NULL, {1}, setup_trace, run_trace_record, teardown_trace},
+    {"trace_stamp", NULL, {1}, setup_trace, run_trace_stamp, teardown_trace},
+};
+
+#define BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+
+typedef struct BenchOptions {
+    const char* filter; // Substring of the benchmark names or NULL
+    const char* json;   // Output file or NULL
+    size_t repetitions;
+    double min_time;    // Seconds per repetition
+    double warmup;      // Seconds per case
+} bench_options_t;
+
+static int compare_doubles(const void* const a, const void* const b) {
+    const double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of sorted values
+static double percentile(const double* const sorted, const size_t n, const double p) {
+    size_t rank = (size_t) (p * (double) n + 0.999999);
+    if (rank < 1) { rank = 1; }
+    if (rank > n) { rank = n; }
+    return sorted[rank - 1];
+}
+
+static bench_result_t measure(const bench_t* const bench, bench_state_t* const s, const bench_options_t* const options, double* const times) {
+    bench_result_t result = {1, 0, 0, 0, 0};
+
+    // Warm-up: caches, branch predictors and the clock of the core
+    const double warmup_end = seconds() + options->warmup;
+    do { bench->run(s, 1); } while (seconds() < warmup_end);
+
+    // Calibrate the calls per repetition
+    for (;;) {
+        const double start = seconds();
+        bench->run(s, result.calls);
+        if (seconds() - start >= options->min_time || result.calls >= ((size_t) 1 << 40)) { break; }
+        result.calls *= 2;
+    }
+
+    double sum = 0;
+    for (size_t r = 0; r < options->repetitions; ++r) {
+        const double start = seconds();
+        bench->run(s, result.calls);
+        times[r] = (seconds() - start) * 1e9 / (double) result.calls;
+        sum += times[r];
+    }
+    qsort(times, options->repetitions, sizeof(double), compare_doubles);
+    result.min = times[0];
+    result.median = percentile(times, options->repetitions, 0.5);
+    result.p99 = percentile(times, options->repetitions, 0.99);
+    result.mean = sum / (double) options->repetitions;
+    return result;
+}
+
+static const char* precision_name(void) {
+#if defined(DSP_PRECISION_DOUBLE)
+    return "double";
+#elif defined(DSP_PRECISION_MIXED)
+    return "mixed";
+#else
+    return "float";
+#endif
+}
+
+static bool select_simd(const char* const name) {
+    const dsp_simd_isa_t isas[] = {SimdScalar, SimdSSE, SimdAVX2, SimdAVX512, SimdNEON};
+    for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+        const char* a = dsp_simd_isa_name(isas[i]);
+        const char* b = name;
+        while (*a != '\0' && *b != '\0' && (*a | 0x20) == (*b | 0x20)) { ++a; ++b; }
+        if (*a == '\0' && *b == '\0') { return dsp_simd_select(isas[i]); }
+    }
+    return false;
+}
+
+static bool parse_arguments(const int argc, char** const argv, bench_options_t* const options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* const value = (i + 1 < argc ? argv[i + 1] : NULL);
+        if (strcmp(argv[i], "--help") == 0 || value == NULL) { return false; }
+        else if (strcmp(argv[i], "--filter") == 0) { options->filter = value; }
+        else if (strcmp(argv[i], "--json") == 0) { options->json = value; }
+        else if (strcmp(argv[i], "--repetitions") == 0) { options->repetitions = strtoul(value, NULL, 10); }
+        else if (strcmp(argv[i], "--min-time") == 0) { options->min_time = 1e-6 * strtod(value, NULL); }
+        else if (strcmp(argv[i], "--warmup") == 0) { options->warmup = 1e-3 * strtod(value, NULL); }
+        else if (strcmp(argv[i], "--simd") == 0) {
+            if (!select_simd(value)) {
+                fprintf(stderr, "dsp_bench: instruction set '%s' is not supported\n", value);
+                return false;
+            }
+        }
+        else { return false; }
+        ++i;
+    }
+    return options->repetitions >= 1 && options->repetitions <= BENCH_MAX_REPETITIONS && options->min_time > 0;
+}
+
+int main(int argc, char** argv) {
+    bench_options_t options = {NULL, NULL, 101, 200e-6, 20e-3};
+    if (!parse_arguments(argc, argv, &options)) {
+        fprintf(stderr, "usage: dsp_bench [--filter <text>] [--repetitions <n>] [--min-time <us>] [--warmup <ms>] [--simd <isa>] [--json <file>]\n");
+        return 2;
+    }
+
+    FILE* json = NULL;
+    if (options.json != NULL) {
+        json = fopen(options.json, "w");
+        if (json == NULL) {
+            fprintf(stderr, "dsp_bench: cannot write '%s'\n", options.json);
+            return 1;
+        }
+        fprintf(json, "{\n  \"context\": {\"precision\": \"%s\", \"simd\": \"%s\", \"repetitions\": %zu, \"min_time_us\": %.1f, \"warmup_ms\": %.1f},\n",
+            precision_name(), dsp_simd_isa_name(dsp_simd_selected()), options.repetitions, 1e6 * options.min_time, 1e3 * options.warmup);
+        fprintf(json, "  \"benchmarks\": [");
+    }
+
+    static real_t in[BENCH_SIGNAL], out[BENCH_SIGNAL + 2];
+    unsigned int seed = 1;
+    for (size_t k = 0; k < BENCH_SIGNAL; ++k) { in[k] = noise(&seed); }
+    static double times[BENCH_MAX_REPETITIONS];
+
+    printf("%s precision, %s kernels, %zu repetitions\n", precision_name(), dsp_simd_isa_name(dsp_simd_selected()), options.repetitions);
+    printf("%-30s %-14s %12s %12s %12s %12s %14s\n", "benchmark", "size", "min [ns]", "median [ns]", "p99 [ns]", "mean [ns]", "items/s");
+
+    int status = 0;
+    size_t cases = 0;
+    for (size_t b = 0; b < BENCHMARKS; ++b) {
+        const bench_t* const bench = &benchmarks[b];
+        if (options.filter != NULL && strstr(bench->name, options.filter) == NULL) { continue; }
+
+        for (size_t i = 0; i < BENCH_MAX_SIZES && (i == 0 || bench->sizes[i] != 0); ++i) {
+            bench_state_t s;
+            memset(&s, 0, sizeof(s));
+            s.size = bench->sizes[i];
+            s.items = 1;
+            s.in = in;
+            s.out = out;
+
+            char size[32] = "-";
+            if (bench->parameter != NULL) { snprintf(size, sizeof(size), "%s=%zu", bench->parameter, s.size); }
+
+            if (!bench->setup(&s)) {
+                fprintf(stderr, "dsp_bench: setup of %s %s failed\n", bench->name, size);
+                status = 1;
+            }
+            else {
+                const bench_result_t r = measure(bench, &s, &options, times);
+                const double rate = 1e9 * (double) s.items / r.median;
+                printf("%-30s %-14s %12.1f %12.1f %12.1f %12.1f %14.4g\n", bench->name, size, r.min, r.median, r.p99, r.mean, rate);
+                fflush(stdout);
+
+                if (json != NULL) {
+                    fprintf(json, "%s\n    {\"name\": \"%s\", \"parameter\": ", (cases == 0 ? "" : ","), bench->name);
+                    if (bench->parameter != NULL) { fprintf(json, "\"%s\"", bench->parameter); } else { fprintf(json, "null"); }
+                    fprintf(json, ", \"size\": %zu, \"items\": %zu, \"calls\": %zu, \"min_ns\": %.3f, \"median_ns\": %.3f, \"p99_ns\": %.3f, \"mean_ns\": %.3f, \"items_per_second\": %.6g}",
+                        s.size, s.items, r.calls, r.min, r.median, r.p99, r.mean, rate);
+                }
+                ++cases;
+            }
+            if (bench->teardown != NULL && (s.object != NULL || s.lu != NULL)) { bench->teardown(&s); }
+            dsp_matrix_destroy(s.A);
+            dsp_matrix_destroy(s.B);
+            dsp_matrix_destroy(s.C);
+            dsp_workspace_destroy(s.ws);
+        }
+    }
+
+    if (json != NULL) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+    return status;
+}
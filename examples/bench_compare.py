@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Compare two JSON results of dsp_bench.
+
+    bench_compare.py <baseline.json> <current.json> [--metric median_ns] [--threshold 0.10]
+
+Prints the change of every case found in both files and exits with 1 if any
+case got slower than the baseline by more than the threshold (relative).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        results = json.load(f)
+    cases = {}
+    for case in results["benchmarks"]:
+        cases[(case["name"], case["size"])] = case
+    return results.get("context", {}), cases
+
+
+def label(key, case):
+    name, size = key
+    return name if case.get("parameter") is None else "%s %s=%d" % (name, case["parameter"], size)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two JSON results of dsp_bench")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--metric", default="median_ns", choices=["min_ns", "median_ns", "p99_ns", "mean_ns"])
+    parser.add_argument("--threshold", type=float, default=0.10, help="allowed relative slowdown (default 0.10)")
+    args = parser.parse_args()
+
+    baseline_context, baseline = load(args.baseline)
+    current_context, current = load(args.current)
+    for key in ("precision", "simd"):
+        if baseline_context.get(key) != current_context.get(key):
+            print("warning: %s differs (baseline %s, current %s)" % (key, baseline_context.get(key), current_context.get(key)))
+
+    regressions = 0
+    print("%-44s %14s %14s %9s" % ("benchmark", "baseline", "current", "change"))
+    for key, case in current.items():
+        if key not in baseline:
+            print("%-44s %14s %14.1f %9s" % (label(key, case), "-", case[args.metric], "new"))
+            continue
+        before = baseline[key][args.metric]
+        after = case[args.metric]
+        change = (after - before) / before if before > 0 else 0.0
+        slower = change > args.threshold
+        regressions += slower
+        print("%-44s %14.1f %14.1f %+8.1f%%%s" % (label(key, case), before, after, 100 * change, "  SLOWER" if slower else ""))
+    for key, case in baseline.items():
+        if key not in current:
+            print("%-44s %14.1f %14s %9s" % (label(key, case), case[args.metric], "-", "missing"))
+
+    print("%d of %d cases slower than %+.0f%% (%s)" % (regressions, len(current), 100 * args.threshold, args.metric))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,14 @@
+#include <stdio.h>
+
+// One entry per precision build (see 'bench_precision_kernels.c')
+void bench_precision_float(void);
+void bench_precision_mixed(void);
+void bench_precision_double(void);
+
+int main() {
+    printf("%-8s %12s %12s %12s %12s %14s %14s\n", "build", "ztf4 [MS/s]", "sos12 [MS/s]", "zss4 [MS/s]", "inv32 [1/s]", "inv residual", "pt1 error");
+    bench_precision_float();
+    bench_precision_mixed();
+    bench_precision_double();
+    return 0;
+}
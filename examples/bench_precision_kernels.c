@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include "DSP/Math/Matrix.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/SecondOrderSections.h"
+
+// Compiled once per precision build (DSPc, DSPd, DSPm), all linked into 'bench_precision'
+#if defined(DSP_PRECISION_DOUBLE)
+#define BENCH_ENTRY bench_precision_double
+#define BENCH_NAME "double"
+#elif defined(DSP_PRECISION_MIXED)
+#define BENCH_ENTRY bench_precision_mixed
+#define BENCH_NAME "mixed"
+#else
+#define BENCH_ENTRY bench_precision_float
+#define BENCH_NAME "float"
+#endif
+
+#define BLOCK 4096
+#define BLOCKS 256
+
+void BENCH_ENTRY(void);
+
+
+static double seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+}
+
+// Million samples per second of 'BLOCKS' blocks
+#define MEGA_SAMPLES(start) ((double) BLOCK * BLOCKS / (seconds() - (start)) / 1e6)
+
+void BENCH_ENTRY(void) {
+    static real_t in[BLOCK], out[BLOCK];
+    for (size_t k = 0; k < BLOCK; ++k) { in[k] = (real_t) ((k * 7919) % 101) / 50 - 1; }
+
+    // Order 4 transfer function
+    const real_t num[5] = {0.0048f, 0.0193f, 0.0289f, 0.0193f, 0.0048f};
+    const real_t den[5] = {1, -2.3695f, 2.3140f, -1.0547f, 0.1874f};
+    dsp_ztf_t* const ztf = dsp_ztf_create_from_arrays(4, num, den, NULL, NULL);
+    dsp_ztf_process_block(ztf, in, out, BLOCK); // warm-up
+    double start = seconds();
+    for (size_t b = 0; b < BLOCKS; ++b) { dsp_ztf_process_block(ztf, in, out, BLOCK); }
+    const double ztf_rate = MEGA_SAMPLES(start);
+
+    // Order 12 as second order sections
+    dsp_sos_t* const sos = dsp_sos_create(6);
+    const real_t section_num[3] = {0.2f, 0.4f, 0.2f};
+    for (size_t k = 0; k < 6; ++k) {
+        const real_t section_den[3] = {1, -1.2f + 0.05f * (real_t) k, 0.5f};
+        dsp_sos_set_section(sos, k, section_num, section_den);
+    }
+    dsp_sos_process_block(sos, in, out, BLOCK); // warm-up
+    start = seconds();
+    for (size_t b = 0; b < BLOCKS; ++b) { dsp_sos_process_block(sos, in, out, BLOCK); }
+    const double sos_rate = MEGA_SAMPLES(start);
+
+    // 4 states, 1 input, 1 output
+    const real_t a[16] = {0.9f, 0.1f, 0, 0, -0.1f, 0.9f, 0, 0, 0, 0, 0.8f, 0.2f, 0, 0, -0.2f, 0.8f};
+    const real_t bu[4] = {1, 0, 1, 0}, c[4] = {0, 1, 0, 1}, d[1] = {0};
+    dsp_zss_t* const zss = dsp_zss_create_from_arrays(4, 1, 1, a, bu, c, d, NULL);
+    start = seconds();
+    for (size_t b = 0; b < BLOCKS / 4; ++b) {
+        for (size_t k = 0; k < BLOCK; ++k) { dsp_zss_update(zss, &in[k], &out[k]); }
+    }
+    const double zss_rate = MEGA_SAMPLES(start) / 4;
+
+    // Inverse of a diagonally dominant 32 x 32 matrix, residual max |A * inv(A) - I|
+    enum { n = 32, inversions = 200 };
+    dsp_matrix_t* const mat = dsp_matrix_create(n, n);
+    dsp_matrix_t* const inv = dsp_matrix_create(n, n);
+    dsp_matrix_t* const product = dsp_matrix_create(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) { mat->elements[i * n + j] = (i == j ? 4 : 0) + (real_t) ((i * 31 + j * 17) % 13) / 13; }
+    }
+    start = seconds();
+    for (size_t k = 0; k < inversions; ++k) { dsp_matrix_inv(inv, mat); }
+    const double inv_rate = inversions / (seconds() - start);
+    dsp_matrix_multiply(product, mat, inv);
+    double residual = 0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) { residual = fmax(residual, fabs(product->elements[i * n + j] - (i == j ? 1 : 0))); }
+    }
+
+    // Step response of a PT1 with its pole at 1 - 2^-20 after 2^20 samples (exact: 1 - pole^(2^20 - 1)).
+    // The pole is exact in float, so the error is that of the state and not of the coefficients.
+    enum { pt1_samples = 1 << 20 };
+    const real_t pt1_b = 1.0f / pt1_samples, pt1_a = 1 - pt1_b, one = 1, zero = 0;
+    dsp_zss_t* const pt1 = dsp_zss_create_from_arrays(1, 1, 1, &pt1_a, &pt1_b, &one, &zero, NULL);
+    real_t y = 0;
+    for (size_t k = 0; k < pt1_samples; ++k) { dsp_zss_update(pt1, &one, &y); }
+    const double pt1_error = fabs(y - (1 - pow((double) pt1_a, pt1_samples - 1)));
+
+    printf("%-8s %12.1f %12.1f %12.1f %12.1f %14.2e %14.2e\n", BENCH_NAME, ztf_rate, sos_rate, zss_rate, inv_rate, residual, pt1_error);
+
+    dsp_ztf_destroy(ztf);
+    dsp_sos_destroy(sos);
+    dsp_zss_destroy(zss);
+    dsp_zss_destroy(pt1);
+    dsp_matrix_destroy(mat);
+    dsp_matrix_destroy(inv);
+    dsp_matrix_destroy(product);
+}
@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DSP/Discrete/BlockDiagram.h"
+#include "DSP/Discrete/pidController.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/zStateObserver.h"
+#include "DSP/Discrete/Discontinuous.h"
+#include "DSP/Diagnostics/Replay.h"
+
+// Replay recorded signals through a block chain faster than real time
+//
+//     dsp_replay run <recording> [<outputs>] [--chain <chain>] [--batch <samples>]
+//     dsp_replay generate <recording> <samples> [--chain <chain>] [--double]
+//     dsp_replay compare <outputs> <outputs> [--tolerance <t>]
+//
+// Chains (width of the recording -> width of the outputs):
+//     loop      setpoint, measurement -> pid(setpoint - measurement) with limits (2 -> 1)
+//     filter    sensor -> lowpass -> lowpass -> saturation (1 -> 1)
+//     observer  u, y -> estimated states of a second order plant (2 -> 2)
+//
+// 'run' prints the throughput in samples per second and as a multiple of real time,
+// 'compare' exits with 1 if two output files differ by more than the tolerance.
+
+#define REPLAY_MAX_SAMPLES 4096
+#define REPLAY_SAMPLE_TIME 0.001
+
+
+// Blocks of a chain, destroyed with the chain
+typedef struct ReplayChain {
+    dsp_diagram_t* diagram;
+    size_t input;
+    size_t output;
+    size_t width;
+    dsp_pid_t* pid;
+    dsp_ztf_t* filters[2];
+    dsp_saturation_t* saturation;
+    dsp_zso_t* zso;
+} replay_chain_t;
+
+
+static void destroy_chain(replay_chain_t* const chain) {
+    dsp_diagram_destroy(chain->diagram);
+    if (chain->pid != NULL) { dsp_pid_destroy(chain->pid); }
+    if (chain->filters[0] != NULL) { dsp_ztf_destroy(chain->filters[0]); }
+    if (chain->filters[1] != NULL) { dsp_ztf_destroy(chain->filters[1]); }
+    if (chain->saturation != NULL) { dsp_saturation_destroy(chain->saturation); }
+    if (chain->zso != NULL) { dsp_zso_destroy(chain->zso); }
+}
+
+// Observer: input port u, y (width 2), output port xh (width 2)
+static void observer_update(void* const context, const real_t* const in, real_t* const out) {
+    dsp_zso_update((dsp_zso_t*) context, &in[0], &in[1], out);
+}
+
+// Second order plant of the observer chain (x1' = x2, damped) sampled with REPLAY_SAMPLE_TIME
+static dsp_zss_t* create_plant(void) {
+    const real_t a[4] = {1, 0.001f, -0.01f, 0.995f};
+    const real_t b[2] = {0, 0.001f};
+    const real_t c[2] = {1, 0};
+    const real_t d[1] = {0};
+    return dsp_zss_create_from_arrays(2, 1, 1, a, b, c, d, NULL);
+}
+
+static bool build_chain(const char* const name, replay_chain_t* const chain) {
+    memset(chain, 0, sizeof(replay_chain_t));
+    dsp_diagram_t* const diagram = dsp_diagram_create(8, REPLAY_MAX_SAMPLES);
+    chain->diagram = diagram;
+    if (diagram == NULL) { return false; }
+
+    if (strcmp(name, "loop") == 0) {
+        const real_t gains[2] = {1, -1};
+        size_t demux, error, controller;
+        chain->width = 2;
+        chain->pid = dsp_pid_create_and_configure((real_t) REPLAY_SAMPLE_TIME, 2, 10, 0.01f, 100,
+            true, 1, -1,
+            true, 500, -400,
+            true, 0.5f,
+            false, 0);
+        return chain->pid != NULL && dsp_diagram_add_input(diagram, 2, &chain->input) && dsp_diagram_add_demux(diagram, 2, &demux) &&
+            dsp_diagram_add_sum(diagram, 2, gains, &error) && dsp_diagram_add_pid(diagram, chain->pid, &controller) &&
+            dsp_diagram_add_output(diagram, 1, &chain->output) &&
+            dsp_diagram_connect(diagram, chain->input, 0, demux, 0) && dsp_diagram_connect(diagram, demux, 0, error, 0) &&
+            dsp_diagram_connect(diagram, demux, 1, error, 1) && dsp_diagram_connect(diagram, error, 0, controller, 0) &&
+            dsp_diagram_connect(diagram, controller, 0, chain->output, 0) && dsp_diagram_compile(diagram);
+    }
+    if (strcmp(name, "filter") == 0) {
+        size_t first, second, limit;
+        chain->width = 1;
+        chain->filters[0] = dsp_ztf_create_lowpass_filter(1, 0.01f, (real_t) REPLAY_SAMPLE_TIME, 0, 0);
+        chain->filters[1] = dsp_ztf_create_lowpass_filter(1, 0.01f, (real_t) REPLAY_SAMPLE_TIME, 0, 0);
+        chain->saturation = dsp_saturation_create(0.8f, -0.8f);
+        return chain->filters[0] != NULL && chain->filters[1] != NULL && chain->saturation != NULL &&
+            dsp_diagram_add_input(diagram, 1, &chain->input) && dsp_diagram_add_ztf(diagram, chain->filters[0], &first) &&
+            dsp_diagram_add_ztf(diagram, chain->filters[1], &second) && dsp_diagram_add_saturation(diagram, chain->saturation, &limit) &&
+            dsp_diagram_add_output(diagram, 1, &chain->output) &&
+            dsp_diagram_connect(diagram, chain->input, 0, first, 0) && dsp_diagram_connect(diagram, first, 0, second, 0) &&
+            dsp_diagram_connect(diagram, second, 0, limit, 0) && dsp_diagram_connect(diagram, limit, 0, chain->output, 0) &&
+            dsp_diagram_compile(diagram);
+    }
+    if (strcmp(name, "observer") == 0) {
+        const real_t l[2] = {0.5f, 2};
+        size_t observer;
+        chain->width = 2;
+        dsp_zss_t* const plant = create_plant();
+        if (plant == NULL) { return false; }
+        chain->zso = dsp_zso_create_from_zss(plant, l, NULL);
+        dsp_zss_destroy(plant);
+        return chain->zso != NULL && dsp_diagram_add_input(diagram, 2, &chain->input) &&
+            dsp_diagram_add_function(diagram, observer_update, chain->zso, 2, 2, &observer) &&
+            dsp_diagram_add_output(diagram, 2, &chain->output) &&
+            dsp_diagram_connect(diagram, chain->input, 0, observer, 0) && dsp_diagram_connect(diagram, observer, 0, chain->output, 0) &&
+            dsp_diagram_compile(diagram);
+    }
+    fprintf(stderr, "dsp_replay: unknown chain '%s' (loop, filter, observer)\n", name);
+    return false;
+}
+
+
+// Square wave of 2 s and a noisy first order response to it (further values: the response)
+static int generate(const char* const path, const uint64_t samples, const char* const chain_name, const bool wide) {
+    replay_chain_t chain;
+    const bool built = build_chain(chain_name, &chain);
+    const size_t width = chain.width;
+    destroy_chain(&chain);
+    if (!built) { return 1; }
+
+    FILE* const file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "dsp_replay: cannot create '%s'\n", path);
+        return 1;
+    }
+    const size_t value_size = (wide ? sizeof(double) : sizeof(float));
+    bool written = dsp_replay_write_header(file, width, samples, value_size, REPLAY_SAMPLE_TIME);
+
+    unsigned int seed = 1;
+    real_t response = 0;
+    real_t values[REPLAY_MAX_SAMPLES * 2];
+    for (uint64_t first = 0; written && first < samples; first += REPLAY_MAX_SAMPLES) {
+        const size_t n = (samples - first < REPLAY_MAX_SAMPLES ? (size_t) (samples - first) : REPLAY_MAX_SAMPLES);
+        for (size_t j = 0; j < n; ++j) {
+            const real_t square = (((first + j) / 1000) % 2 == 0 ? 1 : -1);
+            seed = seed * 1103515245u + 12345u;
+            const real_t noise = 0.01f * ((real_t) ((seed >> 8) & 0xFFFF) / 32768 - 1);
+            response += 0.02f * (square - response);
+            values[j * width] = (width == 1 ? response + noise : square);
+            for (size_t e = 1; e < width; ++e) { values[j * width + e] = response + noise; }
+        }
+        written = dsp_replay_write(file, values, n * width, value_size);
+    }
+    written = (fclose(file) == 0) && written;
+    if (!written) { fprintf(stderr, "dsp_replay: writing '%s' failed\n", path); }
+    return (written ? 0 : 1);
+}
+
+static int run(const char* const path, const char* const outputs, const char* const chain_name, const size_t batch) {
+    dsp_replay_file_t* const recording = dsp_replay_open(path);
+    if (recording == NULL) {
+        fprintf(stderr, "dsp_replay: '%s' is not a recording of this version\n", path);
+        return 1;
+    }
+    replay_chain_t chain;
+    if (!build_chain(chain_name, &chain)) {
+        destroy_chain(&chain);
+        dsp_replay_close(recording);
+        return 1;
+    }
+    const dsp_replay_file_header_t* const header = dsp_replay_header(recording);
+    if (header->width != chain.width) {
+        fprintf(stderr, "dsp_replay: the chain '%s' needs %zu values per sample, the recording has %llu\n",
+            chain_name, chain.width, (unsigned long long) header->width);
+        destroy_chain(&chain);
+        dsp_replay_close(recording);
+        return 1;
+    }
+
+    FILE* const file = (outputs == NULL ? NULL : fopen(outputs, "wb"));
+    dsp_replay_stats_t stats;
+    bool passed = (outputs == NULL || file != NULL);
+    passed = passed && dsp_replay_run(chain.diagram, chain.input, chain.output, recording, file, batch, &stats);
+    if (file != NULL) { passed = (fclose(file) == 0) && passed; }
+
+    if (passed) {
+        printf("%llu samples in %llu batches, %.3f ms (%.3f ms processing)\n", (unsigned long long) stats.samples,
+            (unsigned long long) stats.batches, 1e3 * stats.seconds, 1e3 * stats.process_seconds);
+        printf("%.4g samples/s", stats.samples_per_second);
+        if (header->sample_time > 0) { printf(", %.4g x real time", stats.samples_per_second * header->sample_time); }
+        printf("\n");
+    }
+    else { fprintf(stderr, "dsp_replay: replay of '%s' failed\n", path); }
+    destroy_chain(&chain);
+    dsp_replay_close(recording);
+    return (passed ? 0 : 1);
+}
+
+static int compare(const char* const path_a, const char* const path_b, const double tolerance) {
+    dsp_replay_file_t* const a = dsp_replay_open(path_a);
+    dsp_replay_file_t* const b = dsp_replay_open(path_b);
+    int result = 1;
+    if (a == NULL || b == NULL) { fprintf(stderr, "dsp_replay: cannot open '%s'\n", (a == NULL ? path_a : path_b)); }
+    else if (dsp_replay_header(a)->width != dsp_replay_header(b)->width || dsp_replay_header(a)->samples != dsp_replay_header(b)->samples) {
+        fprintf(stderr, "dsp_replay: '%s' and '%s' differ in width or length\n", path_a, path_b);
+    }
+    else {
+        const size_t width = (size_t) dsp_replay_header(a)->width;
+        const uint64_t samples = dsp_replay_header(a)->samples;
+        const size_t chunk = (width < REPLAY_MAX_SAMPLES ? REPLAY_MAX_SAMPLES / width : 1);
+        real_t* const values_a = (real_t*) malloc(2 * chunk * width * sizeof(real_t));
+        real_t* const values_b = (values_a == NULL ? NULL : &values_a[chunk * width]);
+        double max_difference = 0;
+        uint64_t worst = 0;
+        for (uint64_t first = 0; values_a != NULL && first < samples; first += chunk) {
+            const size_t n = dsp_replay_read(a, first, chunk, values_a);
+            dsp_replay_read(b, first, chunk, values_b);
+            for (size_t k = 0; k < n * width; ++k) {
+                const double difference = (double) values_a[k] - (double) values_b[k];
+                const double magnitude = (difference < 0 ? -difference : difference);
+                if (magnitude > max_difference || magnitude != magnitude) {
+                    max_difference = magnitude;
+                    worst = first + k / width;
+                }
+            }
+        }
+        if (values_a != NULL) {
+            printf("max difference %.9g at sample %llu\n", max_difference, (unsigned long long) worst);
+            result = (max_difference <= tolerance ? 0 : 1);
+        }
+        free(values_a);
+    }
+    dsp_replay_close(a);
+    dsp_replay_close(b);
+    return result;
+}
+
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: dsp_replay run <recording> [<outputs>] [--chain loop|filter|observer] [--batch <samples>]\n"
+        "       dsp_replay generate <recording> <samples> [--chain loop|filter|observer] [--double]\n"
+        "       dsp_replay compare <outputs> <outputs> [--tolerance <t>]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* positional[3] = {NULL, NULL, NULL};
+    size_t n_positional = 0;
+    const char* chain = "loop";
+    size_t batch = 0;
+    bool wide = false;
+    double tolerance = 0;
+    for (int k = 1; k < argc; ++k) {
+        if (strcmp(argv[k], "--chain") == 0 && k + 1 < argc) { chain = argv[++k]; }
+        else if (strcmp(argv[k], "--batch") == 0 && k + 1 < argc) { batch = (size_t) strtoul(argv[++k], NULL, 10); }
+        else if (strcmp(argv[k], "--tolerance") == 0 && k + 1 < argc) { tolerance = strtod(argv[++k], NULL); }
+        else if (strcmp(argv[k], "--double") == 0) { wide = true; }
+        else if (argv[k][0] != '-' && n_positional < 3) { positional[n_positional++] = argv[k]; }
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (n_positional >= 2 && n_positional <= 3 && strcmp(positional[0], "run") == 0) {
+        return run(positional[1], positional[2], chain, batch);
+    }
+    if (n_positional == 3 && strcmp(positional[0], "generate") == 0) {
+        return generate(positional[1], strtoull(positional[2], NULL, 10), chain, wide);
+    }
+    if (n_positional == 3 && strcmp(positional[0], "compare") == 0) {
+        return compare(positional[1], positional[2], tolerance);
+    }
+    usage();
+    return 2;
+}
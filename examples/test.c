@@ -1,18 +1,43 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <float.h>
+#include <stdint.h>
 
 // DSP-Math
 #include "DSP/Math/Polynomial.h"
 #include "DSP/Math/Matrix.h"
 #include "DSP/Math/Vector.h"
+#include "DSP/Math/Simd.h"
+#include "DSP/Math/FFT.h"
+#include "DSP/Math/LUDecomposition.h"
+#include "DSP/Math/QRDecomposition.h"
+#include "DSP/Math/CholeskyDecomposition.h"
+#include "DSP/Memory/Memory.h"
+#include "DSP/Memory/Workspace.h"
+#include "DSP/Memory/Allocator.h"
 
 // DSP-Discrete
 #include "DSP/Discrete/Signal.h"
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zTransferFunctionBank.h"
 #include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/zStateObserver.h"
+#include "DSP/Discrete/zStateSpaceBank.h"
 #include "DSP/Discrete/Integrator.h"
 #include "DSP/Discrete/Derivative.h"
 #include "DSP/Discrete/pidController.h"
+#include "DSP/Discrete/pidBank.h"
 #include "DSP/Discrete/Discontinuous.h"
+#include "DSP/Discrete/DiscontinuousBank.h"
+#include "DSP/Discrete/BlockDiagram.h"
+#include "DSP/Discrete/SecondOrderSections.h"
+#include "DSP/Parallel/Executor.h"
+#include "DSP/Parallel/TaskGraph.h"
+#include "DSP/Diagnostics/PerfCounters.h"
+#include "DSP/Diagnostics/LatencyHistogram.h"
+#include "DSP/Diagnostics/TraceRing.h"
+#include "DSP/Diagnostics/Replay.h"
 
 
 
@@ -705,6 +730,1607 @@ void test_pid() {
 }
 
 
+bool test_ztf_process_block() {
+
+    // 4th order low-pass filter
+    const real_t num[] = {0.0048f, 0.0193f, 0.0289f, 0.0193f, 0.0048f};
+    const real_t den[] = {1.0000f, -2.3695f, 2.3140f, -1.0547f, 0.1874f};
+    const real_t u0[] = {0.1f, -0.2f, 0.3f, -0.4f};
+    const real_t y0[] = {0.5f, 0.4f, 0.3f, 0.2f};
+    const size_t n_samples = 1000;
+
+    // One system per sample, one per frame
+    dsp_ztf_t* const ztf_sample = dsp_ztf_create_from_arrays(4, num, den, u0, y0);
+    dsp_ztf_t* const ztf_block = dsp_ztf_create_from_arrays(4, num, den, u0, y0);
+
+    // Create Signals
+    dsp_signal_t* const u = dsp_signal_create(n_samples);
+    dsp_signal_t* const y_sample = dsp_signal_create(n_samples);
+    dsp_signal_t* const y_block = dsp_signal_create(n_samples);
+
+    real_t uk = 0, yk = 0;
+    for (size_t k = 0; k < n_samples; ++k) {
+        uk = step(k, 10) - 2 * step(k, 400) + sinf(0.05f * k);
+        yk = dsp_ztf_update(ztf_sample, uk);
+        dsp_signal_push_back(u, &uk);
+        dsp_signal_push_back(y_sample, &yk);
+    }
+
+    // Frames shorter than, equal to and longer than the order
+    dsp_signal_resize(y_block, n_samples, NULL);
+    const size_t frame_sizes[] = {1, 3, 4, 5, 64, 250};
+    size_t k = 0, f = 0;
+    while (k < n_samples) {
+        const size_t frame = frame_sizes[f++ % 6];
+        const size_t n = (k + frame <= n_samples ? frame : n_samples - k);
+        dsp_ztf_process_block(ztf_block, &(u->elements[k]), &(y_block->elements[k]), n);
+        k += n;
+    }
+
+    // Outputs and final state must be bit-identical
+    bool passed = (memcmp(y_sample->elements, y_block->elements, n_samples * sizeof(real_t)) == 0);
+    passed = passed && (dsp_ztf_update(ztf_sample, 1) == dsp_ztf_update(ztf_block, 1));
+
+    // A static gain and an order long enough for the vector kernels
+    const size_t orders[] = {0, 16};
+    for (size_t o = 0; passed && o < 2; ++o) {
+        real_t coefficients[17];
+        for (size_t i = 0; i <= orders[o]; ++i) { coefficients[i] = (i == 0 ? 1.0f : 0.02f / (real_t) (i + 1)); }
+        dsp_ztf_t* const sample = dsp_ztf_create_from_arrays(orders[o], coefficients, coefficients, NULL, NULL);
+        dsp_ztf_t* const block = dsp_ztf_create_from_arrays(orders[o], coefficients, coefficients, NULL, NULL);
+        passed = (sample != NULL && block != NULL) && dsp_ztf_process_block(block, u->elements, y_block->elements, 100);
+        for (size_t j = 0; passed && j < 100; ++j) { passed = (y_block->elements[j] == dsp_ztf_update(sample, u->elements[j])); }
+        dsp_ztf_destroy(sample);
+        dsp_ztf_destroy(block);
+    }
+    printf("ztf_process_block: %s\n", (passed ? "passed" : "FAILED"));
+
+    dsp_ztf_destroy(ztf_sample);
+    dsp_ztf_destroy(ztf_block);
+    dsp_signal_destroy(u);
+    dsp_signal_destroy(y_sample);
+    dsp_signal_destroy(y_block);
+    return passed;
+}
+
+
+
+bool test_ztf_history() {
+
+    // 12th order system, the ring buffer wraps around many times
+    const size_t order = 12;
+    real_t num[13], den[13], u0[12], y0[12];
+    for (size_t i = 0; i <= order; ++i) {
+        num[i] = 1.0f / (real_t) (i + 1);
+        den[i] = (i == 0 ? 2.0f : 0.5f / (real_t) (i * i + 1));
+    }
+    for (size_t i = 0; i < order; ++i) { u0[i] = 0.1f * i; y0[i] = -0.05f * i; }
+    dsp_ztf_t* const ztf = dsp_ztf_create_from_arrays(order, num, den, u0, y0);
+
+    // Reference: shifted history (newest first), the outputs in accum_t like 'ztf->y'
+    real_t u[13] = {0};
+    accum_t y[13] = {0};
+    memcpy(u, u0, order * sizeof(real_t));
+    for (size_t i = 0; i < order; ++i) { y[i] = y0[i]; }
+
+    bool passed = (dsp_ztf_output(ztf) == y0[0]);
+    for (size_t k = 0; k < 500; ++k) {
+
+        // Restart from the initial condition in the middle of the run
+        if (k == 250) {
+            dsp_ztf_set_initial_condition(ztf, u0, y0);
+            memcpy(u, u0, order * sizeof(real_t));
+            for (size_t i = 0; i < order; ++i) { y[i] = y0[i]; }
+        }
+
+        const real_t uk = sinf(0.1f * k) + step(k, 100);
+        memmove(&u[1], &u[0], order * sizeof(real_t));
+        memmove(&y[1], &y[0], order * sizeof(accum_t));
+        u[0] = uk;
+        accum_t bu = 0, ay = 0;
+        for (size_t i = 0; i <= order; ++i) { bu += (accum_t) num[i] * u[i]; }
+        for (size_t i = 1; i <= order; ++i) { ay += (accum_t) den[i] * y[i]; }
+        y[0] = (bu - ay) / den[0];
+
+        passed = passed && (dsp_ztf_update(ztf, uk) == (real_t) y[0]) && (dsp_ztf_output(ztf) == (real_t) y[0]);
+    }
+
+    dsp_ztf_reset(ztf);
+    passed = passed && (dsp_ztf_output(ztf) == 0) && (dsp_ztf_update(ztf, 1) == num[0] / den[0]);
+    printf("ztf_history: %s\n", (passed ? "passed" : "FAILED"));
+
+    dsp_ztf_destroy(ztf);
+    return passed;
+}
+
+
+// Pseudo random numbers in [-1, 1]
+static real_t noise(unsigned int* const seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (real_t) ((*seed >> 8) & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+// Tolerance of a sum of 'n' products: n * eps * sum(|u[k] * v[k]|)
+// (worst case rounding error of any summation order, with or without FMA)
+static bool close_to(const real_t x, const real_t reference, const size_t n, const real_t magnitude) {
+    return fabsf(x - reference) <= (real_t) n * FLT_EPSILON * magnitude;
+}
+
+bool test_simd_kernels() {
+
+    const dsp_simd_isa_t isas[] = {SimdSSE, SimdAVX2, SimdAVX512, SimdNEON};
+    const dsp_simd_isa_t default_isa = dsp_simd_selected();
+    const size_t n_max = 300;
+    real_t u[300], v[300], w[600], w_ref[599], q[300], q_ref[300], r[300], r_ref[300];
+
+    bool passed = true;
+    for (size_t i = 0; i < 4; ++i) {
+        if (!dsp_simd_is_supported(isas[i])) {
+            printf("simd_kernels (%s): skipped\n", dsp_simd_isa_name(isas[i]));
+            continue;
+        }
+
+        bool isa_passed = true;
+        unsigned int seed = 42;
+        for (size_t n = 1; n <= n_max; n += (n < 40 ? 1 : 37)) {
+            for (size_t k = 0; k < n; ++k) { u[k] = noise(&seed); v[k] = noise(&seed); }
+
+            // Dot product
+            real_t magnitude = 0;
+            for (size_t k = 0; k < n; ++k) { magnitude += fabsf(u[k] * v[k]); }
+            dsp_simd_select(SimdScalar);
+            const real_t dot_ref = dsp_dot_product(u, v, n);
+            dsp_simd_select(isas[i]);
+            isa_passed = isa_passed && close_to(dsp_dot_product(u, v, n), dot_ref, n, magnitude);
+
+            // Element-wise multiply-add (one rounding with or without FMA)
+            for (size_t k = 0; k < n; ++k) { q[k] = 1; }
+            dsp_simd_multiply_add(q, u, v, n);
+            for (size_t k = 0; k < n; ++k) { isa_passed = isa_passed && close_to(q[k], 1 + u[k] * v[k], 2, 1 + fabsf(u[k] * v[k])); }
+
+            // Convolution (the last element of 'w' must stay untouched)
+            const size_t m = (n + 1) / 2;
+            dsp_simd_select(SimdScalar);
+            dsp_conv(u, n, v, m, w_ref, n + m - 1);
+            dsp_simd_select(isas[i]);
+            w[n + m - 1] = 123;
+            dsp_conv(u, n, v, m, w, n + m - 1);
+            isa_passed = isa_passed && (w[n + m - 1] == 123);
+            for (size_t k = 0; k < n + m - 1; ++k) {
+                real_t conv_magnitude = 0;
+                for (size_t j = (k < n ? 0 : k - (n - 1)); j <= (k < m ? k : m - 1); ++j) { conv_magnitude += fabsf(v[j] * u[k-j]); }
+                isa_passed = isa_passed && close_to(w[k], w_ref[k], m, conv_magnitude);
+            }
+
+            // Deconvolution by a well-conditioned divisor (|v[0]| > sum(|v[1..]|)),
+            // the errors stay of the order of a few eps * max(|u|)
+            const real_t d[4] = {4.0f, 0.5f * v[0], 0.5f * v[1 % n], 0.5f * v[2 % n]};
+            if (n >= 4) {
+                dsp_simd_select(SimdScalar);
+                dsp_deconv(u, n, d, 4, q_ref, n - 3, r_ref, n);
+                dsp_simd_select(isas[i]);
+                dsp_deconv(u, n, d, 4, q, n - 3, r, n);
+                for (size_t k = 0; k < n; ++k) {
+                    if (k < n - 3) { isa_passed = isa_passed && close_to(q[k], q_ref[k], 16, 1); }
+                    isa_passed = isa_passed && close_to(r[k], r_ref[k], 16, 1);
+                }
+            }
+        }
+
+        printf("simd_kernels (%s): %s\n", dsp_simd_isa_name(isas[i]), (isa_passed ? "passed" : "FAILED"));
+        passed = passed && isa_passed;
+    }
+
+    dsp_simd_select(default_isa);
+    return passed;
+}
+
+
+bool test_fft_conv() {
+
+    // Real FFT against the direct DFT
+    const size_t n_fft = 64;
+    real_t x[64], X[66], x_back[64];
+    unsigned int seed = 7;
+    for (size_t k = 0; k < n_fft; ++k) { x[k] = noise(&seed); }
+    const dsp_fft_plan_t* const plan = dsp_fft_plan_cached(n_fft);
+    dsp_fft_real_forward(plan, x, X);
+    dsp_fft_real_inverse(plan, X, x_back);
+
+    bool passed = (plan != NULL) && (plan == dsp_fft_plan_cached(n_fft));
+    for (size_t k = 0; k <= n_fft / 2; ++k) {
+        double re = 0, im = 0;
+        for (size_t j = 0; j < n_fft; ++j) {
+            re += x[j] * cos(-2 * M_PI * (double) (j * k) / n_fft);
+            im += x[j] * sin(-2 * M_PI * (double) (j * k) / n_fft);
+        }
+        passed = passed && (fabs(X[2*k] - re) < 1e-4) && (fabs(X[2*k+1] - im) < 1e-4);
+    }
+    for (size_t k = 0; k < n_fft; ++k) { passed = passed && (fabsf(x_back[k] - x[k]) < 1e-5f); }
+
+    // Convolution of long signals against the direct sum
+    // Tolerance: 8 * log2(fft size) * eps * |u|_2 * |v|_2
+    const size_t sizes[][2] = {{128, 128}, {1000, 130}, {300, 4000}, {5000, 257}};
+    for (size_t i = 0; i < 4; ++i) {
+        const size_t nu = sizes[i][0], nv = sizes[i][1], nw = nu + nv - 1;
+        dsp_signal_t* const u = dsp_signal_create(nu);
+        dsp_signal_t* const v = dsp_signal_create(nv);
+        dsp_signal_t* const w = dsp_signal_create(1);
+        dsp_signal_resize(u, nu, NULL);
+        dsp_signal_resize(v, nv, NULL);
+
+        real_t norm_u = 0, norm_v = 0;
+        for (size_t k = 0; k < nu; ++k) { u->elements[k] = noise(&seed); norm_u += u->elements[k] * u->elements[k]; }
+        for (size_t k = 0; k < nv; ++k) { v->elements[k] = noise(&seed); norm_v += v->elements[k] * v->elements[k]; }
+        const real_t tolerance = 8 * 20 * FLT_EPSILON * sqrtf(norm_u) * sqrtf(norm_v);
+
+        passed = passed && (dsp_signal_conv(w, u, v) == nw);
+        for (size_t k = 0; k < nw && passed; ++k) {
+            double sum = 0;
+            for (size_t j = (k < nu ? 0 : k - (nu - 1)); j <= (k < nv ? k : nv - 1); ++j) {
+                sum += (double) v->elements[j] * u->elements[k-j];
+            }
+            passed = passed && (fabs(w->elements[k] - sum) <= tolerance);
+        }
+
+        dsp_signal_destroy(u);
+        dsp_signal_destroy(v);
+        dsp_signal_destroy(w);
+    }
+
+    printf("fft_conv: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+
+bool test_matrix_multiply() {
+
+    // Products against a double precision reference
+    // Tolerance: k * eps * sum(|a[i][p] * b[p][j]|)
+    const size_t sizes[][3] = {{1, 1, 1}, {5, 7, 3}, {4, 32, 9}, {50, 60, 70}, {131, 33, 300}};
+    unsigned int seed = 3;
+    bool passed = true;
+    for (size_t s = 0; s < 5; ++s) {
+        const size_t m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+        dsp_matrix_t* const A = dsp_matrix_create(m, k);
+        dsp_matrix_t* const At = dsp_matrix_create(k, m);
+        dsp_matrix_t* const B = dsp_matrix_create(k, n);
+        dsp_matrix_t* const Bt = dsp_matrix_create(n, k);
+        dsp_matrix_t* const C = dsp_matrix_create(m, n);
+        dsp_matrix_t* const C_add = dsp_matrix_create(m, n);
+        dsp_matrix_t* const C_tn = dsp_matrix_create(m, n);
+        dsp_matrix_t* const C_nt = dsp_matrix_create(m, n);
+        for (size_t i = 0; i < m * k; ++i) { A->elements[i] = noise(&seed); }
+        for (size_t i = 0; i < k * n; ++i) { B->elements[i] = noise(&seed); }
+        for (size_t i = 0; i < m * n; ++i) { C_add->elements[i] = 1; }
+        dsp_matrix_transpose(At, A);
+        dsp_matrix_transpose(Bt, B);
+
+        passed = passed && dsp_matrix_multiply(C, A, B);
+        passed = passed && dsp_matrix_multiply_and_add(C_add, A, B);
+        passed = passed && dsp_matrix_transpose_multiply(C_tn, At, B);
+        passed = passed && dsp_matrix_multiply_transpose(C_nt, A, Bt);
+
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double sum = 0, magnitude = 0;
+                for (size_t p = 0; p < k; ++p) {
+                    sum += (double) A->elements[i * k + p] * B->elements[p * n + j];
+                    magnitude += fabs((double) A->elements[i * k + p] * B->elements[p * n + j]);
+                }
+                const double tolerance = k * FLT_EPSILON * (magnitude + 1);
+                passed = passed && (fabs(C->elements[i * n + j] - sum) <= tolerance);
+                passed = passed && (fabs(C_add->elements[i * n + j] - (sum + 1)) <= tolerance);
+                passed = passed && (fabs(C_tn->elements[i * n + j] - sum) <= tolerance);
+                passed = passed && (fabs(C_nt->elements[i * n + j] - sum) <= tolerance);
+            }
+        }
+
+        dsp_matrix_destroy(A); dsp_matrix_destroy(At);
+        dsp_matrix_destroy(B); dsp_matrix_destroy(Bt);
+        dsp_matrix_destroy(C); dsp_matrix_destroy(C_add);
+        dsp_matrix_destroy(C_tn); dsp_matrix_destroy(C_nt);
+    }
+
+    // Pseudo inverse of a tall and a wide matrix: A * pinv(A) * A = A
+    for (size_t s = 0; s < 2; ++s) {
+        const size_t m = (s == 0 ? 40 : 6), n = (s == 0 ? 6 : 40);
+        dsp_matrix_t* const A = dsp_matrix_create(m, n);
+        dsp_matrix_t* const P = dsp_matrix_create(n, m);
+        dsp_matrix_t* const AP = dsp_matrix_create(m, m);
+        dsp_matrix_t* const APA = dsp_matrix_create(m, n);
+        for (size_t i = 0; i < m * n; ++i) { A->elements[i] = noise(&seed); }
+
+        passed = passed && dsp_matrix_pinv(P, A) && dsp_matrix_multiply(AP, A, P) && dsp_matrix_multiply(APA, AP, A);
+        for (size_t i = 0; i < m * n; ++i) { passed = passed && (fabsf(APA->elements[i] - A->elements[i]) < 1e-4f); }
+
+        dsp_matrix_destroy(A); dsp_matrix_destroy(P);
+        dsp_matrix_destroy(AP); dsp_matrix_destroy(APA);
+    }
+
+    printf("matrix_multiply: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+
+bool test_matrix_lu() {
+
+    // Diagonally weighted random system
+    const size_t n = 30;
+    unsigned int seed = 11;
+    dsp_matrix_t* const A = dsp_matrix_create(n, n);
+    dsp_matrix_t* const A_copy = dsp_matrix_create(n, n);
+    dsp_matrix_t* const A_inv = dsp_matrix_create(n, n);
+    dsp_matrix_t* const I = dsp_matrix_create(n, n);
+    for (size_t i = 0; i < n * n; ++i) { A->elements[i] = noise(&seed) + (i % (n + 1) == 0 ? 4.0f : 0.0f); }
+
+    // Factor once, solve many right-hand sides
+    dsp_matrix_lu_t* const lu = dsp_matrix_lu_create_from_matrix(A);
+    bool passed = (lu != NULL) && !dsp_matrix_lu_is_singular(lu);
+    real_t x[30], b[30];
+    for (size_t r = 0; r < 10 && passed; ++r) {
+        for (size_t i = 0; i < n; ++i) { b[i] = noise(&seed); }
+        passed = passed && dsp_matrix_lu_solve(lu, x, b);
+        for (size_t i = 0; i < n; ++i) {
+            passed = passed && (fabsf(dsp_dot_product(&(A->elements[i * n]), x, n) - b[i]) < 1e-5f);
+        }
+    }
+
+    // Determinant against Gauss-Jordan, inverse
+    dsp_matrix_copy_assign(A_copy, A);
+    const real_t det_gj = dsp_matrix_gauss_jordan(A_copy, NULL);
+    passed = passed && (fabsf(dsp_matrix_det(A) - det_gj) <= 1e-4f * fabsf(det_gj));
+    passed = passed && dsp_matrix_inv(A_inv, A) && dsp_matrix_multiply(I, A_inv, A);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            passed = passed && (fabsf(I->elements[i * n + j] - (i == j ? 1.0f : 0.0f)) < 1e-5f);
+        }
+    }
+
+    // Singular matrix (two equal rows)
+    memcpy(&(A->elements[n]), A->elements, n * sizeof(real_t));
+    passed = passed && !dsp_matrix_lu_factor(lu, A) && dsp_matrix_lu_is_singular(lu);
+    passed = passed && (dsp_matrix_lu_det(lu) == 0) && !dsp_matrix_lu_solve(lu, x, b);
+    passed = passed && (dsp_matrix_det(A) == 0) && !dsp_matrix_inv(A_inv, A);
+
+    printf("matrix_lu: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_matrix_lu_destroy(lu);
+    dsp_matrix_destroy(A); dsp_matrix_destroy(A_copy);
+    dsp_matrix_destroy(A_inv); dsp_matrix_destroy(I);
+    return passed;
+}
+
+
+bool test_least_squares() {
+
+    unsigned int seed = 5;
+    static unsigned char memory[4096];
+    dsp_workspace_t ws;
+    dsp_workspace_init(&ws, memory, sizeof(memory));
+    real_t A_elements[48], b[8], x[8], r[8], w[8];
+    bool passed = true;
+
+    // Overdetermined 8 x 6: the residual is orthogonal to the columns of A
+    dsp_matrix_t A = {8, 6, A_elements};
+    for (size_t i = 0; i < 48; ++i) { A_elements[i] = noise(&seed); }
+    for (size_t i = 0; i < 8; ++i) { b[i] = noise(&seed); }
+    dsp_matrix_qr_t qr;
+    passed = passed && (dsp_matrix_qr_workspace_size(8, 6) <= ws.size);
+    passed = passed && dsp_workspace_reset(&ws) && dsp_matrix_qr_init(&qr, 8, 6, &ws) && dsp_matrix_qr_factor(&qr, &A) && dsp_matrix_qr_solve(&qr, x, b);
+    for (size_t i = 0; i < 8; ++i) { r[i] = dsp_dot_product(&A_elements[i * 6], x, 6) - b[i]; }
+    for (size_t j = 0; j < 6; ++j) {
+        real_t s = 0;
+        for (size_t i = 0; i < 8; ++i) { s += A_elements[i * 6 + j] * r[i]; }
+        passed = passed && (fabsf(s) < 1e-5f);
+    }
+
+    // Underdetermined 6 x 8: exact and minimum norm, x = A^T * w with (A * A^T) * w = b
+    dsp_matrix_t B = {6, 8, A_elements};
+    real_t AAt_elements[36];
+    dsp_matrix_t AAt = {6, 6, AAt_elements};
+    passed = passed && dsp_workspace_reset(&ws) && dsp_matrix_qr_init(&qr, 6, 8, &ws) && dsp_matrix_qr_factor(&qr, &B) && dsp_matrix_qr_solve(&qr, x, b);
+    passed = passed && dsp_matrix_multiply_transpose(&AAt, &B, &B) && dsp_solve(w, 6, AAt_elements, b, 6);
+    for (size_t i = 0; i < 6; ++i) { passed = passed && (fabsf(dsp_dot_product(&A_elements[i * 8], x, 8) - b[i]) < 1e-5f); }
+    for (size_t j = 0; j < 8; ++j) {
+        real_t s = 0;
+        for (size_t i = 0; i < 6; ++i) { s += A_elements[i * 8 + j] * w[i]; }
+        passed = passed && (fabsf(s - x[j]) < 1e-4f);
+    }
+
+    // Pseudo inverse: pinv(A) * A == I
+    real_t P_elements[48], I_elements[36];
+    dsp_matrix_t P = {6, 8, P_elements};
+    dsp_matrix_t I = {6, 6, I_elements};
+    passed = passed && dsp_matrix_pinv(&P, &A) && dsp_matrix_multiply(&I, &P, &A);
+    for (size_t i = 0; i < 36; ++i) { passed = passed && (fabsf(I_elements[i] - (i % 7 == 0 ? 1.0f : 0.0f)) < 1e-5f); }
+
+    // Rank deficient: two equal columns
+    for (size_t i = 0; i < 8; ++i) { A_elements[i * 6 + 5] = A_elements[i * 6 + 2]; }
+    passed = passed && dsp_workspace_reset(&ws) && dsp_matrix_qr_init(&qr, 8, 6, &ws) && !dsp_matrix_qr_factor(&qr, &A) && !dsp_matrix_qr_solve(&qr, x, b);
+
+    // Cholesky of A^T * A + I
+    real_t M_elements[36], y[6];
+    dsp_matrix_t M = {6, 6, M_elements};
+    dsp_matrix_chol_t chol;
+    for (size_t i = 0; i < 48; ++i) { A_elements[i] = noise(&seed); }
+    passed = passed && dsp_matrix_transpose_multiply(&M, &A, &A);
+    for (size_t i = 0; i < 6; ++i) { M_elements[i * 7] += 1; }
+    passed = passed && dsp_workspace_reset(&ws) && dsp_matrix_chol_init(&chol, 6, &ws) && dsp_matrix_chol_factor(&chol, &M);
+    passed = passed && dsp_matrix_chol_solve(&chol, y, b);
+    for (size_t i = 0; i < 6; ++i) { passed = passed && (fabsf(dsp_dot_product(&M_elements[i * 6], y, 6) - b[i]) < 1e-5f); }
+    const real_t det = dsp_matrix_det(&M);
+    passed = passed && (fabsf(dsp_matrix_chol_det(&chol) - det) <= 1e-4f * det);
+    M_elements[0] = -1;
+    passed = passed && !dsp_matrix_chol_factor(&chol, &M) && !dsp_matrix_chol_solve(&chol, y, b);
+
+    // Fit a cubic through 50 points without heap allocation
+    real_t xs[50], ys[50], p[4];
+    const real_t ref[4] = {0.5f, -1.0f, 0.25f, 2.0f};
+    for (size_t i = 0; i < 50; ++i) {
+        xs[i] = noise(&seed);
+        ys[i] = ref[0] + xs[i] * (ref[1] + xs[i] * (ref[2] + xs[i] * ref[3]));
+    }
+    passed = passed && dsp_workspace_reset(&ws) && (dsp_polyfit_workspace_size(3, 50) <= ws.size);
+    passed = passed && dsp_polyfit_with_workspace(p, 3, xs, ys, 50, &ws);
+    for (size_t k = 0; k < 4; ++k) { passed = passed && (fabsf(p[k] - ref[k]) < 1e-4f); }
+    p[0] = p[1] = p[2] = p[3] = 0;
+    passed = passed && dsp_polyfit(p, 3, xs, ys, 50);
+    for (size_t k = 0; k < 4; ++k) { passed = passed && (fabsf(p[k] - ref[k]) < 1e-4f); }
+
+    printf("least_squares: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+
+bool test_workspace() {
+
+    const size_t n = 12;
+    unsigned int seed = 17;
+    dsp_matrix_t* const A = dsp_matrix_create(n, n);
+    dsp_matrix_t* const T = dsp_matrix_create(n + 4, n);
+    dsp_matrix_t* const R = dsp_matrix_create(n, n + 4);
+    dsp_vector_t* const b = dsp_vector_create(n);
+    dsp_vector_t* const t = dsp_vector_create(n + 4);
+    dsp_vector_t* const x = dsp_vector_create(n);
+    for (size_t i = 0; i < n * n; ++i) { A->elements[i] = noise(&seed) + (i % (n + 1) == 0 ? 4.0f : 0.0f); }
+    for (size_t i = 0; i < (n + 4) * n; ++i) { T->elements[i] = noise(&seed); }
+    for (size_t i = 0; i < n; ++i) { b->elements[i] = noise(&seed); }
+    for (size_t i = 0; i < n + 4; ++i) { t->elements[i] = noise(&seed); }
+    real_t xs[40], ys[40], p[4];
+    for (size_t i = 0; i < 40; ++i) { xs[i] = noise(&seed); ys[i] = noise(&seed); }
+
+    // Size the workspace once for the largest call
+    size_t size = dsp_matrix_det_workspace_size(n);
+    if (dsp_matrix_workspace_size(n, n) + dsp_matrix_inv_workspace_size(n) > size) { size = dsp_matrix_workspace_size(n, n) + dsp_matrix_inv_workspace_size(n); }
+    if (dsp_matrix_pinv_workspace_size(n + 4, n) > size) { size = dsp_matrix_pinv_workspace_size(n + 4, n); }
+    if (dsp_vector_solve_lse_workspace_size(n + 4, n) > size) { size = dsp_vector_solve_lse_workspace_size(n + 4, n); }
+    if (dsp_polyfit_workspace_size(3, 40) > size) { size = dsp_polyfit_workspace_size(3, 40); }
+    dsp_workspace_t* const ws = dsp_workspace_create(size);
+    bool passed = (ws != NULL);
+
+    // Reference results of the allocating functions
+    size_t count = dsp_memory_allocation_count();
+    const real_t det_ref = dsp_matrix_det(A);
+    dsp_matrix_t* const A_inv_ref = dsp_matrix_create_inv(A);
+    dsp_vector_t* const x_ref = dsp_vector_create_solution(T, t);
+    passed = passed && (A_inv_ref != NULL) && (x_ref != NULL);
+    if (dsp_memory_counting_enabled()) {
+        passed = passed && (dsp_memory_allocation_count() > count);
+    }
+
+    // Same results without a single heap allocation
+    count = dsp_memory_allocation_count();
+    passed = passed && (dsp_matrix_det_with_workspace(A, ws) == det_ref);
+    dsp_matrix_t* const A_inv = dsp_matrix_create_inv_in_workspace(A, ws);
+    passed = passed && (A_inv != NULL) && (memcmp(A_inv->elements, A_inv_ref->elements, n * n * sizeof(real_t)) == 0);
+    passed = passed && dsp_workspace_release(ws, 0);
+    passed = passed && dsp_matrix_pinv_with_workspace(R, T, ws);
+    passed = passed && dsp_vector_solve_lse_with_workspace(x, T, t, ws);
+    passed = passed && (memcmp(x->elements, x_ref->elements, n * sizeof(real_t)) == 0);
+    passed = passed && dsp_polyfit_with_workspace(p, 3, xs, ys, 40, ws);
+    passed = passed && (dsp_memory_allocation_count() == count) && (ws->used == 0) && (ws->peak <= ws->size);
+
+    // Exhausted workspace
+    dsp_workspace_t small;
+    unsigned char memory[64];
+    passed = passed && dsp_workspace_init(&small, memory, sizeof(memory));
+    passed = passed && (dsp_matrix_det_with_workspace(A, &small) == 0) && (small.used == 0);
+
+    printf("workspace: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_workspace_destroy(ws);
+    dsp_matrix_destroy(A_inv_ref); dsp_vector_destroy(x_ref);
+    dsp_matrix_destroy(A); dsp_matrix_destroy(T); dsp_matrix_destroy(R);
+    dsp_vector_destroy(b); dsp_vector_destroy(t); dsp_vector_destroy(x);
+    return passed;
+}
+
+
+static bool in_region(const void* const ptr, const void* const begin, const size_t size) {
+    return ((const unsigned char*) ptr >= (const unsigned char*) begin) && ((const unsigned char*) ptr < (const unsigned char*) begin + size);
+}
+
+bool test_allocator() {
+
+    // Build a small controller graph into one arena
+    static unsigned char memory[1 << 14];
+    dsp_arena_t arena;
+    bool passed = dsp_arena_init(&arena, memory, sizeof(memory));
+    const size_t count = dsp_memory_allocation_count();
+    const dsp_allocator_t* const previous = dsp_allocator_select(dsp_arena_allocator(&arena));
+    dsp_zss_t* const pt1 = dsp_zss_create_pt1(2, 3, 0.01f, 0);
+    dsp_ztf_t* const lpf = dsp_ztf_create_lowpass_filter(1, 0.1f, 0.01f, 0, 0);
+    dsp_pid_t* const pid = dsp_pid_create();
+    dsp_signal_t* const signal = dsp_signal_create(1);
+    for (size_t k = 0; k < 100; ++k) { const real_t value = (real_t) k; dsp_signal_push_back(signal, &value); }
+    passed = passed && (dsp_allocator_select(previous) == dsp_arena_allocator(&arena));
+    passed = passed && (dsp_memory_allocation_count() == count);
+
+    passed = passed && (pt1 != NULL) && (lpf != NULL) && (pid != NULL) && (signal != NULL);
+    passed = passed && in_region(pt1, memory, sizeof(memory)) && in_region(pt1->A->elements, memory, sizeof(memory));
+    passed = passed && in_region(lpf, memory, sizeof(memory)) && in_region(lpf->b, memory, sizeof(memory));
+    passed = passed && in_region(pid, memory, sizeof(memory)) && in_region(signal->elements, memory, sizeof(memory));
+    passed = passed && (signal->size == 100) && (signal->elements[99] == 99);
+
+    // Destroying after switching back goes to the arena (no-op)
+    const size_t used = arena.used;
+    dsp_zss_destroy(pt1); dsp_ztf_destroy(lpf); dsp_pid_destroy(pid); dsp_signal_destroy(signal);
+    passed = passed && (arena.used == used) && dsp_arena_reset(&arena) && (arena.used == 0);
+
+    // Vectors from a pool: blocks are given back on destroy
+    dsp_pool_t* const pool = dsp_pool_create(16 * sizeof(real_t), 4);
+    passed = passed && (pool != NULL) && (pool->available == 4);
+    dsp_allocator_select(dsp_pool_allocator(pool));
+    dsp_vector_t* const a = dsp_vector_create(3);
+    dsp_vector_t* const b = dsp_vector_create(16);
+    dsp_vector_t* const c = dsp_vector_create(17);
+    dsp_allocator_select(NULL);
+    passed = passed && (a != NULL) && (b != NULL) && (c == NULL) && (pool->available == 0);
+    dsp_vector_destroy(a);
+    dsp_vector_destroy(b);
+    passed = passed && (pool->available == 4) && (dsp_allocator_selected() == dsp_allocator_default());
+    dsp_pool_destroy(pool);
+
+    printf("allocator: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+
+bool test_zss_packed() {
+
+    const size_t nx = 4, nu = 2, ny = 3;
+    unsigned int seed = 23;
+    real_t a[16], b[8], c[12], d[6], x0[4];
+    for (size_t i = 0; i < 16; ++i) { a[i] = 0.4f * noise(&seed); }
+    for (size_t i = 0; i < 8; ++i) { b[i] = noise(&seed); }
+    for (size_t i = 0; i < 12; ++i) { c[i] = noise(&seed); }
+    for (size_t i = 0; i < 6; ++i) { d[i] = noise(&seed); }
+    for (size_t i = 0; i < 4; ++i) { x0[i] = noise(&seed); }
+
+    // One allocation for the struct, one for all matrices and vectors
+    const size_t count = dsp_memory_allocation_count();
+    dsp_zss_t* const zss = dsp_zss_create_from_arrays(nx, nu, ny, a, b, c, d, x0);
+    bool passed = (zss != NULL);
+    if (dsp_memory_counting_enabled()) { passed = passed && (dsp_memory_allocation_count() - count == 2); }
+
+    // x, xn, A, B, C, D back to back, starting on a cache line
+    const unsigned char* const x_begin = (const unsigned char*) zss->x->elements;
+    passed = passed && (((uintptr_t) x_begin) % 64 == 0);
+    passed = passed && (zss->xn->elements == zss->x->elements + 4);
+    passed = passed && (zss->A->elements == zss->x->elements + 8);
+    passed = passed && (zss->B->elements == zss->x->elements + 24);
+    passed = passed && (zss->C->elements == zss->x->elements + 32);
+    passed = passed && (zss->D->elements == zss->x->elements + 44);
+
+    // Same response as the reference recursion
+    real_t x[4], xn[4], u[2], y[3];
+    memcpy(x, x0, sizeof(x));
+    dsp_zss_t* const moved = dsp_zss_create_move(zss);
+    dsp_zss_t* const copy = dsp_zss_create_copy(moved);
+    passed = passed && (moved != NULL) && (copy != NULL) && (zss->block == NULL);
+    for (size_t k = 0; k < 50 && passed; ++k) {
+        u[0] = noise(&seed); u[1] = noise(&seed);
+        passed = passed && dsp_zss_update(moved, u, y);
+        for (size_t i = 0; i < ny; ++i) {
+            const real_t ref = dsp_dot_product(&c[i * nx], x, nx) + dsp_dot_product(&d[i * nu], u, nu);
+            passed = passed && (fabsf(y[i] - ref) < 1e-5f);
+        }
+        for (size_t i = 0; i < nx; ++i) { xn[i] = dsp_dot_product(&a[i * nx], x, nx) + dsp_dot_product(&b[i * nu], u, nu); }
+        memcpy(x, xn, sizeof(x));
+    }
+    passed = passed && dsp_zss_copy_assign(copy, moved) && (memcmp(copy->x->elements, moved->x->elements, sizeof(x)) == 0);
+
+    printf("zss_packed: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_zss_destroy(zss);
+    dsp_zss_destroy(moved);
+    dsp_zss_destroy(copy);
+    return passed;
+}
+
+bool test_pid_bank() {
+
+    // Every combination of the options, 37 lanes so the vector kernels have a remainder
+    const size_t n = 37;
+    const dsp_simd_isa_t isas[] = {SimdScalar, SimdSSE, SimdAVX2, SimdAVX512};
+    const dsp_simd_isa_t default_isa = dsp_simd_selected();
+    dsp_pid_t* pids[37];
+    real_t u[37], y[37], y_fb[37];
+
+    bool passed = true;
+    for (size_t i = 0; i < 4; ++i) {
+        if (!dsp_simd_is_supported(isas[i])) { continue; }
+        dsp_simd_select(isas[i]);
+
+        unsigned int seed = 11;
+        dsp_pid_bank_t* const bank = dsp_pid_bank_create(n);
+        passed = passed && (bank != NULL);
+        for (size_t k = 0; k < n && passed; ++k) {
+            pids[k] = dsp_pid_create_and_configure(0.01f,
+                2 + noise(&seed), 10 + 5 * noise(&seed), 0.1f + 0.05f * noise(&seed), 20,
+                (k & 1) != 0, 1 + 0.5f * noise(&seed), -1 + 0.5f * noise(&seed),
+                (k & 2) != 0, 50, -40,
+                (k & 4) != 0, 2 + noise(&seed),
+                (k & 8) != 0, 3 + noise(&seed));
+            passed = passed && (pids[k] != NULL) && dsp_pid_bank_set_controller(bank, k, pids[k]);
+        }
+
+        // Same outputs and states as each controller on its own, bit for bit
+        for (size_t step = 0; step < 300 && passed; ++step) {
+            for (size_t k = 0; k < n; ++k) { u[k] = 3 * noise(&seed); y_fb[k] = noise(&seed); }
+            if (step % 3 == 0) {
+                passed = passed && dsp_pid_bank_get_output(bank, u, y) && dsp_pid_bank_update_state(bank, y_fb);
+                for (size_t k = 0; k < n; ++k) {
+                    passed = passed && (dsp_pid_get_output(pids[k], u[k]) == y[k]);
+                    dsp_pid_update_state(pids[k], y_fb[k]);
+                }
+            }
+            else {
+                passed = passed && dsp_pid_bank_update(bank, u, y);
+                for (size_t k = 0; k < n; ++k) { passed = passed && (dsp_pid_update(pids[k], u[k]) == y[k]); }
+            }
+        }
+        dsp_pid_t lane;
+        for (size_t k = 0; k < n && passed; ++k) {
+            passed = dsp_pid_bank_get_controller(bank, k, &lane) && (memcmp(&lane.Xi, &pids[k]->Xi, sizeof(real_t)) == 0) &&
+                (lane.Xd == pids[k]->Xd) && (lane.Xr == pids[k]->Xr) && (lane.pidsum == pids[k]->pidsum);
+        }
+
+        for (size_t k = 0; k < n; ++k) { dsp_pid_destroy(pids[k]); }
+        dsp_pid_bank_destroy(bank);
+    }
+    dsp_simd_select(default_isa);
+
+    printf("pid_bank: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+bool test_ztf_bank() {
+
+    // Per-channel coefficients: stable second order sections with random histories
+    const size_t channels = 19, n_samples = 200;
+    unsigned int seed = 5;
+    dsp_ztf_t* ztfs[19];
+    real_t u[19], y[19];
+
+    const size_t count = dsp_memory_allocation_count();
+    dsp_ztf_bank_t* const bank = dsp_ztf_bank_create(2, channels, false);
+    bool passed = (bank != NULL);
+    if (dsp_memory_counting_enabled()) { passed = passed && (dsp_memory_allocation_count() - count == 1); }
+    for (size_t c = 0; c < channels && passed; ++c) {
+        const real_t r = 0.5f + 0.4f * fabsf(noise(&seed)), phi = 3 * noise(&seed);
+        const real_t num[3] = {noise(&seed), noise(&seed), noise(&seed)};
+        const real_t den[3] = {2, -4 * r * cosf(phi), 2 * r * r};
+        const real_t u0[2] = {noise(&seed), noise(&seed)}, y0[2] = {noise(&seed), noise(&seed)};
+        ztfs[c] = dsp_ztf_create_from_arrays(2, num, den, u0, y0);
+        passed = passed && (ztfs[c] != NULL) && dsp_ztf_bank_set_channel(bank, c, ztfs[c]);
+    }
+    for (size_t k = 0; k < n_samples && passed; ++k) {
+        for (size_t c = 0; c < channels; ++c) { u[c] = noise(&seed); }
+        passed = passed && dsp_ztf_bank_update(bank, u, y);
+        for (size_t c = 0; c < channels; ++c) { passed = passed && (fabsf(dsp_ztf_update(ztfs[c], u[c]) - y[c]) < 1e-4f); }
+    }
+    for (size_t c = 0; c < channels; ++c) { dsp_ztf_destroy(ztfs[c]); }
+    dsp_ztf_bank_destroy(bank);
+
+    // Shared coefficients: lowpass filters, one block of samples
+    real_t in[5 * 50], out[5 * 50];
+    dsp_ztf_bank_t* const lowpass = dsp_ztf_bank_create_lowpass_filter(5, 2, 0.1f, 0.01f);
+    dsp_ztf_t* const reference = dsp_ztf_create_lowpass_filter(2, 0.1f, 0.01f, 0, 0);
+    for (size_t k = 0; k < 5 * 50; ++k) { in[k] = noise(&seed); }
+    passed = passed && (lowpass != NULL) && (reference != NULL) && dsp_ztf_bank_process_block(lowpass, in, out, 50);
+    for (size_t c = 0; c < 5 && passed; ++c) {
+        dsp_ztf_reset(reference);
+        for (size_t k = 0; k < 50; ++k) { passed = passed && (fabsf(dsp_ztf_update(reference, in[k * 5 + c]) - out[k * 5 + c]) < 1e-5f); }
+    }
+    dsp_ztf_bank_destroy(lowpass);
+    dsp_ztf_destroy(reference);
+
+    printf("ztf_bank: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+bool test_discontinuous_bank() {
+
+    // 21 channels so the vector kernels have a remainder, inputs pass all thresholds
+    enum { n = 21 };
+    const dsp_simd_isa_t isas[] = {SimdScalar, SimdAVX2};
+    const dsp_simd_isa_t default_isa = dsp_simd_selected();
+    dsp_saturation_t* saturation[n];
+    dsp_dead_zone_t* dead_zone[n];
+    dsp_rate_limiter_t* rate_limiter[n];
+    dsp_quantization_t* quantizer[3][n];
+    dsp_schmitt_trigger_t* trigger[n];
+    dsp_schmitt_quantization_t* schmitt_quantizer[n];
+    real_t u[n], y[n], y_dz[n], y_st[n], y_sq[n], y_q[3][n];
+
+    bool passed = true;
+    for (size_t i = 0; i < 2; ++i) {
+        if (!dsp_simd_is_supported(isas[i])) { continue; }
+        dsp_simd_select(isas[i]);
+
+        unsigned int seed = 3;
+        dsp_saturation_bank_t* const saturation_bank = dsp_saturation_bank_create(n, 1, -1);
+        dsp_dead_zone_bank_t* const dead_zone_bank = dsp_dead_zone_bank_create(n, 0.5f, -0.5f);
+        dsp_rate_limiter_bank_t* const rate_limiter_bank = dsp_rate_limiter_bank_create(n, 10, -10, 0.01f, 0);
+        dsp_quantization_bank_t* quantizer_bank[3];
+        for (size_t m = 0; m < 3; ++m) { quantizer_bank[m] = dsp_quantizer_bank_create(n, 0, 1, (rounding_method_t) m); }
+        dsp_schmitt_trigger_t* const prototype = dsp_schmitt_trigger_create(-0.5f, 0.5f, 0, 1, false, false);
+        dsp_schmitt_trigger_bank_t* const trigger_bank = dsp_schmitt_trigger_bank_create(n, prototype);
+        dsp_schmitt_quantization_t* const quantizer_prototype = dsp_schmitt_quantizer_create_relative(0, 0.25f, 0.5f, 0.1f, 0);
+        dsp_schmitt_quantization_bank_t* const schmitt_quantizer_bank = dsp_schmitt_quantizer_bank_create(n, quantizer_prototype);
+        passed = passed && (saturation_bank != NULL) && (dead_zone_bank != NULL) && (rate_limiter_bank != NULL) && (trigger_bank != NULL) && (schmitt_quantizer_bank != NULL);
+
+        for (size_t k = 0; k < n && passed; ++k) {
+            const real_t limit = 0.5f + fabsf(noise(&seed));
+            saturation[k] = dsp_saturation_create(limit, -limit + 0.2f * noise(&seed));
+            dead_zone[k] = dsp_dead_zone_create(0.3f * limit, -0.2f * limit);
+            rate_limiter[k] = dsp_rate_limiter_create(20 * limit, -30 * limit, 0.01f, noise(&seed));
+            for (size_t m = 0; m < 3; ++m) {
+                quantizer[m][k] = dsp_quantizer_create(0.1f * noise(&seed), 0.05f * limit, (rounding_method_t) m);
+                passed = passed && dsp_quantizer_bank_set_channel(quantizer_bank[m], k, quantizer[m][k]->offset, quantizer[m][k]->interval);
+            }
+            trigger[k] = dsp_schmitt_trigger_create(-0.3f * limit, 0.2f * limit, -limit, limit, (k & 1) != 0, (k & 2) != 0);
+            schmitt_quantizer[k] = dsp_schmitt_quantizer_create_relative(0.1f * noise(&seed), 0.1f * limit, 0.5f, 0.1f, noise(&seed));
+            passed = passed &&
+                dsp_saturation_bank_set_channel(saturation_bank, k, saturation[k]) &&
+                dsp_dead_zone_bank_set_channel(dead_zone_bank, k, dead_zone[k]) &&
+                dsp_rate_limiter_bank_set_channel(rate_limiter_bank, k, rate_limiter[k]) &&
+                dsp_schmitt_trigger_bank_set_channel(trigger_bank, k, trigger[k]) &&
+                dsp_schmitt_quantizer_bank_set_channel(schmitt_quantizer_bank, k, schmitt_quantizer[k]);
+        }
+
+        // Saturation, rate limitation and quantization chained in place, the others side by side
+        for (size_t step = 0; step < 300 && passed; ++step) {
+            for (size_t k = 0; k < n; ++k) { u[k] = 2 * noise(&seed); }
+            passed = passed && dsp_dead_zone_bank_update(dead_zone_bank, u, y_dz);
+            passed = passed && dsp_schmitt_trigger_bank_update(trigger_bank, u, y_st);
+            passed = passed && dsp_schmitt_quantizer_bank_update(schmitt_quantizer_bank, u, y_sq);
+            for (size_t m = 0; m < 3; ++m) { passed = passed && dsp_quantizer_bank_update(quantizer_bank[m], u, y_q[m]); }
+            passed = passed && dsp_saturation_bank_update(saturation_bank, u, y);
+            passed = passed && dsp_rate_limiter_bank_update(rate_limiter_bank, y, y);
+            for (size_t k = 0; k < n; ++k) {
+                const real_t chained = dsp_rate_limiter_update(rate_limiter[k], dsp_saturation_update(saturation[k], u[k]));
+                passed = passed && (chained == y[k]);
+                passed = passed && (dsp_dead_zone_update(dead_zone[k], u[k]) == y_dz[k]);
+                passed = passed && (dsp_schmitt_trigger_update(trigger[k], u[k]) == y_st[k]);
+                passed = passed && (dsp_schmitt_quantizer_update(schmitt_quantizer[k], u[k]) == y_sq[k]);
+                for (size_t m = 0; m < 3; ++m) { passed = passed && (dsp_quantizer_update(quantizer[m][k], u[k]) == y_q[m][k]); }
+            }
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            dsp_saturation_destroy(saturation[k]);
+            dsp_dead_zone_destroy(dead_zone[k]);
+            dsp_rate_limiter_destroy(rate_limiter[k]);
+            for (size_t m = 0; m < 3; ++m) { dsp_quantizer_destroy(quantizer[m][k]); }
+            dsp_schmitt_trigger_destroy(trigger[k]);
+            dsp_schmitt_quantizer_destroy(schmitt_quantizer[k]);
+        }
+        dsp_saturation_bank_destroy(saturation_bank);
+        dsp_dead_zone_bank_destroy(dead_zone_bank);
+        dsp_rate_limiter_bank_destroy(rate_limiter_bank);
+        for (size_t m = 0; m < 3; ++m) { dsp_quantizer_bank_destroy(quantizer_bank[m]); }
+        dsp_schmitt_trigger_destroy(prototype);
+        dsp_schmitt_trigger_bank_destroy(trigger_bank);
+        dsp_schmitt_quantizer_destroy(quantizer_prototype);
+        dsp_schmitt_quantizer_bank_destroy(schmitt_quantizer_bank);
+    }
+    dsp_simd_select(default_isa);
+
+    printf("discontinuous_bank: %s\n", (passed ? "passed" : "FAILED"));
+    return passed;
+}
+
+bool test_zss_bank() {
+
+    // 70 lanes: one tile with a remainder, ranges of whole cache lines for the threads
+    enum { nx = 3, nu = 2, ny = 2, lanes = 70 };
+    unsigned int seed = 17;
+    dsp_zss_t* models[lanes] = {NULL}; // Lanes after a failed creation stay NULL for the cleanup
+    real_t u[nu * lanes], y[ny * lanes], u_lane[nu], y_lane[ny], x[nx];
+
+    dsp_zss_bank_t* const bank = dsp_zss_bank_create(nx, nu, ny, lanes);
+    bool passed = (bank != NULL);
+    for (size_t l = 0; l < lanes && passed; ++l) {
+        real_t a[nx * nx], b[nx * nu], c[ny * nx], d[ny * nu], x0[nx];
+        for (size_t i = 0; i < nx * nx; ++i) { a[i] = 0.5f * noise(&seed); }
+        for (size_t i = 0; i < nx * nu; ++i) { b[i] = noise(&seed); }
+        for (size_t i = 0; i < ny * nx; ++i) { c[i] = noise(&seed); }
+        for (size_t i = 0; i < ny * nu; ++i) { d[i] = noise(&seed); }
+        for (size_t i = 0; i < nx; ++i) { x0[i] = noise(&seed); }
+        models[l] = dsp_zss_create_from_arrays(nx, nu, ny, a, b, c, d, x0);
+        passed = passed && (models[l] != NULL) && dsp_zss_bank_set_lane(bank, l, models[l]);
+    }
+
+    // Same trajectories as every model on its own, serial and threaded
+    for (size_t k = 0; k < 100 && passed; ++k) {
+        for (size_t i = 0; i < nu * lanes; ++i) { u[i] = noise(&seed); }
+        passed = passed && (k % 2 == 0 ? dsp_zss_bank_update(bank, u, y) : dsp_zss_bank_update_parallel(bank, u, y, 3));
+        for (size_t l = 0; l < lanes; ++l) {
+            for (size_t j = 0; j < nu; ++j) { u_lane[j] = u[j * lanes + l]; }
+            passed = passed && dsp_zss_update(models[l], u_lane, y_lane);
+            for (size_t i = 0; i < ny; ++i) { passed = passed && (fabsf(y[i * lanes + l] - y_lane[i]) < 1e-4f); }
+        }
+    }
+    for (size_t l = 0; l < lanes && passed; ++l) {
+        passed = dsp_zss_bank_get_state(bank, l, x);
+        for (size_t i = 0; i < nx; ++i) { passed = passed && (fabsf(x[i] - models[l]->x->elements[i]) < 1e-4f); }
+    }
+
+    printf("zss_bank: %s\n", (passed ? "passed" : "FAILED"));
+    for (size_t l = 0; l < lanes; ++l) { dsp_zss_destroy(models[l]); }
+    dsp_zss_bank_destroy(bank);
+    return passed;
+}
+
+
+
+bool test_executor() {
+
+    // Ranges of whole cache lines (16 floats) on 3 workers: the last worker gets a short range
+    enum { n = 100, nx = 2 };
+    const size_t line = 64 / sizeof(real_t);
+    const size_t chunk = ((n + 2) / 3 + line - 1) / line * line;
+    unsigned int seed = 23;
+    real_t u[n], y[n], y_serial[n], num[3], den[3];
+
+    dsp_executor_t* const executor = dsp_executor_create(3, NULL);
+    dsp_pid_bank_t* const pids = dsp_pid_bank_create(n);
+    dsp_pid_bank_t* const pids_serial = dsp_pid_bank_create(n);
+    dsp_ztf_bank_t* const ztfs = dsp_ztf_bank_create(2, n, false);
+    dsp_ztf_bank_t* const ztfs_serial = dsp_ztf_bank_create(2, n, false);
+    dsp_zss_bank_t* const zss = dsp_zss_bank_create(nx, 1, 1, n);
+    dsp_zss_bank_t* const zss_serial = dsp_zss_bank_create(nx, 1, 1, n);
+    bool passed = (executor != NULL && pids != NULL && pids_serial != NULL && ztfs != NULL && ztfs_serial != NULL && zss != NULL && zss_serial != NULL);
+    passed = passed && dsp_executor_set_inline_threshold(executor, 0);
+
+    for (size_t k = 0; k < n && passed; ++k) {
+        dsp_pid_t* const pid = dsp_pid_create_and_configure(0.01f, 2 + noise(&seed), 10, 0.1f, 20, true, 1, -1, false, 0, 0, true, 2, false, 0);
+        passed = (pid != NULL) && dsp_pid_bank_set_controller(pids, k, pid) && dsp_pid_bank_set_controller(pids_serial, k, pid);
+        dsp_pid_destroy(pid);
+
+        num[0] = noise(&seed); num[1] = noise(&seed); num[2] = noise(&seed);
+        den[0] = 1; den[1] = -0.5f + 0.1f * noise(&seed); den[2] = 0.1f * noise(&seed);
+        passed = passed && dsp_ztf_bank_set_channel_coefficients(ztfs, k, num, den) && dsp_ztf_bank_set_channel_coefficients(ztfs_serial, k, num, den);
+
+        const real_t a[nx * nx] = {0.5f * noise(&seed), 0.1f, -0.1f, 0.5f * noise(&seed)};
+        const real_t b[nx] = {noise(&seed), noise(&seed)};
+        const real_t c[nx] = {noise(&seed), noise(&seed)};
+        const real_t d[1] = {noise(&seed)};
+        dsp_zss_t* const model = dsp_zss_create_from_arrays(nx, 1, 1, a, b, c, d, NULL);
+        passed = passed && (model != NULL) && dsp_zss_bank_set_lane(zss, k, model) && dsp_zss_bank_set_lane(zss_serial, k, model);
+        dsp_zss_destroy(model);
+    }
+
+    // Partitioned ticks give the same results as the serial ones, bit for bit
+    for (size_t step = 0; step < 50 && passed; ++step) {
+        for (size_t k = 0; k < n; ++k) { u[k] = noise(&seed); }
+        passed = dsp_executor_pid_bank_update(executor, pids, u, y) && dsp_pid_bank_update(pids_serial, u, y_serial) && (memcmp(y, y_serial, sizeof(y)) == 0);
+        passed = passed && dsp_executor_ztf_bank_update(executor, ztfs, u, y) && dsp_ztf_bank_update(ztfs_serial, u, y_serial) && (memcmp(y, y_serial, sizeof(y)) == 0);
+        passed = passed && dsp_executor_zss_bank_update(executor, zss, u, y) && dsp_zss_bank_update(zss_serial, u, y_serial) && (memcmp(y, y_serial, sizeof(y)) == 0);
+    }
+
+    // Every worker took part in every tick (floats: 48 items each, the last worker: 4; without threads the caller does all)
+    dsp_executor_stats_t stats;
+    const size_t workers = dsp_executor_workers(executor);
+    for (size_t w = 0; w < workers && passed; ++w) {
+        passed = dsp_executor_get_stats(executor, w, &stats) && (stats.ticks == 150) && (stats.items == 150 * (workers == 1 ? n : (w == 2 ? n - 2 * chunk : chunk)));
+    }
+
+    // Small banks run on the caller only
+    passed = passed && dsp_executor_reset_stats(executor) && dsp_executor_set_inline_threshold(executor, DSP_EXECUTOR_INLINE_ITEMS);
+    passed = passed && dsp_executor_pid_bank_update(executor, pids, u, y) && dsp_executor_get_stats(executor, 0, &stats) && (stats.items == n);
+    passed = passed && (workers == 1 || (dsp_executor_get_stats(executor, 1, &stats) && stats.ticks == 0));
+
+    printf("executor: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_zss_bank_destroy(zss_serial);
+    dsp_zss_bank_destroy(zss);
+    dsp_ztf_bank_destroy(ztfs_serial);
+    dsp_ztf_bank_destroy(ztfs);
+    dsp_pid_bank_destroy(pids_serial);
+    dsp_pid_bank_destroy(pids);
+    dsp_executor_destroy(executor);
+    return passed;
+}
+
+
+
+static void task_graph_sum(void* const context, const real_t* const in, real_t* const out) {
+    (void) context;
+    out[0] = in[0] + in[1] + in[2] + in[3];
+}
+
+bool test_task_graph() {
+
+    // Per channel: r -> ztf -> pid -> saturation, an observer on channels 0 and 1, a sum of the rest
+    enum { channels = 4, sets = 2 };
+    const real_t a[4] = {0.9f, 0.1f, 0, 0.8f}, b[4] = {0.1f, 0, 0, 0.1f}, c[4] = {1, 0, 0, 1}, d[4] = {0}, l[4] = {0.2f, 0, 0, 0.2f};
+    dsp_ztf_t* ztf[sets][channels];
+    dsp_pid_t* pid[sets][channels];
+    dsp_saturation_t* saturation[sets][channels];
+    dsp_zso_t* zso[sets];
+    unsigned int seed = 29;
+
+    for (size_t k = 0; k < sets; ++k) {
+        for (size_t ch = 0; ch < channels; ++ch) {
+            ztf[k][ch] = dsp_ztf_create_lowpass_filter(1, 0.05f * (ch + 1), 0.01f, 0, 0);
+            pid[k][ch] = dsp_pid_create_and_configure(0.01f, 2, 10, 0.1f, 20, false, 0, 0, false, 0, 0, false, 0, false, 0);
+            saturation[k][ch] = dsp_saturation_create(1, -1);
+        }
+        zso[k] = dsp_zso_create_from_arrays(2, 2, 2, a, b, c, d, l, NULL);
+    }
+
+    dsp_executor_t* const executor = dsp_executor_create(3, NULL);
+    dsp_task_graph_t* const graph = dsp_task_graph_create(19, 20);
+    bool passed = (executor != NULL && graph != NULL);
+
+    // Added out of order on purpose
+    const size_t zso_u[2] = {12, 13}, zso_y[2] = {4, 5}, zso_xh[2] = {16, 17}, sum_in[4] = {16, 17, 14, 15}, sum_out[1] = {18};
+    passed = passed && dsp_task_graph_add_function(graph, task_graph_sum, NULL, 4, sum_in, 1, sum_out);
+    passed = passed && dsp_task_graph_add_zso(graph, zso[0], zso_u, zso_y, zso_xh);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        passed = passed && dsp_task_graph_add_saturation(graph, saturation[0][ch], 8 + ch, 12 + ch);
+        passed = passed && dsp_task_graph_add_pid(graph, pid[0][ch], 4 + ch, 8 + ch);
+        passed = passed && dsp_task_graph_add_ztf(graph, ztf[0][ch], ch, 4 + ch);
+    }
+
+    // A signal has only one writer
+    passed = passed && !dsp_task_graph_add_ztf(graph, ztf[1][0], 0, 4);
+    passed = passed && dsp_task_graph_compile(graph, executor);
+
+    // Same signals as the blocks updated one after the other
+    real_t r[channels], f[channels], p[channels], sat[channels], xh[2];
+    for (size_t step = 0; step < 200 && passed; ++step) {
+        for (size_t ch = 0; ch < channels; ++ch) { r[ch] = noise(&seed); passed = passed && dsp_task_graph_set_signal(graph, ch, r[ch]); }
+        passed = passed && dsp_task_graph_tick(graph);
+
+        for (size_t ch = 0; ch < channels; ++ch) {
+            f[ch] = dsp_ztf_update(ztf[1][ch], r[ch]);
+            p[ch] = dsp_pid_update(pid[1][ch], f[ch]);
+            sat[ch] = dsp_saturation_update(saturation[1][ch], p[ch]);
+            passed = passed && (dsp_task_graph_get_signal(graph, 12 + ch) == sat[ch]);
+        }
+        dsp_zso_update(zso[1], sat, f, xh);
+        passed = passed && (dsp_task_graph_get_signal(graph, 18) == xh[0] + xh[1] + sat[2] + sat[3]);
+    }
+
+    // Every block ran in every tick
+    dsp_task_stats_t stats;
+    for (size_t k = 0; k < 2 + 3 * channels && passed; ++k) {
+        passed = dsp_task_graph_get_stats(graph, k, &stats) && (stats.ticks == 200) && (stats.worker < dsp_executor_workers(executor));
+    }
+
+    // Cycles can't be scheduled, even through a block with a state
+    dsp_task_graph_t* const loop = dsp_task_graph_create(2, 2);
+    const size_t s0 = 0, s1 = 1;
+    passed = passed && dsp_task_graph_add_function(loop, task_graph_sum, NULL, 1, &s0, 1, &s1) && dsp_task_graph_add_function(loop, task_graph_sum, NULL, 1, &s1, 1, &s0);
+    passed = passed && !dsp_task_graph_compile(loop, NULL) && !dsp_task_graph_tick(loop);
+    dsp_task_graph_t* const cycle = dsp_task_graph_create(2, 2);
+    passed = passed && dsp_task_graph_add_ztf(cycle, ztf[0][0], s0, s1) && dsp_task_graph_add_function(cycle, task_graph_sum, NULL, 1, &s1, 1, &s0);
+    passed = passed && !dsp_task_graph_compile(cycle, NULL);
+
+    printf("task_graph: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_task_graph_destroy(cycle);
+    dsp_task_graph_destroy(loop);
+    dsp_task_graph_destroy(graph);
+    dsp_executor_destroy(executor);
+    for (size_t k = 0; k < sets; ++k) {
+        for (size_t ch = 0; ch < channels; ++ch) {
+            dsp_ztf_destroy(ztf[k][ch]);
+            dsp_pid_destroy(pid[k][ch]);
+            dsp_saturation_destroy(saturation[k][ch]);
+        }
+        dsp_zso_destroy(zso[k]);
+    }
+    return passed;
+}
+
+
+
+static void block_diagram_gain(void* const context, const real_t* const in, real_t* const out) {
+    out[0] = *((const real_t*) context) * in[0];
+}
+
+bool test_block_diagram() {
+
+    enum { sets = 2, samples = 8 };
+    const real_t gains[2] = {1, -1}, gain = 0.5f;
+    const real_t a[4] = {1, 0.01f, -0.1f, 0.98f}, b[2] = {0, 0.01f}, c[2] = {1, 0}, d[1] = {0};
+    const real_t a2[4] = {0.5f, 0.1f, 0, 0.7f}, b2[4] = {1, 0, 0, 1}, c2[4] = {1, 0.5f, 0, 1}, d2[4] = {0.1f, 0, 0, 0.2f};
+    dsp_pid_t* pid[sets];
+    dsp_saturation_t* saturation[sets];
+    dsp_zss_t* plant[sets];
+    dsp_ztf_t* ztf[sets];
+    dsp_dead_zone_t* dead_zone[sets];
+    dsp_zss_t* model[sets];
+    dsp_pid_t* pi[sets];
+    dsp_ztf_t* pt1[sets];
+    for (size_t k = 0; k < sets; ++k) {
+        pid[k] = dsp_pid_create_and_configure(0.01f, 5, 2, 0.1f, 20, false, 0, 0, false, 0, 0, false, 0, false, 0);
+        saturation[k] = dsp_saturation_create(2, -2);
+        plant[k] = dsp_zss_create_from_arrays(2, 1, 1, a, b, c, d, NULL);
+        ztf[k] = dsp_ztf_create_lowpass_filter(1, 0.05f, 0.01f, 0, 0);
+        dead_zone[k] = dsp_dead_zone_create(0.1f, -0.1f);
+        model[k] = dsp_zss_create_from_arrays(2, 2, 2, a2, b2, c2, d2, NULL);
+        pi[k] = dsp_pid_create_and_configure(0.01f, 2, 1, 0, 20, false, 0, 0, false, 0, 0, false, 0, false, 0);
+        pt1[k] = dsp_ztf_create_PT1(1, 0.1f, 0.01f, 0, 0);
+    }
+    unsigned int seed = 31;
+
+    // Control loop, closed through the plant without feedthrough: runs sample by sample
+    size_t r, error, controller, actuator, system, y;
+    dsp_diagram_t* const loop = dsp_diagram_create(8, samples);
+    bool passed = (loop != NULL);
+    passed = passed && dsp_diagram_add_input(loop, 1, &r) && dsp_diagram_add_sum(loop, 2, gains, &error) && dsp_diagram_add_pid(loop, pid[0], &controller);
+    passed = passed && dsp_diagram_add_saturation(loop, saturation[0], &actuator) && dsp_diagram_add_zss(loop, plant[0], &system) && dsp_diagram_add_output(loop, 1, &y);
+    passed = passed && dsp_diagram_connect(loop, r, 0, error, 0) && dsp_diagram_connect(loop, system, 0, error, 1);
+    passed = passed && dsp_diagram_connect(loop, error, 0, controller, 0) && dsp_diagram_connect(loop, controller, 0, actuator, 0);
+    passed = passed && !dsp_diagram_compile(loop); // plant input unconnected
+    passed = passed && dsp_diagram_connect(loop, actuator, 0, system, 0) && dsp_diagram_connect(loop, system, 0, y, 0);
+    passed = passed && !dsp_diagram_connect(loop, r, 0, system, 0); // already connected
+    passed = passed && dsp_diagram_compile(loop);
+
+    real_t u = 0, plant_y;
+    for (size_t block = 0; block < 25 && passed; ++block) {
+        real_t* const in = dsp_diagram_input(loop, r);
+        for (size_t j = 0; j < samples; ++j) { in[j] = 1 + 0.1f * noise(&seed); }
+        passed = dsp_diagram_process(loop, samples);
+        const real_t* const out = dsp_diagram_output(loop, y);
+        for (size_t j = 0; j < samples; ++j) {
+            dsp_zss_get_output(plant[1], &u, &plant_y);
+            u = dsp_saturation_update(saturation[1], dsp_pid_update(pid[1], in[j] - plant_y));
+            dsp_zss_update_state(plant[1], &u);
+            passed = passed && (out[j] == plant_y);
+        }
+    }
+    passed = passed && (plant[0]->x->elements[0] == plant[1]->x->elements[0]) && (plant[0]->x->elements[1] == plant[1]->x->elements[1]);
+
+    // Chain without feedback: runs block by block
+    size_t r1, r2, filter, dead, mux, mimo, demux, sum, scale, out1;
+    dsp_diagram_t* const chain = dsp_diagram_create(10, samples);
+    passed = passed && (chain != NULL);
+    passed = passed && dsp_diagram_add_input(chain, 1, &r1) && dsp_diagram_add_input(chain, 1, &r2) && dsp_diagram_add_ztf(chain, ztf[0], &filter);
+    passed = passed && dsp_diagram_add_dead_zone(chain, dead_zone[0], &dead) && dsp_diagram_add_mux(chain, 2, &mux) && dsp_diagram_add_zss(chain, model[0], &mimo);
+    passed = passed && dsp_diagram_add_demux(chain, 2, &demux) && dsp_diagram_add_sum(chain, 2, NULL, &sum);
+    passed = passed && dsp_diagram_add_function(chain, block_diagram_gain, (void*) &gain, 1, 1, &scale) && dsp_diagram_add_output(chain, 1, &out1);
+    passed = passed && !dsp_diagram_connect(chain, r1, 0, mimo, 0); // width 1 into width 2
+    passed = passed && dsp_diagram_connect(chain, r1, 0, filter, 0) && dsp_diagram_connect(chain, filter, 0, dead, 0);
+    passed = passed && dsp_diagram_connect(chain, dead, 0, mux, 0) && dsp_diagram_connect(chain, r2, 0, mux, 1) && dsp_diagram_connect(chain, mux, 0, mimo, 0);
+    passed = passed && dsp_diagram_connect(chain, mimo, 0, demux, 0) && dsp_diagram_connect(chain, demux, 0, sum, 0) && dsp_diagram_connect(chain, demux, 1, sum, 1);
+    passed = passed && dsp_diagram_connect(chain, sum, 0, scale, 0) && dsp_diagram_connect(chain, scale, 0, out1, 0);
+    passed = passed && dsp_diagram_compile(chain);
+
+    real_t model_u[2], model_y[2];
+    for (size_t block = 0; block < 25 && passed; ++block) {
+        real_t* const in1 = dsp_diagram_input(chain, r1);
+        real_t* const in2 = dsp_diagram_input(chain, r2);
+        for (size_t j = 0; j < samples; ++j) { in1[j] = noise(&seed); in2[j] = noise(&seed); }
+        passed = (block % 2 == 0 ? dsp_diagram_process(chain, samples) : dsp_diagram_step(chain));
+        const real_t* const out = dsp_diagram_output(chain, out1);
+        for (size_t j = 0; j < (block % 2 == 0 ? samples : 1); ++j) {
+            model_u[0] = dsp_dead_zone_update(dead_zone[1], dsp_ztf_update(ztf[1], in1[j]));
+            model_u[1] = in2[j];
+            dsp_zss_update(model[1], model_u, model_y);
+            passed = passed && (out[j] == gain * (model_y[0] + model_y[1]));
+        }
+    }
+
+    // Control loop, closed through a strictly proper transfer function (b[0] = 0)
+    size_t w, deviation, compensator, lag, z;
+    dsp_diagram_t* const feedback = dsp_diagram_create(5, samples);
+    passed = passed && (feedback != NULL);
+    passed = passed && dsp_diagram_add_input(feedback, 1, &w) && dsp_diagram_add_sum(feedback, 2, gains, &deviation) && dsp_diagram_add_pid(feedback, pi[0], &compensator);
+    passed = passed && dsp_diagram_add_ztf(feedback, pt1[0], &lag) && dsp_diagram_add_output(feedback, 1, &z);
+    passed = passed && dsp_diagram_connect(feedback, w, 0, deviation, 0) && dsp_diagram_connect(feedback, lag, 0, deviation, 1);
+    passed = passed && dsp_diagram_connect(feedback, deviation, 0, compensator, 0) && dsp_diagram_connect(feedback, compensator, 0, lag, 0);
+    passed = passed && dsp_diagram_connect(feedback, lag, 0, z, 0) && dsp_diagram_compile(feedback);
+
+    real_t lag_y;
+    for (size_t block = 0; block < 25 && passed; ++block) {
+        real_t* const in = dsp_diagram_input(feedback, w);
+        for (size_t j = 0; j < samples; ++j) { in[j] = 1 + 0.1f * noise(&seed); }
+        passed = dsp_diagram_process(feedback, samples);
+        const real_t* const out = dsp_diagram_output(feedback, z);
+        for (size_t j = 0; j < samples; ++j) {
+            lag_y = dsp_ztf_next_output(pt1[1]);
+            passed = passed && (dsp_ztf_update(pt1[1], dsp_pid_update(pi[1], in[j] - lag_y)) == lag_y);
+            passed = passed && (out[j] == lag_y);
+        }
+    }
+    passed = passed && (dsp_ztf_output(pt1[0]) == dsp_ztf_output(pt1[1])) && (lag_y > 0.5f);
+
+    // Algebraic loop: the pid has feedthrough
+    size_t s, p;
+    dsp_diagram_t* const algebraic = dsp_diagram_create(2, 1);
+    passed = passed && dsp_diagram_add_sum(algebraic, 1, NULL, &s) && dsp_diagram_add_pid(algebraic, pid[0], &p);
+    passed = passed && dsp_diagram_connect(algebraic, s, 0, p, 0) && dsp_diagram_connect(algebraic, p, 0, s, 0);
+    passed = passed && !dsp_diagram_compile(algebraic) && !dsp_diagram_step(algebraic);
+
+    printf("block_diagram: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_diagram_destroy(algebraic);
+    dsp_diagram_destroy(feedback);
+    dsp_diagram_destroy(chain);
+    dsp_diagram_destroy(loop);
+    for (size_t k = 0; k < sets; ++k) {
+        dsp_pid_destroy(pid[k]);
+        dsp_saturation_destroy(saturation[k]);
+        dsp_zss_destroy(plant[k]);
+        dsp_ztf_destroy(ztf[k]);
+        dsp_dead_zone_destroy(dead_zone[k]);
+        dsp_zss_destroy(model[k]);
+        dsp_pid_destroy(pi[k]);
+        dsp_ztf_destroy(pt1[k]);
+    }
+    return passed;
+}
+
+
+
+// Coefficients (b0, b1, b2, a0, a1, a2) of the sections of a digital Butterworth lowpass filter of even order
+// (bilinear transform, 'cutoff' relative to the sample rate, unit gain at DC)
+static void butterworth_sections(const size_t order, const double cutoff, double* const sos) {
+    const double wc = 2 * tan(3.14159265358979 * cutoff);
+    for (size_t k = 0; k < order / 2; ++k) {
+
+        // Analog pole s and digital pole z = (1 + s/2) / (1 - s/2)
+        const double theta = 3.14159265358979 * (double) (2 * k + order + 1) / (double) (2 * order);
+        const double sr = wc * cos(theta), si = wc * sin(theta);
+        const double nr = 1 + sr / 2, ni = si / 2, dr = 1 - sr / 2, di = -si / 2;
+        const double d = dr * dr + di * di;
+        const double zr = (nr * dr + ni * di) / d, zi = (ni * dr - nr * di) / d;
+
+        double* const section = &sos[6 * k];
+        section[3] = 1;
+        section[4] = -2 * zr;
+        section[5] = zr * zr + zi * zi;
+        section[0] = (1 + section[4] + section[5]) / 4;
+        section[1] = 2 * section[0];
+        section[2] = section[0];
+    }
+}
+
+// Expand sections into numerator and denominator of a transfer function
+static void expand_sections(const size_t sections, const double* const sos, real_t* const num, real_t* const den) {
+    double b[2 * 8 + 1] = {1}, a[2 * 8 + 1] = {1};
+    for (size_t k = 0; k < sections; ++k) {
+        for (size_t i = 2 * k + 3; i-- > 0;) {
+            double bi = 0, ai = 0;
+            for (size_t j = 0; j < 3 && j <= i; ++j) {
+                bi += sos[6 * k + j] * b[i - j];
+                ai += sos[6 * k + 3 + j] * a[i - j];
+            }
+            b[i] = bi;
+            a[i] = ai;
+        }
+    }
+    for (size_t i = 0; i <= 2 * sections; ++i) { num[i] = (real_t) b[i]; den[i] = (real_t) a[i]; }
+}
+
+// Step response of sections in double precision
+static double sections_step(const size_t sections, const double* const sos, double* const state) {
+    double x = 1;
+    for (size_t k = 0; k < sections; ++k) {
+        const double* const c = &sos[6 * k];
+        const double y = c[0] * x + state[2 * k];
+        state[2 * k] = c[1] * x - c[4] * y + state[2 * k + 1];
+        state[2 * k + 1] = c[2] * x - c[5] * y;
+        x = y;
+    }
+    return x;
+}
+
+bool test_sos() {
+    bool passed = true;
+
+    // Order 4 from two known sections and with a delay, against the zTransferFunction
+    {
+        const double sos[12] = {0.2, 0.4, 0.2, 1, -0.5, 0.3, 1, -1, 0.5, 1, 0.2, 0.1};
+        real_t num[5], den[5];
+        expand_sections(2, sos, num, den);
+        const real_t delayed_num[4] = {0, 0.5f, 0.25f, 0};
+        const real_t delayed_den[4] = {1, -0.9f, 0.2f, 0.1f};
+
+        dsp_sos_t* const cascade = dsp_sos_create_from_tf(4, num, den);
+        dsp_sos_t* const delayed = dsp_sos_create_from_tf(3, delayed_num, delayed_den);
+        dsp_ztf_t* const ztf = dsp_ztf_create_from_arrays(4, num, den, NULL, NULL);
+        dsp_ztf_t* const delayed_ztf = dsp_ztf_create_from_arrays(3, delayed_num, delayed_den, NULL, NULL);
+        passed = passed && cascade != NULL && delayed != NULL && ztf != NULL && delayed_ztf != NULL;
+        passed = passed && cascade->sections == 2 && delayed->sections == 2;
+
+        for (size_t k = 0; passed && k < 100; ++k) {
+            const real_t u = (k == 0 ? 1 : 0);
+            passed = passed && fabsf(dsp_sos_update(cascade, u) - dsp_ztf_update(ztf, u)) < 1e-5f;
+            passed = passed && fabsf(dsp_sos_update(delayed, u) - dsp_ztf_update(delayed_ztf, u)) < 1e-5f;
+        }
+
+        // Polynomials of different orders, block processing in place
+        const real_t p_num[3] = {0.2f, 0.4f, 0.2f};
+        const dsp_poly_t num_poly = {2, (real_t*) p_num};
+        const dsp_poly_t den_poly = {4, den};
+        dsp_sos_t* const from_poly = dsp_sos_create_from_poly(&num_poly, &den_poly);
+        dsp_ztf_t* const padded = dsp_ztf_create_from_arrays(4, (const real_t[5]) {0.2f, 0.4f, 0.2f, 0, 0}, den, NULL, NULL);
+        passed = passed && from_poly != NULL && padded != NULL;
+
+        real_t block[64];
+        unsigned int seed = 19;
+        for (size_t k = 0; k < 64; ++k) { block[k] = noise(&seed); }
+        passed = passed && dsp_sos_process_block(from_poly, block, block, 64);
+        seed = 19;
+        for (size_t k = 0; passed && k < 64; ++k) { passed = passed && fabsf(block[k] - dsp_ztf_update(padded, noise(&seed))) < 1e-4f; }
+
+        dsp_sos_destroy(cascade);
+        dsp_sos_destroy(delayed);
+        dsp_sos_destroy(from_poly);
+        dsp_ztf_destroy(ztf);
+        dsp_ztf_destroy(delayed_ztf);
+        dsp_ztf_destroy(padded);
+    }
+
+    // Order 12 in float: narrow lowpass from its sections, wider one factored from the transfer function
+    {
+        double narrow[36], wide[36];
+        butterworth_sections(12, 0.01, narrow);
+        butterworth_sections(12, 0.1, wide);
+
+        real_t narrow_sos[36], num[13], den[13];
+        for (size_t i = 0; i < 36; ++i) { narrow_sos[i] = (real_t) narrow[i]; }
+        expand_sections(6, wide, num, den);
+
+        dsp_sos_t* const from_arrays = dsp_sos_create_from_arrays(6, narrow_sos);
+        dsp_sos_t* const from_tf = dsp_sos_create_from_tf(12, num, den);
+        passed = passed && from_arrays != NULL && from_tf != NULL && from_tf->sections == 6;
+
+        double narrow_state[12] = {0}, wide_state[12] = {0};
+        real_t step[500];
+        for (size_t k = 0; passed && k < 5000; k += 500) {
+            for (size_t i = 0; i < 500; ++i) { step[i] = 1; }
+            passed = passed && dsp_sos_process_block(from_arrays, step, step, 500);
+            for (size_t i = 0; passed && i < 500; ++i) {
+                passed = passed && fabs(step[i] - sections_step(6, narrow, narrow_state)) < 1e-3;
+                passed = passed && fabs(dsp_sos_update(from_tf, 1) - sections_step(6, wide, wide_state)) < 1e-2;
+            }
+        }
+        passed = passed && fabsf(step[499] - 1) < 1e-3f;
+
+        dsp_sos_destroy(from_arrays);
+        dsp_sos_destroy(from_tf);
+    }
+
+    // Invalid parameters
+    passed = passed && dsp_sos_create(0) == NULL;
+    passed = passed && dsp_sos_create_from_tf(2, NULL, (const real_t[3]) {0, 1, 1}) == NULL;
+    passed = passed && !dsp_sos_process_block(NULL, NULL, NULL, 0);
+
+    printf("sos: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+
+
+// Step response of a PT1 with its pole at 1 - 2^-18 (exact in float) as ztf, zss and zso.
+// With the states in accum_t the mixed precision build stays as close to the exact response as the double build.
+bool test_slow_pole() {
+    enum { samples = 1 << 18 };
+    const real_t b = 1.0f / samples, a = 1 - b, one = 1, zero = 0;
+    const double exact = 1 - pow((double) a, samples - 1);
+    const double tolerance = (sizeof(accum_t) == sizeof(double) ? 1e-6 : 1e-3);
+
+    dsp_ztf_t* const ztf = dsp_ztf_create_from_arrays(1, (const real_t[2]) {0, b}, (const real_t[2]) {1, -a}, NULL, NULL);
+    dsp_zss_t* const zss = dsp_zss_create_from_arrays(1, 1, 1, &a, &b, &one, &zero, NULL);
+    dsp_zso_t* const zso = dsp_zso_create_from_arrays(1, 1, 1, &a, &b, &one, &zero, &zero, NULL);
+    bool passed = (ztf != NULL && zss != NULL && zso != NULL);
+
+    real_t ztf_y = 0, zss_y = 0, zso_x = 0;
+    for (size_t k = 0; passed && k < samples; ++k) {
+        ztf_y = dsp_ztf_update(ztf, 1);
+        passed = dsp_zss_update(zss, &one, &zss_y) && dsp_zso_update(zso, &one, &zero, &zso_x);
+    }
+    passed = passed && fabs(ztf_y - exact) < tolerance && fabs(zss_y - exact) < tolerance && fabs(zso_x - exact) < tolerance;
+
+    // The state survives a copy
+    dsp_zss_t* const copy = dsp_zss_create_copy(zss);
+    real_t copy_y = 0;
+    passed = passed && copy != NULL && dsp_zss_update(zss, &one, &zss_y) && dsp_zss_update(copy, &one, &copy_y) && (copy_y == zss_y);
+
+    printf("slow_pole: %s\n", passed ? "passed" : "FAILED");
+    dsp_ztf_destroy(ztf);
+    dsp_zss_destroy(zss);
+    dsp_zss_destroy(copy);
+    dsp_zso_destroy(zso);
+    return passed;
+}
+
+
+bool test_perf_counters() {
+
+    // The measured call runs with and without the CMake option 'DSP_PERF_COUNTERS'
+    dsp_pid_t* const pid = dsp_pid_create_controller(0.01f, 2, 10, 0.1f, 20);
+    dsp_ztf_t* const ztf = dsp_ztf_create_lowpass_filter(1, 0.1f, 0.01f, 0, 0);
+    dsp_perf_t* const perf = dsp_perf_create(2);
+    dsp_perf_instance_t* const pid_perf = dsp_perf_instance(perf, pid, "pid");
+    dsp_perf_instance_t* const ztf_perf = dsp_perf_instance(perf, ztf, "ztf");
+
+    real_t y = 0, filtered = 0;
+    for (size_t k = 0; k < 100; ++k) {
+        DSP_PERF_MEASURE(perf, pid_perf, y = dsp_pid_update(pid, 1));
+        DSP_PERF_MEASURE(perf, ztf_perf, filtered = dsp_ztf_update(ztf, y));
+    }
+    bool passed = (pid != NULL && ztf != NULL && y > 2 && filtered > 0);
+
+#ifdef DSP_PERF_COUNTERS
+    // One instance per block, counters of every call
+    dsp_perf_stats_t stats;
+    passed = passed && (perf != NULL && pid_perf != NULL && ztf_perf != NULL && pid_perf != ztf_perf);
+    passed = passed && (dsp_perf_instance(perf, pid, "again") == pid_perf);
+    passed = passed && (dsp_perf_instance(perf, &y, "full") == NULL);
+    passed = passed && dsp_perf_get_stats(pid_perf, &stats) && (stats.calls == 100);
+    for (size_t e = 0; e < DSP_PERF_EVENTS; ++e) {
+        passed = passed && (dsp_perf_event_available(perf, (dsp_perf_event_t) e) || stats.counts[e] == 0);
+    }
+    passed = passed && dsp_perf_event_available(perf, PerfCycles) == (stats.counts[PerfCycles] > 0);
+
+    FILE* const report = tmpfile();
+    passed = passed && (report != NULL) && dsp_perf_report(perf, report) && (ftell(report) > 0);
+    if (report != NULL) { fclose(report); }
+
+    passed = passed && dsp_perf_reset(perf) && dsp_perf_get_stats(ztf_perf, &stats) && (stats.calls == 0 && stats.nanoseconds == 0);
+    passed = passed && !dsp_perf_get_stats(NULL, &stats) && (dsp_perf_instance(NULL, pid, "pid") == NULL);
+#else
+    passed = passed && (perf == NULL && pid_perf == NULL && ztf_perf == NULL);
+#endif
+
+    dsp_perf_destroy(perf);
+    dsp_ztf_destroy(ztf);
+    dsp_pid_destroy(pid);
+    printf("perf_counters: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+
+
+// Every worker records the durations 1 ... 1000 ticks
+static void latency_record_task(void* const context, const size_t first, const size_t count) {
+    (void) first;
+    (void) count;
+    for (uint64_t ticks = 1; ticks <= 1000; ++ticks) { dsp_latency_record((dsp_latency_t*) context, ticks); }
+}
+
+static bool within_bucket(const double value_ns, const uint64_t ticks) {
+    const double exact = dsp_latency_ticks_to_ns(ticks);
+    return value_ns >= exact * (1 - 1e-9) && value_ns <= exact * (1 + 1.0 / DSP_LATENCY_SUB_BUCKETS);
+}
+
+bool test_latency_histogram() {
+    dsp_pid_t* const pid = dsp_pid_create_controller(0.01f, 2, 10, 0.1f, 20);
+    dsp_latency_t* const histogram = dsp_latency_create(pid, "pid");
+    dsp_latency_stats_t stats;
+    bool passed = (pid != NULL && histogram != NULL && dsp_latency_block(histogram) == pid);
+
+    // Durations of known ticks: exact below 32 ticks, at most 1/32 above
+    passed = passed && dsp_latency_set_deadline(histogram, dsp_latency_ticks_to_ns(900));
+    for (uint64_t ticks = 1; ticks <= 1000 && passed; ++ticks) { dsp_latency_record(histogram, ticks); }
+    passed = passed && dsp_latency_get_stats(histogram, &stats) && (stats.count == 1000 && stats.overruns == 100);
+    passed = passed && within_bucket(stats.min_ns, 1) && within_bucket(stats.max_ns, 1000);
+    passed = passed && within_bucket(stats.p50_ns, 500) && within_bucket(stats.p99_ns, 990) && within_bucket(stats.p999_ns, 999);
+    passed = passed && fabs(stats.mean_ns - dsp_latency_ticks_to_ns(500) - dsp_latency_ticks_to_ns(1) / 2) < 1e-6 * stats.mean_ns;
+    passed = passed && fabs(stats.jitter_ns - (stats.p999_ns - stats.p50_ns)) < 1e-9;
+    passed = passed && dsp_latency_reset(histogram) && dsp_latency_get_stats(histogram, &stats) && (stats.count == 0 && stats.overruns == 0);
+    dsp_latency_record(histogram, 17);
+    passed = passed && dsp_latency_percentile(histogram, 0.5) == dsp_latency_ticks_to_ns(17);
+
+    // Lock-free recording from every worker at once
+    dsp_executor_t* const executor = dsp_executor_create(2, NULL);
+    passed = passed && (executor != NULL) && dsp_latency_reset(histogram);
+    passed = passed && dsp_executor_broadcast(executor, latency_record_task, histogram);
+    passed = passed && dsp_latency_get_stats(histogram, &stats) && (stats.count == 1000 * dsp_executor_workers(executor));
+    passed = passed && within_bucket(stats.p50_ns, 500) && within_bucket(stats.max_ns, 1000);
+    dsp_executor_destroy(executor);
+
+    // Measured calls
+    dsp_latency_reset(histogram);
+    real_t y = 0;
+    for (size_t k = 0; k < 100; ++k) { DSP_LATENCY_MEASURE(histogram, y = dsp_pid_update(pid, 1)); }
+    passed = passed && (y > 2) && dsp_latency_get_stats(histogram, &stats) && (stats.count == 100);
+    passed = passed && (stats.min_ns <= stats.p50_ns && stats.p50_ns <= stats.p99_ns && stats.p99_ns <= stats.p999_ns && stats.p999_ns <= stats.max_ns);
+
+    FILE* const report = tmpfile();
+    const dsp_latency_t* const histograms[1] = {histogram};
+    passed = passed && (report != NULL) && dsp_latency_report(histograms, 1, report) && (ftell(report) > 0);
+    if (report != NULL) { fclose(report); }
+
+    // Invalid parameters
+    dsp_latency_record(NULL, 1);
+    passed = passed && !dsp_latency_get_stats(NULL, &stats) && !dsp_latency_set_deadline(histogram, -1);
+    passed = passed && dsp_latency_percentile(histogram, 2) == 0 && !dsp_latency_destroy(NULL);
+
+    dsp_latency_destroy(histogram);
+    dsp_pid_destroy(pid);
+    printf("latency_histogram: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+
+
+// Worker 1 writes records with the values of their number, every other worker checks snapshots
+typedef struct TraceTestContext {
+    dsp_trace_t* trace;
+    bool consistent;
+} trace_test_context_t;
+
+static void trace_race_task(void* const context, const size_t worker, const size_t count) {
+    (void) count;
+    trace_test_context_t* const test = (trace_test_context_t*) context;
+    if (worker == 1) {
+        for (size_t n = 0; n < 100000; ++n) {
+            const real_t values[2] = {(real_t) (n % 1000), (real_t) (n % 1000) + 1};
+            dsp_trace_write(test->trace, 1, TraceValues, values, 2);
+        }
+        return;
+    }
+    static dsp_trace_record_t records[64];
+    for (size_t k = 0; k < 1000; ++k) {
+        const size_t copied = dsp_trace_snapshot(test->trace, records, 64);
+        for (size_t i = 0; i < copied; ++i) {
+            const float expected = (float) ((records[i].sequence - 1) % 1000);
+            if (records[i].values[0] != expected || records[i].values[1] != expected + 1 || (i > 0 && records[i].sequence <= records[i - 1].sequence)) {
+                __atomic_store_n(&test->consistent, false, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+bool test_trace_ring() {
+    dsp_pid_t* const pid = dsp_pid_create_controller(0.01f, 2, 10, 0.1f, 20);
+    dsp_trace_t* const trace = dsp_trace_create(5);
+    dsp_trace_record_t records[16];
+    bool passed = (pid != NULL && trace != NULL && dsp_trace_capacity(trace) == 8);
+
+    // The ring keeps the newest 8 of 20 records
+    for (size_t k = 0; k < 20 && passed; ++k) {
+        dsp_trace_stamp(trace);
+        dsp_pid_update(pid, 1 - 0.1f * (real_t) k);
+        dsp_trace_pid(trace, 3, pid);
+    }
+    size_t copied = dsp_trace_snapshot(trace, records, 16);
+    passed = passed && (copied == 8 && dsp_trace_written(trace) == 20);
+    for (size_t i = 0; i < copied && passed; ++i) {
+        passed = (records[i].sequence == 13 + i && records[i].source == 3 && records[i].kind == TracePid && records[i].count == 6);
+        passed = passed && (i == 0 || records[i].timestamp >= records[i - 1].timestamp);
+        passed = passed && records[i].values[0] == (float) (1 - 0.1f * (real_t) (12 + i));
+    }
+    passed = passed && records[7].values[0] == (float) pid->input && records[7].values[1] == (float) pid->pidsum &&
+        records[7].values[2] == (float) pid->output && records[7].values[3] == (float) pid->Xi &&
+        records[7].values[4] == (float) pid->Xd && records[7].values[5] == (float) pid->Xr;
+    passed = passed && (dsp_trace_snapshot(trace, records, 3) == 3 && records[0].sequence == 18);
+
+    // Ring of the calling thread
+    const real_t values[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    dsp_trace_write(NULL, 9, TraceValues, values, 8);
+    passed = passed && (dsp_trace_written(trace) == 20) && dsp_trace_select(trace) && (dsp_trace_selected() == trace);
+    dsp_trace_write(NULL, 9, TraceValues, values, 8);
+    passed = passed && (dsp_trace_snapshot(trace, records, 1) == 1 && records[0].source == 9 && records[0].count == 6 && records[0].values[5] == 6);
+    dsp_trace_select(NULL);
+
+    // Dump: header and the records of a snapshot
+    FILE* const file = tmpfile();
+    dsp_trace_file_header_t header;
+    passed = passed && (file != NULL) && dsp_trace_dump(trace, file);
+    if (file != NULL) {
+        rewind(file);
+        passed = passed && fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, DSP_TRACE_MAGIC, 8) == 0;
+        passed = passed && (header.records == 8 && header.record_size == sizeof(dsp_trace_record_t) && header.ns_per_tick > 0);
+        passed = passed && fread(records, sizeof(dsp_trace_record_t), 8, file) == 8 && (records[0].sequence == 14 && records[7].sequence == 21);
+        fclose(file);
+    }
+
+    // Snapshots while another thread writes
+    dsp_trace_t* const shared = dsp_trace_create(256);
+    dsp_executor_t* const executor = dsp_executor_create(2, NULL);
+    trace_test_context_t context = {shared, true};
+    passed = passed && (shared != NULL && executor != NULL);
+    if (passed && dsp_executor_workers(executor) == 1) { trace_race_task(&context, 1, 1); }
+    passed = passed && dsp_executor_broadcast(executor, trace_race_task, &context) && context.consistent;
+    dsp_executor_destroy(executor);
+    dsp_trace_destroy(shared);
+
+    passed = passed && (dsp_trace_create(0) == NULL) && (dsp_trace_snapshot(NULL, records, 1) == 0) && !dsp_trace_dump(trace, NULL);
+    dsp_trace_destroy(trace);
+    dsp_pid_destroy(pid);
+    printf("trace_ring: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+bool test_replay() {
+    bool passed = true;
+    const char* const recording_name = "Replay-Test-in.dsps";
+    const char* const outputs_name = "Replay-Test-out.dsps";
+    const size_t samples = 1000;
+
+    // Recording of setpoint and measurement as double
+    real_t values[2 * 1000];
+    for (size_t k = 0; k < samples; ++k) {
+        values[2 * k] = (real_t) ((k / 100) % 2);
+        values[2 * k + 1] = (real_t) (0.5 * sin(0.01 * (double) k));
+    }
+    FILE* file = fopen(recording_name, "wb");
+    passed = passed && (file != NULL) && dsp_replay_write_header(file, 2, samples, sizeof(double), 0.001);
+    passed = passed && dsp_replay_write(file, values, 2 * samples, sizeof(double));
+    if (file != NULL) { fclose(file); }
+
+    dsp_replay_file_t* const recording = dsp_replay_open(recording_name);
+    const dsp_replay_file_header_t* const header = dsp_replay_header(recording);
+    real_t tail[2 * 4];
+    passed = passed && (recording != NULL) && (header->width == 2 && header->samples == samples && header->value_size == sizeof(double));
+    passed = passed && (dsp_replay_read(recording, samples - 2, 4, tail) == 2) && (tail[3] == values[2 * samples - 1]);
+    passed = passed && (dsp_replay_read(recording, samples, 1, tail) == 0);
+
+    // error = setpoint - measurement through a lowpass, in batches of 64 samples
+    const real_t gains[2] = {1, -1};
+    dsp_ztf_t* const filter = dsp_ztf_create_lowpass_filter(1, 0.02f, 0.001f, 0, 0);
+    dsp_ztf_t* const reference = dsp_ztf_create_lowpass_filter(1, 0.02f, 0.001f, 0, 0);
+    dsp_diagram_t* const diagram = dsp_diagram_create(5, 64);
+    size_t input, demux, error, lowpass, output;
+    passed = passed && dsp_diagram_add_input(diagram, 2, &input) && dsp_diagram_add_demux(diagram, 2, &demux);
+    passed = passed && dsp_diagram_add_sum(diagram, 2, gains, &error) && dsp_diagram_add_ztf(diagram, filter, &lowpass) && dsp_diagram_add_output(diagram, 1, &output);
+    passed = passed && dsp_diagram_connect(diagram, input, 0, demux, 0) && dsp_diagram_connect(diagram, demux, 0, error, 0);
+    passed = passed && dsp_diagram_connect(diagram, demux, 1, error, 1) && dsp_diagram_connect(diagram, error, 0, lowpass, 0);
+    passed = passed && dsp_diagram_connect(diagram, lowpass, 0, output, 0) && dsp_diagram_compile(diagram);
+    passed = passed && (dsp_diagram_width(diagram, input) == 2 && dsp_diagram_width(diagram, lowpass) == 0 && dsp_diagram_max_samples(diagram) == 64);
+
+    dsp_replay_stats_t stats;
+    file = fopen(outputs_name, "wb");
+    passed = passed && (file != NULL) && dsp_replay_run(diagram, input, output, recording, file, 0, &stats);
+    if (file != NULL) { fclose(file); }
+    passed = passed && (stats.samples == samples && stats.batches == 16 && stats.seconds > 0 && stats.samples_per_second > 0);
+
+    // Outputs in the format and value type of the recording, equal to the filter run sample by sample
+    dsp_replay_file_t* const outputs = dsp_replay_open(outputs_name);
+    passed = passed && (outputs != NULL) && (dsp_replay_header(outputs)->width == 1 && dsp_replay_header(outputs)->value_size == sizeof(double));
+    real_t y[1000];
+    passed = passed && (dsp_replay_read(outputs, 0, samples, y) == samples);
+    for (size_t k = 0; passed && k < samples; ++k) {
+        passed = (y[k] == dsp_ztf_update(reference, values[2 * k] - values[2 * k + 1]));
+    }
+
+    // Uneven batches without outputs, wrong widths and files
+    passed = passed && dsp_replay_run(diagram, input, output, recording, NULL, 7, &stats) && (stats.batches == 143);
+    passed = passed && !dsp_replay_run(diagram, output, input, recording, NULL, 0, NULL) && !dsp_replay_run(diagram, input, output, outputs, NULL, 0, NULL);
+    file = fopen(outputs_name, "r+b");
+    passed = passed && (file != NULL) && dsp_replay_write_header(file, 1, samples + 1, sizeof(double), 0); // longer than the file
+    if (file != NULL) { fclose(file); }
+    passed = passed && (dsp_replay_open(outputs_name) == NULL) && (dsp_replay_open("Replay-Test-missing.dsps") == NULL);
+    passed = passed && !dsp_replay_write_header(stdout, 1, 1, 2, 0);
+
+    dsp_replay_close(outputs);
+    dsp_replay_close(recording);
+    dsp_diagram_destroy(diagram);
+    dsp_ztf_destroy(filter);
+    dsp_ztf_destroy(reference);
+    remove(recording_name);
+    remove(outputs_name);
+    printf("replay: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
 
 
 int main() {
@@ -731,5 +2357,32 @@ int main() {
 
     test_pid();
 
+    // Checks
+    bool passed = true;
+    passed = test_ztf_process_block() && passed;
+    passed = test_ztf_history() && passed;
+    passed = test_simd_kernels() && passed;
+    passed = test_fft_conv() && passed;
+    passed = test_matrix_multiply() && passed;
+    passed = test_matrix_lu() && passed;
+    passed = test_least_squares() && passed;
+    passed = test_workspace() && passed;
+    passed = test_allocator() && passed;
+    passed = test_zss_packed() && passed;
+    passed = test_pid_bank() && passed;
+    passed = test_ztf_bank() && passed;
+    passed = test_discontinuous_bank() && passed;
+    passed = test_zss_bank() && passed;
+    passed = test_executor() && passed;
+    passed = test_task_graph() && passed;
+    passed = test_block_diagram() && passed;
+    passed = test_sos() && passed;
+    passed = test_slow_pole() && passed;
+    passed = test_perf_counters() && passed;
+    passed = test_latency_histogram() && passed;
+    passed = test_trace_ring() && passed;
+    passed = test_replay() && passed;
+
     printf("Bye bye...\n");
+    return (passed ? 0 : 1);
 }
\ No newline at end of file
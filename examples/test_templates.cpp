@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <cmath>
+
+#include "DSP/Discrete/zTransferFunction.h"
+#include "DSP/Discrete/zStateSpace.h"
+#include "DSP/Discrete/TransferFunction.hpp"
+#include "DSP/Discrete/StateSpace.hpp"
+
+
+// Uniform noise in [-1, 1)
+static real_t noise(unsigned int* const seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (real_t) ((*seed >> 8) & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+bool test_transfer_function() {
+
+    // Biquad against dsp_ztf_update, then handed back and forth with its history
+    const real_t num[3] = {0.2f, 0.4f, 0.2f}, den[3] = {2, -0.8f, 0.3f};
+    dsp_ztf_t* const ztf = dsp_ztf_create_from_arrays(2, num, den, NULL, NULL);
+    dsp::TransferFunction<2> biquad({0.2f, 0.4f, 0.2f}, {2, -0.8f, 0.3f});
+    unsigned int seed = 37;
+
+    bool passed = (ztf != NULL);
+    for (size_t k = 0; k < 500 && passed; ++k) {
+        const real_t u = noise(&seed);
+        passed = (std::fabs(biquad.update(u) - dsp_ztf_update(ztf, u)) < 1e-5f);
+    }
+
+    dsp::TransferFunction<2> copy;
+    dsp::TransferFunction<3> other;
+    passed = passed && copy.assign(ztf) && !other.assign(ztf) && biquad.copy_to(ztf);
+    for (size_t k = 0; k < 100 && passed; ++k) {
+        const real_t u = noise(&seed);
+        const real_t y = copy.update(u);
+        passed = (std::fabs(y - dsp_ztf_update(ztf, u)) < 1e-5f) && (std::fabs(y - biquad.update(u)) < 1e-5f);
+    }
+
+    // The last output follows the history it was given
+    const real_t initial_u[2] = {0.5f, -0.25f}, initial_y[2] = {0.75f, 0.125f};
+    passed = passed && copy.assign(ztf) && (copy.output() == dsp_ztf_output(ztf)) && (copy.output() == copy.history_y()[0]);
+    copy.set_initial_condition(initial_u, initial_y);
+    passed = passed && (copy.output() == initial_y[0]);
+    copy.reset();
+    passed = passed && (copy.output() == 0);
+
+    // Without history
+    const real_t gain = 3;
+    dsp_ztf_t* const static_gain = dsp_ztf_create_from_arrays(0, &gain, NULL, NULL, NULL);
+    dsp::TransferFunction<0> scaled;
+    passed = passed && (static_gain != NULL) && (dsp_ztf_update(static_gain, 0.5f) == 1.5f);
+    passed = passed && scaled.assign(static_gain) && (scaled.output() == 1.5f);
+    scaled.set_initial_condition(NULL, NULL);
+    passed = passed && (scaled.output() == 0);
+    dsp_ztf_destroy(static_gain);
+
+    printf("transfer_function: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_ztf_destroy(ztf);
+    return passed;
+}
+
+bool test_state_space() {
+
+    const real_t a[4] = {0.9f, 0.1f, -0.2f, 0.8f}, b[4] = {1, 0, 0.5f, 1}, c[2] = {1, -1}, d[2] = {0.1f, 0};
+    dsp_zss_t* const zss = dsp_zss_create_from_arrays(2, 2, 1, a, b, c, d, NULL);
+    dsp::StateSpace<2, 2, 1> model({0.9f, 0.1f, -0.2f, 0.8f}, {1, 0, 0.5f, 1}, {1, -1}, {0.1f, 0});
+    unsigned int seed = 41;
+
+    bool passed = (zss != NULL) && model.has_feedthrough();
+    real_t y_zss[1];
+    for (size_t k = 0; k < 500 && passed; ++k) {
+        const std::array<real_t, 2> u = {{noise(&seed), noise(&seed)}};
+        const std::array<real_t, 1> y = model.update(u);
+        passed = dsp_zss_update(zss, u.data(), y_zss) && (std::fabs(y[0] - y_zss[0]) < 1e-4f);
+    }
+
+    dsp::StateSpace<2, 2, 1> copy;
+    dsp::StateSpace<2, 1, 1> other;
+    passed = passed && copy.assign(zss) && !other.assign(zss) && (std::fabs(copy.x[0] - model.x[0]) < 1e-4f) && (std::fabs(copy.x[1] - model.x[1]) < 1e-4f);
+    dsp_zss_t* const created = model.create_zss();
+    passed = passed && (created != NULL) && model.copy_to(created) && (created->x->elements[1] == model.x[1]);
+
+    printf("state_space: %s\n", (passed ? "passed" : "FAILED"));
+    dsp_zss_destroy(created);
+    dsp_zss_destroy(zss);
+    return passed;
+}
+
+
+
+int main() {
+
+    bool passed = true;
+    passed = test_transfer_function() && passed;
+    passed = test_state_space() && passed;
+    return (passed ? 0 : 1);
+}
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "DSP/Diagnostics/TraceRing.h"
+
+// Print a dump of 'dsp_trace_dump()' as CSV
+//
+//     dsp_trace_decode <dump> [--source <id>]
+//
+// One line per record: sequence, time in nanoseconds since the first record, source, kind and the values.
+// Records the writer overwrote during the dump are skipped.
+
+static const char* kind_name(const uint16_t kind) {
+    switch (kind) {
+        case TraceValues: return "values";
+        case TracePid: return "pid";
+        default: return "user";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 && !(argc == 4 && strcmp(argv[2], "--source") == 0)) {
+        fprintf(stderr, "usage: dsp_trace_decode <dump> [--source <id>]\n");
+        return 2;
+    }
+    const long source = (argc == 4 ? strtol(argv[3], NULL, 10) : -1);
+
+    FILE* const file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        fprintf(stderr, "dsp_trace_decode: cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+
+    dsp_trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, DSP_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DSP_TRACE_VERSION || header.record_size != sizeof(dsp_trace_record_t)) {
+        fprintf(stderr, "dsp_trace_decode: '%s' is not a trace dump of this version\n", argv[1]);
+        fclose(file);
+        return 1;
+    }
+
+    printf("# pid: v0 = input, v1 = pidsum, v2 = output, v3 = Xi, v4 = Xd, v5 = Xr\n");
+    printf("sequence,time_ns,source,kind,v0,v1,v2,v3,v4,v5\n");
+    bool first = true;
+    uint64_t start = 0, skipped = 0;
+    for (uint64_t k = 0; k < header.records; ++k) {
+        dsp_trace_record_t record;
+        if (fread(&record, sizeof(record), 1, file) != 1) {
+            fprintf(stderr, "dsp_trace_decode: truncated after %llu records\n", (unsigned long long) k);
+            fclose(file);
+            return 1;
+        }
+        if (record.sequence == 0) {
+            ++skipped;
+            continue;
+        }
+        if (first) {
+            start = record.timestamp;
+            first = false;
+        }
+        if (source >= 0 && record.source != source) { continue; }
+
+        const double time = header.ns_per_tick * (double) (int64_t) (record.timestamp - start);
+        printf("%llu,%.0f,%u,%s", (unsigned long long) record.sequence, time, (unsigned) record.source, kind_name(record.kind));
+        for (size_t v = 0; v < DSP_TRACE_VALUES; ++v) {
+            if (v < record.count) { printf(",%.9g", (double) record.values[v]); } else { printf(","); }
+        }
+        printf("\n");
+    }
+    if (skipped != 0) { fprintf(stderr, "dsp_trace_decode: %llu records were overwritten during the dump\n", (unsigned long long) skipped); }
+    fclose(file);
+    return 0;
+}